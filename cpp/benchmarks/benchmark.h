@@ -0,0 +1,301 @@
+/// Author: PlumpDolphin
+/// Date: October 16, 2026
+///
+/// Description:
+///     Provides a small, dependency-free microbenchmark runner used by the benchmark programs in this folder.
+///     Every benchmark is calibrated to run for a minimum amount of time, and reports nanoseconds per operation,
+///     items per second and heap allocations per operation. Results can be printed as a table, or as JSON or CSV
+///     so runs from different commits can be compared.
+///
+///     This header replaces the global allocation functions to count allocations,
+///     so it must only be included by a single translation unit of each benchmark program.
+///
+/// License:
+///     The code in this file is licensed under the
+///     Revised 3-Clause BSD License.
+///     For details, see https://opensource.org/licenses/BSD-3-Clause
+
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+
+
+// Example usage showing a benchmark program.
+/*
+    #include "benchmark.h"
+
+    int main(int argc, char** argv) {
+        BenchmarkRunner runner(argc, argv);
+
+        std::vector<float> values(1024);
+        runner.run("fill 1024 floats", [&](size_t iterations) {
+            for (size_t n = 0; n < iterations; n++) {
+                std::fill(values.begin(), values.end(), float(n));
+                benchmark_keep(values);
+            }
+        }, 1, values.size()); // 1 operation and 1024 items per iteration
+
+        return runner.finish();
+    }
+
+    // Command line options:
+    //     --filter=<text>      Only runs benchmarks whose name contains the text
+    //     --format=table|json|csv
+    //     --min-time=<seconds> Minimum measured time of every benchmark, 0.1 by default
+    //     --repetitions=<n>    Runs every benchmark n times and reports the median
+*/
+
+
+
+// Allocation counting
+// Every allocation made through operator new is counted, including the ones made by the standard library.
+// GCC can't see that the replaced operator new uses malloc, and warns about freeing its memory.
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+inline std::atomic<size_t> benchmark_allocations { 0 };
+
+void* operator new(size_t size) {
+    benchmark_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    benchmark_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, std::align_val_t align) {
+    benchmark_allocations.fetch_add(1, std::memory_order_relaxed);
+    size_t alignment = static_cast<size_t>(align);
+#if defined(_MSC_VER)
+    if (void* p = _aligned_malloc(size ? size : 1, alignment))
+        return p;
+#else
+    if (void* p = std::aligned_alloc(alignment, ((size + alignment - 1) / alignment) * alignment))
+        return p;
+#endif
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size, std::align_val_t align) { return operator new(size, align); }
+
+void operator delete(void* p) noexcept                         { std::free(p); }
+void operator delete[](void* p) noexcept                       { std::free(p); }
+void operator delete(void* p, size_t) noexcept                 { std::free(p); }
+void operator delete[](void* p, size_t) noexcept               { std::free(p); }
+
+// Aligned allocations must be released by the matching function on Windows
+inline void _benchmark_aligned_free(void* p) {
+#if defined(_MSC_VER)
+    _aligned_free(p);
+#else
+    std::free(p);
+#endif
+}
+
+void operator delete(void* p, std::align_val_t) noexcept           { _benchmark_aligned_free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept         { _benchmark_aligned_free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept   { _benchmark_aligned_free(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { _benchmark_aligned_free(p); }
+
+#if defined(__GNUC__) && !defined(__clang__)
+    #pragma GCC diagnostic pop
+#endif
+
+
+
+// Keeps the compiler from optimizing away a value, or the work that produced it
+template <typename T>
+inline void benchmark_keep(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r"(&value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+
+
+// Result of a single benchmark
+struct BenchmarkResult {
+    std::string name;
+    size_t iterations = 0;
+    double ns_per_op = 0;
+    double items_per_second = 0;
+    double allocations_per_op = 0;
+};
+
+
+
+class BenchmarkRunner {
+public:
+    enum class Format { Table, Json, Csv };
+
+    // Settings
+    std::string filter;
+    Format format = Format::Table;
+    double min_time = 0.1;
+    size_t repetitions = 1;
+
+
+
+    BenchmarkRunner() {}
+
+    // Reads the settings from the command line
+    BenchmarkRunner(int argc, char** argv) {
+        for (int i = 1; i < argc; i++) {
+            std::string_view arg = argv[i];
+            if (arg.starts_with("--filter="))
+                filter = arg.substr(9);
+            else if (arg == "--format=json")
+                format = Format::Json;
+            else if (arg == "--format=csv")
+                format = Format::Csv;
+            else if (arg == "--format=table")
+                format = Format::Table;
+            else if (arg.starts_with("--min-time="))
+                min_time = std::atof(argv[i] + 11);
+            else if (arg.starts_with("--repetitions="))
+                repetitions = std::max(1, std::atoi(argv[i] + 14));
+            else
+                std::fprintf(stderr, "Unknown option: %s\n", argv[i]);
+        }
+    }
+
+
+
+    // Runs `f(iterations)`, which should repeat the measured work `iterations` times.
+    // Every iteration counts as `ops` operations and `items` items, for benchmarks that process a batch per iteration.
+    template <typename F>
+    void run(std::string_view name, F&& f, size_t ops = 1, size_t items = 1) {
+        if (!filter.empty() && name.find(filter) == std::string_view::npos)
+            return;
+
+        if (results.empty() && format == Format::Table)
+            std::printf("%-52s %14s %12s %16s %12s\n", "Benchmark", "Iterations", "ns/op", "items/s", "allocs/op");
+
+        // Grows the iteration count until one run takes long enough to time reliably
+        size_t iterations = 1;
+        while (true) {
+            double seconds = _time(f, iterations).first;
+            if (seconds >= min_time || iterations >= (size_t(1) << 40))
+                break;
+
+            double scale = seconds > 0 ? (min_time * 1.2) / seconds : 100;
+            iterations = static_cast<size_t>(static_cast<double>(iterations) * std::clamp(scale, 2.0, 100.0));
+        }
+
+        // Measured runs, keeping the median
+        std::vector<std::pair<double, size_t>> runs;
+        for (size_t r = 0; r < repetitions; r++)
+            runs.push_back(_time(f, iterations));
+        std::sort(runs.begin(), runs.end());
+        auto [seconds, allocations] = runs[runs.size() / 2];
+
+        BenchmarkResult result;
+        result.name = name;
+        result.iterations = iterations;
+        result.ns_per_op = (seconds * 1e9) / static_cast<double>(iterations * ops);
+        result.items_per_second = static_cast<double>(iterations * items) / seconds;
+        result.allocations_per_op = static_cast<double>(allocations) / static_cast<double>(iterations * ops);
+        results.push_back(result);
+
+        if (format == Format::Table) {
+            std::printf("%-52s %14zu %12.3f %16.4g %12.3f\n", result.name.c_str(), result.iterations,
+                        result.ns_per_op, result.items_per_second, result.allocations_per_op);
+            std::fflush(stdout);
+        } else {
+            std::fprintf(stderr, "%s\n", result.name.c_str());
+        }
+    }
+
+    // Prints machine-readable results, and returns the exit code for main()
+    int finish() {
+        if (format == Format::Json) {
+            std::printf("{\n  \"context\": {\"compiler\": \"%s\", \"optimized\": %s, \"min_time\": %g, \"repetitions\": %zu},\n",
+                        _escape(_compiler()).c_str(), _optimized() ? "true" : "false", min_time, repetitions);
+            std::printf("  \"benchmarks\": [\n");
+            for (size_t i = 0; i < results.size(); i++) {
+                const BenchmarkResult& r = results[i];
+                std::printf("    {\"name\": \"%s\", \"iterations\": %zu, \"ns_per_op\": %.6g, "
+                            "\"items_per_second\": %.6g, \"allocations_per_op\": %.6g}%s\n",
+                            _escape(r.name).c_str(), r.iterations, r.ns_per_op, r.items_per_second,
+                            r.allocations_per_op, i + 1 < results.size() ? "," : "");
+            }
+            std::printf("  ]\n}\n");
+        } else if (format == Format::Csv) {
+            std::printf("name,iterations,ns_per_op,items_per_second,allocations_per_op\n");
+            for (const auto &r: results)
+                std::printf("\"%s\",%zu,%.6g,%.6g,%.6g\n", r.name.c_str(), r.iterations, r.ns_per_op,
+                            r.items_per_second, r.allocations_per_op);
+        }
+        return 0;
+    }
+
+    const std::vector<BenchmarkResult>& getResults() const { return results; }
+
+
+
+private:
+    std::vector<BenchmarkResult> results;
+
+    // Returns the elapsed seconds and the number of allocations of one run
+    template <typename F>
+    static std::pair<double, size_t> _time(F& f, size_t iterations) {
+        size_t allocations = benchmark_allocations.load(std::memory_order_relaxed);
+        auto start = std::chrono::steady_clock::now();
+        f(iterations);
+        auto end = std::chrono::steady_clock::now();
+        allocations = benchmark_allocations.load(std::memory_order_relaxed) - allocations;
+        return { std::chrono::duration<double>(end - start).count(), allocations };
+    }
+
+    static std::string _escape(std::string_view text) {
+        std::string out;
+        for (char c: text) {
+            if (c == '"' || c == '\\')
+                out += '\\';
+            out += c;
+        }
+        return out;
+    }
+
+    static std::string _compiler() {
+#if defined(__clang__)
+        return "clang " __clang_version__;
+#elif defined(__GNUC__)
+        return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+        return "msvc " + std::to_string(_MSC_VER);
+#else
+        return "unknown";
+#endif
+    }
+
+    static bool _optimized() {
+#if defined(__OPTIMIZE__) || defined(NDEBUG)
+        return true;
+#else
+        return false;
+#endif
+    }
+};
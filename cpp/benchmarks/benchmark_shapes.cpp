@@ -0,0 +1,969 @@
+/// Author: PlumpDolphin
+/// Date: October 16, 2026
+///
+/// Description:
+///     Microbenchmarks for the hot paths of vectorx.h, shapes.h and polygon.h: vector operators, point rotation,
+///     vertex generation, serialization, transforms dispatched through Shape2D, spatial indices, the collision
+///     pipeline, the polygon geometry kernels, tessellation, point queries, ray casting and rasterization.
+///
+///     Build and run from this folder with an optimizing compiler, for example:
+///         g++ -std=c++20 -O2 -march=native -I.. benchmark_shapes.cpp -o benchmark_shapes
+///         ./benchmark_shapes --format=json > before.json
+///
+///     Building with -DSHAPES_INSTRUMENTATION (or -DSHAPES_INSTRUMENTATION_TIMERS) also prints to stderr what one
+///     frame of the "instrumented frame" benchmark counted: trig evaluations, vertex buffers, serializations and
+///     transform calls. Compare the timings of both builds to see what the instrumentation costs.
+///
+/// License:
+///     The code in this file is licensed under the
+///     Revised 3-Clause BSD License.
+///     For details, see https://opensource.org/licenses/BSD-3-Clause
+
+
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <numbers>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "benchmark.h" // Includes the BenchmarkRunner.
+#include "collision.h"  // Includes the CollisionPipeline.
+#include "instrument.h" // Includes the counters reported by the instrumented frame.
+#include "polygon.h"    // Includes the polygon kernels being measured.
+#include "raster.h"     // Includes the Rasterizer drawing shapes into grids.
+#include "raycast.h"    // Includes the RayCaster and the BVH it can traverse.
+#include "shapebatch.h" // Includes CircleBatch, for level of detail rendering.
+#include "shapes.h"     // Includes the shapes and vectors being measured.
+#include "spatial.h"    // Includes the BVH and UniformGrid indices.
+#include "tessellate.h" // Includes the Tessellator used to export meshes.
+
+
+
+// Number of vectors or shapes processed by every iteration of the batched benchmarks
+constexpr size_t batch_size = 1024;
+
+
+
+// Vector operators
+// Every operator is measured between two vectors and between a vector and a scalar, over a batch of vectors.
+// Integer-only operators are skipped for floating-point vectors. Right hand sides stay in [1, 7],
+// so division, modulo and shifts are always defined.
+#define BENCHMARK_VECTOR_OP(op, ...)                                                                   \
+    runner.run(prefix + " " #op " vector", [&](size_t iterations) {                                    \
+        for (size_t n = 0; n < iterations; n++) {                                                      \
+            for (size_t i = 0; i < batch_size; i++)                                                    \
+                out[i] = a[i] op b[i];                                                                 \
+            benchmark_keep(out);                                                                       \
+        }                                                                                              \
+    }, batch_size, batch_size);                                                                        \
+                                                                                                       \
+    runner.run(prefix + " " #op " scalar", [&](size_t iterations) {                                    \
+        for (size_t n = 0; n < iterations; n++) {                                                      \
+            for (size_t i = 0; i < batch_size; i++)                                                    \
+                out[i] = a[i] op scalar;                                                               \
+            benchmark_keep(out);                                                                       \
+        }                                                                                              \
+    }, batch_size, batch_size);
+
+template <typename V>
+void benchmark_vector_ops(BenchmarkRunner& runner, const std::string& prefix) {
+    using T = typename V::value_type;
+
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<int> values(1, 7);
+
+    std::vector<V> a(batch_size), b(batch_size), out(batch_size);
+    for (size_t i = 0; i < batch_size; i++) {
+        for (size_t d = 0; d < V::dimensions; d++) {
+            a[i][d] = static_cast<T>(values(rng) * 16);
+            b[i][d] = static_cast<T>(values(rng));
+        }
+    }
+    T scalar = 3;
+
+    BENCHMARK_VECTOR_OP(+)
+    BENCHMARK_VECTOR_OP(-)
+    BENCHMARK_VECTOR_OP(*)
+    BENCHMARK_VECTOR_OP(/)
+
+    if constexpr (std::is_integral_v<T>) {
+        BENCHMARK_VECTOR_OP(%)
+        BENCHMARK_VECTOR_OP(&)
+        BENCHMARK_VECTOR_OP(|)
+        BENCHMARK_VECTOR_OP(^)
+        BENCHMARK_VECTOR_OP(<<)
+        BENCHMARK_VECTOR_OP(>>)
+    }
+}
+
+template <size_t N>
+void benchmark_vector_types(BenchmarkRunner& runner) {
+    std::string name = "Vector" + std::to_string(N);
+    benchmark_vector_ops<Vector<int, N>>(runner, name + "<int>");
+    benchmark_vector_ops<Vector<float, N>>(runner, name + "<float>");
+    benchmark_vector_ops<Vector<double, N>>(runner, name + "<double>");
+}
+
+
+
+// Point rotation, with the angle converted on every call, and with a precomputed cosine and sine
+void benchmark_rotation(BenchmarkRunner& runner) {
+    std::vector<Vector2<float>> points(batch_size), out(batch_size);
+    for (size_t i = 0; i < batch_size; i++)
+        points[i] = Vector2<float>(static_cast<float>(i), static_cast<float>(batch_size - i));
+    Vector2<float> origin(3, 4);
+
+    runner.run("rotate_point degrees", [&](size_t iterations) {
+        for (size_t n = 0; n < iterations; n++) {
+            for (size_t i = 0; i < batch_size; i++)
+                out[i] = rotate_point(points[i], origin, static_cast<Angle>(i));
+            benchmark_keep(out);
+        }
+    }, batch_size, batch_size);
+
+    Angle radians = to_radians(static_cast<Angle>(30));
+    auto cosine = cos(radians);
+    auto sine = sin(radians);
+    runner.run("rotate_point cosine/sine", [&](size_t iterations) {
+        for (size_t n = 0; n < iterations; n++) {
+            for (size_t i = 0; i < batch_size; i++)
+                out[i] = rotate_point(points[i], origin, cosine, sine);
+            benchmark_keep(out);
+        }
+    }, batch_size, batch_size);
+
+    runner.run("rotate_points span", [&](size_t iterations) {
+        for (size_t n = 0; n < iterations; n++) {
+            rotate_points<float>(points, out, origin, static_cast<Angle>(30));
+            benchmark_keep(out);
+        }
+    }, batch_size, batch_size);
+
+    // Integer points take the fixed-point path, lanes use the packed integer kernel
+    std::vector<Vector2<int>> int_points(batch_size), int_out(batch_size);
+    VectorArray2<float> lanes(points), lanes_out;
+    VectorArray2<int> int_lanes(batch_size), int_lanes_out;
+    for (size_t i = 0; i < batch_size; i++) {
+        int_points[i] = Vector2<int>(static_cast<int>(i), static_cast<int>(batch_size - i));
+        int_lanes.x[i] = int_points[i].x;
+        int_lanes.y[i] = int_points[i].y;
+    }
+
+    runner.run("rotate_points span<int>", [&](size_t iterations) {
+        for (size_t n = 0; n < iterations; n++) {
+            rotate_points<int>(int_points, int_out, Vector2<int>(3, 4), static_cast<Angle>(30));
+            benchmark_keep(int_out);
+        }
+    }, batch_size, batch_size);
+
+    runner.run("rotate_points VectorArray2<float>", [&](size_t iterations) {
+        for (size_t n = 0; n < iterations; n++) {
+            rotate_points(lanes, lanes_out, origin, static_cast<Angle>(30));
+            benchmark_keep(lanes_out);
+        }
+    }, batch_size, batch_size);
+
+    runner.run("rotate_points VectorArray2<int>", [&](size_t iterations) {
+        for (size_t n = 0; n < iterations; n++) {
+            rotate_points(int_lanes, int_lanes_out, Vector2<int>(3, 4), static_cast<Angle>(30));
+            benchmark_keep(int_lanes_out);
+        }
+    }, batch_size, batch_size);
+}
+
+
+
+// Vertex generation
+void benchmark_vertices(BenchmarkRunner& runner) {
+    Circle<float> circle(5, 1, 2, 30);
+    std::vector<Vector2<float>> buffer(4096);
+
+    // Every resolution is rendered into a reused buffer, so only the unit-circle cache could allocate
+    for (size_t resolution = 8; resolution <= 4096; resolution *= 2) {
+        runner.run("Circle::vertices " + std::to_string(resolution), [&](size_t iterations) {
+            for (size_t n = 0; n < iterations; n++) {
+                circle.vertices(std::span<Vector2<float>>(buffer), resolution);
+                benchmark_keep(buffer);
+            }
+        }, 1, resolution);
+    }
+
+    // Returning a new list allocates once per call
+    runner.run("Circle::vertices 64 new list", [&](size_t iterations) {
+        for (size_t n = 0; n < iterations; n++) {
+            auto list = circle.vertices(size_t(64));
+            benchmark_keep(list);
+        }
+    }, 1, 64);
+
+    // A batch of circles with radii spread over several orders of magnitude, at a fixed resolution
+    // and at a level of detail. Items are circles, so the two are comparable.
+    CircleBatch<float> circles;
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> exponent(-1, 3);
+    for (size_t i = 0; i < batch_size; i++)
+        circles.push_back(Circle<float>(std::pow(10.0f, exponent(rng)), static_cast<float>(i), 0, static_cast<float>(i)));
+
+    std::vector<Vector2<float>> batch_buffer;
+    circles.vertices(batch_buffer);
+    runner.run("CircleBatch::vertices 64", [&](size_t iterations) {
+        for (size_t n = 0; n < iterations; n++) {
+            circles.vertices(batch_buffer);
+            benchmark_keep(batch_buffer);
+        }
+    }, 1, batch_size);
+
+    std::vector<size_t> offsets;
+    CircleDetail detail { 0.25, 1 };
+    runner.run("CircleBatch::vertices detail " + std::to_string(circles.vertexCount(detail)), [&](size_t iterations) {
+        for (size_t n = 0; n < iterations; n++) {
+            circles.vertices(batch_buffer, offsets, detail);
+            benchmark_keep(batch_buffer);
+        }
+    }, 1, batch_size);
+
+    Rectangle<float> rectangle(1, 2, 3, 4, 30);
+    runner.run("Rectangle::vertices", [&](size_t iterations) {
+        for (size_t n = 0; n < iterations; n++) {
+            rectangle.vertices(std::span<Vector2<float>>(buffer));
+            benchmark_keep(buffer);
+        }
+    }, 1, 4);
+
+    for (size_t sides: { 3, 5, 8, 64 }) {
+        NGon<float> ngon(sides, 5, 1, 2, 30);
+        runner.run("NGon::vertices " + std::to_string(sides), [&](size_t iterations) {
+            for (size_t n = 0; n < iterations; n++) {
+                ngon.vertices(std::span<Vector2<float>>(buffer));
+                benchmark_keep(buffer);
+            }
+        }, 1, sides);
+    }
+}
+
+
+
+// Serialization into a reused string, which is cleared whenever it grows past a few megabytes.
+template <typename Element>
+void benchmark_serializer(BenchmarkRunner& runner, const std::string& name, const Element& element) {
+    std::string out;
+    out.reserve(1 << 22);
+
+    runner.run(name + " str", [&](size_t iterations) {
+        for (size_t n = 0; n < iterations; n++) {
+            if (out.size() > (1 << 21))
+                out.clear();
+            element.str(out);
+        }
+        benchmark_keep(out);
+    });
+
+    runner.run(name + " json", [&](size_t iterations) {
+        for (size_t n = 0; n < iterations; n++) {
+            if (out.size() > (1 << 21))
+                out.clear();
+            element.json(out);
+        }
+        benchmark_keep(out);
+    });
+}
+
+void benchmark_serializers(BenchmarkRunner& runner) {
+    benchmark_serializer(runner, "Vector2<float>", Vector2<float>(1.25f, -3.5f));
+    benchmark_serializer(runner, "Vector4<int>", Vector4<int>(1, -20, 300, -4000));
+    benchmark_serializer(runner, "Circle<float>", Circle<float>(5, 1.5f, 2.25f, 30));
+    benchmark_serializer(runner, "Rectangle<float>", Rectangle<float>(1, 2, 3, 4, 30));
+    benchmark_serializer(runner, "NGon<float>", NGon<float>(6, 5, 1, 2, 30));
+
+    // Returning a new string allocates on every call
+    Circle<float> circle(5, 1.5f, 2.25f, 30);
+    runner.run("Circle<float> json new string", [&](size_t iterations) {
+        for (size_t n = 0; n < iterations; n++) {
+            std::string json = circle.json();
+            benchmark_keep(json);
+        }
+    });
+}
+
+
+
+// Transforms called through Shape2D pointers over a mixed batch of shapes
+void benchmark_dispatch(BenchmarkRunner& runner) {
+    std::vector<std::unique_ptr<Shape2D<float>>> shapes;
+    for (size_t i = 0; i < batch_size; i++) {
+        float x = static_cast<float>(i);
+        switch (i % 3) {
+        case 0:  shapes.push_back(std::make_unique<Circle<float>>(5, x, x)); break;
+        case 1:  shapes.push_back(std::make_unique<Rectangle<float>>(3, 4, x, x)); break;
+        default: shapes.push_back(std::make_unique<NGon<float>>(5, 3, x, x)); break;
+        }
+    }
+
+    // move, rotateFrom and scaleFrom defer the move of the position like transform(), so every call is
+    // flushed in the timed loop, and a chain of them is flushed once
+    runner.run("Shape2D::move + flush", [&](size_t iterations) {
+        for (size_t n = 0; n < iterations; n++) {
+            float step = (n & 1) ? 1.0f : -1.0f;
+            for (auto &shape: shapes) {
+                shape->move(step, step);
+                shape->flush();
+            }
+        }
+    }, batch_size, batch_size);
+
+    runner.run("Shape2D::rotate", [&](size_t iterations) {
+        for (size_t n = 0; n < iterations; n++)
+            for (auto &shape: shapes)
+                shape->rotate(1);
+    }, batch_size, batch_size);
+
+    runner.run("Shape2D::rotateFrom + flush", [&](size_t iterations) {
+        for (size_t n = 0; n < iterations; n++) {
+            for (auto &shape: shapes) {
+                shape->rotateFrom(1, 0, 0);
+                shape->flush();
+            }
+        }
+    }, batch_size, batch_size);
+
+    runner.run("Shape2D::scaleFrom + flush", [&](size_t iterations) {
+        for (size_t n = 0; n < iterations; n++) {
+            float scalar = (n & 1) ? 1.25f : 0.8f;
+            for (auto &shape: shapes) {
+                shape->scaleFrom(scalar, 0, 0);
+                shape->flush();
+            }
+        }
+    }, batch_size, batch_size);
+
+    runner.run("Shape2D::move, rotateFrom, scaleFrom x4 + flush", [&](size_t iterations) {
+        for (size_t n = 0; n < iterations; n++) {
+            float scalar = (n & 1) ? 1.25f : 0.8f;
+            for (auto &shape: shapes) {
+                for (int k = 0; k < 4; k++) {
+                    shape->move(1, -1);
+                    shape->rotateFrom(1, 0, 0);
+                    shape->scaleFrom(scalar, 0, 0);
+                }
+                shape->flush();
+            }
+        }
+    }, batch_size, batch_size * 12);
+
+    // Deferred transforms only compose a matrix until the shape is read, so every transform is flushed
+    // in the timed loop. Otherwise only the matrix composition would be measured.
+    auto t = Transform2D<float>::rotation(1, Vector2<float>(0, 0));
+    runner.run("Shape2D::transform + flush", [&](size_t iterations) {
+        for (size_t n = 0; n < iterations; n++) {
+            for (auto &shape: shapes) {
+                shape->transform(t);
+                shape->flush();
+            }
+        }
+    }, batch_size, batch_size);
+
+    runner.run("Shape2D::transform + bounds", [&](size_t iterations) {
+        for (size_t n = 0; n < iterations; n++) {
+            for (auto &shape: shapes) {
+                shape->transform(t);
+                auto box = shape->bounds();
+                benchmark_keep(box);
+            }
+        }
+    }, batch_size, batch_size);
+
+    // Every shape is flushed above, so the area isn't timed with a leftover transform
+    runner.run("Shape2D::area", [&](size_t iterations) {
+        for (size_t n = 0; n < iterations; n++) {
+            float total = 0;
+            for (auto &shape: shapes)
+                total += shape->area();
+            benchmark_keep(total);
+        }
+    }, batch_size, batch_size);
+}
+
+
+
+// Building, refitting and querying both spatial indices over scenes of small shapes, against a linear scan
+// of the same bounds. Scenes grow with the same density, so every query finds about the same number of shapes.
+void benchmark_spatial(BenchmarkRunner& runner) {
+    constexpr size_t queries = 1024;
+
+    for (size_t count: { 10000, 100000 }) {
+        float world = 10 * std::sqrt(static_cast<float>(count));
+        std::mt19937 rng(1);
+        std::uniform_real_distribution<float> coordinate(0, world), size(1, 5), angle(0, 360);
+
+        std::vector<std::unique_ptr<Shape2D<float>>> owned;
+        for (size_t i = 0; i < count; i++) {
+            Vector2<float> position(coordinate(rng), coordinate(rng));
+            if (i % 2 == 0)
+                owned.push_back(std::make_unique<Circle<float>>(size(rng), position));
+            else
+                owned.push_back(std::make_unique<Rectangle<float>>(size(rng), size(rng), position, angle(rng)));
+        }
+
+        std::vector<Shape2D<float>*> scene;
+        for (auto &shape: owned)
+            scene.push_back(shape.get());
+
+        std::vector<Bounds2D<float>> regions;
+        std::vector<Vector2<float>> points;
+        for (size_t i = 0; i < queries; i++) {
+            Vector2<float> corner(coordinate(rng), coordinate(rng));
+            regions.push_back(Bounds2D<float>(corner, corner + Vector2<float>(20, 20)));
+            points.push_back(Vector2<float>(coordinate(rng), coordinate(rng)));
+        }
+
+        BVH<float> bvh;
+        UniformGrid<float> grid(8);
+        std::vector<uint32_t> hits;
+        std::string suffix = " " + std::to_string(count) + " shapes";
+
+        runner.run("BVH::build" + suffix, [&](size_t iterations) {
+            for (size_t n = 0; n < iterations; n++) {
+                bvh.build(scene);
+                benchmark_keep(bvh);
+            }
+        }, 1, count);
+
+        runner.run("UniformGrid::build" + suffix, [&](size_t iterations) {
+            for (size_t n = 0; n < iterations; n++) {
+                grid.build(scene);
+                benchmark_keep(grid);
+            }
+        }, 1, count);
+
+        // Every shape moves by a fraction of its size each frame, then the index is refit
+        runner.run("BVH::refit moving" + suffix, [&](size_t iterations) {
+            for (size_t n = 0; n < iterations; n++) {
+                float step = (n & 1) ? 0.5f : -0.5f;
+                for (auto *shape: scene)
+                    shape->move(step, step);
+                bvh.refit(scene);
+                benchmark_keep(bvh);
+            }
+        }, 1, count);
+
+        runner.run("UniformGrid::refit moving" + suffix, [&](size_t iterations) {
+            for (size_t n = 0; n < iterations; n++) {
+                float step = (n & 1) ? 0.5f : -0.5f;
+                for (auto *shape: scene)
+                    shape->move(step, step);
+                grid.refit(scene);
+                benchmark_keep(grid);
+            }
+        }, 1, count);
+
+        // Both indices were refit to where the shapes ended up, and the scan reads the same bounds
+        std::vector<Bounds2D<float>> boxes(count);
+        bounds_all<float>(scene, boxes);
+
+        runner.run("BVH::query region" + suffix, [&](size_t iterations) {
+            for (size_t n = 0; n < iterations; n++) {
+                for (const auto &region: regions) {
+                    bvh.query(region, hits);
+                    benchmark_keep(hits);
+                }
+            }
+        }, queries, queries);
+
+        runner.run("UniformGrid::query region" + suffix, [&](size_t iterations) {
+            for (size_t n = 0; n < iterations; n++) {
+                for (const auto &region: regions) {
+                    grid.query(region, hits);
+                    benchmark_keep(hits);
+                }
+            }
+        }, queries, queries);
+
+        runner.run("linear scan region" + suffix, [&](size_t iterations) {
+            for (size_t n = 0; n < iterations; n++) {
+                for (const auto &region: regions) {
+                    hits.clear();
+                    for (uint32_t i = 0; i < count; i++)
+                        if (boxes[i].overlaps(region))
+                            hits.push_back(i);
+                    benchmark_keep(hits);
+                }
+            }
+        }, queries, queries);
+
+        runner.run("BVH::query point" + suffix, [&](size_t iterations) {
+            for (size_t n = 0; n < iterations; n++) {
+                for (const auto &point: points) {
+                    bvh.query(point, hits);
+                    benchmark_keep(hits);
+                }
+            }
+        }, queries, queries);
+
+        runner.run("UniformGrid::query point" + suffix, [&](size_t iterations) {
+            for (size_t n = 0; n < iterations; n++) {
+                for (const auto &point: points) {
+                    grid.query(point, hits);
+                    benchmark_keep(hits);
+                }
+            }
+        }, queries, queries);
+
+        runner.run("linear scan point" + suffix, [&](size_t iterations) {
+            for (size_t n = 0; n < iterations; n++) {
+                for (const auto &point: points) {
+                    hits.clear();
+                    for (uint32_t i = 0; i < count; i++)
+                        if (boxes[i].contains(point))
+                            hits.push_back(i);
+                    benchmark_keep(hits);
+                }
+            }
+        }, queries, queries);
+    }
+}
+
+
+
+// Finding every contact in a scene of 200k small shapes, as a physics step would, on one thread and on all of them
+void benchmark_collision(BenchmarkRunner& runner) {
+    constexpr size_t count = 200000;
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> coordinate(0, 4000), size(1, 8), angle(0, 360);
+
+    CircleBatch<float> circles;
+    RectangleBatch<float> rectangles;
+    NGonBatch<float> ngons;
+    for (size_t i = 0; i < count; i++) {
+        Vector2<float> position(coordinate(rng), coordinate(rng));
+        if (i % 3 == 0)
+            circles.push_back(Circle<float>(size(rng) / 2, position));
+        else if (i % 3 == 1)
+            rectangles.push_back(Rectangle<float>(size(rng), size(rng), position, angle(rng)));
+        else
+            ngons.push_back(NGon<float>(6, size(rng) / 2, position, angle(rng)));
+    }
+
+    for (size_t threads: { 1, 0 }) {
+        CollisionPipeline<float> pipeline(threads);
+        std::string name = "CollisionPipeline::detect 200k shapes, " + std::to_string(pipeline.threadCount()) + " threads";
+
+        // Shapes are added again every step, the same as a physics engine would after moving them
+        runner.run(name, [&](size_t iterations) {
+            for (size_t n = 0; n < iterations; n++) {
+                pipeline.clear();
+                pipeline.add(circles);
+                pipeline.add(rectangles);
+                pipeline.add(ngons);
+                benchmark_keep(pipeline.detect());
+            }
+        }, 1, count);
+    }
+}
+
+
+
+// Polygon geometry kernels, over star-shaped outlines with a wobbling radius.
+// The kernels are called directly, since Polygon caches their results until the vertices change.
+void benchmark_polygons(BenchmarkRunner& runner) {
+    for (size_t count: { 1000, 100000 }) {
+        std::vector<Vector2<float>> outline(count);
+        for (size_t i = 0; i < count; i++) {
+            float angle = 6.2831853f * static_cast<float>(i) / static_cast<float>(count);
+            float radius = 50 + (30 * std::sin(static_cast<float>(i) * 0.37f));
+            outline[i] = Vector2<float>(radius * std::cos(angle), radius * std::sin(angle));
+        }
+
+        Polygon<float> polygon(outline, Vector2<float>(1, 2), 30);
+        const float* x = polygon.points.x;
+        const float* y = polygon.points.y;
+        std::string suffix = " " + std::to_string(count);
+
+        runner.run("polygon_moments" + suffix, [&](size_t iterations) {
+            for (size_t n = 0; n < iterations; n++) {
+                auto moments = polygon_moments(x, y, count);
+                benchmark_keep(moments);
+            }
+        }, 1, count);
+
+        runner.run("polygon_perimeter" + suffix, [&](size_t iterations) {
+            for (size_t n = 0; n < iterations; n++) {
+                double perimeter = polygon_perimeter(x, y, count);
+                benchmark_keep(perimeter);
+            }
+        }, 1, count);
+
+        runner.run("polygon_contains" + suffix, [&](size_t iterations) {
+            for (size_t n = 0; n < iterations; n++) {
+                bool inside = polygon_contains(x, y, count, static_cast<double>(n % 64), 0.5);
+                benchmark_keep(inside);
+            }
+        }, 1, count);
+
+        std::vector<size_t> indices;
+        runner.run("polygon_convex_hull" + suffix, [&](size_t iterations) {
+            for (size_t n = 0; n < iterations; n++) {
+                polygon_convex_hull(x, y, count, indices);
+                benchmark_keep(indices);
+            }
+        }, 1, count);
+
+        // Polygon checks the linear hull against every vertex, and only needs the general hull when it fails
+        runner.run("polygon_hull_contains_all" + suffix, [&](size_t iterations) {
+            for (size_t n = 0; n < iterations; n++) {
+                bool holds = polygon_hull_contains_all(x, y, count, indices);
+                benchmark_keep(holds);
+            }
+        }, 1, count);
+
+        std::vector<size_t> general;
+        runner.run("polygon_point_hull" + suffix, [&](size_t iterations) {
+            for (size_t n = 0; n < iterations; n++) {
+                polygon_point_hull(x, y, count, general);
+                benchmark_keep(general);
+            }
+        }, 1, count);
+
+        runner.run("polygon_simplify" + suffix, [&](size_t iterations) {
+            for (size_t n = 0; n < iterations; n++) {
+                polygon_simplify(x, y, count, 0.5, indices);
+                benchmark_keep(indices);
+            }
+        }, 1, count);
+
+        std::vector<Vector2<float>> buffer(count);
+        runner.run("Polygon::vertices" + suffix, [&](size_t iterations) {
+            for (size_t n = 0; n < iterations; n++) {
+                polygon.vertices(std::span<Vector2<float>>(buffer));
+                benchmark_keep(buffer);
+            }
+        }, 1, count);
+    }
+}
+
+
+
+// Tessellation of a mixed scene into reused buffers, and ear clipping of a polygon that isn't convex
+void benchmark_tessellation(BenchmarkRunner& runner) {
+    std::vector<std::unique_ptr<Shape2D<float>>> shapes;
+    size_t vertex_total = 0;
+    for (size_t i = 0; i < batch_size; i++) {
+        float x = static_cast<float>(i);
+        switch (i % 3) {
+        case 0:  shapes.push_back(std::make_unique<Circle<float>>(5, x, x)); break;
+        case 1:  shapes.push_back(std::make_unique<Rectangle<float>>(3, 4, x, x)); break;
+        default: shapes.push_back(std::make_unique<NGon<float>>(5, 3, x, x)); break;
+        }
+        vertex_total += shapes.back()->vertexCount();
+    }
+
+    Tessellator<float, uint32_t> tessellator;
+    std::vector<Vector2<float>> vertices;
+    std::vector<uint32_t> indices;
+    runner.run("Tessellator::tessellate scene", [&](size_t iterations) {
+        for (size_t n = 0; n < iterations; n++) {
+            tessellator.tessellate(shapes, vertices, indices);
+            benchmark_keep(indices);
+        }
+    }, 1, vertex_total);
+
+    VectorArray2<float> lanes;
+    runner.run("Tessellator::tessellate scene lanes", [&](size_t iterations) {
+        for (size_t n = 0; n < iterations; n++) {
+            tessellator.tessellate(shapes, lanes, indices);
+            benchmark_keep(indices);
+        }
+    }, 1, vertex_total);
+
+    // A star with 128 points, so half of its vertices are reflex
+    std::vector<Vector2<float>> star(256);
+    for (size_t i = 0; i < star.size(); i++) {
+        float angle = 6.2831853f * static_cast<float>(i) / static_cast<float>(star.size());
+        float radius = (i & 1) ? 4.0f : 10.0f;
+        star[i] = Vector2<float>(radius * std::cos(angle), radius * std::sin(angle));
+    }
+
+    std::vector<Polygon<float>> polygons = { Polygon<float>(star) };
+    runner.run("Tessellator::tessellate star 256", [&](size_t iterations) {
+        for (size_t n = 0; n < iterations; n++) {
+            tessellator.tessellate(polygons, vertices, indices);
+            benchmark_keep(indices);
+        }
+    }, 1, star.size());
+}
+
+
+
+// Point queries over lanes of random sample points, for each of the analytic shapes
+void benchmark_point_queries(BenchmarkRunner& runner) {
+    constexpr size_t samples = 1 << 16;
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> coordinate(-20, 20);
+
+    VectorArray2<float> points(samples);
+    for (size_t i = 0; i < samples; i++)
+        points.set(i, Vector2<float>(coordinate(rng), coordinate(rng)));
+
+    std::vector<std::pair<std::string, std::unique_ptr<Shape2D<float>>>> shapes;
+    shapes.emplace_back("Circle", std::make_unique<Circle<float>>(8, 1, 2));
+    shapes.emplace_back("Rectangle", std::make_unique<Rectangle<float>>(12, 6, 1, 2, 30));
+    shapes.emplace_back("NGon 6", std::make_unique<NGon<float>>(6, 8, 1, 2, 30));
+
+    std::vector<uint64_t> mask(query_mask_words(samples));
+    std::vector<float> distances(samples);
+    for (auto &[name, shape]: shapes) {
+        runner.run(name + "::contains lanes", [&](size_t iterations) {
+            for (size_t n = 0; n < iterations; n++) {
+                shape->contains(points, mask);
+                benchmark_keep(mask);
+            }
+        }, 1, samples);
+
+        runner.run(name + "::signedDistance lanes", [&](size_t iterations) {
+            for (size_t n = 0; n < iterations; n++) {
+                shape->signedDistance(points, distances);
+                benchmark_keep(distances);
+            }
+        }, 1, samples);
+    }
+}
+
+
+
+
+
+// Rays are cast in fans from a few eyes, the way sensors and visibility queries cast them,
+// at a scene of mixed shapes, with and without a BVH
+void benchmark_raycasting(BenchmarkRunner& runner) {
+    constexpr size_t eyes = 16, rays_per_eye = 1024;
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> coordinate(0, 1000), size(2, 8), angle(0, 360);
+
+    std::vector<Ray2D<float>> rays;
+    for (size_t e = 0; e < eyes; e++) {
+        Vector2<float> eye(coordinate(rng), coordinate(rng));
+        for (size_t i = 0; i < rays_per_eye; i++) {
+            float radians = 2 * std::numbers::pi_v<float> * static_cast<float>(i) / rays_per_eye;
+            rays.push_back(Ray2D<float>(eye, Vector2<float>(std::cos(radians), std::sin(radians))));
+        }
+    }
+    std::vector<RayHit<float>> hits(rays.size());
+
+    for (size_t count : { 1000, 10000 }) {
+        std::vector<std::unique_ptr<Shape2D<float>>> owned;
+        for (size_t i = 0; i < count; i++) {
+            Vector2<float> position(coordinate(rng), coordinate(rng));
+            if (i % 3 == 0)
+                owned.push_back(std::make_unique<Circle<float>>(size(rng), position));
+            else if (i % 3 == 1)
+                owned.push_back(std::make_unique<Rectangle<float>>(size(rng), size(rng), position, angle(rng)));
+            else
+                owned.push_back(std::make_unique<NGon<float>>(6, size(rng), position, angle(rng)));
+        }
+
+        std::vector<Shape2D<float>*> scene;
+        for (auto &shape: owned)
+            scene.push_back(shape.get());
+
+        BVH<float> bvh;
+        bvh.build(scene);
+        RayCaster<float> caster;
+        std::string suffix = " " + std::to_string(count) + " shapes";
+
+        runner.run("RayCaster::cast sweep" + suffix, [&](size_t iterations) {
+            for (size_t n = 0; n < iterations; n++) {
+                caster.cast(scene, rays, hits);
+                benchmark_keep(hits);
+            }
+        }, 1, rays.size());
+
+        runner.run("RayCaster::cast BVH" + suffix, [&](size_t iterations) {
+            for (size_t n = 0; n < iterations; n++) {
+                caster.cast(scene, bvh, rays, hits);
+                benchmark_keep(hits);
+            }
+        }, 1, rays.size());
+    }
+}
+
+
+
+
+// A 4096 x 4096 grid of mixed shapes a few cells across, drawn as bit-packed and 8-bit occupancy, and as coverage
+void benchmark_rasterization(BenchmarkRunner& runner) {
+    constexpr size_t count = 100000;
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> coordinate(0, 1024), size(0.5f, 4), angle(0, 360);
+
+    std::vector<std::unique_ptr<Shape2D<float>>> owned;
+    for (size_t i = 0; i < count; i++) {
+        Vector2<float> position(coordinate(rng), coordinate(rng));
+        if (i % 3 == 0)
+            owned.push_back(std::make_unique<Circle<float>>(size(rng), position));
+        else if (i % 3 == 1)
+            owned.push_back(std::make_unique<Rectangle<float>>(size(rng), size(rng), position, angle(rng)));
+        else
+            owned.push_back(std::make_unique<NGon<float>>(6, size(rng), position, angle(rng)));
+    }
+
+    std::vector<Shape2D<float>*> scene;
+    for (auto &shape: owned)
+        scene.push_back(shape.get());
+
+    RasterGrid<float> grid { Vector2<float>(0, 0), 0.25f, 4096, 4096 };
+    std::vector<uint64_t> bits(grid.wordCount());
+    std::vector<uint8_t> cells(grid.cellCount());
+    Rasterizer<float> rasterizer;
+    Executor executor;
+
+    runner.run("Rasterizer::rasterize bits", [&](size_t iterations) {
+        for (size_t n = 0; n < iterations; n++) {
+            rasterizer.rasterize(scene, grid, bits);
+            benchmark_keep(bits);
+        }
+    }, 1, count);
+
+    runner.run("Rasterizer::rasterize bits, executor", [&](size_t iterations) {
+        for (size_t n = 0; n < iterations; n++) {
+            rasterizer.rasterize(scene, grid, bits, executor);
+            benchmark_keep(bits);
+        }
+    }, 1, count);
+
+    runner.run("Rasterizer::rasterize occupancy, executor", [&](size_t iterations) {
+        for (size_t n = 0; n < iterations; n++) {
+            rasterizer.rasterize(scene, grid, cells, executor);
+            benchmark_keep(cells);
+        }
+    }, 1, count);
+
+    runner.run("Rasterizer::rasterize coverage, executor", [&](size_t iterations) {
+        for (size_t n = 0; n < iterations; n++) {
+            rasterizer.rasterize(scene, grid, cells, executor, RasterMode::Coverage);
+            benchmark_keep(cells);
+        }
+    }, 1, count);
+
+    // One wavy polygon of 100k vertices across most of the grid, drawn from its edge table
+    constexpr size_t vertices = 100000;
+    std::vector<Vector2<float>> outline(vertices);
+    for (size_t i = 0; i < vertices; i++) {
+        float angle = static_cast<float>(i) * 2 * std::numbers::pi_v<float> / vertices;
+        float radius = 400 + (100 * std::sin(angle * 37));
+        outline[i] = Vector2<float>(radius * std::cos(angle), radius * std::sin(angle));
+    }
+    Polygon<float> polygon(outline, Vector2<float>(512, 512));
+    std::vector<Shape2D<float>*> large = { &polygon };
+
+    runner.run("Rasterizer::rasterize polygon, executor", [&](size_t iterations) {
+        for (size_t n = 0; n < iterations; n++) {
+            rasterizer.rasterize(large, grid, cells, executor);
+            benchmark_keep(cells);
+        }
+    }, 1, vertices);
+
+    runner.run("Rasterizer::rasterize polygon coverage, executor", [&](size_t iterations) {
+        for (size_t n = 0; n < iterations; n++) {
+            rasterizer.rasterize(large, grid, cells, executor, RasterMode::Coverage);
+            benchmark_keep(cells);
+        }
+    }, 1, vertices);
+}
+
+
+
+
+
+// Cost of the instrumentation hooks, which compile to nothing unless SHAPES_INSTRUMENTATION is defined,
+// and a frame of mixed shape work whose counters are reported when it is
+void benchmark_instrumentation(BenchmarkRunner& runner) {
+    runner.run("INSTRUMENT_COUNT", [&](size_t iterations) {
+        for (size_t n = 0; n < iterations; n++)
+            INSTRUMENT_COUNT(TransformCalls, 1);
+    });
+
+    runner.run("instrument_snapshot", [&](size_t iterations) {
+        for (size_t n = 0; n < iterations; n++)
+            benchmark_keep(instrument_snapshot());
+    });
+
+    std::vector<Circle<float>> circles;
+    std::vector<Rectangle<float>> rectangles;
+    std::vector<NGon<float>> ngons;
+    for (size_t i = 0; i < batch_size / 3; i++) {
+        float x = static_cast<float>(i);
+        circles.emplace_back(5, x, x);
+        rectangles.emplace_back(3, 4, x, x);
+        ngons.emplace_back(5, 3, x, x);
+    }
+
+    std::vector<Shape2D<float>*> shapes;
+    for (size_t i = 0; i < circles.size(); i++) {
+        shapes.push_back(&circles[i]);
+        shapes.push_back(&rectangles[i]);
+        shapes.push_back(&ngons[i]);
+    }
+
+    // Moves and rotates every shape, lists its vertices and serializes every 16th shape of each type
+    std::vector<Vector2<float>> vertices;
+    std::string out;
+    auto frame = [&](size_t n) {
+        float step = (n & 1) ? 1.0f : -1.0f;
+        for (Shape2D<float>* shape: shapes) {
+            shape->move(step, step);
+            shape->rotateFrom(step, 0, 0);
+            shape->vertices(vertices);
+        }
+        for (size_t i = 0; i < circles.size(); i += 16) {
+            out.clear();
+            circles[i].json(out);
+            rectangles[i].json(out);
+            ngons[i].json(out);
+        }
+        benchmark_keep(vertices);
+        benchmark_keep(out);
+    };
+
+    const std::string name = "instrumented frame";
+    runner.run(name, [&](size_t iterations) {
+        for (size_t n = 0; n < iterations; n++)
+            frame(n);
+    }, 1, shapes.size());
+
+#if defined(SHAPES_INSTRUMENTATION)
+    if (runner.filter.empty() || name.find(runner.filter) != std::string::npos) {
+        instrument_reset();
+        frame(0);
+        std::fprintf(stderr, "%s: %s\n", name.c_str(), instrument_snapshot().str().c_str());
+    }
+#endif
+}
+
+
+
+
+
+int main(int argc, char** argv) {
+    BenchmarkRunner runner(argc, argv);
+
+    benchmark_vector_types<2>(runner);
+    benchmark_vector_types<3>(runner);
+    benchmark_vector_types<4>(runner);
+
+    benchmark_rotation(runner);
+    benchmark_vertices(runner);
+    benchmark_serializers(runner);
+    benchmark_dispatch(runner);
+    benchmark_spatial(runner);
+    benchmark_collision(runner);
+    benchmark_polygons(runner);
+    benchmark_tessellation(runner);
+    benchmark_point_queries(runner);
+    benchmark_raycasting(runner);
+    benchmark_rasterization(runner);
+    benchmark_instrumentation(runner);
+
+    return runner.finish();
+}
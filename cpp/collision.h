@@ -0,0 +1,890 @@
+/// Author: PlumpDolphin
+/// Date: October 16, 2026
+///
+/// Description:
+///     Provides exact intersection tests between Circles, Rectangles and N-Gons, and a multithreaded
+///     collision pipeline built on them. Every test works from the analytic shape data (radius, size, N
+///     and rotation), and reports the penetration depth and normal along with the intersection itself.
+///
+///     The pipeline finds candidate pairs with a sort-and-sweep broadphase along the axis where shapes are
+///     most spread out, within strips a few shapes wide across it, then runs the exact tests in parallel
+///     on a thread pool kept by the pipeline. Every floating-point sum the broadphase decides on is taken over
+///     fixed blocks of shapes in a fixed order, so the contacts, and their order, are always the same
+///     regardless of the number of threads.
+///
+/// License:
+///     The code in this file is licensed under the
+///     Revised 3-Clause BSD License.
+///     For details, see https://opensource.org/licenses/BSD-3-Clause
+
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include "shapes.h"     // Includes definitions for the shapes being tested.
+#include "shapebatch.h" // Includes definitions for the shape batches accepted by the pipeline.
+#include "executor.h"   // Includes definition for Executor, the persistent team running every phase.
+
+
+
+// Example usage showing single tests and the collision pipeline.
+/*
+    Circle<float> c(2, 0, 0);
+    Rectangle<float> r(4, 2, Vector2<float>(3, 0), 45);
+
+    // Test a single pair of shapes
+    Contact2D<float> contact;
+    if (collide(c, r, contact))
+        std::cout << contact.depth << " along " << contact.normal.str() << std::endl;
+
+    // Find every contact in a scene, once per physics step
+    CollisionPipeline<float> pipeline;
+
+    pipeline.clear();
+    pipeline.add(circleBatch);  // Shapes are numbered in the order they are added,
+    pipeline.add(ngonBatch);    // so batches take up consecutive ids
+    pipeline.add(r);
+
+    for (const Contact2D<float>& contact: pipeline.detect())
+        resolve(contact.a, contact.b, contact.normal, contact.depth);
+*/
+
+
+
+
+
+// Kind of shape described by a collider.
+// Pairs are always tested with the lower kind first.
+enum class ColliderType : uint8_t {
+    Circle,
+    Rectangle,
+    NGon,
+};
+
+
+
+// A contact between two intersecting shapes
+template <typename R>
+struct Contact2D {
+    uint32_t a = 0;    // Id of the first shape
+    uint32_t b = 0;    // Id of the second shape
+    Vector2<R> normal; // Unit normal pointing from a towards b
+    R depth = 0;       // Distance b must move along the normal to separate the shapes
+};
+
+
+
+// Analytic description of a shape used for collision tests.
+// Fill in the shape data and call prepare(), or use make_collider().
+template <typename R>
+struct Collider2D {
+    // Shape data
+    ColliderType type = ColliderType::Circle;
+    uint32_t N = 0;    // Number of N-Gon vertices
+    uint32_t id = 0;   // Id reported in contacts
+    Vector2<R> center;
+    Vector2<R> half;   // Half of a Rectangle's size
+    R radius = 0;      // Circle radius or N-Gon circumradius
+    Angle rotation = 0;
+
+    // Derived by prepare()
+    Vector2<R> axis_x;  // Local x and y axes, rotated into place
+    Vector2<R> axis_y;  // For N-Gons, axis_y is also the direction of the first vertex
+    Vector2<R> normal;  // Outward normal of the first N-Gon edge
+    Vector2<R> step;    // Cosine and sine of the angle between N-Gon vertices
+    Bounds2D<R> bounds;
+
+    // N-Gons with more vertices than this find their extents from angles rather than by visiting every vertex
+    static constexpr uint32_t scan_limit = 32;
+
+
+
+    // Computes the rotated axes and bounds. Must be called after the shape data changes.
+    void prepare() {
+        R radians = to_radians<R>(rotation);
+        R c = rotation == 0 ? 1 : std::cos(radians);
+        R s = rotation == 0 ? 0 : std::sin(radians);
+
+        // A negative radius places every vertex opposite the center, the same as a half turn
+        if (radius < 0) {
+            radius = -radius;
+            c = -c;
+            s = -s;
+        }
+
+        axis_x = Vector2<R>(c, s);
+        axis_y = Vector2<R>(-s, c);
+
+        switch (type) {
+        case ColliderType::Circle:
+            bounds = Bounds2D<R>(Vector2<R>(center.x - radius, center.y - radius),
+                                 Vector2<R>(center.x + radius, center.y + radius));
+            break;
+
+        case ColliderType::Rectangle: {
+            half = Vector2<R>(std::abs(half.x), std::abs(half.y));
+            R ex = (half.x * std::abs(c)) + (half.y * std::abs(s));
+            R ey = (half.x * std::abs(s)) + (half.y * std::abs(c));
+            bounds = Bounds2D<R>(Vector2<R>(center.x - ex, center.y - ey), Vector2<R>(center.x + ex, center.y + ey));
+            break;
+        }
+
+        case ColliderType::NGon: {
+            if (N < 3) {
+                // Degenerate N-Gons have no area, and never collide
+                bounds = Bounds2D<R>(center, center);
+                break;
+            }
+
+            // Half of the angle between vertices gives both the edge normal and the step between vertices
+            R half_angle = static_cast<R>(M_PI) / static_cast<R>(N);
+            R hs = std::sin(half_angle);
+            R hc = std::cos(half_angle);
+            step = Vector2<R>((hc * hc) - (hs * hs), 2 * hs * hc);
+            normal = Vector2<R>((hs * c) - (hc * s), (hs * s) + (hc * c));
+
+            R min_x, max_x, min_y, max_y;
+            extent(Vector2<R>(1, 0), min_x, max_x);
+            extent(Vector2<R>(0, 1), min_y, max_y);
+            bounds = Bounds2D<R>(Vector2<R>(center.x + min_x, center.y + min_y),
+                                 Vector2<R>(center.x + max_x, center.y + max_y));
+            break;
+        }
+        }
+    }
+
+
+
+    // Finds the interval covered by the shape along a unit axis, relative to its center
+    void extent(Vector2<R> axis, R& low, R& high) const {
+        switch (type) {
+        case ColliderType::Circle:
+            low = -radius;
+            high = radius;
+            return;
+
+        case ColliderType::Rectangle: {
+            R e = (half.x * std::abs((axis.x * axis_x.x) + (axis.y * axis_x.y)))
+                + (half.y * std::abs((axis.x * axis_y.x) + (axis.y * axis_y.y)));
+            low = -e;
+            high = e;
+            return;
+        }
+
+        case ColliderType::NGon:
+            if (N <= scan_limit) {
+                // Walk the vertices by repeatedly rotating the first one
+                Vector2<R> v = axis_y;
+                R d = (v.x * axis.x) + (v.y * axis.y);
+                R lo = d, hi = d;
+                for (uint32_t i = 1; i < N; i++) {
+                    v = _next_vertex(v);
+                    d = (v.x * axis.x) + (v.y * axis.y);
+                    lo = d < lo ? d : lo;
+                    hi = d > hi ? d : hi;
+                }
+                low = lo * radius;
+                high = hi * radius;
+            } else {
+                // The furthest vertex along a direction is the one closest to it in angle
+                high = radius * _nearest_cosine(axis);
+                low = -radius * _nearest_cosine(Vector2<R>(-axis.x, -axis.y));
+            }
+            return;
+        }
+    }
+
+    // Returns the N-Gon vertex closest to a point
+    Vector2<R> closestVertex(Vector2<R> point) const {
+        R px = point.x - center.x;
+        R py = point.y - center.y;
+        Vector2<R> best = axis_y;
+
+        if (N <= scan_limit) {
+            // The closest vertex is the one furthest along the direction of the point
+            R best_d = (best.x * px) + (best.y * py);
+            Vector2<R> v = axis_y;
+            for (uint32_t i = 1; i < N; i++) {
+                v = _next_vertex(v);
+                R d = (v.x * px) + (v.y * py);
+                if (d > best_d) {
+                    best_d = d;
+                    best = v;
+                }
+            }
+        } else {
+            // Vertex i is i steps clockwise from local (0, 1)
+            R local_x = (px * axis_x.x) + (py * axis_x.y);
+            R local_y = (px * axis_y.x) + (py * axis_y.y);
+            R segment = static_cast<R>(2 * M_PI) / static_cast<R>(N);
+            R angle = std::round(std::atan2(local_x, local_y) / segment) * segment;
+
+            R lx = std::sin(angle);
+            R ly = std::cos(angle);
+            best = Vector2<R>((lx * axis_x.x) + (ly * axis_y.x), (lx * axis_x.y) + (ly * axis_y.y));
+        }
+
+        return Vector2<R>(center.x + (best.x * radius), center.y + (best.y * radius));
+    }
+
+    // Returns the normal of the N-Gon edge following a given one
+    Vector2<R> nextNormal(Vector2<R> n) const { return _next_vertex(n); }
+
+
+
+private:
+    // Rotates a direction clockwise by one vertex, the same order as NGon::vertices
+    Vector2<R> _next_vertex(Vector2<R> v) const {
+        return Vector2<R>((v.x * step.x) + (v.y * step.y), (v.y * step.x) - (v.x * step.y));
+    }
+
+    // Cosine of the angle between a unit direction and the nearest vertex direction
+    R _nearest_cosine(Vector2<R> axis) const {
+        R local_x = (axis.x * axis_x.x) + (axis.y * axis_x.y);
+        R local_y = (axis.x * axis_y.x) + (axis.y * axis_y.y);
+        R segment = static_cast<R>(2 * M_PI) / static_cast<R>(N);
+        R t = std::atan2(local_x, local_y) / segment;
+        return std::cos((t - std::round(t)) * segment);
+    }
+};
+
+
+
+
+
+// Collider construction
+// Each shape's data is converted to the floating-point type used by UnitCircleCache.
+// Shapes with a pending transform are read through a flushed copy.
+
+template <typename T>
+Collider2D<typename UnitCircleCache<T>::Real> make_collider(const Circle<T>& circle, uint32_t id = 0) {
+    using R = typename UnitCircleCache<T>::Real;
+    if (circle.hasPendingTransform())
+        return make_collider(flushed(circle), id);
+
+    Collider2D<R> c;
+    c.type = ColliderType::Circle;
+    c.id = id;
+    c.center = Vector2<R>(static_cast<R>(circle.position.x), static_cast<R>(circle.position.y));
+    c.radius = static_cast<R>(circle.radius);
+    c.prepare();
+    return c;
+}
+
+template <typename T>
+Collider2D<typename UnitCircleCache<T>::Real> make_collider(const Rectangle<T>& rectangle, uint32_t id = 0) {
+    using R = typename UnitCircleCache<T>::Real;
+    if (rectangle.hasPendingTransform())
+        return make_collider(flushed(rectangle), id);
+
+    Collider2D<R> c;
+    c.type = ColliderType::Rectangle;
+    c.id = id;
+    c.center = Vector2<R>(static_cast<R>(rectangle.position.x), static_cast<R>(rectangle.position.y));
+    c.half = Vector2<R>(static_cast<R>(rectangle.size.x) / 2, static_cast<R>(rectangle.size.y) / 2);
+    c.rotation = rectangle.rotation;
+    c.prepare();
+    return c;
+}
+
+template <typename T>
+Collider2D<typename UnitCircleCache<T>::Real> make_collider(const NGon<T>& ngon, uint32_t id = 0) {
+    using R = typename UnitCircleCache<T>::Real;
+    if (ngon.hasPendingTransform())
+        return make_collider(flushed(ngon), id);
+
+    Collider2D<R> c;
+    c.type = ColliderType::NGon;
+    c.id = id;
+    c.N = static_cast<uint32_t>(ngon.N);
+    c.center = Vector2<R>(static_cast<R>(ngon.position.x), static_cast<R>(ngon.position.y));
+    c.radius = static_cast<R>(ngon.radius);
+    c.rotation = ngon.rotation;
+    c.prepare();
+    return c;
+}
+
+
+
+
+
+// Pairwise tests
+// Each returns true if the shapes overlap, and fills in the contact. Shapes that only touch don't overlap.
+
+template <typename R>
+bool collide_circles(const Collider2D<R>& a, const Collider2D<R>& b, Contact2D<R>& contact) {
+    R dx = b.center.x - a.center.x;
+    R dy = b.center.y - a.center.y;
+    R reach = a.radius + b.radius;
+
+    R distance_sq = (dx * dx) + (dy * dy);
+    if (!(distance_sq < reach * reach))
+        return false;
+
+    // Circles with the same center are pushed apart along x
+    R distance = std::sqrt(distance_sq);
+    contact.normal = distance > 0 ? Vector2<R>(dx / distance, dy / distance) : Vector2<R>(1, 0);
+    contact.depth = reach - distance;
+    return true;
+}
+
+// Tests a circle against a rectangle by finding the closest point of the rectangle in its local space
+template <typename R>
+bool collide_circle_rectangle(const Collider2D<R>& circle, const Collider2D<R>& rectangle, Contact2D<R>& contact) {
+    R px = circle.center.x - rectangle.center.x;
+    R py = circle.center.y - rectangle.center.y;
+    R lx = (px * rectangle.axis_x.x) + (py * rectangle.axis_x.y);
+    R ly = (px * rectangle.axis_y.x) + (py * rectangle.axis_y.y);
+
+    R cx = std::clamp(lx, -rectangle.half.x, rectangle.half.x);
+    R cy = std::clamp(ly, -rectangle.half.y, rectangle.half.y);
+
+    // Normal in the rectangle's local space, pointing from the rectangle to the circle
+    R nx, ny;
+
+    if (cx != lx || cy != ly) {
+        // The center is outside, so the closest point is on the boundary
+        R dx = lx - cx;
+        R dy = ly - cy;
+        R distance_sq = (dx * dx) + (dy * dy);
+        if (!(distance_sq < circle.radius * circle.radius))
+            return false;
+
+        R distance = std::sqrt(distance_sq);
+        nx = dx / distance;
+        ny = dy / distance;
+        contact.depth = circle.radius - distance;
+    } else {
+        // The center is inside, so push out through the nearest side
+        R gap_x = rectangle.half.x - std::abs(lx);
+        R gap_y = rectangle.half.y - std::abs(ly);
+        if (gap_x <= gap_y) {
+            nx = lx < 0 ? -1 : 1;
+            ny = 0;
+            contact.depth = circle.radius + gap_x;
+        } else {
+            nx = 0;
+            ny = ly < 0 ? -1 : 1;
+            contact.depth = circle.radius + gap_y;
+        }
+    }
+
+    // Rotate into world space, and flip to point from the circle to the rectangle
+    contact.normal = Vector2<R>(-((nx * rectangle.axis_x.x) + (ny * rectangle.axis_y.x)),
+                                -((nx * rectangle.axis_x.y) + (ny * rectangle.axis_y.y)));
+    return true;
+}
+
+
+
+// Separating axis state, tracking the axis of least penetration
+template <typename R>
+struct _SeparatingAxes {
+    R depth = std::numeric_limits<R>::infinity();
+    Vector2<R> normal;
+
+    // Projects both shapes onto the axis. Returns false if the axis separates them.
+    bool test(const Collider2D<R>& a, const Collider2D<R>& b, Vector2<R> axis) {
+        R a_low, a_high, b_low, b_high;
+        a.extent(axis, a_low, a_high);
+        b.extent(axis, b_low, b_high);
+
+        R offset = ((b.center.x - a.center.x) * axis.x) + ((b.center.y - a.center.y) * axis.y);
+        R forward = a_high - (offset + b_low);  // Distance to push b along the axis
+        R backward = (offset + b_high) - a_low; // Distance to push b against the axis
+
+        if (!(forward > 0 && backward > 0))
+            return false;
+
+        if (forward < depth) {
+            depth = forward;
+            normal = axis;
+        }
+        if (backward < depth) {
+            depth = backward;
+            normal = Vector2<R>(-axis.x, -axis.y);
+        }
+        return true;
+    }
+
+    // Tests every edge normal of a Rectangle or N-Gon
+    bool testEdges(const Collider2D<R>& a, const Collider2D<R>& b, const Collider2D<R>& edges) {
+        if (edges.type == ColliderType::Rectangle)
+            return test(a, b, edges.axis_x) && test(a, b, edges.axis_y);
+
+        // Opposite edges of an even N-Gon share an axis
+        uint32_t count = edges.N % 2 == 0 ? edges.N / 2 : edges.N;
+        Vector2<R> n = edges.normal;
+        for (uint32_t i = 0; i < count; i++, n = edges.nextNormal(n))
+            if (!test(a, b, n))
+                return false;
+        return true;
+    }
+};
+
+// Tests two convex shapes with the separating axis theorem, using the edge normals of both.
+// When one is a circle, the axis through its closest vertex is used in place of its edges.
+template <typename R>
+bool collide_sat(const Collider2D<R>& a, const Collider2D<R>& b, Contact2D<R>& contact) {
+    _SeparatingAxes<R> axes;
+
+    if (a.type == ColliderType::Circle) {
+        Vector2<R> vertex = b.closestVertex(a.center);
+        R dx = a.center.x - vertex.x;
+        R dy = a.center.y - vertex.y;
+        R length = std::sqrt((dx * dx) + (dy * dy));
+        if (length > 0 && !axes.test(a, b, Vector2<R>(dx / length, dy / length)))
+            return false;
+    } else if (!axes.testEdges(a, b, a)) {
+        return false;
+    }
+
+    if (!axes.testEdges(a, b, b))
+        return false;
+
+    contact.normal = axes.normal;
+    contact.depth = axes.depth;
+    return true;
+}
+
+
+
+// Tests any two colliders, picking the matching test for their types
+template <typename R>
+bool collide(const Collider2D<R>& a, const Collider2D<R>& b, Contact2D<R>& contact) {
+    // Degenerate N-Gons have no area
+    if ((a.type == ColliderType::NGon && a.N < 3) || (b.type == ColliderType::NGon && b.N < 3))
+        return false;
+
+    // Test with the lower type first, and flip the normal back
+    if (a.type > b.type) {
+        bool hit = collide(b, a, contact);
+        contact.normal = Vector2<R>(-contact.normal.x, -contact.normal.y);
+        contact.a = a.id;
+        contact.b = b.id;
+        return hit;
+    }
+
+    contact.a = a.id;
+    contact.b = b.id;
+
+    if (a.type == ColliderType::Circle && b.type == ColliderType::Circle)
+        return collide_circles(a, b, contact);
+    if (a.type == ColliderType::Circle && b.type == ColliderType::Rectangle)
+        return collide_circle_rectangle(a, b, contact);
+    return collide_sat(a, b, contact);
+}
+
+// Tests any two shapes
+template <typename T, template <typename> class A, template <typename> class B>
+bool collide(const A<T>& a, const B<T>& b, Contact2D<typename UnitCircleCache<T>::Real>& contact) {
+    return collide(make_collider(a, 0), make_collider(b, 1), contact);
+}
+
+template <typename T, template <typename> class A, template <typename> class B>
+bool intersects(const A<T>& a, const B<T>& b) {
+    Contact2D<typename UnitCircleCache<T>::Real> contact;
+    return collide(a, b, contact);
+}
+
+
+
+
+
+// Finds every contact between a set of shapes.
+// Shapes are copied in with add(), and numbered in the order they were added.
+// A pipeline keeps its buffers between steps, so clearing and refilling it every step doesn't reallocate.
+template <typename T>
+class CollisionPipeline {
+public:
+    using Real = typename UnitCircleCache<T>::Real;
+
+    // Scenes are split into at most this many tasks per thread for each phase, and tasks get at least
+    // min_shapes_per_task shapes, so small scenes are handled by fewer threads
+    static constexpr size_t tasks_per_thread = 4;
+    static constexpr size_t min_shapes_per_task = 4096;
+
+    // The spread and size of the shapes are summed in blocks of this many shapes, and the blocks are combined
+    // in order, so the sweep axis and strips, and with them the contacts, don't depend on the number of threads
+    static constexpr size_t sum_block = 1024;
+
+    // Most strips the scene is split into along the axis across the sweep
+    static constexpr size_t max_strips = 4096;
+
+    // Number of sorted entries swept by each narrowphase task
+    static constexpr size_t sweep_chunk = 256;
+
+
+
+    // Uses every hardware thread when the thread count is 0.
+    // The threads are started once and kept by the pipeline, so detecting contacts every step doesn't start any.
+    explicit CollisionPipeline(size_t threads = 0) { setThreads(threads); }
+
+    void setThreads(size_t count) {
+        if (executor == nullptr || count != requested) {
+            executor.reset();
+            executor = std::make_unique<Executor>(count);
+            requested = count;
+        }
+    }
+
+    size_t threadCount() const { return executor->threadCount(); }
+
+
+
+    // Shape management
+    void clear() { colliders.clear(); }
+    void reserve(size_t count) { colliders.reserve(count); }
+    size_t size() const { return colliders.size(); }
+
+    // Each add returns the id of the (first) added shape. Shapes with a pending transform are added flushed.
+    uint32_t add(const Circle<T>& circle) {
+        if (circle.hasPendingTransform())
+            return add(flushed(circle));
+        return _push(ColliderType::Circle, 0, circle.position.x, circle.position.y, circle.radius, 0, 0, 0);
+    }
+
+    uint32_t add(const Rectangle<T>& rectangle) {
+        if (rectangle.hasPendingTransform())
+            return add(flushed(rectangle));
+        return _push(ColliderType::Rectangle, 0, rectangle.position.x, rectangle.position.y, 0,
+                     rectangle.size.x, rectangle.size.y, rectangle.rotation);
+    }
+
+    uint32_t add(const NGon<T>& ngon) {
+        if (ngon.hasPendingTransform())
+            return add(flushed(ngon));
+        return _push(ColliderType::NGon, ngon.N, ngon.position.x, ngon.position.y, ngon.radius, 0, 0, ngon.rotation);
+    }
+
+    uint32_t add(const CircleBatch<T>& batch) {
+        uint32_t first = static_cast<uint32_t>(colliders.size());
+        colliders.reserve(colliders.size() + batch.count());
+        for (size_t i = 0; i < batch.count(); i++)
+            _push(ColliderType::Circle, 0, batch.position.x[i], batch.position.y[i], batch.radius[i], 0, 0, 0);
+        return first;
+    }
+
+    uint32_t add(const RectangleBatch<T>& batch) {
+        uint32_t first = static_cast<uint32_t>(colliders.size());
+        colliders.reserve(colliders.size() + batch.count());
+        for (size_t i = 0; i < batch.count(); i++)
+            _push(ColliderType::Rectangle, 0, batch.position.x[i], batch.position.y[i], 0,
+                  batch.size.x[i], batch.size.y[i], batch.rotation[i]);
+        return first;
+    }
+
+    uint32_t add(const NGonBatch<T>& batch) {
+        uint32_t first = static_cast<uint32_t>(colliders.size());
+        colliders.reserve(colliders.size() + batch.count());
+        for (size_t i = 0; i < batch.count(); i++)
+            _push(ColliderType::NGon, batch.N[i], batch.position.x[i], batch.position.y[i], batch.radius[i],
+                  0, 0, batch.rotation[i]);
+        return first;
+    }
+
+
+
+
+
+
+    // Finds every overlapping pair of shapes.
+    // Contacts are ordered by the sweep, with the lower id of each pair first as `a`.
+    const std::vector<Contact2D<Real>>& detect() {
+        result.clear();
+        candidates = 0;
+
+        size_t n = colliders.size();
+        if (n < 2)
+            return result;
+
+        // Tasks cover whole blocks, so every block is summed the same way by whichever thread runs it
+        block_count = (n + sum_block - 1) / sum_block;
+        size_t most_tasks = std::max<size_t>(1, n / min_shapes_per_task);
+        task_count = std::min({ block_count, executor->threadCount() * tasks_per_thread, most_tasks });
+        blocks.assign(block_count, Partial());
+
+        auto each_task = [&](auto&& f) {
+            executor->run(0, task_count, [&](size_t begin, size_t end) {
+                for (size_t t = begin; t < end; t++)
+                    f(t, _task_begin(t), _task_begin(t + 1));
+            }, 1);
+        };
+
+        // Prepare the colliders and gather the spread and size of their bounds, block by block
+        each_task([&](size_t, size_t begin, size_t end) {
+            for (size_t block = begin / sum_block; block * sum_block < end; block++)
+                _prepare_block(block);
+        });
+        _choose_strips();
+
+        // Count how many shapes each task places in each strip
+        histogram.assign(task_count * strip_count, 0);
+        each_task([&](size_t t, size_t begin, size_t end) {
+            uint32_t* counts = histogram.data() + (t * strip_count);
+            for (size_t i = begin; i < end; i++) {
+                const Bounds2D<Real>& box = colliders[i].bounds;
+                size_t last = _strip_of(_axis_max(box, cross));
+                for (size_t s = _strip_of(_axis_min(box, cross)); s <= last; s++)
+                    counts[s]++;
+            }
+        });
+
+        // Turn the counts into the offset each task writes its first entry of a strip to,
+        // after those of earlier tasks, so every strip lists its shapes in id order
+        strip_start.assign(strip_count + 1, 0);
+        size_t offset = 0;
+        for (size_t s = 0; s < strip_count; s++) {
+            strip_start[s] = offset;
+            for (size_t t = 0; t < task_count; t++) {
+                uint32_t count = histogram[(t * strip_count) + s];
+                histogram[(t * strip_count) + s] = static_cast<uint32_t>(offset);
+                offset += count;
+            }
+        }
+        strip_start[strip_count] = offset;
+        entries.resize(offset);
+
+        each_task([&](size_t t, size_t begin, size_t end) {
+            _place(histogram.data() + (t * strip_count), begin, end);
+        });
+
+        // Sort every strip, then sweep the sorted entries in fixed chunks
+        parallel_for(*executor, 0, strip_count, [&](size_t begin, size_t end) {
+            for (size_t s = begin; s < end; s++)
+                std::sort(entries.data() + strip_start[s], entries.data() + strip_start[s + 1]);
+        });
+
+        chunk_count = (offset + sweep_chunk - 1) / sweep_chunk;
+        if (chunk_contacts.size() < chunk_count)
+            chunk_contacts.resize(chunk_count);
+        chunk_candidates.assign(chunk_count, 0);
+
+        parallel_for(*executor, 0, chunk_count, [&](size_t begin, size_t end) {
+            for (size_t chunk = begin; chunk < end; chunk++)
+                _sweep(chunk);
+        });
+
+        // Gather the contacts in sweep order
+        size_t total = 0;
+        for (size_t c = 0; c < chunk_count; c++) {
+            total += chunk_contacts[c].size();
+            candidates += chunk_candidates[c];
+        }
+        result.reserve(total);
+        for (size_t c = 0; c < chunk_count; c++)
+            result.insert(result.end(), chunk_contacts[c].begin(), chunk_contacts[c].end());
+
+        return result;
+    }
+
+    // Contacts found by the last detect()
+    const std::vector<Contact2D<Real>>& contacts() const { return result; }
+
+    // Number of pairs that passed the broadphase in the last detect()
+    size_t candidatePairs() const { return candidates; }
+
+
+
+private:
+    // A shape's bounds within one strip, sorted by the start of its interval along the sweep axis
+    struct Entry {
+        Real min, max;             // Interval along the sweep axis
+        Real cross_min, cross_max; // Interval along the other axis
+        uint32_t index;            // Id of the shape
+        uint32_t first;            // First strip the shape is in
+
+        bool operator<(const Entry& other) const {
+            return min < other.min || (min == other.min && index < other.index);
+        }
+    };
+
+    // Sums over one block of shapes
+    struct Partial {
+        double sum[2] = { 0, 0 };
+        double sum_sq[2] = { 0, 0 };
+        double extent[2] = { 0, 0 };
+        size_t finite = 0;
+        Real low[2] = { std::numeric_limits<Real>::infinity(), std::numeric_limits<Real>::infinity() };
+        Real high[2] = { -std::numeric_limits<Real>::infinity(), -std::numeric_limits<Real>::infinity() };
+    };
+
+    std::unique_ptr<Executor> executor;
+    size_t requested = 0;
+
+    size_t block_count = 0;
+    size_t task_count = 0;
+    size_t chunk_count = 0;
+    size_t candidates = 0;
+
+    // Sweep axis and strips, chosen from the sums of every block
+    int axis = 0;
+    int cross = 1;
+    size_t strip_count = 1;
+    Real strip_low = 0;
+    Real strip_scale = 0;
+
+    std::vector<Collider2D<Real>> colliders;
+    std::vector<Partial> blocks;
+    std::vector<Entry> entries;         // Entries of every strip, one strip after another
+    std::vector<size_t> strip_start;
+    std::vector<uint32_t> histogram;    // Strip sizes counted by each task, then where it writes them
+
+    std::vector<std::vector<Contact2D<Real>>> chunk_contacts;
+    std::vector<size_t> chunk_candidates;
+    std::vector<Contact2D<Real>> result;
+
+    uint32_t _push(ColliderType type, size_t N, T x, T y, T radius, T width, T height, Angle rotation) {
+        Collider2D<Real> c;
+        c.type = type;
+        c.N = static_cast<uint32_t>(N);
+        c.id = static_cast<uint32_t>(colliders.size());
+        c.center = Vector2<Real>(static_cast<Real>(x), static_cast<Real>(y));
+        c.radius = static_cast<Real>(radius);
+        c.half = Vector2<Real>(static_cast<Real>(width) / 2, static_cast<Real>(height) / 2);
+        c.rotation = rotation;
+        colliders.push_back(c);
+        return c.id;
+    }
+
+    static Real _axis_min(const Bounds2D<Real>& box, int axis) { return axis == 0 ? box.min.x : box.min.y; }
+    static Real _axis_max(const Bounds2D<Real>& box, int axis) { return axis == 0 ? box.max.x : box.max.y; }
+
+    // First shape of a task, always at the start of a block
+    size_t _task_begin(size_t t) const {
+        return std::min(((block_count * t) / task_count) * sum_block, colliders.size());
+    }
+
+    void _prepare_block(size_t block) {
+        Partial& partial = blocks[block];
+        size_t end = std::min((block + 1) * sum_block, colliders.size());
+
+        for (size_t i = block * sum_block; i < end; i++) {
+            Collider2D<Real>& c = colliders[i];
+            c.prepare();
+
+            double width = c.bounds.max.x - c.bounds.min.x;
+            double height = c.bounds.max.y - c.bounds.min.y;
+            if (std::isfinite(width) && std::isfinite(height)) {
+                partial.extent[0] += width;
+                partial.extent[1] += height;
+                partial.finite++;
+            }
+
+            for (int a = 0; a < 2; a++) {
+                double center = a == 0 ? c.center.x : c.center.y;
+                Real low = _axis_min(c.bounds, a);
+                if (std::isfinite(center)) {
+                    partial.sum[a] += center;
+                    partial.sum_sq[a] += center * center;
+                }
+                if (std::isfinite(low)) {
+                    partial.low[a] = std::min(partial.low[a], low);
+                    partial.high[a] = std::max(partial.high[a], low);
+                }
+            }
+        }
+    }
+
+    // Sweeps along the axis where centers vary the most, so the fewest intervals overlap
+    void _choose_strips() {
+        Partial total;
+        for (const Partial& p: blocks) {
+            for (int a = 0; a < 2; a++) {
+                total.sum[a] += p.sum[a];
+                total.sum_sq[a] += p.sum_sq[a];
+                total.extent[a] += p.extent[a];
+                total.low[a] = std::min(total.low[a], p.low[a]);
+                total.high[a] = std::max(total.high[a], p.high[a]);
+            }
+            total.finite += p.finite;
+        }
+
+        double n = static_cast<double>(colliders.size());
+        double variance[2];
+        for (int a = 0; a < 2; a++)
+            variance[a] = (total.sum_sq[a] / n) - ((total.sum[a] / n) * (total.sum[a] / n));
+        axis = variance[1] > variance[0] ? 1 : 0;
+        cross = 1 - axis;
+
+        // A single sweep over a 2D scene tests every shape against the whole column it sweeps past.
+        // Splitting the other axis into strips a few shapes tall keeps each sweep short.
+        strip_low = total.low[cross];
+        double range = static_cast<double>(total.high[cross]) - strip_low;
+        double mean = total.finite > 0 ? total.extent[cross] / total.finite : 0;
+        double height = std::max(2 * mean, range / max_strips);
+        strip_count = 1;
+        if (range > 0 && height > 0 && std::isfinite(range))
+            strip_count = std::min<size_t>(max_strips, static_cast<size_t>(range / height) + 1);
+        strip_scale = strip_count > 1 ? static_cast<Real>(1 / height) : 0;
+    }
+
+    size_t _strip_of(Real value) const {
+        Real t = (value - strip_low) * strip_scale;
+        if (t >= static_cast<Real>(strip_count))
+            return strip_count - 1;
+        return t > 0 ? static_cast<size_t>(t) : 0;
+    }
+
+    // Writes the entries of shapes [begin, end) into every strip they overlap, advancing the offsets
+    void _place(uint32_t* offsets, size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            const Bounds2D<Real>& box = colliders[i].bounds;
+
+            // Intervals with an invalid start are moved past the end, where they overlap nothing
+            Entry e;
+            e.min = _axis_min(box, axis);
+            e.min = std::isnan(e.min) ? std::numeric_limits<Real>::infinity() : e.min;
+            e.max = _axis_max(box, axis);
+            e.cross_min = _axis_min(box, cross);
+            e.cross_max = _axis_max(box, cross);
+            e.index = static_cast<uint32_t>(i);
+            e.first = static_cast<uint32_t>(_strip_of(e.cross_min));
+
+            size_t last = _strip_of(e.cross_max);
+            for (size_t s = e.first; s <= last; s++)
+                entries[offsets[s]++] = e;
+        }
+    }
+
+    // Sweeps one chunk of the sorted entries, testing every pair whose bounds overlap on both axes.
+    // A pair in several strips is only tested in the first strip they share.
+    void _sweep(size_t chunk) {
+        std::vector<Contact2D<Real>>& out = chunk_contacts[chunk];
+        out.clear();
+
+        size_t first = chunk * sweep_chunk;
+        size_t last = std::min(first + sweep_chunk, entries.size());
+        size_t strip = std::upper_bound(strip_start.begin(), strip_start.end(), first) - strip_start.begin() - 1;
+        size_t tested = 0;
+        Contact2D<Real> contact;
+
+        for (size_t i = first; i < last; i++) {
+            while (i >= strip_start[strip + 1])
+                strip++;
+
+            const Entry& e = entries[i];
+            size_t strip_end = strip_start[strip + 1];
+            for (size_t j = i + 1; j < strip_end && entries[j].min <= e.max; j++) {
+                const Entry& other = entries[j];
+                if (other.cross_min > e.cross_max || other.cross_max < e.cross_min)
+                    continue;
+                if (std::max(e.first, other.first) != strip)
+                    continue;
+
+                tested++;
+                uint32_t a = std::min(e.index, other.index);
+                uint32_t b = std::max(e.index, other.index);
+                if (collide(colliders[a], colliders[b], contact))
+                    out.push_back(contact);
+            }
+        }
+        chunk_candidates[chunk] = tested;
+    }
+};
@@ -0,0 +1,318 @@
+/// Author: PlumpDolphin
+/// Date: October 16, 2026
+///
+/// Description:
+///     Provides the Executor class, a small work-stealing thread pool, along with the parallel_for and
+///     parallel_transform helpers that split bulk operations over it.
+///     Every worker owns a deque of tasks. It takes work from the back of its own deque and, once that runs dry,
+///     steals from the front of the others, so uneven chunks even out without a shared queue to fight over.
+///     The thread calling parallel_for works on its own tasks too, rather than sleeping until they are done.
+///
+/// License:
+///     The code in this file is licensed under the
+///     Revised 3-Clause BSD License.
+///     For details, see https://opensource.org/licenses/BSD-3-Clause
+
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+
+
+// Example usage showing parallel loops.
+/*
+    // Uses every hardware thread. Executor::shared() returns a process-wide instance instead.
+    Executor executor;
+
+    // Runs the function over chunks of the range [0, count)
+    std::vector<float> values(count);
+    parallel_for(executor, 0, count, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++)
+            values[i] = std::sqrt(float(i));
+    });
+
+    // Same as std::transform, but split over the executor
+    std::vector<Bounds2D<float>> boxes(shapes.size());
+    parallel_transform(executor, shapes.begin(), shapes.end(), boxes.begin(),
+                       [](const Circle<float>& c) { return c.bounds(); });
+
+    // Chunks can be tuned per call, or for every call on an executor
+    parallel_for(executor, 0, count, work, 4096);
+    executor.setChunkSize(4096);
+
+    // A single thread runs every chunk in order, on the calling thread
+    Executor serial(1);
+*/
+
+
+
+class Executor {
+public:
+    // Each thread is given this many chunks when the chunk size is picked automatically,
+    // which leaves room for stealing to balance out uneven chunks.
+    static constexpr size_t chunks_per_thread = 4;
+
+
+
+    // Starts `threads - 1` workers, as the calling thread works too. 0 uses every hardware thread.
+    // A chunk size of 0 is picked automatically for every call.
+    explicit Executor(size_t threads = 0, size_t chunk_size = 0)
+        : chunk_size(chunk_size) {
+        if (threads == 0)
+            threads = std::thread::hardware_concurrency();
+        if (threads == 0)
+            threads = 1;
+
+        // The last queue is shared by threads outside of the pool
+        queues = std::make_unique<_Queue[]>(threads);
+        queue_count = threads;
+
+        workers.reserve(threads - 1);
+        for (size_t i = 0; i + 1 < threads; i++)
+            workers.emplace_back([this, i]() { _work(i); });
+    }
+
+    ~Executor() {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+            stopping = true;
+        }
+        sleep.notify_all();
+
+        for (auto &worker: workers)
+            worker.join();
+    }
+
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    // A process-wide executor using every hardware thread
+    static Executor& shared() {
+        static Executor executor;
+        return executor;
+    }
+
+
+
+    // Settings
+    size_t threadCount() const { return queue_count; }
+
+    size_t chunkSize() const { return chunk_size; }
+    void setChunkSize(size_t size) { chunk_size = size; }
+
+    // Chunk size used for a range of `count` elements, when the call doesn't ask for one
+    size_t chunkFor(size_t count) const {
+        if (chunk_size > 0)
+            return chunk_size;
+        size_t chunks = queue_count * chunks_per_thread;
+        return count > chunks ? (count + chunks - 1) / chunks : 1;
+    }
+
+
+
+    // Calls `f(begin, end)` for every chunk of [begin, end), and returns once all of them have finished.
+    // The first exception thrown by any chunk is rethrown here, after the remaining chunks have run.
+    // With a single thread, or a single chunk, every chunk runs in order on the calling thread.
+    template <typename F>
+    void run(size_t begin, size_t end, F&& f, size_t chunk = 0) {
+        if (end <= begin)
+            return;
+
+        size_t count = end - begin;
+        if (chunk == 0)
+            chunk = chunkFor(count);
+        size_t chunks = (count + chunk - 1) / chunk;
+
+        if (queue_count == 1 || chunks == 1) {
+            std::exception_ptr error;
+            for (size_t first = begin; first < end; first += chunk) {
+                try {
+                    f(first, end - first > chunk ? first + chunk : end);
+                } catch (...) {
+                    if (!error)
+                        error = std::current_exception();
+                }
+            }
+            if (error)
+                std::rethrow_exception(error);
+            return;
+        }
+
+        using Function = std::remove_reference_t<F>;
+        _Job job;
+        job.remaining = chunks;
+
+        // Counted before the tasks become visible, so workers never see a negative count
+        queued.fetch_add(chunks, std::memory_order_acq_rel);
+
+        // Every queue is handed one contiguous block of chunks, which is usually all it needs.
+        size_t per_queue = (chunks + queue_count - 1) / queue_count;
+        for (size_t q = 0, c = 0; q < queue_count && c < chunks; q++) {
+            std::lock_guard<std::mutex> lock(queues[q].mutex);
+            for (size_t n = 0; n < per_queue && c < chunks; n++, c++) {
+                size_t first = begin + (c * chunk);
+                queues[q].tasks.push_back(_Task {
+                    [](void* function, size_t first, size_t last) { (*static_cast<Function*>(function))(first, last); },
+                    const_cast<void*>(static_cast<const void*>(std::addressof(f))),
+                    first, end - first > chunk ? first + chunk : end, &job
+                });
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+        }
+        sleep.notify_all();
+
+        // Help out until every chunk of this job has been taken, then wait for the ones still running
+        size_t home = _home();
+        while (job.remaining.load(std::memory_order_acquire) > 0) {
+            if (!_runOne(home)) {
+                std::unique_lock<std::mutex> lock(job.mutex);
+                job.done.wait(lock, [&job]() { return job.remaining.load(std::memory_order_acquire) == 0; });
+            }
+        }
+
+        // The last chunk signals while holding the lock, so the job can't be destroyed before it lets go
+        std::lock_guard<std::mutex> lock(job.mutex);
+        if (job.error)
+            std::rethrow_exception(job.error);
+    }
+
+
+
+private:
+    struct _Job {
+        std::atomic<size_t> remaining { 0 };
+        std::mutex mutex;
+        std::condition_variable done;
+        std::exception_ptr error;
+    };
+
+    struct _Task {
+        void (*invoke)(void*, size_t, size_t);
+        void* function;
+        size_t begin, end;
+        _Job* job;
+    };
+
+    // Queues sit on separate cache lines, so workers taking from their own don't slow each other down
+    struct alignas(64) _Queue {
+        std::mutex mutex;
+        std::deque<_Task> tasks;
+    };
+
+    std::unique_ptr<_Queue[]> queues;
+    size_t queue_count = 0;
+    size_t chunk_size = 0;
+    std::vector<std::thread> workers;
+
+    std::atomic<size_t> queued { 0 };
+    std::mutex sleep_mutex;
+    std::condition_variable sleep;
+    bool stopping = false;
+
+    // Lets a worker find its own queue when it starts a nested job
+    static inline thread_local const Executor* current_executor = nullptr;
+    static inline thread_local size_t current_queue = 0;
+
+    size_t _home() const { return current_executor == this ? current_queue : queue_count - 1; }
+
+    // Takes a task from the back of its own queue, or steals one from the front of another
+    bool _runOne(size_t home) {
+        _Task task;
+        bool found = false;
+
+        {
+            std::lock_guard<std::mutex> lock(queues[home].mutex);
+            if (!queues[home].tasks.empty()) {
+                task = queues[home].tasks.back();
+                queues[home].tasks.pop_back();
+                found = true;
+            }
+        }
+
+        for (size_t k = 1; k < queue_count && !found; k++) {
+            _Queue& victim = queues[(home + k) % queue_count];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (!victim.tasks.empty()) {
+                task = victim.tasks.front();
+                victim.tasks.pop_front();
+                found = true;
+            }
+        }
+
+        if (!found)
+            return false;
+
+        queued.fetch_sub(1, std::memory_order_acq_rel);
+        _execute(task);
+        return true;
+    }
+
+    static void _execute(const _Task& task) {
+        _Job* job = task.job;
+        try {
+            task.invoke(task.function, task.begin, task.end);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(job->mutex);
+            if (!job->error)
+                job->error = std::current_exception();
+        }
+
+        std::lock_guard<std::mutex> lock(job->mutex);
+        if (job->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            job->done.notify_all();
+    }
+
+    void _work(size_t index) {
+        current_executor = this;
+        current_queue = index;
+
+        while (true) {
+            if (_runOne(index))
+                continue;
+
+            std::unique_lock<std::mutex> lock(sleep_mutex);
+            sleep.wait(lock, [this]() { return stopping || queued.load(std::memory_order_acquire) > 0; });
+            if (stopping && queued.load(std::memory_order_acquire) == 0)
+                return;
+        }
+    }
+};
+
+
+
+// Calls `f(begin, end)` for chunks of the range [begin, end), split over the executor.
+// Chunks must only write results for their own elements, which keeps the output the same for any thread count.
+// A chunk size of 0 uses the executor's chunk size.
+template <typename F>
+void parallel_for(Executor& executor, size_t begin, size_t end, F&& f, size_t chunk = 0) {
+    executor.run(begin, end, std::forward<F>(f), chunk);
+}
+
+// Same as std::transform, writing `f(*it)` for every input to the output, split over the executor.
+// Both iterators must be random access.
+template <typename InputIt, typename OutputIt, typename F>
+OutputIt parallel_transform(Executor& executor, InputIt first, InputIt last, OutputIt out, F&& f, size_t chunk = 0) {
+    size_t count = static_cast<size_t>(std::distance(first, last));
+    executor.run(0, count, [&](size_t begin, size_t end) {
+        InputIt in = first + begin;
+        OutputIt to = out + begin;
+        for (size_t i = begin; i < end; i++, ++in, ++to)
+            *to = f(*in);
+    }, chunk);
+    return out + count;
+}
@@ -0,0 +1,333 @@
+/// Author: PlumpDolphin
+/// Date: October 16, 2026
+///
+/// Description:
+///     Provides Q16.16 fixed-point sine and cosine, and the integer rotation functions used by shapes with
+///     integer coordinates. Angles are quantized to 1/65536 of a degree and looked up in a quarter-wave sine table,
+///     which is built by the compiler from exact integer and double arithmetic, so every platform gets the same table.
+///     Rotations only use integer arithmetic from there on, so integer shapes rotate to the same vertices on every
+///     machine, with no float trig. Multiples of 90 degrees are exact.
+///
+/// License:
+///     The code in this file is licensed under the
+///     Revised 3-Clause BSD License.
+///     For details, see https://opensource.org/licenses/BSD-3-Clause
+
+
+#pragma once
+
+#define _USE_MATH_DEFINES // This allows access of the Pi definition, M_PI, from <cmath>
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#endif
+
+#include "vectorx.h"     // Includes definition for Vector2<T>.
+#include "vectorarray.h" // Includes definition for VectorArray2<T> used by the bulk functions.
+
+
+
+// Example usage showing integer rotation.
+/*
+    // Integer shapes use these automatically, through rotate_point and rotate_points.
+    Vector2<int> p = rotate_point(Vector2<int>(100, 0), Vector2<int>(0, 0), 90.0f); // Exactly (0, 100)
+
+    // A rotation can be computed once and reused
+    FixedRotation r = fixed_rotation(30.0f);
+    Vector2<int> q = rotate_point(Vector2<int>(100, 0), Vector2<int>(0, 0), r);
+
+    // Bulk rotation of integer lanes, which vectorizes to packed integer multiplies
+    VectorArray2<int32_t> points = ...;
+    rotate_points_fixed(points, points, Vector2<int32_t>(0, 0), r);
+
+    // Angles may also be given directly in fixed-point degrees
+    FixedRotation half = fixed_sin_cos(fixed_degrees_per_turn / 2);
+*/
+
+
+
+// Loop hint used by the bulk kernels, the same as the one used by vectorarray.h.
+#if defined(__clang__)
+    #define _FIXED_VECTORIZE _Pragma("clang loop vectorize(enable) interleave(enable)")
+#elif defined(__GNUC__)
+    #define _FIXED_VECTORIZE _Pragma("GCC ivdep")
+#elif defined(_MSC_VER)
+    #define _FIXED_VECTORIZE __pragma(loop(ivdep))
+#else
+    #define _FIXED_VECTORIZE
+#endif
+
+
+
+// Q16.16 values, with 16 integer and 16 fractional bits
+typedef int32_t Fixed;
+
+constexpr int fixed_fraction_bits = 16;
+constexpr Fixed fixed_one = Fixed(1) << fixed_fraction_bits;
+
+// Angles are measured in Q16.16 degrees, and may span any number of turns
+constexpr int64_t fixed_degrees_per_turn = int64_t(360) << fixed_fraction_bits;
+constexpr int64_t fixed_degrees_per_quarter = int64_t(90) << fixed_fraction_bits;
+
+// Rounds a Q16.16 product back to an integer, halves rounding up.
+// Right shifts of negative values are arithmetic since C++20, so this matches on every platform.
+constexpr int64_t fixed_round(int64_t value) {
+    return (value + (int64_t(1) << (fixed_fraction_bits - 1))) >> fixed_fraction_bits;
+}
+
+// Converts degrees to Q16.16 degrees, rounding to the nearest step.
+// Scaling by 2^16 is exact in double, so the result only depends on the input value.
+constexpr int64_t fixed_degrees(double degrees) {
+    double scaled = degrees * fixed_one;
+    return scaled >= 0 ? static_cast<int64_t>(scaled + 0.5) : -static_cast<int64_t>(0.5 - scaled);
+}
+
+
+
+// Quarter-wave sine table
+// Entry k holds sin(90° * k / fixed_sine_segments) in Q16.16. Linear interpolation between entries adds far less
+// than one Q16.16 step of error, and every segment spans a whole number of Q16.16 degrees.
+constexpr size_t fixed_sine_segments = 1024;
+constexpr int64_t fixed_sine_segment = fixed_degrees_per_quarter / fixed_sine_segments;
+
+static_assert(fixed_degrees_per_quarter % fixed_sine_segments == 0, "Sine table segments must span whole steps");
+
+constexpr std::array<Fixed, fixed_sine_segments + 1> _fixed_sine_table() {
+    std::array<Fixed, fixed_sine_segments + 1> table {};
+    for (size_t k = 0; k <= fixed_sine_segments; k++) {
+        // Taylor series of sine, accurate to double precision for r <= π/2
+        double r = (M_PI / 2) * static_cast<double>(k) / static_cast<double>(fixed_sine_segments);
+        double r2 = r * r;
+        double sine = r, term = r;
+        for (int t = 1; t <= 12; t++) {
+            term *= -r2 / ((2 * t) * ((2 * t) + 1));
+            sine += term;
+        }
+        table[k] = static_cast<Fixed>((sine * fixed_one) + 0.5);
+    }
+    return table;
+}
+
+inline constexpr std::array<Fixed, fixed_sine_segments + 1> fixed_sine_table = _fixed_sine_table();
+
+constexpr int64_t _fixed_sine_checksum() {
+    int64_t sum = 0;
+    for (size_t k = 0; k <= fixed_sine_segments; k++)
+        sum = (sum * 31 + fixed_sine_table[k]) % 1000000007;
+    return sum;
+}
+
+// Pins the table, so a compiler that evaluated it differently fails here instead of desynchronizing at runtime
+static_assert(fixed_sine_table[0] == 0 && fixed_sine_table[fixed_sine_segments] == fixed_one &&
+              fixed_sine_table[fixed_sine_segments / 2] == 46341 && _fixed_sine_checksum() == 484491180,
+              "Fixed-point sine table differs from the reference table");
+
+// Sine of an angle within [0, 90] degrees, in Q16.16 degrees
+constexpr Fixed _fixed_quarter_sine(int64_t angle) {
+    int64_t k = angle / fixed_sine_segment;
+    int64_t f = angle - (k * fixed_sine_segment);
+    if (f == 0)
+        return fixed_sine_table[k];
+
+    int64_t low = fixed_sine_table[k];
+    int64_t high = fixed_sine_table[k + 1];
+    return static_cast<Fixed>(low + ((((high - low) * f) + (fixed_sine_segment / 2)) / fixed_sine_segment));
+}
+
+
+
+// Cosine and sine of an angle in Q16.16
+struct FixedRotation {
+    Fixed cosine = fixed_one;
+    Fixed sine = 0;
+};
+
+// Looks up the cosine and sine of an angle in Q16.16 degrees.
+// Whole quarter turns only swap and negate table entries, so 0, 90, 180 and 270 degrees are exact.
+constexpr FixedRotation fixed_sin_cos(int64_t angle) {
+    int64_t a = angle % fixed_degrees_per_turn;
+    if (a < 0)
+        a += fixed_degrees_per_turn;
+
+    int64_t quarter = a / fixed_degrees_per_quarter;
+    int64_t r = a - (quarter * fixed_degrees_per_quarter);
+    Fixed s = _fixed_quarter_sine(r);
+    Fixed c = _fixed_quarter_sine(fixed_degrees_per_quarter - r);
+
+    switch (quarter) {
+    case 1:  return { -s, c };
+    case 2:  return { -c, -s };
+    case 3:  return { s, -c };
+    default: return { c, s };
+    }
+}
+
+constexpr FixedRotation fixed_rotation(double degrees) { return fixed_sin_cos(fixed_degrees(degrees)); }
+
+
+
+// Integer rotation
+// Offsets from the origin are multiplied in 64 bits, so coordinates up to ±2^46 of the origin can't overflow.
+// Results are rounded to the nearest integer, rather than truncated.
+
+// Counter-clockwise rotation around the origin, the same direction as the floating-point rotate_point
+template <typename T> requires std::is_integral_v<T>
+constexpr Vector2<T> rotate_point(Vector2<T> position, Vector2<T> origin, FixedRotation rotation) {
+    int64_t dx = static_cast<int64_t>(position.x) - origin.x;
+    int64_t dy = static_cast<int64_t>(position.y) - origin.y;
+
+    int64_t x = fixed_round((dx * rotation.cosine) - (dy * rotation.sine));
+    int64_t y = fixed_round((dx * rotation.sine) + (dy * rotation.cosine));
+    return Vector2<T>(static_cast<T>(x + origin.x), static_cast<T>(y + origin.y));
+}
+
+#if defined(__AVX2__)
+// Rotates 32-bit lanes four elements at a time, and returns the index of the first element left for the scalar loop.
+// Products are widened to 64 bits, the same as the scalar loop, so both give identical results.
+// The origin's share of the products is folded into a constant, along with a bias that keeps every sum positive,
+// which lets a logical shift stand in for the arithmetic 64-bit shift that AVX2 lacks. The bias is a multiple of
+// 2^48, so it only changes bits that are dropped when the result is narrowed back to 32 bits.
+inline size_t _rotate_lanes_fixed_avx2(const int32_t* sx, const int32_t* sy, int32_t* dx, int32_t* dy,
+                                       size_t begin, size_t end, Vector2<int32_t> origin, FixedRotation rotation) {
+    const int64_t bias = (int64_t(1) << 52) + (int64_t(1) << (fixed_fraction_bits - 1));
+    const int64_t kx = bias - (int64_t(origin.x) * rotation.cosine) + (int64_t(origin.y) * rotation.sine);
+    const int64_t ky = bias - (int64_t(origin.x) * rotation.sine) - (int64_t(origin.y) * rotation.cosine);
+
+    const __m256i c = _mm256_set1_epi64x(rotation.cosine);
+    const __m256i s = _mm256_set1_epi64x(rotation.sine);
+    const __m256i offset_x = _mm256_set1_epi64x(kx);
+    const __m256i offset_y = _mm256_set1_epi64x(ky);
+    const __m128i position_x = _mm_set1_epi32(origin.x);
+    const __m128i position_y = _mm_set1_epi32(origin.y);
+    const __m256i low_halves = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m256i x = _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(sx + i)));
+        __m256i y = _mm256_cvtepi32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(sy + i)));
+
+        __m256i rx = _mm256_sub_epi64(_mm256_add_epi64(_mm256_mul_epi32(x, c), offset_x), _mm256_mul_epi32(y, s));
+        __m256i ry = _mm256_add_epi64(_mm256_add_epi64(_mm256_mul_epi32(x, s), offset_y), _mm256_mul_epi32(y, c));
+        rx = _mm256_permutevar8x32_epi32(_mm256_srli_epi64(rx, fixed_fraction_bits), low_halves);
+        ry = _mm256_permutevar8x32_epi32(_mm256_srli_epi64(ry, fixed_fraction_bits), low_halves);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dx + i), _mm_add_epi32(_mm256_castsi256_si128(rx), position_x));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dy + i), _mm_add_epi32(_mm256_castsi256_si128(ry), position_y));
+    }
+    return i;
+}
+
+// Interleaved counterpart of the kernel above, for four (x, y) pairs at a time.
+// Every pair fills one 64-bit lane, so x is multiplied where it lies and y once it is shifted down.
+// The rounded x ends up in the low half of its lane and y is shifted into the high half, so a blend
+// packs them back into pairs without a shuffle.
+inline size_t _rotate_pairs_fixed_avx2(const Vector2<int32_t>* src, Vector2<int32_t>* dst, size_t count,
+                                       Vector2<int32_t> origin, FixedRotation rotation) {
+    static_assert(sizeof(Vector2<int32_t>) == 2 * sizeof(int32_t), "Pairs must be packed for the interleaved kernel");
+
+    const int64_t bias = (int64_t(1) << 52) + (int64_t(1) << (fixed_fraction_bits - 1));
+    const int64_t kx = bias - (int64_t(origin.x) * rotation.cosine) + (int64_t(origin.y) * rotation.sine);
+    const int64_t ky = bias - (int64_t(origin.x) * rotation.sine) - (int64_t(origin.y) * rotation.cosine);
+
+    const __m256i c = _mm256_set1_epi64x(rotation.cosine);
+    const __m256i s = _mm256_set1_epi64x(rotation.sine);
+    const __m256i offset_x = _mm256_set1_epi64x(kx);
+    const __m256i offset_y = _mm256_set1_epi64x(ky);
+    const __m256i position = _mm256_setr_epi32(origin.x, origin.y, origin.x, origin.y,
+                                               origin.x, origin.y, origin.x, origin.y);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256i xy = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        __m256i y = _mm256_srli_epi64(xy, 32);
+
+        __m256i rx = _mm256_sub_epi64(_mm256_add_epi64(_mm256_mul_epi32(xy, c), offset_x), _mm256_mul_epi32(y, s));
+        __m256i ry = _mm256_add_epi64(_mm256_add_epi64(_mm256_mul_epi32(xy, s), offset_y), _mm256_mul_epi32(y, c));
+        __m256i pairs = _mm256_blend_epi32(_mm256_srli_epi64(rx, fixed_fraction_bits),
+                                           _mm256_slli_epi64(ry, 32 - fixed_fraction_bits), 0xAA);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_add_epi32(pairs, position));
+    }
+    return i;
+}
+#endif
+
+// Rotates every point around the origin. The input and output may be the same buffer.
+// 32-bit points use the interleaved AVX2 kernel above when it's available, and give the same results.
+template <typename T> requires std::is_integral_v<T>
+void rotate_points_fixed(std::span<const Vector2<std::type_identity_t<T>>> in,
+                         std::span<Vector2<std::type_identity_t<T>>> out,
+                         Vector2<T> origin, FixedRotation rotation) {
+    const Vector2<T>* src = in.data();
+    Vector2<T>* dst = out.data();
+    size_t count = in.size() < out.size() ? in.size() : out.size();
+
+    size_t i = 0;
+#if defined(__AVX2__)
+    if constexpr (std::is_same_v<T, int32_t>)
+        i = _rotate_pairs_fixed_avx2(src, dst, count, origin, rotation);
+#endif
+
+    for (; i < count; i++)
+        dst[i] = rotate_point(src[i], origin, rotation);
+}
+
+// Rotates the elements [begin, end) of a pair of lanes.
+// Every iteration only reads and writes its own element, so this compiles to packed integer multiplies.
+// 32-bit lanes use the AVX2 kernel above when it's available, as compilers only vectorize this loop at -O3.
+template <typename T> requires std::is_integral_v<T>
+void _rotate_lanes_fixed(const T* sx, const T* sy, T* dx, T* dy, size_t begin, size_t end,
+                         Vector2<T> origin, FixedRotation rotation) {
+#if defined(__AVX2__)
+    if constexpr (std::is_same_v<T, int32_t>)
+        begin = _rotate_lanes_fixed_avx2(sx, sy, dx, dy, begin, end, origin, rotation);
+#endif
+
+    const int64_t c = rotation.cosine;
+    const int64_t s = rotation.sine;
+    const int64_t half = int64_t(1) << (fixed_fraction_bits - 1);
+
+    _FIXED_VECTORIZE
+    for (size_t i = begin; i < end; i++) {
+        int64_t ox = static_cast<int64_t>(sx[i]) - origin.x;
+        int64_t oy = static_cast<int64_t>(sy[i]) - origin.y;
+        dx[i] = static_cast<T>((((ox * c) - (oy * s) + half) >> fixed_fraction_bits) + origin.x);
+        dy[i] = static_cast<T>((((ox * s) + (oy * c) + half) >> fixed_fraction_bits) + origin.y);
+    }
+}
+
+// Structure-of-arrays variant, which keeps every lane contiguous for the vectorizer.
+template <typename T> requires std::is_integral_v<T>
+void rotate_points_fixed(const VectorArray2<T>& in, VectorArray2<T>& out, Vector2<T> origin, FixedRotation rotation) {
+    if (&in != &out)
+        out.resize(in.size());
+
+    _rotate_lanes_fixed(in.x, in.y, out.x, out.y, 0, in.size(), origin, rotation);
+}
+
+
+
+// Direction i of N, rotated clockwise by an angle and scaled by a radius, in integer coordinates.
+// This is the integer counterpart of place_unit_vertices: (r·sin(a - θ), r·cos(a - θ)) for a = 360°·i/N.
+template <typename T> requires std::is_integral_v<T>
+constexpr Vector2<T> fixed_unit_vertex(size_t i, size_t N, int64_t rotation, T radius) {
+    int64_t direction = (fixed_degrees_per_turn * static_cast<int64_t>(i)) / static_cast<int64_t>(N);
+    FixedRotation r = fixed_sin_cos(direction - rotation);
+    return Vector2<T>(static_cast<T>(fixed_round(static_cast<int64_t>(radius) * r.sine)),
+                      static_cast<T>(fixed_round(static_cast<int64_t>(radius) * r.cosine)));
+}
+
+
+
+
+
+
+// Clean up all definitions to prevent collisions with other headers.
+#undef _FIXED_VECTORIZE
@@ -0,0 +1,311 @@
+/// Author: PlumpDolphin
+/// Date: October 16, 2026
+///
+/// Description:
+///     Provides optional instrumentation of the hot paths in shapes.h and transform.h.
+///     Counters track trig evaluations, vertex buffers allocated, serializations, and transform calls,
+///     so a slow frame can be pinned on trig, allocation or serialization without a profiler.
+///     Scoped timers can additionally report every vertices(), rotate_point() and serializer call to an
+///     external profiler through a pair of hooks.
+///
+///     Everything is compiled out unless enabled, before including any of the headers:
+///         #define SHAPES_INSTRUMENTATION        // Counters
+///         #define SHAPES_INSTRUMENTATION_TIMERS // Scoped timers, which also enables the counters
+///
+/// License:
+///     The code in this file is licensed under the
+///     Revised 3-Clause BSD License.
+///     For details, see https://opensource.org/licenses/BSD-3-Clause
+
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+
+
+// Example usage showing counters and timer hooks.
+/*
+    #define SHAPES_INSTRUMENTATION_TIMERS
+    #include "shapes.h"
+
+    // Counters are kept per thread, and summed over every thread by the snapshot
+    instrument_reset();
+    render_frame();
+    InstrumentCounters frame = instrument_snapshot();
+    std::cout << frame.str() << std::endl;
+
+    // Forward timed scopes to a profiler
+    instrument_set_hooks(
+        [](const char* name) { profiler_begin(name); },
+        [](const char* name, uint64_t nanoseconds) { profiler_end(name, nanoseconds); });
+*/
+
+
+
+#if defined(SHAPES_INSTRUMENTATION_TIMERS) && !defined(SHAPES_INSTRUMENTATION)
+    #define SHAPES_INSTRUMENTATION
+#endif
+
+// Gives every scoped object declared by the macros below a unique name
+#define _INSTRUMENT_CONCAT2(a, b) a##b
+#define _INSTRUMENT_CONCAT(a, b) _INSTRUMENT_CONCAT2(a, b)
+
+
+
+// Every counter that is tracked
+enum class InstrumentCounter : size_t {
+    TrigEvaluations,  // Calls to sin or cos
+    VertexBuffers,    // Vertex lists allocated or grown by vertices()
+    VertexBytes,      // Bytes allocated for those lists
+    Serializations,   // Calls to a shape's str() or json()
+    SerializedBytes,  // Bytes appended by those calls
+    TransformCalls,   // Calls to a transform function of Shape2D
+    Count
+};
+
+constexpr size_t instrument_counter_count = static_cast<size_t>(InstrumentCounter::Count);
+
+
+
+// A snapshot of every counter
+struct InstrumentCounters {
+    uint64_t values[instrument_counter_count] = {};
+
+    uint64_t operator[](InstrumentCounter counter) const { return values[static_cast<size_t>(counter)]; }
+
+    uint64_t trigEvaluations() const { return (*this)[InstrumentCounter::TrigEvaluations]; }
+    uint64_t vertexBuffers() const   { return (*this)[InstrumentCounter::VertexBuffers]; }
+    uint64_t vertexBytes() const     { return (*this)[InstrumentCounter::VertexBytes]; }
+    uint64_t serializations() const  { return (*this)[InstrumentCounter::Serializations]; }
+    uint64_t serializedBytes() const { return (*this)[InstrumentCounter::SerializedBytes]; }
+    uint64_t transformCalls() const  { return (*this)[InstrumentCounter::TransformCalls]; }
+
+    InstrumentCounters operator-(const InstrumentCounters& other) const {
+        InstrumentCounters out;
+        for (size_t i = 0; i < instrument_counter_count; i++)
+            out.values[i] = values[i] - other.values[i];
+        return out;
+    }
+
+    InstrumentCounters& operator+=(const InstrumentCounters& other) {
+        for (size_t i = 0; i < instrument_counter_count; i++)
+            values[i] += other.values[i];
+        return *this;
+    }
+
+    std::string str() const {
+        const char* names[instrument_counter_count] = {
+            "trig", "vertex buffers", "vertex bytes", "serializations", "serialized bytes", "transform calls"
+        };
+
+        std::string out = "InstrumentCounters { ";
+        for (size_t i = 0; i < instrument_counter_count; i++) {
+            if (i > 0)
+                out += ", ";
+            out += names[i];
+            out += ": ";
+            out += std::to_string(values[i]);
+        }
+        out += " }";
+        return out;
+    }
+};
+
+
+
+#if defined(SHAPES_INSTRUMENTATION)
+
+// Counters of a single thread.
+// Only the owning thread writes them, so an increment is a plain load and store, while snapshots
+// taken from other threads still read whole values.
+struct _InstrumentThread {
+    std::atomic<uint64_t> values[instrument_counter_count] = {};
+
+    _InstrumentThread();
+    ~_InstrumentThread();
+
+    InstrumentCounters load() const {
+        InstrumentCounters out;
+        for (size_t i = 0; i < instrument_counter_count; i++)
+            out.values[i] = values[i].load(std::memory_order_relaxed);
+        return out;
+    }
+};
+
+// Every live thread's counters, along with the totals of threads that have exited
+struct _InstrumentRegistry {
+    std::mutex mutex;
+    std::vector<const _InstrumentThread*> threads;
+    InstrumentCounters retired;
+    InstrumentCounters baseline;
+
+    static _InstrumentRegistry& instance() {
+        static _InstrumentRegistry registry;
+        return registry;
+    }
+
+    // Sum of every thread, ignoring the baseline. The mutex must be held.
+    InstrumentCounters total() const {
+        InstrumentCounters out = retired;
+        for (auto thread: threads)
+            out += thread->load();
+        return out;
+    }
+};
+
+inline _InstrumentThread::_InstrumentThread() {
+    _InstrumentRegistry& registry = _InstrumentRegistry::instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.threads.push_back(this);
+}
+
+inline _InstrumentThread::~_InstrumentThread() {
+    _InstrumentRegistry& registry = _InstrumentRegistry::instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.retired += load();
+    std::erase(registry.threads, this);
+}
+
+inline _InstrumentThread& _instrument_thread() {
+    static thread_local _InstrumentThread counters;
+    return counters;
+}
+
+// Adds to one of the calling thread's counters
+inline void instrument_count(InstrumentCounter counter, uint64_t amount = 1) {
+    std::atomic<uint64_t>& value = _instrument_thread().values[static_cast<size_t>(counter)];
+    value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+// Sum of every thread's counters since the last reset
+inline InstrumentCounters instrument_snapshot() {
+    _InstrumentRegistry& registry = _InstrumentRegistry::instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    return registry.total() - registry.baseline;
+}
+
+// Counters of the calling thread only, which are never reset
+inline InstrumentCounters instrument_thread_snapshot() {
+    return _instrument_thread().load();
+}
+
+// Starts counting from zero again. Counters aren't cleared, only remembered, so threads can keep counting meanwhile.
+inline void instrument_reset() {
+    _InstrumentRegistry& registry = _InstrumentRegistry::instance();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.baseline = registry.total();
+}
+
+// Counts a vertex list that has to allocate to hold `count` vertices
+template <typename V>
+inline void _instrument_buffer(const std::vector<V>& list, size_t count) {
+    if (count > list.capacity()) {
+        instrument_count(InstrumentCounter::VertexBuffers);
+        instrument_count(InstrumentCounter::VertexBytes, count * sizeof(V));
+    }
+}
+
+// Counts one serialization, along with the bytes it appended to `out`
+class _InstrumentSerialization {
+public:
+    explicit _InstrumentSerialization(const std::string& out) : out(out), start(out.size()) {}
+
+    ~_InstrumentSerialization() {
+        instrument_count(InstrumentCounter::Serializations);
+        instrument_count(InstrumentCounter::SerializedBytes, out.size() - start);
+    }
+
+    _InstrumentSerialization(const _InstrumentSerialization&) = delete;
+    _InstrumentSerialization& operator=(const _InstrumentSerialization&) = delete;
+
+private:
+    const std::string& out;
+    size_t start;
+};
+
+#define INSTRUMENT_COUNT(counter, amount) instrument_count(InstrumentCounter::counter, amount)
+#define INSTRUMENT_BUFFER(list, count) _instrument_buffer(list, count)
+#define INSTRUMENT_SERIALIZATION(out) \
+    _InstrumentSerialization _INSTRUMENT_CONCAT(_instrument_serialization_, __LINE__)(out)
+
+#else
+
+// Disabled instrumentation reports nothing
+inline InstrumentCounters instrument_snapshot() { return {}; }
+inline InstrumentCounters instrument_thread_snapshot() { return {}; }
+inline void instrument_reset() {}
+
+#define INSTRUMENT_COUNT(counter, amount) ((void)0)
+#define INSTRUMENT_BUFFER(list, count) ((void)0)
+#define INSTRUMENT_SERIALIZATION(out) ((void)0)
+
+#endif
+
+
+
+// Timer hooks
+// `begin` is called when a timed scope starts, and `end` when it finishes, with the elapsed time.
+// Either may be null. Hooks are shared by every thread, and must be safe to call from any of them.
+using InstrumentBeginHook = void (*)(const char* name);
+using InstrumentEndHook = void (*)(const char* name, uint64_t nanoseconds);
+
+struct _InstrumentHooks {
+    std::atomic<InstrumentBeginHook> begin { nullptr };
+    std::atomic<InstrumentEndHook> end { nullptr };
+
+    static _InstrumentHooks& instance() {
+        static _InstrumentHooks hooks;
+        return hooks;
+    }
+};
+
+inline void instrument_set_hooks(InstrumentBeginHook begin, InstrumentEndHook end) {
+    _InstrumentHooks::instance().begin.store(begin, std::memory_order_release);
+    _InstrumentHooks::instance().end.store(end, std::memory_order_release);
+}
+
+
+
+#if defined(SHAPES_INSTRUMENTATION_TIMERS)
+
+// Times the enclosing scope, reporting it to the hooks
+class InstrumentScope {
+public:
+    explicit InstrumentScope(const char* name)
+        : name(name), end(_InstrumentHooks::instance().end.load(std::memory_order_acquire)) {
+        if (auto begin = _InstrumentHooks::instance().begin.load(std::memory_order_acquire))
+            begin(name);
+        if (end)
+            start = std::chrono::steady_clock::now();
+    }
+
+    ~InstrumentScope() {
+        if (end) {
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            end(name, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        }
+    }
+
+    InstrumentScope(const InstrumentScope&) = delete;
+    InstrumentScope& operator=(const InstrumentScope&) = delete;
+
+private:
+    const char* name;
+    InstrumentEndHook end;
+    std::chrono::steady_clock::time_point start;
+};
+
+#define INSTRUMENT_SCOPE(name) InstrumentScope _INSTRUMENT_CONCAT(_instrument_scope_, __LINE__)(name)
+
+#else
+
+#define INSTRUMENT_SCOPE(name) ((void)0)
+
+#endif
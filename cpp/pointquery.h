@@ -0,0 +1,295 @@
+/// Author: PlumpDolphin
+/// Date: October 16, 2026
+///
+/// Description:
+///     Provides the analytic point queries used by the contains() and signedDistance() functions of the shapes.
+///     A point is moved into a shape's local frame, relative to its position with its rotation undone,
+///     where circles, rectangles and regular N-Gons are simple functions of their size.
+///
+///     The batch kernels work on structure-of-arrays points, and write a bitmask or an array of distances.
+///     Float lanes are processed 8 points at a time with AVX2 when it's available, and every kernel works on
+///     a range of points, so it can be split over an executor.
+///
+/// License:
+///     The code in this file is licensed under the
+///     Revised 3-Clause BSD License.
+///     For details, see https://opensource.org/licenses/BSD-3-Clause
+
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#endif
+
+#include "vectorx.h" // Includes definition for Vector2<T>.
+
+
+
+// Example usage showing the batch queries, through the shapes that use them.
+/*
+    Circle<float> circle(5, 1, 2);
+    bool hit = circle.contains(Vector2<float>(3, 3));
+    float distance = circle.signedDistance(Vector2<float>(10, 2)); // 4, negative inside the circle
+
+    // Millions of samples are tested as lanes, writing one bit per point
+    VectorArray2<float> samples = ...;
+    std::vector<uint64_t> mask(query_mask_words(samples.size()));
+    circle.contains(samples, mask);
+
+    // Or distances, split over an executor
+    std::vector<float> field(samples.size());
+    circle.signedDistance(samples, field, executor);
+*/
+
+
+
+// Number of 64-bit mask words needed for a bit per point
+constexpr size_t query_mask_words(size_t count) { return (count + 63) / 64; }
+
+// Moves points into a shape's local frame: relative to its position, then rotated back by its rotation,
+// where (c, s) are the cosine and sine of the rotation.
+template <typename Real>
+struct QueryFrame {
+    Real px = 0, py = 0;
+    Real c = 1, s = 0;
+
+    Vector2<Real> local(Real x, Real y) const {
+        Real dx = x - px, dy = y - py;
+        return Vector2<Real>((dx * c) + (dy * s), (dy * c) - (dx * s));
+    }
+
+    // Rotates a direction into the frame, or back out of it, without moving it
+    Vector2<Real> localDirection(Real x, Real y) const { return Vector2<Real>((x * c) + (y * s), (y * c) - (x * s)); }
+    Vector2<Real> worldDirection(Real x, Real y) const { return Vector2<Real>((x * c) - (y * s), (x * s) + (y * c)); }
+};
+
+
+
+// Local shape functions
+// Each query tests a point in the local frame with inside(), and measures its signed distance with distance().
+// Distances are negative inside the shape, and exact everywhere.
+
+// A circle of radius `radius` around the origin
+template <typename Real>
+struct CircleQuery {
+    Real radius = 0;
+
+    bool inside(Real x, Real y) const { return ((x * x) + (y * y)) <= (radius * radius); }
+    Real distance(Real x, Real y) const { return std::sqrt((x * x) + (y * y)) - radius; }
+};
+
+// A rectangle centered on the origin, extending `hw` and `hh` along each axis
+template <typename Real>
+struct RectangleQuery {
+    Real hw = 0, hh = 0;
+
+    bool inside(Real x, Real y) const { return std::abs(x) <= hw && std::abs(y) <= hh; }
+
+    Real distance(Real x, Real y) const {
+        Real qx = std::abs(x) - hw, qy = std::abs(y) - hh;
+        Real ox = qx > 0 ? qx : 0, oy = qy > 0 ? qy : 0;
+        Real in = qx > qy ? qx : qy;
+        return std::sqrt((ox * ox) + (oy * oy)) + (in < 0 ? in : 0);
+    }
+};
+
+// A regular N-Gon around the origin, with vertices at radius `radius`.
+// `normals` is the 2N entry unit-circle table, whose odd entries point at the middle of every edge.
+// The edge facing a point the most is the one nearest to it: inside, the point's distance is to that edge's line,
+// and outside, to that edge or its nearest end. N-Gons of fewer than 3 vertices are empty.
+template <typename Real>
+struct NGonQuery {
+    size_t N = 0;
+    Real radius = 0;
+    Real apothem = 0;   // Distance from the center to the middle of every edge
+    Real half_edge = 0;
+    const Vector2<Real>* normals = nullptr;
+
+    NGonQuery() {}
+    NGonQuery(size_t N, Real radius, const Vector2<Real>* normals)
+        : N(N), radius(radius), normals(normals) {
+        // The first edge's normal is at half the central angle, so it holds the cosine and sine of pi / N
+        if (N >= 3) {
+            apothem = radius * normals[1].y;
+            half_edge = radius * normals[1].x;
+        }
+    }
+
+    bool inside(Real x, Real y) const {
+        bool in = N >= 3;
+        for (size_t k = 1; k < 2 * N; k += 2)
+            in &= ((normals[k].x * x) + (normals[k].y * y)) <= apothem;
+        return in;
+    }
+
+    Real distance(Real x, Real y) const {
+        if (N < 3)
+            return std::sqrt((x * x) + (y * y));
+
+        // Position of the point along the normal and the tangent of the edge facing it
+        Real u = -std::numeric_limits<Real>::infinity(), v = 0;
+        for (size_t k = 1; k < 2 * N; k += 2) {
+            Real along = (normals[k].x * x) + (normals[k].y * y);
+            if (along > u) {
+                u = along;
+                v = (normals[k].y * x) - (normals[k].x * y);
+            }
+        }
+
+        Real over = std::abs(v) - half_edge;
+        if (over > 0)
+            return std::sqrt(((u - apothem) * (u - apothem)) + (over * over));
+        return u - apothem;
+    }
+};
+
+
+
+// Batch kernels
+// Points [begin, end) of the lanes are tested, and begin must be a multiple of 64, since whole mask words are written.
+// Bit i % 64 of mask[i / 64] is set when point i is inside, and bits past the last point are cleared.
+
+// Converts a distance to the output type, rounding for integer shapes
+template <typename T, typename Real>
+T _query_result(Real distance) {
+    if constexpr (std::is_integral_v<T>)
+        return static_cast<T>(std::lround(distance));
+    else
+        return static_cast<T>(distance);
+}
+
+#if defined(__AVX2__)
+// AVX2 versions of the local shape functions, for 8 float points at once.
+// Ranges that don't fill the last 8 points finish with masked loads, rather than the scalar loop, so every point
+// is computed the same way however a batch is split.
+
+inline __m256 _query_abs8(__m256 v) { return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), v); }
+
+// Lanes enabled for the first `count` of 8 points, used to load and store the last points of a range
+inline __m256i _query_lanes8(size_t count) {
+    int enabled = count < 8 ? static_cast<int>(count) : 8;
+    return _mm256_cmpgt_epi32(_mm256_set1_epi32(enabled), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+}
+
+inline void _query_local8(const QueryFrame<float>& frame, __m256 x, __m256 y, __m256& lx, __m256& ly) {
+    __m256 dx = _mm256_sub_ps(x, _mm256_set1_ps(frame.px));
+    __m256 dy = _mm256_sub_ps(y, _mm256_set1_ps(frame.py));
+    __m256 c = _mm256_set1_ps(frame.c), s = _mm256_set1_ps(frame.s);
+    lx = _mm256_add_ps(_mm256_mul_ps(dx, c), _mm256_mul_ps(dy, s));
+    ly = _mm256_sub_ps(_mm256_mul_ps(dy, c), _mm256_mul_ps(dx, s));
+}
+
+inline __m256 _query_inside8(const CircleQuery<float>& q, __m256 x, __m256 y) {
+    __m256 d2 = _mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y));
+    return _mm256_cmp_ps(d2, _mm256_set1_ps(q.radius * q.radius), _CMP_LE_OQ);
+}
+
+inline __m256 _query_distance8(const CircleQuery<float>& q, __m256 x, __m256 y) {
+    __m256 d2 = _mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y));
+    return _mm256_sub_ps(_mm256_sqrt_ps(d2), _mm256_set1_ps(q.radius));
+}
+
+inline __m256 _query_inside8(const RectangleQuery<float>& q, __m256 x, __m256 y) {
+    return _mm256_and_ps(_mm256_cmp_ps(_query_abs8(x), _mm256_set1_ps(q.hw), _CMP_LE_OQ),
+                         _mm256_cmp_ps(_query_abs8(y), _mm256_set1_ps(q.hh), _CMP_LE_OQ));
+}
+
+inline __m256 _query_distance8(const RectangleQuery<float>& q, __m256 x, __m256 y) {
+    __m256 zero = _mm256_setzero_ps();
+    __m256 qx = _mm256_sub_ps(_query_abs8(x), _mm256_set1_ps(q.hw));
+    __m256 qy = _mm256_sub_ps(_query_abs8(y), _mm256_set1_ps(q.hh));
+    __m256 ox = _mm256_max_ps(qx, zero), oy = _mm256_max_ps(qy, zero);
+    __m256 in = _mm256_min_ps(_mm256_max_ps(qx, qy), zero);
+    return _mm256_add_ps(_mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(ox, ox), _mm256_mul_ps(oy, oy))), in);
+}
+
+inline __m256 _query_inside8(const NGonQuery<float>& q, __m256 x, __m256 y) {
+    __m256 in = q.N >= 3 ? _mm256_castsi256_ps(_mm256_set1_epi32(-1)) : _mm256_setzero_ps();
+    __m256 apothem = _mm256_set1_ps(q.apothem);
+    for (size_t k = 1; k < 2 * q.N; k += 2) {
+        __m256 along = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(q.normals[k].x), x),
+                                     _mm256_mul_ps(_mm256_set1_ps(q.normals[k].y), y));
+        in = _mm256_and_ps(in, _mm256_cmp_ps(along, apothem, _CMP_LE_OQ));
+    }
+    return in;
+}
+
+inline __m256 _query_distance8(const NGonQuery<float>& q, __m256 x, __m256 y) {
+    if (q.N < 3)
+        return _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(x, x), _mm256_mul_ps(y, y)));
+
+    __m256 u = _mm256_set1_ps(-std::numeric_limits<float>::infinity()), v = _mm256_setzero_ps();
+    for (size_t k = 1; k < 2 * q.N; k += 2) {
+        __m256 nx = _mm256_set1_ps(q.normals[k].x), ny = _mm256_set1_ps(q.normals[k].y);
+        __m256 along = _mm256_add_ps(_mm256_mul_ps(nx, x), _mm256_mul_ps(ny, y));
+        __m256 across = _mm256_sub_ps(_mm256_mul_ps(ny, x), _mm256_mul_ps(nx, y));
+        __m256 nearer = _mm256_cmp_ps(along, u, _CMP_GT_OQ);
+        u = _mm256_blendv_ps(u, along, nearer);
+        v = _mm256_blendv_ps(v, across, nearer);
+    }
+
+    __m256 gap = _mm256_sub_ps(u, _mm256_set1_ps(q.apothem));
+    __m256 over = _mm256_sub_ps(_query_abs8(v), _mm256_set1_ps(q.half_edge));
+    __m256 corner = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(gap, gap), _mm256_mul_ps(over, over)));
+    return _mm256_blendv_ps(gap, corner, _mm256_cmp_ps(over, _mm256_setzero_ps(), _CMP_GT_OQ));
+}
+#endif
+
+// Tests points [begin, end) against a shape, one bit per point
+template <typename T, typename Real, typename Query>
+void query_contains(const T* x, const T* y, size_t begin, size_t end, const QueryFrame<Real>& frame,
+                    const Query& query, uint64_t* mask) {
+    for (size_t word = begin; word < end; word += 64) {
+        size_t count = end - word < 64 ? end - word : 64;
+        uint64_t bits = 0;
+
+#if defined(__AVX2__)
+        if constexpr (std::is_same_v<T, float> && std::is_same_v<Real, float>) {
+            for (size_t j = 0; j < count; j += 8) {
+                __m256i lanes = _query_lanes8(count - j);
+                __m256 lx, ly;
+                _query_local8(frame, _mm256_maskload_ps(x + word + j, lanes), _mm256_maskload_ps(y + word + j, lanes), lx, ly);
+                __m256 inside = _mm256_and_ps(_query_inside8(query, lx, ly), _mm256_castsi256_ps(lanes));
+                bits |= static_cast<uint64_t>(_mm256_movemask_ps(inside)) << j;
+            }
+            mask[word / 64] = bits;
+            continue;
+        }
+#endif
+
+        for (size_t j = 0; j < count; j++) {
+            Vector2<Real> p = frame.local(static_cast<Real>(x[word + j]), static_cast<Real>(y[word + j]));
+            bits |= static_cast<uint64_t>(query.inside(p.x, p.y)) << j;
+        }
+        mask[word / 64] = bits;
+    }
+}
+
+// Measures the signed distance of points [begin, end) to a shape
+template <typename T, typename Real, typename Query>
+void query_distances(const T* x, const T* y, size_t begin, size_t end, const QueryFrame<Real>& frame,
+                     const Query& query, T* out) {
+#if defined(__AVX2__)
+    if constexpr (std::is_same_v<T, float> && std::is_same_v<Real, float>) {
+        for (size_t i = begin; i < end; i += 8) {
+            __m256i lanes = _query_lanes8(end - i);
+            __m256 lx, ly;
+            _query_local8(frame, _mm256_maskload_ps(x + i, lanes), _mm256_maskload_ps(y + i, lanes), lx, ly);
+            _mm256_maskstore_ps(out + i, lanes, _query_distance8(query, lx, ly));
+        }
+        return;
+    }
+#endif
+
+    for (size_t i = begin; i < end; i++) {
+        Vector2<Real> p = frame.local(static_cast<Real>(x[i]), static_cast<Real>(y[i]));
+        out[i] = _query_result<T>(query.distance(p.x, p.y));
+    }
+}
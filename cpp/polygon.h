@@ -0,0 +1,1047 @@
+/// Author: PlumpDolphin
+/// Date: October 16, 2026
+///
+/// Description:
+///     Provides the Polygon class, for arbitrary simple polygons such as imported outlines, built on the Shape2D base.
+///     Vertices are stored once, in local space, as a structure of arrays, and every transform only updates the
+///     polygon's position, rotation and scaling. The transform is applied to the whole vertex set when it is read,
+///     in the same pass that renders the vertices, so moving a polygon costs the same for 10 vertices or 10^5.
+///
+///     The geometry functions (area, perimeter, centroid, containment, convex hull and simplification) run over
+///     the local lanes, with kernels written so the compiler can fill SIMD registers, and results that don't depend
+///     on the transform are cached until the vertices change.
+///
+/// License:
+///     The code in this file is licensed under the
+///     Revised 3-Clause BSD License.
+///     For details, see https://opensource.org/licenses/BSD-3-Clause
+
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "shapes.h" // Includes definitions for Shape2D, Bounds2D and the rotation functions.
+
+
+
+// Example usage showing polygons built from outlines.
+/*
+    // Vertices given in world space are re-centered around their centroid, which becomes the position
+    std::vector<Vector2<float>> outline = load_outline();
+    Polygon<float> p = Polygon<float>::fromVertices(outline);
+
+    // Transforms are constant time, the vertices are only transformed when they are read
+    p.rotate(30);
+    p.scaleFrom(2, Vector2<float>(0, 0));
+
+    float area = p.area();
+    Vector2<float> center = p.centroid();
+    bool inside = p.contains(Vector2<float>(1, 2));
+
+    // Derived polygons keep the transform of the original
+    Polygon<float> hull = p.convexHull();
+    Polygon<float> coarse = p.simplified(0.5f); // Drops vertices within 0.5 units of the outline
+
+    // Local vertices can be edited directly, followed by a call to invalidate()
+    p.points.push_back(Vector2<float>(3, 4));
+    p.invalidate();
+*/
+
+
+
+// Type used to accumulate products of coordinates.
+// Integer polygons are exact in 64 bits as long as local coordinates stay within ±2^30.
+template <typename T>
+using polygon_wide_t = std::conditional_t<std::is_integral_v<T>, int64_t, double>;
+
+// Number of partial sums kept by the reduction kernels.
+// Floating-point sums can't be reordered by the compiler, so independent partial sums are what lets it
+// evaluate several edges per instruction.
+constexpr size_t polygon_kernel_width = 8;
+
+
+
+// Geometry kernels
+// These work on the lanes of a closed polygon of `n` vertices, where the last vertex connects back to the first.
+// Coordinates are taken relative to the first vertex, which keeps products small.
+
+// Sums of a polygon's edges: twice its signed area, and the area-weighted sums of its centroid.
+template <typename T>
+struct PolygonMoments {
+    polygon_wide_t<T> area2 = 0; // Positive for counter-clockwise vertices
+    double cx = 0;               // Sum of (x[i] + x[i+1]) * cross[i], so the centroid is (cx, cy) / (3 * area2)
+    double cy = 0;               // Sum of (y[i] + y[i+1]) * cross[i]
+};
+
+template <typename T>
+PolygonMoments<T> polygon_moments(const T* x, const T* y, size_t n) {
+    using Wide = polygon_wide_t<T>;
+    constexpr size_t W = polygon_kernel_width;
+
+    PolygonMoments<T> out;
+    if (n < 3)
+        return out;
+
+    const Wide x0 = x[0], y0 = y[0];
+    Wide area[W] = {};
+    double cx[W] = {}, cy[W] = {};
+
+    // Edges i -> i + 1, W at a time
+    size_t i = 0;
+    for (; i + W < n; i += W) {
+        for (size_t j = 0; j < W; j++) {
+            Wide ax = x[i + j] - x0, ay = y[i + j] - y0;
+            Wide bx = x[i + j + 1] - x0, by = y[i + j + 1] - y0;
+            Wide cross = (ax * by) - (bx * ay);
+            area[j] += cross;
+            cx[j] += static_cast<double>(ax + bx) * static_cast<double>(cross);
+            cy[j] += static_cast<double>(ay + by) * static_cast<double>(cross);
+        }
+    }
+
+    for (size_t j = 0; j < W; j++) {
+        out.area2 += area[j];
+        out.cx += cx[j];
+        out.cy += cy[j];
+    }
+
+    // Remaining edges. The closing edge ends at the first vertex, which is (0, 0) here, so it adds nothing.
+    for (; i + 1 < n; i++) {
+        Wide ax = x[i] - x0, ay = y[i] - y0;
+        Wide bx = x[i + 1] - x0, by = y[i + 1] - y0;
+        Wide cross = (ax * by) - (bx * ay);
+        out.area2 += cross;
+        out.cx += static_cast<double>(ax + bx) * static_cast<double>(cross);
+        out.cy += static_cast<double>(ay + by) * static_cast<double>(cross);
+    }
+
+    // Move the centroid sums back from the first vertex, which moves the centroid, cx / (3 * area2), by x0
+    out.cx += 3 * static_cast<double>(x0) * static_cast<double>(out.area2);
+    out.cy += 3 * static_cast<double>(y0) * static_cast<double>(out.area2);
+    return out;
+}
+
+// Sum of the lengths of every edge, including the closing edge
+template <typename T>
+double polygon_perimeter(const T* x, const T* y, size_t n) {
+    constexpr size_t W = polygon_kernel_width;
+    if (n < 2)
+        return 0;
+
+    double sum[W] = {};
+    size_t i = 0;
+    for (; i + W < n; i += W) {
+        for (size_t j = 0; j < W; j++) {
+            double dx = static_cast<double>(x[i + j + 1]) - static_cast<double>(x[i + j]);
+            double dy = static_cast<double>(y[i + j + 1]) - static_cast<double>(y[i + j]);
+            sum[j] += std::sqrt((dx * dx) + (dy * dy));
+        }
+    }
+
+    double total = 0;
+    for (size_t j = 0; j < W; j++)
+        total += sum[j];
+
+    for (; i + 1 < n; i++)
+        total += std::hypot(static_cast<double>(x[i + 1]) - x[i], static_cast<double>(y[i + 1]) - y[i]);
+    return total + std::hypot(static_cast<double>(x[0]) - x[n - 1], static_cast<double>(y[0]) - y[n - 1]);
+}
+
+// Tests whether a point is inside the polygon by counting the edges crossed by a ray towards +x.
+// Every edge is tested independently, with the tests folded into integer masks instead of branches,
+// and float polygons are tested in float, so each SIMD register holds as many edges as it can.
+// Points exactly on an edge may be reported either way.
+template <typename T>
+bool polygon_contains(const T* x, const T* y, size_t n, double px, double py) {
+    using Real = std::conditional_t<std::is_same_v<T, float>, float, double>;
+    using Mask = std::conditional_t<sizeof(Real) == 4, int32_t, int64_t>;
+    if (n < 3)
+        return false;
+
+    // An edge a -> b, relative to the point, crosses the ray when it straddles y = 0,
+    // and its intercept (ax * by - bx * ay) / (by - ay) is positive
+    const Real qx = static_cast<Real>(px), qy = static_cast<Real>(py);
+    auto crosses = [qx, qy](T xa, T ya, T xb, T yb) -> Mask {
+        Real ax = static_cast<Real>(xa) - qx, ay = static_cast<Real>(ya) - qy;
+        Real bx = static_cast<Real>(xb) - qx, by = static_cast<Real>(yb) - qy;
+        Mask straddles = Mask(ay > 0) ^ Mask(by > 0);
+        Mask behind = Mask((ax * by) > (bx * ay)) ^ Mask(by > ay);
+        return straddles & ~behind;
+    };
+
+    Mask crossings = crosses(x[n - 1], y[n - 1], x[0], y[0]);
+    for (size_t i = 1; i < n; i++)
+        crossings += crosses(x[i - 1], y[i - 1], x[i], y[i]);
+    return (crossings & 1) != 0;
+}
+
+// Squared distance from a point to the nearest edge, including the closing edge
+template <typename T>
+double polygon_distance2(const T* x, const T* y, size_t n, double px, double py) {
+    constexpr size_t W = polygon_kernel_width;
+    if (n == 0)
+        return std::numeric_limits<double>::infinity();
+
+    // Distance to the segment a -> b, from the nearest point along it
+    auto segment = [px, py](T xa, T ya, T xb, T yb) {
+        double ax = static_cast<double>(xa) - px, ay = static_cast<double>(ya) - py;
+        double ex = static_cast<double>(xb) - static_cast<double>(xa), ey = static_cast<double>(yb) - static_cast<double>(ya);
+        double length2 = (ex * ex) + (ey * ey);
+        double t = length2 > 0 ? -((ax * ex) + (ay * ey)) / length2 : 0;
+        t = t < 0 ? 0 : (t > 1 ? 1 : t);
+        double dx = ax + (t * ex), dy = ay + (t * ey);
+        return (dx * dx) + (dy * dy);
+    };
+
+    double best[W];
+    for (size_t j = 0; j < W; j++)
+        best[j] = std::numeric_limits<double>::infinity();
+
+    size_t i = 0;
+    for (; i + W < n; i += W) {
+        for (size_t j = 0; j < W; j++) {
+            double d = segment(x[i + j], y[i + j], x[i + j + 1], y[i + j + 1]);
+            best[j] = d < best[j] ? d : best[j];
+        }
+    }
+
+    double nearest = segment(x[n - 1], y[n - 1], x[0], y[0]);
+    for (size_t j = 0; j < W; j++)
+        nearest = best[j] < nearest ? best[j] : nearest;
+    for (; i + 1 < n; i++) {
+        double d = segment(x[i], y[i], x[i + 1], y[i + 1]);
+        nearest = d < nearest ? d : nearest;
+    }
+    return nearest;
+}
+
+// Distance along a ray to the first edge it crosses, in lengths of its direction, and the index of that edge's
+// first vertex. Returns false if the ray crosses no edge. Rays running along an edge don't cross it.
+template <typename T>
+bool polygon_raycast(const T* x, const T* y, size_t n, double ox, double oy, double dx, double dy,
+                     double& t, size_t& edge) {
+    t = std::numeric_limits<double>::infinity();
+    for (size_t i = 0; i < n; i++) {
+        size_t j = i + 1 < n ? i + 1 : 0;
+        double ax = static_cast<double>(x[i]) - ox, ay = static_cast<double>(y[i]) - oy;
+        double ex = static_cast<double>(x[j]) - static_cast<double>(x[i]), ey = static_cast<double>(y[j]) - static_cast<double>(y[i]);
+        double denominator = (dx * ey) - (dy * ex);
+        if (denominator == 0)
+            continue;
+
+        // Solves origin + s * direction = a + u * edge
+        double s = ((ax * ey) - (ay * ex)) / denominator;
+        double u = ((ax * dy) - (ay * dx)) / denominator;
+        if (s >= 0 && u >= 0 && u <= 1 && s < t) {
+            t = s;
+            edge = i;
+        }
+    }
+    return t < std::numeric_limits<double>::infinity();
+}
+
+// 1 if c is left of the line a -> b, -1 if right, and 0 if the three are collinear.
+// The products are compared rather than subtracted, so a compiler fusing them into an FMA
+// can't make the same turn test differently depending on the order of its points.
+template <typename T>
+int _polygon_turn(const T* x, const T* y, size_t a, size_t b, size_t c) {
+    using Wide = polygon_wide_t<T>;
+    Wide left = (Wide(x[b]) - x[a]) * (Wide(y[c]) - y[a]);
+    Wide right = (Wide(y[b]) - y[a]) * (Wide(x[c]) - x[a]);
+    return (left > right) - (left < right);
+}
+
+template <typename T>
+polygon_wide_t<T> _polygon_distance2(const T* x, const T* y, size_t a, size_t b) {
+    using Wide = polygon_wide_t<T>;
+    Wide dx = Wide(x[b]) - x[a], dy = Wide(y[b]) - y[a];
+    return (dx * dx) + (dy * dy);
+}
+
+// Finds the convex hull of a simple polygon in linear time, with Melkman's algorithm.
+// Writes the indices of the hull's vertices to `hull`, counter-clockwise, without collinear vertices.
+// The vertices must form a simple polygon, or a simple polyline; arbitrary point sets need a general hull algorithm.
+template <typename T>
+void polygon_convex_hull(const T* x, const T* y, size_t n, std::vector<size_t>& hull) {
+    hull.clear();
+
+    // Start from the first vertex, the furthest vertex of the run collinear with it, and the next turn.
+    // A simple polygon can't double back along a line, so the furthest vertex of the run is its last one.
+    size_t a = 0, b = 1;
+    while (b < n && x[b] == x[a] && y[b] == y[a])
+        b++;
+    size_t c = b + 1;
+    for (; c < n && _polygon_turn(x, y, a, b, c) == 0; c++) {
+        if (_polygon_distance2(x, y, a, c) > _polygon_distance2(x, y, a, b))
+            b = c;
+    }
+
+    if (c >= n) {
+        // Every vertex is on one line
+        if (b < n)
+            hull = { a, b };
+        else if (n > 0)
+            hull = { a };
+        return;
+    }
+
+    // Deque of hull vertices, with the same vertex at both ends
+    std::vector<size_t> deque((2 * n) + 1);
+    size_t bottom = n, top = n + 3;
+    deque[bottom] = deque[top] = c;
+    if (_polygon_turn(x, y, a, b, c) > 0) {
+        deque[bottom + 1] = a;
+        deque[bottom + 2] = b;
+    } else {
+        deque[bottom + 1] = b;
+        deque[bottom + 2] = a;
+    }
+
+    for (size_t i = c + 1; i < n; i++) {
+        // Vertices inside the current hull are skipped
+        if (_polygon_turn(x, y, deque[bottom], deque[bottom + 1], i) > 0 &&
+            _polygon_turn(x, y, deque[top - 1], deque[top], i) > 0)
+            continue;
+
+        while (_polygon_turn(x, y, deque[bottom], deque[bottom + 1], i) <= 0)
+            bottom++;
+        deque[--bottom] = i;
+
+        while (_polygon_turn(x, y, deque[top - 1], deque[top], i) <= 0)
+            top--;
+        deque[++top] = i;
+    }
+
+    hull.assign(deque.begin() + static_cast<std::ptrdiff_t>(bottom), deque.begin() + static_cast<std::ptrdiff_t>(top));
+}
+
+// Finds the convex hull of any set of points, such as outlines that cross themselves, with Andrew's monotone chain.
+// Writes the same indices as polygon_convex_hull() would for a simple polygon, but takes O(n log n).
+template <typename T>
+void polygon_point_hull(const T* x, const T* y, size_t n, std::vector<size_t>& hull) {
+    hull.clear();
+    std::vector<size_t> order(n);
+    for (size_t i = 0; i < n; i++)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [x, y](size_t a, size_t b) {
+        return x[a] < x[b] || (x[a] == x[b] && y[a] < y[b]);
+    });
+
+    // Lower chain from left to right, then the upper chain back, both keeping only left turns
+    for (size_t i: order) {
+        while (hull.size() >= 2 && _polygon_turn(x, y, hull[hull.size() - 2], hull.back(), i) <= 0)
+            hull.pop_back();
+        hull.push_back(i);
+    }
+    size_t lower = hull.size() + 1;
+    for (size_t k = n - 1; k-- > 0;) {
+        size_t i = order[k];
+        while (hull.size() >= lower && _polygon_turn(x, y, hull[hull.size() - 2], hull.back(), i) <= 0)
+            hull.pop_back();
+        hull.push_back(i);
+    }
+
+    // The upper chain ends where the lower one started. Points that are all the same leave one vertex.
+    if (hull.size() > 1)
+        hull.pop_back();
+    if (hull.size() == 2 && x[hull[0]] == x[hull[1]] && y[hull[0]] == y[hull[1]])
+        hull.pop_back();
+}
+
+// True if every vertex is inside or on the convex polygon `hull`, given counter-clockwise.
+// Checks the result of polygon_convex_hull(), which can leave out vertices of a polygon that isn't simple.
+template <typename T>
+bool polygon_hull_contains_all(const T* x, const T* y, size_t n, const std::vector<size_t>& hull) {
+    using Wide = polygon_wide_t<T>;
+    size_t h = hull.size();
+    if (h == 0)
+        return n == 0;
+
+    size_t first = hull[0], last = hull[h - 1];
+    if (h < 3) {
+        // A point or a segment holds the points on its line that don't project past either end
+        Wide dx = Wide(x[last]) - x[first], dy = Wide(y[last]) - y[first];
+        for (size_t i = 0; i < n; i++) {
+            Wide along = ((Wide(x[i]) - x[first]) * dx) + ((Wide(y[i]) - y[first]) * dy);
+            if (_polygon_turn(x, y, first, last, i) != 0 || along < 0 || along > (dx * dx) + (dy * dy))
+                return false;
+            if (h == 1 && (x[i] != x[first] || y[i] != y[first]))
+                return false;
+        }
+        return true;
+    }
+
+    // The hull is split into a fan of wedges from its first vertex. Each point is placed in a wedge with the same
+    // products as _polygon_turn, from hull offsets gathered up front, and then tested against the wedge's outer edge.
+    std::vector<Wide> hx(h), hy(h);
+    for (size_t k = 0; k < h; k++) {
+        hx[k] = Wide(x[hull[k]]) - x[first];
+        hy[k] = Wide(y[hull[k]]) - y[first];
+    }
+
+    size_t wedge = 1;
+    for (size_t i = 0; i < n; i++) {
+        Wide qx = Wide(x[i]) - x[first], qy = Wide(y[i]) - y[first];
+        auto left = [&](size_t k) { return hx[k] * qy >= hy[k] * qx; };
+        if (!left(1) || (hx[h - 1] * qy > hy[h - 1] * qx))
+            return false;
+
+        // Neighbouring vertices of an outline are usually in the same or a nearby wedge, so the search walks
+        // from the last one, and only falls back to a binary search when that takes more than a few steps
+        for (int step = 0;; step++) {
+            bool down = !left(wedge);
+            bool up = wedge + 2 < h && left(wedge + 1);
+            if (!down && !up)
+                break;
+
+            if (step == 4) {
+                size_t low = 1, high = h - 1;
+                while (high - low > 1) {
+                    size_t middle = (low + high) / 2;
+                    if (left(middle))
+                        low = middle;
+                    else
+                        high = middle;
+                }
+                wedge = low;
+                break;
+            }
+            wedge = up ? wedge + 1 : wedge - 1;
+        }
+
+        if (_polygon_turn(x, y, hull[wedge], hull[wedge + 1], i) < 0)
+            return false;
+    }
+    return true;
+}
+
+// Simplifies a closed polygon with the Ramer-Douglas-Peucker algorithm.
+// Writes the indices of the vertices kept to `kept`, in order. Every dropped vertex is within `tolerance` of
+// the simplified outline. Large tolerances can leave fewer than 3 vertices.
+// Typically O(n log n), but outlines where nearly every vertex is kept approach O(n^2).
+template <typename T>
+void polygon_simplify(const T* x, const T* y, size_t n, double tolerance, std::vector<size_t>& kept) {
+    kept.clear();
+    if (n < 3) {
+        for (size_t i = 0; i < n; i++)
+            kept.push_back(i);
+        return;
+    }
+
+    // Squared distance from vertex i to the line through a and b, or to a if they are the same point
+    double limit = tolerance * tolerance;
+    auto farthest = [x, y](size_t a, size_t b, size_t first, size_t last) {
+        double ax = x[a], ay = y[a];
+        double dx = static_cast<double>(x[b]) - ax, dy = static_cast<double>(y[b]) - ay;
+        double length2 = (dx * dx) + (dy * dy);
+
+        double best = -1;
+        size_t index = first;
+        for (size_t i = first; i < last; i++) {
+            double px = static_cast<double>(x[i]) - ax, py = static_cast<double>(y[i]) - ay;
+            double cross = (dx * py) - (dy * px);
+            double distance2 = length2 > 0 ? (cross * cross) / length2 : (px * px) + (py * py);
+            if (distance2 > best) {
+                best = distance2;
+                index = i;
+            }
+        }
+        return std::pair<size_t, double>(index, best);
+    };
+
+    // Split the outline at the first vertex and the vertex furthest from it, then refine both halves.
+    // Index n stands for vertex 0 again, closing the outline.
+    std::vector<char> keep(n, 0);
+    size_t split = farthest(0, 0, 1, n).first;
+    keep[0] = keep[split] = 1;
+
+    std::vector<std::pair<size_t, size_t>> stack = { { 0, split }, { split, n } };
+    while (!stack.empty()) {
+        auto [a, b] = stack.back();
+        stack.pop_back();
+        if (b - a < 2)
+            continue;
+
+        auto [index, distance2] = farthest(a, b % n, a + 1, b);
+        if (distance2 > limit) {
+            keep[index] = 1;
+            stack.push_back({ a, index });
+            stack.push_back({ index, b });
+        }
+    }
+
+    for (size_t i = 0; i < n; i++)
+        if (keep[i])
+            kept.push_back(i);
+}
+
+
+
+// A simple polygon with any number of vertices.
+// The vertices are stored in local space, relative to the position, and are scaled by `scaling` and rotated
+// by the rotation around the position when they are read.
+template <typename T>
+class Polygon : public Shape2D<T> {
+public:
+    using Real = typename Shape2D<T>::Real;
+    using Wide = polygon_wide_t<T>;
+
+    // Data
+    VectorArray2<T> points; // Local vertices, in order around the outline
+    T scaling;              // Uniform scale applied to the local vertices
+
+
+
+    // Default constructor
+    Polygon()
+        : scaling(1) {}
+
+    // Local vertices constructor
+    Polygon(const std::vector<Vector2<T>>& points)
+        : points(points), scaling(1) {}
+    Polygon(VectorArray2<T> points)
+        : points(std::move(points)), scaling(1) {}
+
+    // Local vertices and position constructor
+    Polygon(const std::vector<Vector2<T>>& points, Vector2<T> position)
+        : Shape2D<T>(position), points(points), scaling(1) {}
+
+    // Local vertices, position, and rotation constructor
+    Polygon(const std::vector<Vector2<T>>& points, Vector2<T> position, Angle rotation)
+        : Shape2D<T>(position, rotation), points(points), scaling(1) {}
+
+    // Builds a polygon from vertices in world space.
+    // The centroid becomes the position, so the polygon rotates and scales around its center.
+    static Polygon fromVertices(std::span<const Vector2<T>> vertices) {
+        Polygon polygon;
+        polygon.points.resize(vertices.size());
+        for (size_t i = 0; i < vertices.size(); i++)
+            polygon.points.set(i, vertices[i]);
+
+        polygon._updateGeometry();
+        Vector2<Real> center = polygon.local_centroid;
+        Vector2<T> position(static_cast<T>(center.x), static_cast<T>(center.y));
+        polygon.points -= position;
+        polygon.position = position;
+        polygon.invalidate();
+        return polygon;
+    }
+
+    static Polygon fromVertices(const std::vector<Vector2<T>>& vertices) {
+        return fromVertices(std::span<const Vector2<T>>(vertices));
+    }
+
+
+
+    // Marks the cached bounds and geometry as stale.
+    // This must be called after writing to the points directly.
+    void invalidate() {
+        Shape2D<T>::invalidate();
+        geometry_dirty = true;
+        hull_dirty = true;
+    }
+
+
+
+    // Utility functions
+    // Area and perimeter don't depend on the position or rotation, so they are cached until the points change.
+    T area() override {
+        Shape2D<T>::flush();
+        _updateGeometry();
+        Real local = static_cast<Real>(moments.area2 < 0 ? -moments.area2 : moments.area2) / 2;
+        return static_cast<T>(local * scaling * scaling);
+    }
+
+    T perimeter() override {
+        Shape2D<T>::flush();
+        _updateGeometry();
+        return static_cast<T>(local_perimeter * (scaling < 0 ? -scaling : scaling));
+    }
+
+    // True if the local vertices run counter-clockwise
+    bool isCounterClockwise() {
+        _updateGeometry();
+        return moments.area2 > 0;
+    }
+
+    // Center of mass of the polygon's area, in world space
+    Vector2<T> centroid() {
+        Shape2D<T>::flush();
+        _updateGeometry();
+        if constexpr (std::is_integral_v<T>)
+            return _placement()(static_cast<T>(std::lround(local_centroid.x)), static_cast<T>(std::lround(local_centroid.y)));
+        else
+            return _placement()(local_centroid.x, local_centroid.y);
+    }
+
+    // True if every vertex is on the convex hull, without collinear vertices, in the order of the outline.
+    // Outlines that cross themselves can have every vertex on the hull, in a different order.
+    bool isConvex() override {
+        const std::vector<size_t>& h = _hull();
+        size_t n = points.size();
+        if (h.size() != n)
+            return false;
+
+        // The hull runs counter-clockwise, so the outline may run either way
+        size_t step = n > 1 && h[1] == (h[0] + 1) % n ? 1 : n - 1;
+        for (size_t k = 1; k < n; k++) {
+            if (h[k] != (h[k - 1] + step) % n)
+                return false;
+        }
+        return true;
+    }
+
+    // Point queries
+    // Make the base batch overloads visible next to the single point overrides
+    using Shape2D<T>::contains;
+    using Shape2D<T>::signedDistance;
+
+    // Tests whether a point in world space is inside the polygon.
+    // The point is moved into local space, instead of moving every vertex out of it.
+    bool contains(Vector2<T> point) override {
+        _prepareQueries();
+        return _contains(query_frame, point.x, point.y);
+    }
+
+    // Distance to the nearest edge, negative inside the polygon
+    T signedDistance(Vector2<T> point) override {
+        _prepareQueries();
+        return _signedDistance(query_frame, point.x, point.y);
+    }
+
+    // Returns the convex hull, with the same position, rotation and scaling
+    Polygon convexHull() {
+        Shape2D<T>::flush();
+        return _subset(_hull());
+    }
+
+    // Returns a polygon with the vertices that are within `tolerance` of the outline dropped.
+    // The tolerance is in world units, and the result has the same position, rotation and scaling.
+    Polygon simplified(T tolerance) {
+        Shape2D<T>::flush();
+        double scale = scaling < 0 ? -static_cast<double>(scaling) : static_cast<double>(scaling);
+
+        std::vector<size_t> kept;
+        polygon_simplify(points.x, points.y, points.size(), scale > 0 ? tolerance / scale : 0, kept);
+        return _subset(kept);
+    }
+
+
+    // Make the base overloads visible next to the output iterator overload
+    using Shape2D<T>::vertices;
+
+    size_t vertexCount() override { return points.size(); }
+
+    size_t vertices(std::span<Vector2<T>> out) override {
+        size_t count = out.size() < points.size() ? out.size() : points.size();
+        vertices(out.begin(), count);
+        return count;
+    }
+
+    // Renders the polygon through an output iterator and returns the iterator past the last vertex
+    template <std::output_iterator<Vector2<T>> OutputIt>
+    OutputIt vertices(OutputIt out) { return vertices(out, points.size()); }
+
+    // Renders only the first `count` vertices.
+    // Scaling, rotation and translation are applied together, in a single pass over the local lanes.
+    template <std::output_iterator<Vector2<T>> OutputIt>
+    OutputIt vertices(OutputIt out, size_t count) {
+        INSTRUMENT_SCOPE("Polygon::vertices");
+        Shape2D<T>::flush();
+        if (count > points.size())
+            count = points.size();
+
+        const T* x = points.x;
+        const T* y = points.y;
+        _Placement place = _placement();
+        for (size_t i = 0; i < count; i++, out++)
+            *out = place(x[i], y[i]);
+        return out;
+    }
+
+
+
+    // Computes the bounds from the convex hull, which holds every extreme vertex at any rotation
+    Bounds2D<T> computeBounds() override {
+        const std::vector<size_t>& hull = _hull();
+        if (hull.empty())
+            return Bounds2D<T>(Shape2D<T>::position, Shape2D<T>::position);
+
+        // Hull vertices are placed the same way vertices() places them
+        _Placement place = _placement();
+        Vector2<T> min = place(points.x[hull[0]], points.y[hull[0]]);
+        Vector2<T> max = min;
+        T reach = 0;
+        if constexpr (std::is_floating_point_v<T>)
+            reach = std::max(std::abs(points.x[hull[0]]), std::abs(points.y[hull[0]]));
+        for (size_t k = 1; k < hull.size(); k++) {
+            Vector2<T> v = place(points.x[hull[k]], points.y[hull[k]]);
+            if (v.x < min.x) min.x = v.x;
+            if (v.x > max.x) max.x = v.x;
+            if (v.y < min.y) min.y = v.y;
+            if (v.y > max.y) max.y = v.y;
+
+            if constexpr (std::is_floating_point_v<T>)
+                reach = std::max({ reach, std::abs(points.x[hull[k]]), std::abs(points.y[hull[k]]) });
+        }
+
+        // The vertices() loop may be vectorized with fused multiply-adds, which round differently,
+        // so floating-point bounds are widened by a few units in the last place of the terms involved
+        if constexpr (std::is_floating_point_v<T>) {
+            Vector2<T> p = Shape2D<T>::position;
+            T error = 4 * std::numeric_limits<T>::epsilon() * (2 * reach * std::abs(scaling));
+            min -= Vector2<T>(error + (4 * std::numeric_limits<T>::epsilon() * std::abs(p.x)),
+                              error + (4 * std::numeric_limits<T>::epsilon() * std::abs(p.y)));
+            max += Vector2<T>(error + (4 * std::numeric_limits<T>::epsilon() * std::abs(p.x)),
+                              error + (4 * std::numeric_limits<T>::epsilon() * std::abs(p.y)));
+        }
+        return Bounds2D<T>(min, max);
+    }
+
+
+    // Transformative functions
+    // Scaling only changes the factor applied when the vertices are read.
+    void scale(T scalar) override {
+        scaling *= scalar;
+        Shape2D<T>::invalidate();
+    }
+
+
+
+    // Serializers
+    std::string str() {
+        Shape2D<T>::flush();
+        std::string out;
+        str(out);
+        return out;
+    }
+
+    void str(std::string& out) const {
+        if (Shape2D<T>::hasPendingTransform())
+            return flushed(*this).str(out);
+
+        INSTRUMENT_SCOPE("Polygon::str");
+        INSTRUMENT_SERIALIZATION(out);
+
+        out += "Polygon { points: [";
+        for (size_t i = 0; i < points.size(); i++) {
+            if (i > 0)
+                out += ", ";
+            points.get(i).str(out);
+        }
+        out += "], scaling: ";
+        append_formatted(out, scaling);
+        out += ", ";
+        Shape2D<T>::str(out);
+        out += " }";
+    }
+
+    std::string json() {
+        Shape2D<T>::flush();
+        std::string out;
+        json(out);
+        return out;
+    }
+
+    void json(std::string& out) const {
+        if (Shape2D<T>::hasPendingTransform())
+            return flushed(*this).json(out);
+
+        INSTRUMENT_SCOPE("Polygon::json");
+        INSTRUMENT_SERIALIZATION(out);
+
+        out += "{\"points\":[";
+        for (size_t i = 0; i < points.size(); i++) {
+            if (i > 0)
+                out += ',';
+            points.get(i).json(out);
+        }
+        out += "],\"scaling\":";
+        append_formatted(out, scaling);
+        out += ',';
+        Shape2D<T>::json(out);
+        out += '}';
+    }
+
+
+
+    // Parsers
+    // Reads an object written by json(). Members may appear in any order.
+    bool parseJson(const char*& first, const char* last) {
+        invalidate();
+        return parse_json_object(first, last, [this](std::string_view key, const char*& f, const char* l) {
+            if (key == "points")
+                return _parsePoints(f, l);
+            if (key == "scaling")
+                return parse_formatted(f, l, scaling);
+            return Shape2D<T>::parseJsonField(key, f, l);
+        });
+    }
+
+    // Parses a whole JSON document, returning false if it is invalid
+    static bool fromJson(std::string_view json, Polygon& out) { return parse_json_document(json, out); }
+
+
+
+protected:
+    // Batch queries move every point with one shared frame, and read the cached geometry
+    void _containsPoints(const T* x, const T* y, size_t begin, size_t end, uint64_t* mask) override {
+        for (size_t word = begin; word < end; word += 64) {
+            uint64_t bits = 0;
+            for (size_t j = 0; j < 64 && word + j < end; j++)
+                bits |= static_cast<uint64_t>(_contains(query_frame, x[word + j], y[word + j])) << j;
+            mask[word / 64] = bits;
+        }
+    }
+
+    void _signedDistances(const T* x, const T* y, size_t begin, size_t end, T* out) override {
+        for (size_t i = begin; i < end; i++)
+            out[i] = _signedDistance(query_frame, x[i], y[i]);
+    }
+
+    // Rays are moved into local space like points, and cast at every edge
+    void _raycastPacket(RayPacket<Real>& packet, uint32_t id) override {
+        size_t n = points.size();
+        if (scaling == 0 || n < 3)
+            return;
+
+        const QueryFrame<double>& frame = query_frame;
+        double scale = static_cast<double>(scaling);
+        for (size_t i = 0; i < packet.count; i++) {
+            Vector2<double> o = frame.local(packet.ox[i], packet.oy[i]) / scale;
+            Vector2<double> d = frame.localDirection(packet.dx[i], packet.dy[i]) / scale;
+
+            bool in_bounds = o.x >= local_min.x && o.x <= local_max.x && o.y >= local_min.y && o.y <= local_max.y;
+            if (in_bounds && polygon_contains(points.x, points.y, n, o.x, o.y)) {
+                packet.accept(i, 0, Vector2<Real>(), id);
+                continue;
+            }
+
+            double t;
+            size_t edge = 0;
+            if (!polygon_raycast(points.x, points.y, n, o.x, o.y, d.x, d.y, t, edge))
+                continue;
+
+            // The edge's normal, turned to face the ray in world space
+            size_t next = edge + 1 < n ? edge + 1 : 0;
+            double ex = static_cast<double>(points.x[next]) - static_cast<double>(points.x[edge]);
+            double ey = static_cast<double>(points.y[next]) - static_cast<double>(points.y[edge]);
+            double length = std::sqrt((ex * ex) + (ey * ey));
+            Vector2<double> normal = frame.worldDirection(ey / length, -ex / length);
+            if ((normal.x * packet.dx[i]) + (normal.y * packet.dy[i]) > 0)
+                normal *= -1.0;
+            packet.accept(i, static_cast<Real>(t), Vector2<Real>(static_cast<Real>(normal.x), static_cast<Real>(normal.y)), id);
+        }
+    }
+
+    // The outline is filled with the even-odd rule from the edge table built by _prepareRaster()
+    void _rasterize(RasterTile<Real>& tile) override { raster_outline(tile, raster_edges); }
+
+    // Integer polygons round the scaling factor, the same as the sizes of the other integer shapes
+    void _scaleBy(Real factor) override { scaling = Shape2D<T>::_fromReal(static_cast<Real>(scaling) * factor); }
+
+    // The frame's trig is evaluated once here, rather than for every range or packet the kernels run on
+    void _prepareQueries() override {
+        Shape2D<T>::flush();
+        _updateGeometry();
+        query_frame = _localFrame();
+    }
+
+    // The outline is placed in world space once for the whole grid, then its edges are bucketed by row
+    void _prepareRaster(const RasterGrid<Real>& grid) override {
+        _prepareQueries();
+        size_t n = points.size();
+        raster_edges.outline.clear();
+        if (scaling != 0 && n >= 3) {
+            const QueryFrame<double>& frame = query_frame;
+            double scale = static_cast<double>(scaling);
+            raster_edges.outline.resize(n);
+            for (size_t i = 0; i < n; i++) {
+                Vector2<double> p = frame.worldDirection(points.x[i] * scale, points.y[i] * scale);
+                raster_edges.outline[i] = Vector2<Real>(static_cast<Real>(p.x + frame.px), static_cast<Real>(p.y + frame.py));
+            }
+        }
+        raster_edges.build(grid);
+    }
+
+
+
+private:
+    PolygonMoments<T> moments;
+    Vector2<Real> local_centroid;
+    Vector2<double> local_min, local_max; // Bounds of the local vertices
+    double local_perimeter = 0;
+    bool geometry_dirty = true;
+
+    std::vector<size_t> hull;
+    bool hull_dirty = true;
+
+    // Frame of the queries, kept since _prepareQueries()
+    QueryFrame<double> query_frame;
+
+    // World-space edges of the outline, rebuilt for every grid it's drawn into
+    RasterEdgeTable<Real> raster_edges;
+
+    // Computes the cached area, perimeter, local centroid and local bounds.
+    // Polygons without area use the average vertex as their centroid.
+    void _updateGeometry() {
+        if (!geometry_dirty)
+            return;
+
+        size_t n = points.size();
+        moments = polygon_moments(points.x, points.y, n);
+        local_perimeter = polygon_perimeter(points.x, points.y, n);
+
+        if (n > 0) {
+            auto [min_x, max_x] = std::minmax_element(points.x, points.x + n);
+            auto [min_y, max_y] = std::minmax_element(points.y, points.y + n);
+            local_min = Vector2<double>(*min_x, *min_y);
+            local_max = Vector2<double>(*max_x, *max_y);
+        } else {
+            local_min = local_max = Vector2<double>();
+        }
+
+        if (moments.area2 != 0) {
+            double area3 = 3 * static_cast<double>(moments.area2);
+            local_centroid = Vector2<Real>(static_cast<Real>(moments.cx / area3), static_cast<Real>(moments.cy / area3));
+        } else {
+            double sx = 0, sy = 0;
+            for (size_t i = 0; i < n; i++) {
+                sx += points.x[i];
+                sy += points.y[i];
+            }
+            local_centroid = n > 0 ? Vector2<Real>(static_cast<Real>(sx / n), static_cast<Real>(sy / n)) : Vector2<Real>();
+        }
+        geometry_dirty = false;
+    }
+
+    // The linear hull of a simple polygon is checked against every vertex, which also holds for outlines that
+    // cross themselves. When it leaves some out, the hull is found again with the general algorithm.
+    const std::vector<size_t>& _hull() {
+        if (hull_dirty) {
+            polygon_convex_hull(points.x, points.y, points.size(), hull);
+            if (!polygon_hull_contains_all(points.x, points.y, points.size(), hull))
+                polygon_point_hull(points.x, points.y, points.size(), hull);
+            hull_dirty = false;
+        }
+        return hull;
+    }
+
+    // Moves local vertices to world space: scaled, rotated around the position, then offset by it.
+    // Integer polygons rotate in fixed-point, the same as the other integer shapes.
+    struct _Placement {
+        Vector2<T> position;
+        T scaling;
+        Real rc = 0, rs = 0; // Cosine and sine of the rotation, multiplied by the scaling
+        FixedRotation fixed;
+
+        Vector2<T> operator()(T lx, T ly) const {
+            if constexpr (std::is_integral_v<T>)
+                return rotate_point(Vector2<T>(lx * scaling, ly * scaling), Vector2<T>(0, 0), fixed) + position;
+            else
+                return Vector2<T>(position.x + ((lx * rc) - (ly * rs)), position.y + ((lx * rs) + (ly * rc)));
+        }
+    };
+
+    _Placement _placement() const {
+        _Placement place { Shape2D<T>::position, scaling, 0, 0, FixedRotation() };
+        if constexpr (std::is_integral_v<T>) {
+            place.fixed = fixed_rotation(Shape2D<T>::rotation);
+        } else {
+            INSTRUMENT_COUNT(TrigEvaluations, 2);
+            Real radians = to_radians<Real>(Shape2D<T>::rotation);
+            place.rc = cos(radians) * scaling;
+            place.rs = sin(radians) * scaling;
+        }
+        return place;
+    }
+
+    // Frame moving world points to local space, before dividing by the scaling
+    QueryFrame<double> _localFrame() const {
+        INSTRUMENT_COUNT(TrigEvaluations, 2);
+        double radians = to_radians<double>(Shape2D<T>::rotation);
+        QueryFrame<double> frame;
+        frame.px = static_cast<double>(Shape2D<T>::position.x);
+        frame.py = static_cast<double>(Shape2D<T>::position.y);
+        frame.c = std::cos(radians);
+        frame.s = std::sin(radians);
+        return frame;
+    }
+
+    bool _contains(const QueryFrame<double>& frame, T x, T y) const {
+        if (scaling == 0)
+            return false;
+
+        Vector2<double> p = frame.local(static_cast<double>(x), static_cast<double>(y)) / static_cast<double>(scaling);
+
+        // Points outside the local bounds can't be inside, and skip the pass over every edge
+        if (p.x < local_min.x || p.x > local_max.x || p.y < local_min.y || p.y > local_max.y)
+            return false;
+        return polygon_contains(points.x, points.y, points.size(), p.x, p.y);
+    }
+
+    T _signedDistance(const QueryFrame<double>& frame, T x, T y) const {
+        Vector2<double> p = frame.local(static_cast<double>(x), static_cast<double>(y));
+        double scale = std::abs(static_cast<double>(scaling));
+        if (scale == 0)
+            return _query_result<T>(std::sqrt((p.x * p.x) + (p.y * p.y)));
+
+        p /= static_cast<double>(scaling);
+        double distance = std::sqrt(polygon_distance2(points.x, points.y, points.size(), p.x, p.y)) * scale;
+        bool inside = polygon_contains(points.x, points.y, points.size(), p.x, p.y);
+        return _query_result<T>(inside ? -distance : distance);
+    }
+
+    // Builds a polygon from some of the local vertices, keeping the transform
+    Polygon _subset(const std::vector<size_t>& indices) const {
+        Polygon out;
+        out.points.resize(indices.size());
+        for (size_t i = 0; i < indices.size(); i++)
+            out.points.set(i, points.get(indices[i]));
+
+        out.position = Shape2D<T>::position;
+        out.rotation = Shape2D<T>::rotation;
+        out.scaling = scaling;
+        return out;
+    }
+
+    bool _parsePoints(const char*& first, const char* last) {
+        points.clear();
+        if (!expect_json(first, last, '['))
+            return false;
+
+        skip_json_whitespace(first, last);
+        if (first != last && *first == ']') {
+            first++;
+            return true;
+        }
+
+        while (true) {
+            Vector2<T> point;
+            if (!point.parseJson(first, last))
+                return false;
+            points.push_back(point);
+
+            skip_json_whitespace(first, last);
+            if (first == last)
+                return false;
+            if (*first == ']') {
+                first++;
+                return true;
+            }
+            if (*first++ != ',')
+                return false;
+        }
+    }
+};
@@ -0,0 +1,195 @@
+/// Author: PlumpDolphin
+/// Date: October 16, 2026
+///
+/// Description:
+///     Provides the Rasterizer, which draws collections of shapes into caller-owned grids: 8-bit cells holding
+///     occupancy or anti-aliased coverage, or bit-packed occupancy, such as the cost maps used by path planners.
+///
+///     The grid is split into tiles of 64 x 64 cells. Shapes are first binned into every tile their bounds
+///     overlap, then tiles are drawn independently, possibly in parallel, each from its own list of shapes.
+///     A tile is only ever written by one thread, and overlapping shapes combine by keeping the largest value,
+///     so the result is the same for any number of threads.
+///
+/// License:
+///     The code in this file is licensed under the
+///     Revised 3-Clause BSD License.
+///     For details, see https://opensource.org/licenses/BSD-3-Clause
+
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "shapes.h" // Includes definitions for Shape2D, the executor and the scanline spans of every shape.
+
+
+
+// Example usage showing an occupancy grid for path planning.
+/*
+    std::vector<Shape2D<float>*> obstacles = ...;
+
+    // 1024 x 1024 cells of half a unit, covering [-256, 256) on both axes
+    RasterGrid<float> grid { Vector2<float>(-256, -256), 0.5f, 1024, 1024 };
+    std::vector<uint64_t> blocked(grid.wordCount());
+
+    // Grids are overwritten on every call, and the binning buffers are kept, so redrawing doesn't allocate
+    Rasterizer<float> rasterizer;
+    rasterizer.rasterize(obstacles, grid, blocked, executor);
+
+    // Smooth coverage for display, or for costs that fall off at the edges of obstacles
+    std::vector<uint8_t> coverage(grid.cellCount());
+    rasterizer.rasterize(obstacles, grid, coverage, executor, RasterMode::Coverage);
+*/
+
+
+
+// Draws shapes into grids, replacing their previous contents.
+// Functions return false, without writing anything, if the target is smaller than the grid or the cell size isn't positive.
+// Grids without cells have nothing to draw, so they succeed without touching the shapes.
+template <typename T>
+class Rasterizer {
+public:
+    using Real = typename Shape2D<T>::Real;
+
+
+
+    // Draws the shapes into 8-bit cells, grid.width per row
+    bool rasterize(std::span<Shape2D<T>* const> shapes, const RasterGrid<Real>& grid, std::span<uint8_t> cells,
+                   RasterMode mode = RasterMode::Occupancy) {
+        INSTRUMENT_SCOPE("Rasterizer::rasterize");
+        if (cells.size() < grid.cellCount() || !_bin(shapes, grid))
+            return false;
+        _draw(shapes, grid, mode, cells.data(), nullptr, 0, tile_start.size() - 1);
+        return true;
+    }
+
+    // Same as above, split over an executor in whole tiles
+    bool rasterize(std::span<Shape2D<T>* const> shapes, const RasterGrid<Real>& grid, std::span<uint8_t> cells,
+                   Executor& executor, RasterMode mode = RasterMode::Occupancy) {
+        INSTRUMENT_SCOPE("Rasterizer::rasterize");
+        if (cells.size() < grid.cellCount() || !_bin(shapes, grid))
+            return false;
+        parallel_for(executor, 0, tile_start.size() - 1, [&](size_t begin, size_t end) {
+            _draw(shapes, grid, mode, cells.data(), nullptr, begin, end);
+        });
+        return true;
+    }
+
+    // Draws the occupancy of the shapes into bit-packed rows of grid.wordsPerRow() words.
+    // Bit column % 64 of word column / 64 of a row is set when the cell's center is inside a shape.
+    bool rasterize(std::span<Shape2D<T>* const> shapes, const RasterGrid<Real>& grid, std::span<uint64_t> bits) {
+        INSTRUMENT_SCOPE("Rasterizer::rasterize");
+        if (bits.size() < grid.wordCount() || !_bin(shapes, grid))
+            return false;
+        _draw(shapes, grid, RasterMode::Occupancy, nullptr, bits.data(), 0, tile_start.size() - 1);
+        return true;
+    }
+
+    // Same as above, split over an executor in whole tiles
+    bool rasterize(std::span<Shape2D<T>* const> shapes, const RasterGrid<Real>& grid, std::span<uint64_t> bits,
+                   Executor& executor) {
+        INSTRUMENT_SCOPE("Rasterizer::rasterize");
+        if (bits.size() < grid.wordCount() || !_bin(shapes, grid))
+            return false;
+        parallel_for(executor, 0, tile_start.size() - 1, [&](size_t begin, size_t end) {
+            _draw(shapes, grid, RasterMode::Occupancy, nullptr, bits.data(), begin, end);
+        });
+        return true;
+    }
+
+
+
+private:
+    // Shapes binned by tile, with the shapes of tile i at tile_shapes[tile_start[i], tile_start[i + 1])
+    size_t tiles_x = 0;
+    std::vector<uint32_t> tile_start;
+    std::vector<uint32_t> tile_shapes;
+
+    // Tiles overlapped by every shape, as [x_begin, x_end) x [y_begin, y_end), empty for shapes off the grid
+    struct _TileRange {
+        uint32_t x_begin = 0, x_end = 0, y_begin = 0, y_end = 0;
+    };
+    std::vector<_TileRange> ranges;
+
+    // Tiles along an axis overlapped by [low, high], for cells of size `cell` starting at `origin`
+    static void _tiles(Real low, Real high, Real origin, Real cell, size_t cells, uint32_t& begin, uint32_t& end) {
+        Real first = std::floor((low - origin) / cell), last = std::floor((high - origin) / cell);
+        begin = end = 0;
+        if (!(first <= last) || last < 0 || first >= static_cast<Real>(cells))
+            return;
+
+        size_t first_cell = first > 0 ? static_cast<size_t>(first) : 0;
+        size_t last_cell = last < static_cast<Real>(cells - 1) ? static_cast<size_t>(last) : cells - 1;
+        begin = static_cast<uint32_t>(first_cell / raster_tile_size);
+        end = static_cast<uint32_t>((last_cell / raster_tile_size) + 1);
+    }
+
+    // Brings every shape up to date for the grid, then bins it into the tiles its bounds overlap, counting them first
+    // so every list is written once into one buffer
+    bool _bin(std::span<Shape2D<T>* const> shapes, const RasterGrid<Real>& grid) {
+        if (!(grid.cell > 0))
+            return false;
+
+        tiles_x = (grid.width + raster_tile_size - 1) / raster_tile_size;
+        size_t tiles_y = (grid.height + raster_tile_size - 1) / raster_tile_size;
+        tile_start.assign((tiles_x * tiles_y) + 1, 0);
+        if (tiles_x * tiles_y == 0) {
+            tile_shapes.clear();
+            return true;
+        }
+        ranges.resize(shapes.size());
+
+        for (size_t i = 0; i < shapes.size(); i++) {
+            shapes[i]->_prepareRaster(grid);
+            Bounds2D<T> box = shapes[i]->bounds();
+            _TileRange& range = ranges[i];
+            _tiles(static_cast<Real>(box.min.x), static_cast<Real>(box.max.x), grid.origin.x, grid.cell, grid.width,
+                   range.x_begin, range.x_end);
+            _tiles(static_cast<Real>(box.min.y), static_cast<Real>(box.max.y), grid.origin.y, grid.cell, grid.height,
+                   range.y_begin, range.y_end);
+
+            for (uint32_t y = range.y_begin; y < range.y_end; y++)
+                for (uint32_t x = range.x_begin; x < range.x_end; x++)
+                    tile_start[(y * tiles_x) + x + 1]++;
+        }
+
+        for (size_t i = 1; i < tile_start.size(); i++)
+            tile_start[i] += tile_start[i - 1];
+
+        // Shapes are written in order, so every tile draws them in order
+        tile_shapes.resize(tile_start.back());
+        for (size_t i = 0; i < shapes.size(); i++) {
+            const _TileRange& range = ranges[i];
+            for (uint32_t y = range.y_begin; y < range.y_end; y++)
+                for (uint32_t x = range.x_begin; x < range.x_end; x++)
+                    tile_shapes[tile_start[(y * tiles_x) + x]++] = static_cast<uint32_t>(i);
+        }
+
+        // Filling moved every start to the next tile's, so shift them back
+        for (size_t i = tile_start.size() - 1; i > 0; i--)
+            tile_start[i] = tile_start[i - 1];
+        tile_start[0] = 0;
+        return true;
+    }
+
+    // Clears and draws tiles [begin, end)
+    void _draw(std::span<Shape2D<T>* const> shapes, const RasterGrid<Real>& grid, RasterMode mode,
+               uint8_t* cells, uint64_t* bits, size_t begin, size_t end) const {
+        RasterTile<Real> tile;
+        tile.grid = grid;
+        tile.mode = mode;
+        tile.cells = cells;
+        tile.bits = bits;
+
+        for (size_t i = begin; i < end; i++) {
+            tile.place((i % tiles_x) * raster_tile_size, (i / tiles_x) * raster_tile_size);
+            tile.clear();
+            for (uint32_t k = tile_start[i]; k < tile_start[i + 1]; k++)
+                shapes[tile_shapes[k]]->_rasterize(tile);
+        }
+    }
+};
@@ -0,0 +1,432 @@
+/// Author: PlumpDolphin
+/// Date: October 16, 2026
+///
+/// Description:
+///     Provides the scanline spans used to rasterize shapes into grids of cells.
+///     Every shape type gives its span on a horizontal line analytically: a circle from its radius, and
+///     rectangles and N-Gons from their exact corners, without rendering an outline through vertices().
+///     Polygons are filled from their edge crossings with the even-odd rule, through an edge table built once
+///     per grid that buckets the edges by the rows they cross.
+///
+///     Spans are drawn into one tile of the grid at a time, either as occupancy, where a cell is covered
+///     when its center is inside a shape, or as anti-aliased coverage, where a cell holds the fraction of
+///     it covered by the shape, measured exactly along each row at a few heights within the cell.
+///
+/// License:
+///     The code in this file is licensed under the
+///     Revised 3-Clause BSD License.
+///     For details, see https://opensource.org/licenses/BSD-3-Clause
+
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "pointquery.h" // Includes QueryFrame and the local shape descriptions that spans are computed from.
+
+
+
+// Example usage showing a grid drawn through the Rasterizer of raster.h, which splits it into tiles.
+/*
+    // A 4096 x 4096 grid of 0.25 unit cells, with cell (0, 0) at the origin
+    RasterGrid<float> grid { Vector2<float>(0, 0), 0.25f, 4096, 4096 };
+
+    std::vector<uint8_t> coverage(grid.cellCount());
+    rasterizer.rasterize(scene, grid, coverage, RasterMode::Coverage);
+
+    std::vector<uint64_t> occupancy(grid.wordCount());
+    rasterizer.rasterize(scene, grid, occupancy, executor);
+    bool blocked = (occupancy[(row * grid.wordsPerRow()) + (column / 64)] >> (column % 64)) & 1;
+*/
+
+
+
+// How shapes are written into 8-bit cells.
+// Occupancy writes 255 into every cell whose center is inside a shape, and Coverage writes the fraction of
+// every cell covered by a shape, from 0 to 255. Overlapping shapes keep the largest value, so the result
+// doesn't depend on the order shapes are drawn in. Bit-packed grids always hold occupancy.
+enum class RasterMode {
+    Occupancy,
+    Coverage
+};
+
+// Width and height of a tile in cells. Tiles are one 64-bit word wide, so no two tiles share a word.
+constexpr size_t raster_tile_size = 64;
+
+// Number of lines sampled within every row of cells for coverage
+constexpr size_t raster_coverage_lines = 4;
+
+// Number of 64-bit words in a row of a bit-packed grid
+constexpr size_t raster_words_per_row(size_t width) { return (width + 63) / 64; }
+
+// Placement of a grid of cells in world space.
+// Cell (column, row) covers [origin.x + column * cell, origin.x + (column + 1) * cell) along x, and the same along y.
+// Cells are stored row by row, in `width` bytes or raster_words_per_row(width) words per row.
+template <typename Real>
+struct RasterGrid {
+    Vector2<Real> origin;
+    Real cell = 1;
+    size_t width = 0, height = 0;
+
+    size_t cellCount() const { return width * height; }
+    size_t wordsPerRow() const { return raster_words_per_row(width); }
+    size_t wordCount() const { return wordsPerRow() * height; }
+};
+
+
+
+// A tile of a grid, which shapes draw their spans into.
+// Only one thread draws into a tile at a time, and its scratch space is kept from one tile to the next.
+template <typename Real>
+struct RasterTile {
+    RasterGrid<Real> grid;
+    RasterMode mode = RasterMode::Occupancy;
+
+    // Cells [column_begin, column_end) of rows [row_begin, row_end)
+    size_t column_begin = 0, column_end = 0;
+    size_t row_begin = 0, row_end = 0;
+
+    // Target grid, either 8-bit cells or bit-packed occupancy
+    uint8_t* cells = nullptr;
+    uint64_t* bits = nullptr;
+
+    // Scratch space for the vertices, edge crossings and active edges of a shape
+    std::vector<Vector2<Real>> outline;
+    std::vector<Real> crossings;
+    std::vector<uint32_t> active;
+
+    // Moves the tile over a new region of the target grid
+    void place(size_t column, size_t row) {
+        column_begin = column;
+        column_end = std::min(column + raster_tile_size, grid.width);
+        row_begin = row;
+        row_end = std::min(row + raster_tile_size, grid.height);
+        inverse = 1 / grid.cell;
+        std::fill(coverage, coverage + raster_tile_size, Real(0));
+    }
+
+    // Empties every cell of the tile
+    void clear() {
+        for (size_t row = row_begin; row < row_end; row++) {
+            if (bits != nullptr)
+                bits[(row * grid.wordsPerRow()) + (column_begin / 64)] = 0;
+            else
+                std::memset(cells + (row * grid.width) + column_begin, 0, column_end - column_begin);
+        }
+    }
+
+    // Draws a shape spanning [y_min, y_max], whose spans on the line at height y are given by spans(y, emit),
+    // which calls emit(x_begin, x_end) once for every span.
+    template <typename Spans>
+    void draw(Real y_min, Real y_max, Spans spans) {
+        Real first = std::floor((y_min - grid.origin.y) * inverse);
+        Real last = std::floor((y_max - grid.origin.y) * inverse);
+        first = first > static_cast<Real>(row_begin) ? first : static_cast<Real>(row_begin);
+        last = last < static_cast<Real>(row_end) - 1 ? last : static_cast<Real>(row_end) - 1;
+        if (!(first <= last))
+            return;
+
+        for (size_t row = static_cast<size_t>(first); row <= static_cast<size_t>(last); row++) {
+            Real low = grid.origin.y + (static_cast<Real>(row) * grid.cell);
+            if (mode == RasterMode::Occupancy) {
+                spans(low + (grid.cell / 2), [&](Real x_begin, Real x_end) { _fill(row, x_begin, x_end); });
+                continue;
+            }
+
+            size_t touched_begin = raster_tile_size, touched_end = 0;
+            for (size_t line = 0; line < raster_coverage_lines; line++) {
+                Real y = low + ((static_cast<Real>(line) + Real(0.5)) * grid.cell / raster_coverage_lines);
+                spans(y, [&](Real x_begin, Real x_end) { _accumulate(x_begin, x_end, touched_begin, touched_end); });
+            }
+            _resolve(row, touched_begin, touched_end);
+        }
+    }
+
+private:
+    Real inverse = 1;
+
+    // Coverage of the cells of the current row, in lines
+    Real coverage[raster_tile_size];
+
+    // Covers the cells whose centers are within [x_begin, x_end]
+    void _fill(size_t row, Real x_begin, Real x_end) {
+        Real first = std::ceil(((x_begin - grid.origin.x) * inverse) - Real(0.5));
+        Real last = std::floor(((x_end - grid.origin.x) * inverse) - Real(0.5));
+        first = first > static_cast<Real>(column_begin) ? first : static_cast<Real>(column_begin);
+        last = last < static_cast<Real>(column_end) - 1 ? last : static_cast<Real>(column_end) - 1;
+        if (!(first <= last))
+            return;
+
+        size_t begin = static_cast<size_t>(first), end = static_cast<size_t>(last) + 1;
+        if (bits != nullptr) {
+            uint64_t span = ~uint64_t(0) >> (64 - (end - begin));
+            bits[(row * grid.wordsPerRow()) + (column_begin / 64)] |= span << (begin - column_begin);
+        } else {
+            std::memset(cells + (row * grid.width) + begin, 255, end - begin);
+        }
+    }
+
+    // Adds the length of [x_begin, x_end] within every cell of the row, in cells
+    void _accumulate(Real x_begin, Real x_end, size_t& touched_begin, size_t& touched_end) {
+        const Real width = static_cast<Real>(column_end - column_begin);
+        Real u0 = ((x_begin - grid.origin.x) * inverse) - static_cast<Real>(column_begin);
+        Real u1 = ((x_end - grid.origin.x) * inverse) - static_cast<Real>(column_begin);
+        u0 = u0 > 0 ? u0 : 0;
+        u1 = u1 < width ? u1 : width;
+        if (!(u0 < u1))
+            return;
+
+        size_t first = static_cast<size_t>(u0), last = static_cast<size_t>(u1);
+        if (first == last) {
+            coverage[first] += u1 - u0;
+        } else {
+            coverage[first] += static_cast<Real>(first + 1) - u0;
+            for (size_t i = first + 1; i < last; i++)
+                coverage[i] += 1;
+            if (last < column_end - column_begin)
+                coverage[last] += u1 - static_cast<Real>(last);
+        }
+
+        touched_begin = first < touched_begin ? first : touched_begin;
+        touched_end = last + 1 > touched_end ? last + 1 : touched_end;
+        touched_end = touched_end < column_end - column_begin ? touched_end : column_end - column_begin;
+    }
+
+    // Writes the accumulated coverage of the row, keeping the larger of it and what the cells already hold
+    void _resolve(size_t row, size_t touched_begin, size_t touched_end) {
+        uint8_t* out = cells + (row * grid.width) + column_begin;
+        for (size_t i = touched_begin; i < touched_end; i++) {
+            Real value = (coverage[i] * (Real(255) / raster_coverage_lines)) + Real(0.5);
+            uint8_t level = value >= 255 ? 255 : static_cast<uint8_t>(value);
+            out[i] = level > out[i] ? level : out[i];
+            coverage[i] = 0;
+        }
+    }
+};
+
+
+
+// Span kernels
+// Each draws one shape, in world space, into a tile.
+
+template <typename Real>
+void raster_circle(RasterTile<Real>& tile, Real cx, Real cy, Real radius) {
+    tile.draw(cy - radius, cy + radius, [&](Real y, auto emit) {
+        Real dy = y - cy;
+        Real half2 = (radius * radius) - (dy * dy);
+        if (half2 >= 0) {
+            Real half = std::sqrt(half2);
+            emit(cx - half, cx + half);
+        }
+    });
+}
+
+// Any convex outline, in either winding, has one span per line, between its leftmost and rightmost crossings
+template <typename Real>
+void raster_convex(RasterTile<Real>& tile, const Vector2<Real>* vertices, size_t n) {
+    if (n < 3)
+        return;
+
+    Real y_min = vertices[0].y, y_max = vertices[0].y;
+    for (size_t i = 1; i < n; i++) {
+        y_min = vertices[i].y < y_min ? vertices[i].y : y_min;
+        y_max = vertices[i].y > y_max ? vertices[i].y : y_max;
+    }
+
+    tile.draw(y_min, y_max, [&](Real y, auto emit) {
+        Real left = std::numeric_limits<Real>::infinity(), right = -std::numeric_limits<Real>::infinity();
+        for (size_t i = 0, j = n - 1; i < n; j = i++) {
+            const Vector2<Real>& a = vertices[j];
+            const Vector2<Real>& b = vertices[i];
+            if ((a.y < y && b.y < y) || (a.y > y && b.y > y))
+                continue;
+
+            // Edges along the line cover it from end to end
+            Real x0 = a.x, x1 = b.x;
+            if (a.y != b.y)
+                x0 = x1 = a.x + ((y - a.y) * (b.x - a.x) / (b.y - a.y));
+            left = std::min({ left, x0, x1 });
+            right = std::max({ right, x0, x1 });
+        }
+        if (left <= right)
+            emit(left, right);
+    });
+}
+
+// Edges of an outline in world space, bucketed by the rows of the grid they cross.
+// Built once before a shape is drawn, then only read, so any number of tiles can be drawn from it at once.
+// Edges are listed once for every band of raster_tile_size rows they cross, in order of the row their lower end
+// is in, so every line only visits the edges crossing it instead of the whole outline.
+template <typename Real>
+struct RasterEdgeTable {
+    // Edge from its lower end (x, y_low) up to y_high, crossing the line at height y at x + (y - y_low) * slope
+    struct Edge {
+        Real x, y_low, y_high, slope;
+        uint32_t row; // Row of the lower end within the band, 0 for edges starting below it
+    };
+
+    // World-space vertices the edges are built from, filled in by the shape
+    std::vector<Vector2<Real>> outline;
+
+    Real y_min = 0, y_max = 0;
+    size_t band_begin = 0; // First band of rows with edges
+
+    // Edges of band band_begin + i at edges[band_start[i], band_start[i + 1]), empty when no edge is on the grid
+    std::vector<uint32_t> band_start;
+    std::vector<Edge> edges;
+
+    // Buckets the edges of the outline for a grid, counting them first so every list is written once into one buffer
+    void build(const RasterGrid<Real>& grid) {
+        band_start.clear();
+        edges.clear();
+        size_t n = outline.size();
+        if (n < 3 || grid.height == 0 || !(grid.cell > 0))
+            return;
+
+        const Real inverse = 1 / grid.cell;
+        const Real rows = static_cast<Real>(grid.height);
+        y_min = y_max = outline[0].y;
+        for (size_t i = 1; i < n; i++) {
+            y_min = outline[i].y < y_min ? outline[i].y : y_min;
+            y_max = outline[i].y > y_max ? outline[i].y : y_max;
+        }
+
+        // Rows [first, last] of the grid an edge crosses, false for edges along a line or off the grid
+        auto span = [&](const Vector2<Real>& a, const Vector2<Real>& b, size_t& first, size_t& last) {
+            if (a.y == b.y)
+                return false;
+            Real low = std::floor(((a.y < b.y ? a.y : b.y) - grid.origin.y) * inverse);
+            Real high = std::floor(((a.y < b.y ? b.y : a.y) - grid.origin.y) * inverse);
+            if (!(low <= high) || high < 0 || low >= rows)
+                return false;
+            first = low > 0 ? static_cast<size_t>(low) : 0;
+            last = high < rows - 1 ? static_cast<size_t>(high) : grid.height - 1;
+            return true;
+        };
+
+        size_t row_min = std::numeric_limits<size_t>::max(), row_max = 0, first, last;
+        for (size_t i = 0, j = n - 1; i < n; j = i++) {
+            if (span(outline[j], outline[i], first, last)) {
+                row_min = first < row_min ? first : row_min;
+                row_max = last > row_max ? last : row_max;
+            }
+        }
+        if (row_min > row_max)
+            return;
+
+        // Edges are counted by band and starting row, so the prefix sums place them in order within every band
+        band_begin = row_min / raster_tile_size;
+        size_t bands = (row_max / raster_tile_size) + 1 - band_begin;
+        std::vector<uint32_t> start((bands * raster_tile_size) + 1, 0);
+        auto key = [&](size_t band, size_t row) {
+            size_t low = (band_begin + band) * raster_tile_size;
+            return (band * raster_tile_size) + (row > low ? row - low : 0);
+        };
+
+        for (size_t i = 0, j = n - 1; i < n; j = i++) {
+            if (span(outline[j], outline[i], first, last))
+                for (size_t band = (first / raster_tile_size) - band_begin; band <= (last / raster_tile_size) - band_begin; band++)
+                    start[key(band, first) + 1]++;
+        }
+        for (size_t i = 1; i < start.size(); i++)
+            start[i] += start[i - 1];
+
+        edges.resize(start.back());
+        for (size_t i = 0, j = n - 1; i < n; j = i++) {
+            if (!span(outline[j], outline[i], first, last))
+                continue;
+
+            const Vector2<Real>& a = outline[j].y < outline[i].y ? outline[j] : outline[i];
+            const Vector2<Real>& b = outline[j].y < outline[i].y ? outline[i] : outline[j];
+            Edge edge { a.x, a.y, b.y, (b.x - a.x) / (b.y - a.y), 0 };
+            for (size_t band = (first / raster_tile_size) - band_begin; band <= (last / raster_tile_size) - band_begin; band++) {
+                size_t k = key(band, first);
+                edge.row = static_cast<uint32_t>(k - (band * raster_tile_size));
+                edges[start[k]++] = edge;
+            }
+        }
+
+        // Filling moved every start to the next key's, so the band starts are read one key back
+        band_start.resize(bands + 1);
+        band_start[0] = 0;
+        for (size_t band = 1; band <= bands; band++)
+            band_start[band] = start[(band * raster_tile_size) - 1];
+    }
+};
+
+// Fills an outline with the even-odd rule, from the sorted crossings of its edges with every line.
+// Lines are drawn from the bottom up, so edges join the active list with the row their lower end is in,
+// and leave it once the lines have passed their upper end.
+template <typename Real>
+void raster_outline(RasterTile<Real>& tile, const RasterEdgeTable<Real>& table) {
+    size_t band = tile.row_begin / raster_tile_size;
+    if (band < table.band_begin || band - table.band_begin + 1 >= table.band_start.size())
+        return;
+
+    const auto* edges = table.edges.data() + table.band_start[band - table.band_begin];
+    const size_t count = table.band_start[band - table.band_begin + 1] - table.band_start[band - table.band_begin];
+    const Real inverse = 1 / tile.grid.cell;
+    const Real band_low = static_cast<Real>(band * raster_tile_size);
+
+    std::vector<Real>& crossings = tile.crossings;
+    std::vector<uint32_t>& active = tile.active;
+    active.clear();
+    size_t next = 0;
+    tile.draw(table.y_min, table.y_max, [&](Real y, auto emit) {
+        // The row is found the same way as the rows of the edges, so every edge with y_low <= y has joined
+        Real row = std::floor((y - tile.grid.origin.y) * inverse) - band_low;
+        while (next < count && static_cast<Real>(edges[next].row) <= row)
+            active.push_back(static_cast<uint32_t>(next++));
+
+        crossings.clear();
+        size_t kept = 0;
+        for (uint32_t k: active) {
+            const auto& edge = edges[k];
+            if (edge.y_high <= y)
+                continue;
+            active[kept++] = k;
+            if (edge.y_low <= y)
+                crossings.push_back(edge.x + ((y - edge.y_low) * edge.slope));
+        }
+        active.resize(kept);
+
+        std::sort(crossings.begin(), crossings.end());
+        for (size_t k = 0; k + 1 < crossings.size(); k += 2)
+            emit(crossings[k], crossings[k + 1]);
+    });
+}
+
+// Draws a shape given by its frame and local description, the same ones its point queries use
+template <typename Real>
+void raster_shape(RasterTile<Real>& tile, const QueryFrame<Real>& frame, const CircleQuery<Real>& query) {
+    raster_circle(tile, frame.px, frame.py, query.radius);
+}
+
+template <typename Real>
+void raster_shape(RasterTile<Real>& tile, const QueryFrame<Real>& frame, const RectangleQuery<Real>& query) {
+    const Real corners[4][2] = { { -query.hw, -query.hh }, { query.hw, -query.hh }, { query.hw, query.hh }, { -query.hw, query.hh } };
+    Vector2<Real> vertices[4];
+    for (size_t i = 0; i < 4; i++)
+        vertices[i] = frame.worldDirection(corners[i][0], corners[i][1]) + Vector2<Real>(frame.px, frame.py);
+    raster_convex(tile, vertices, 4);
+}
+
+// Vertices are the even entries of the 2N entry table, between the edge normals
+template <typename Real>
+void raster_shape(RasterTile<Real>& tile, const QueryFrame<Real>& frame, const NGonQuery<Real>& query) {
+    if (query.N < 3)
+        return;
+
+    tile.outline.resize(query.N);
+    for (size_t i = 0; i < query.N; i++) {
+        Vector2<Real> local = query.normals[2 * i] * query.radius;
+        tile.outline[i] = frame.worldDirection(local.x, local.y) + Vector2<Real>(frame.px, frame.py);
+    }
+    raster_convex(tile, tile.outline.data(), query.N);
+}
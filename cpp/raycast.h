@@ -0,0 +1,206 @@
+/// Author: PlumpDolphin
+/// Date: October 16, 2026
+///
+/// Description:
+///     Provides the RayCaster, which finds the nearest hit of many rays in a collection of shapes.
+///     Rays are cast in packets of 8 neighbouring rays, so each shape, and each node of a spatial index,
+///     is read once per packet instead of once per ray, and its exact intersection runs on all 8 at once.
+///
+///     Without an index, every packet sweeps the bounds of all shapes, stored as lanes, and only shapes
+///     whose bounds one of its rays enters are intersected. With a BVH, packets descend the hierarchy
+///     nearest child first, skipping nodes that every ray has already hit something in front of.
+///     Both give exactly the same hits, for any number of threads: each ray keeps its nearest hit, and ties
+///     go to the shape with the lower index, whatever order the shapes are visited in.
+///
+/// License:
+///     The code in this file is licensed under the
+///     Revised 3-Clause BSD License.
+///     For details, see https://opensource.org/licenses/BSD-3-Clause
+
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "vectorarray.h" // Includes definition for VectorArray2<T> holding the bounds of the shapes.
+#include "spatial.h"     // Includes definitions for Shape2D, the ray packets and the BVH used to skip shapes.
+
+
+
+// Example usage showing a scene cast against from a sensor.
+/*
+    std::vector<Shape2D<float>*> scene = ...;
+
+    // Neighbouring rays share packets, so rays should be ordered to keep them coherent, like a fan from one point
+    std::vector<Ray2D<float>> rays;
+    for (int i = 0; i < 1024; i++)
+        rays.push_back(Ray2D<float>(eye, Vector2<float>(std::cos(i * step), std::sin(i * step))));
+
+    std::vector<RayHit<float>> hits(rays.size());
+    RayCaster<float> caster;
+    caster.cast(scene, rays, hits);
+
+    // Larger scenes skip most shapes through a BVH, and either way the work can be split over an executor
+    BVH<float> bvh;
+    bvh.build(scene);
+    caster.cast(scene, bvh, rays, hits, executor);
+
+    for (size_t i = 0; i < hits.size(); i++)
+        if (hits[i].hit())
+            draw(rays[i].at(hits[i].t), scene[hits[i].shape]);
+*/
+
+
+
+// Casts rays at a collection of shapes, which are identified by their index in it.
+// The padded bounds of every shape are kept between calls, so casting at a scene again doesn't allocate.
+template <typename T>
+class RayCaster {
+public:
+    using Real = typename Shape2D<T>::Real;
+
+
+
+    // Writes the nearest hit of every ray that `hits` has room for, sweeping every shape
+    void cast(std::span<Shape2D<T>* const> shapes, std::span<const Ray2D<T>> rays, std::span<RayHit<Real>> hits) {
+        INSTRUMENT_SCOPE("RayCaster::cast");
+        size_t count = _prepare(shapes, rays, hits);
+        _cast(shapes, nullptr, rays, hits, 0, _packets(count), count);
+    }
+
+    // Same as above, split over an executor in whole packets
+    void cast(std::span<Shape2D<T>* const> shapes, std::span<const Ray2D<T>> rays, std::span<RayHit<Real>> hits,
+              Executor& executor) {
+        INSTRUMENT_SCOPE("RayCaster::cast");
+        size_t count = _prepare(shapes, rays, hits);
+        parallel_for(executor, 0, _packets(count), [&](size_t begin, size_t end) {
+            _cast(shapes, nullptr, rays, hits, begin, end, count);
+        });
+    }
+
+    // Writes the nearest hit of every ray, visiting only the shapes of the BVH nodes the rays enter.
+    // The BVH must have been built or refit from the same shapes since they were last transformed.
+    void cast(std::span<Shape2D<T>* const> shapes, const BVH<T>& index, std::span<const Ray2D<T>> rays,
+              std::span<RayHit<Real>> hits) {
+        INSTRUMENT_SCOPE("RayCaster::cast");
+        size_t count = _prepare(shapes, rays, hits);
+        _cast(shapes, &index, rays, hits, 0, _packets(count), count);
+    }
+
+    // Same as above, split over an executor in whole packets
+    void cast(std::span<Shape2D<T>* const> shapes, const BVH<T>& index, std::span<const Ray2D<T>> rays,
+              std::span<RayHit<Real>> hits, Executor& executor) {
+        INSTRUMENT_SCOPE("RayCaster::cast");
+        size_t count = _prepare(shapes, rays, hits);
+        parallel_for(executor, 0, _packets(count), [&](size_t begin, size_t end) {
+            _cast(shapes, &index, rays, hits, begin, end, count);
+        });
+    }
+
+
+
+private:
+    // Bounds of every shape, padded so that rounding in the bounds tests never skips a shape that a ray hits
+    VectorArray2<Real> lower, upper;
+
+    // Same depth limit as the BVH's own traversal stack
+    static constexpr size_t stack_size = 128;
+
+    // Padding of the bounds, relative to their size and distance from the origin
+    static constexpr Real padding = std::numeric_limits<Real>::epsilon() * 256;
+
+    static size_t _packets(size_t count) { return (count + ray_packet_size - 1) / ray_packet_size; }
+
+    // Brings every shape up to date for the kernels, which then only read it, and gathers the padded bounds
+    size_t _prepare(std::span<Shape2D<T>* const> shapes, std::span<const Ray2D<T>> rays, std::span<RayHit<Real>> hits) {
+        lower.resize(shapes.size());
+        upper.resize(shapes.size());
+        for (size_t i = 0; i < shapes.size(); i++) {
+            shapes[i]->_prepareQueries();
+            Bounds2D<Real> box = _padded(shapes[i]->bounds());
+            lower.x[i] = box.min.x;
+            lower.y[i] = box.min.y;
+            upper.x[i] = box.max.x;
+            upper.y[i] = box.max.y;
+        }
+        return rays.size() < hits.size() ? rays.size() : hits.size();
+    }
+
+    static Bounds2D<Real> _padded(const Bounds2D<T>& box) {
+        Vector2<Real> min(static_cast<Real>(box.min.x), static_cast<Real>(box.min.y));
+        Vector2<Real> max(static_cast<Real>(box.max.x), static_cast<Real>(box.max.y));
+        Real reach = std::max({ std::abs(min.x), std::abs(min.y), std::abs(max.x), std::abs(max.y) });
+        Real pad = (reach + (max.x - min.x) + (max.y - min.y)) * padding;
+        return Bounds2D<Real>(min - Vector2<Real>(pad, pad), max + Vector2<Real>(pad, pad));
+    }
+
+    bool _enters(const RayPacket<Real>& packet, const Bounds2D<T>& box) const {
+        Bounds2D<Real> padded = _padded(box);
+        return packet.overlaps(padded.min.x, padded.min.y, padded.max.x, padded.max.y) != 0;
+    }
+
+    // Casts packets [begin, end) of the rays
+    void _cast(std::span<Shape2D<T>* const> shapes, const BVH<T>* index, std::span<const Ray2D<T>> rays,
+               std::span<RayHit<Real>> hits, size_t begin, size_t end, size_t count) const {
+        RayPacket<Real> packet;
+        for (size_t p = begin; p < end; p++) {
+            size_t first = p * ray_packet_size;
+            size_t size = count - first < ray_packet_size ? count - first : ray_packet_size;
+            packet.load(rays.subspan(first, size));
+
+            if (index != nullptr) {
+                _traverse(shapes, *index, packet);
+            } else {
+                for (size_t i = 0; i < shapes.size(); i++)
+                    _castShape(shapes, static_cast<uint32_t>(i), packet);
+            }
+            packet.store(hits.subspan(first, size));
+        }
+    }
+
+    void _castShape(std::span<Shape2D<T>* const> shapes, uint32_t id, RayPacket<Real>& packet) const {
+        if (packet.overlaps(lower.x[id], lower.y[id], upper.x[id], upper.y[id]) != 0)
+            shapes[id]->_raycastPacket(packet, id);
+    }
+
+    // Descends the nearer child first, judged along the first ray of the packet,
+    // so later nodes are more often behind hits that were already found
+    void _traverse(std::span<Shape2D<T>* const> shapes, const BVH<T>& index, RayPacket<Real>& packet) const {
+        const std::vector<typename BVH<T>::Node>& nodes = index.getNodes();
+        const std::vector<uint32_t>& items = index.getItems();
+        if (nodes.empty())
+            return;
+
+        uint32_t stack[stack_size];
+        size_t top = 0;
+        stack[top++] = 0;
+
+        while (top > 0) {
+            uint32_t current = stack[--top];
+            const typename BVH<T>::Node& node = nodes[current];
+            if (!_enters(packet, node.box))
+                continue;
+
+            if (node.count > 0) {
+                for (uint32_t i = node.start; i < node.start + node.count; i++)
+                    if (items[i] < shapes.size())
+                        _castShape(shapes, items[i], packet);
+                continue;
+            }
+
+            uint32_t near = current + 1, far = node.start;
+            Vector2<T> offset = (nodes[far].box.min + nodes[far].box.max) - (nodes[near].box.min + nodes[near].box.max);
+            if ((static_cast<Real>(offset.x) * packet.dx[0]) + (static_cast<Real>(offset.y) * packet.dy[0]) < 0)
+                std::swap(near, far);
+            stack[top++] = far;
+            stack[top++] = near;
+        }
+    }
+};
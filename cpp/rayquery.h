@@ -0,0 +1,456 @@
+/// Author: PlumpDolphin
+/// Date: October 16, 2026
+///
+/// Description:
+///     Provides the Ray2D type and the exact ray intersections used by the raycast() functions of the shapes.
+///     As with the point queries, a ray is moved into a shape's local frame, where circles, rectangles and
+///     regular N-Gons are intersected analytically, and the hit normal is rotated back to world space.
+///
+///     Rays are cast in packets of 8, stored as lanes, which are intersected with a shape at once.
+///     Float packets are processed with AVX2 when it's available. Every lane is computed the same way,
+///     whichever lane it is in and whichever other rays share its packet, and ties between shapes are always
+///     broken towards the lower shape id, so the nearest hit of a ray never depends on how rays are grouped
+///     or in which order shapes are visited.
+///
+/// License:
+///     The code in this file is licensed under the
+///     Revised 3-Clause BSD License.
+///     For details, see https://opensource.org/licenses/BSD-3-Clause
+
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <type_traits>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#endif
+
+#include "pointquery.h" // Includes QueryFrame and the local shape descriptions that rays are cast against.
+
+
+
+// Example usage showing rays cast at a single shape.
+/*
+    Rectangle<float> box(4, 2, Vector2<float>(10, 0), 30);
+
+    // The direction doesn't need to be normalized, and hits are measured in lengths of it
+    Ray2D<float> ray(Vector2<float>(0, 0), Vector2<float>(1, 0));
+    RayHit<float> hit = box.raycast(ray);
+    if (hit.hit())
+        std::cout << ray.at(hit.t).str() << " facing " << hit.normal.str() << std::endl;
+
+    // Whole scenes are cast through the RayCaster of raycast.h
+*/
+
+
+
+// A ray starting at `origin` and going along `direction`, which doesn't need to be normalized.
+// Hits are measured in lengths of the direction, so a hit at t is at origin + direction * t.
+template <typename T>
+struct Ray2D {
+    Vector2<T> origin;
+    Vector2<T> direction;
+
+    Ray2D() {}
+    Ray2D(Vector2<T> origin, Vector2<T> direction)
+        : origin(origin), direction(direction) {}
+
+    // Point at a distance along the ray
+    template <typename Real>
+    Vector2<Real> at(Real t) const {
+        return Vector2<Real>(static_cast<Real>(origin.x) + (static_cast<Real>(direction.x) * t),
+                             static_cast<Real>(origin.y) + (static_cast<Real>(direction.y) * t));
+    }
+};
+
+// Nearest hit of a ray.
+// Rays starting inside a shape hit it at t = 0, with a zero normal, since they don't cross its outline.
+template <typename Real>
+struct RayHit {
+    static constexpr uint32_t none = std::numeric_limits<uint32_t>::max();
+
+    Real t = std::numeric_limits<Real>::infinity(); // Distance along the ray, in lengths of its direction
+    Vector2<Real> normal;                           // Unit normal of the outline at the hit, facing the ray
+    uint32_t shape = none;                          // Id of the shape hit, or none
+
+    bool hit() const { return shape != none; }
+};
+
+
+
+// Packets
+// Rays are loaded into the lanes of a packet, along with the nearest hit found so far for each of them.
+// Shapes only replace a lane's hit with a nearer one, or an equally near one of a lower shape id.
+
+constexpr size_t ray_packet_size = 8;
+
+template <typename Real>
+struct RayPacket {
+    static constexpr size_t size = ray_packet_size;
+
+    alignas(32) Real ox[size], oy[size]; // Origins
+    alignas(32) Real dx[size], dy[size]; // Directions
+    alignas(32) Real ix[size], iy[size]; // Inverse directions, used to test bounds
+    alignas(32) Real t[size];            // Nearest hit so far
+    alignas(32) Real nx[size], ny[size];
+    alignas(32) uint32_t shape[size];
+    size_t count = 0;
+
+    // Loads up to `size` rays, clearing their hits.
+    // Lanes without a ray get a negative distance, so no hit is ever nearer.
+    template <typename T>
+    void load(std::span<const Ray2D<T>> rays) {
+        count = rays.size() < size ? rays.size() : size;
+        for (size_t i = 0; i < size; i++) {
+            Ray2D<T> ray = i < count ? rays[i] : Ray2D<T>();
+            ox[i] = static_cast<Real>(ray.origin.x);
+            oy[i] = static_cast<Real>(ray.origin.y);
+            dx[i] = static_cast<Real>(ray.direction.x);
+            dy[i] = static_cast<Real>(ray.direction.y);
+            ix[i] = _inverse(dx[i]);
+            iy[i] = _inverse(dy[i]);
+            t[i] = i < count ? std::numeric_limits<Real>::infinity() : -1;
+            nx[i] = ny[i] = 0;
+            shape[i] = RayHit<Real>::none;
+        }
+    }
+
+    RayHit<Real> hit(size_t lane) const {
+        RayHit<Real> out;
+        out.t = t[lane];
+        out.normal = Vector2<Real>(nx[lane], ny[lane]);
+        out.shape = shape[lane];
+        return out;
+    }
+
+    // Writes the hits of the loaded rays
+    void store(std::span<RayHit<Real>> hits) const {
+        for (size_t i = 0; i < count && i < hits.size(); i++)
+            hits[i] = hit(i);
+    }
+
+    // Keeps a hit if it is nearer than the lane's current one, breaking ties towards the lower shape id
+    void accept(size_t lane, Real distance, Vector2<Real> normal, uint32_t id) {
+        if (distance < t[lane] || (distance == t[lane] && id < shape[lane])) {
+            t[lane] = distance;
+            nx[lane] = normal.x;
+            ny[lane] = normal.y;
+            shape[lane] = id;
+        }
+    }
+
+    // Returns a bit for every lane whose ray enters the box before its current hit.
+    // Boxes that are only touched at a distance equal to the current hit still pass, so ties can be broken.
+    uint32_t overlaps(Real min_x, Real min_y, Real max_x, Real max_y) const {
+#if defined(__AVX2__)
+        if constexpr (std::is_same_v<Real, float>) {
+            __m256 x = _mm256_load_ps(ox), y = _mm256_load_ps(oy);
+            __m256 inv_x = _mm256_load_ps(ix), inv_y = _mm256_load_ps(iy);
+            __m256 x1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(min_x), x), inv_x);
+            __m256 x2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(max_x), x), inv_x);
+            __m256 y1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(min_y), y), inv_y);
+            __m256 y2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(max_y), y), inv_y);
+            __m256 enter = _mm256_max_ps(_mm256_max_ps(_mm256_min_ps(x1, x2), _mm256_min_ps(y1, y2)), _mm256_setzero_ps());
+            __m256 leave = _mm256_min_ps(_mm256_min_ps(_mm256_max_ps(x1, x2), _mm256_max_ps(y1, y2)), _mm256_load_ps(t));
+            return static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(enter, leave, _CMP_LE_OQ)));
+        }
+#endif
+
+        uint32_t bits = 0;
+        for (size_t i = 0; i < size; i++) {
+            Real x1 = (min_x - ox[i]) * ix[i], x2 = (max_x - ox[i]) * ix[i];
+            Real y1 = (min_y - oy[i]) * iy[i], y2 = (max_y - oy[i]) * iy[i];
+            Real enter = std::max(std::max(std::min(x1, x2), std::min(y1, y2)), Real(0));
+            Real leave = std::min(std::min(std::max(x1, x2), std::max(y1, y2)), t[i]);
+            bits |= static_cast<uint32_t>(enter <= leave) << i;
+        }
+        return bits;
+    }
+
+private:
+    // Axis-parallel rays use the largest finite inverse rather than infinity,
+    // so a box edge exactly on the ray's line gives 0 instead of NaN
+    static Real _inverse(Real d) {
+        Real inverse = 1 / d;
+        if (std::isinf(inverse))
+            return std::signbit(d) ? -std::numeric_limits<Real>::max() : std::numeric_limits<Real>::max();
+        return inverse;
+    }
+};
+
+
+
+// Local ray intersections
+// A ray in the local frame of a shape is tested with ray_hit(), which returns true with the distance to the
+// outline, and the unit normal there, if the ray hits the shape. Rays starting inside hit at 0, with a zero normal.
+
+template <typename Real>
+bool ray_hit(const CircleQuery<Real>& q, Real ox, Real oy, Real dx, Real dy, Real& t, Vector2<Real>& normal) {
+    if (q.inside(ox, oy)) {
+        t = 0;
+        normal = Vector2<Real>();
+        return true;
+    }
+
+    // Nearest root of |o + t d|^2 = r^2, which is only ahead of the ray if it points towards the center.
+    // With c > 0, c / (-b + sqrt(disc)) is the same root as (-b - sqrt(disc)) / a, without the cancellation.
+    Real a = (dx * dx) + (dy * dy), b = (ox * dx) + (oy * dy);
+    Real c = ((ox * ox) + (oy * oy)) - (q.radius * q.radius);
+    Real disc = (b * b) - (a * c);
+    if (!(q.radius > 0) || !(b < 0) || disc < 0)
+        return false;
+
+    t = c / (std::sqrt(disc) - b);
+    normal = Vector2<Real>((ox + (t * dx)) / q.radius, (oy + (t * dy)) / q.radius);
+    return true;
+}
+
+// Slab test: the ray is inside the rectangle between entering both slabs and leaving either.
+// The slab entered last gives the normal.
+template <typename Real>
+bool ray_hit(const RectangleQuery<Real>& q, Real ox, Real oy, Real dx, Real dy, Real& t, Vector2<Real>& normal) {
+    if (q.inside(ox, oy)) {
+        t = 0;
+        normal = Vector2<Real>();
+        return true;
+    }
+
+    constexpr Real inf = std::numeric_limits<Real>::infinity();
+    auto slab = [](Real o, Real d, Real h, Real& enter, Real& leave) {
+        if (d == 0) {
+            enter = -inf;
+            leave = inf;
+            return std::abs(o) <= h;
+        }
+        Real t1 = (-h - o) / d, t2 = (h - o) / d;
+        enter = t1 < t2 ? t1 : t2;
+        leave = t1 < t2 ? t2 : t1;
+        return true;
+    };
+
+    Real enter_x, leave_x, enter_y, leave_y;
+    if (!slab(ox, dx, q.hw, enter_x, leave_x) || !slab(oy, dy, q.hh, enter_y, leave_y))
+        return false;
+
+    Real enter = enter_x > enter_y ? enter_x : enter_y;
+    Real leave = leave_x < leave_y ? leave_x : leave_y;
+    if (!(enter <= leave) || enter < 0)
+        return false;
+
+    t = enter;
+    if (enter_x >= enter_y)
+        normal = Vector2<Real>(dx > 0 ? -1 : 1, 0);
+    else
+        normal = Vector2<Real>(0, dy > 0 ? -1 : 1);
+    return true;
+}
+
+// Clips the ray against the half-plane of every edge, keeping the edge entered last for the normal
+template <typename Real>
+bool ray_hit(const NGonQuery<Real>& q, Real ox, Real oy, Real dx, Real dy, Real& t, Vector2<Real>& normal) {
+    if (q.N < 3)
+        return false;
+    if (q.inside(ox, oy)) {
+        t = 0;
+        normal = Vector2<Real>();
+        return true;
+    }
+
+    Real enter = -std::numeric_limits<Real>::infinity(), leave = std::numeric_limits<Real>::infinity();
+    size_t facing = 1;
+    for (size_t k = 1; k < 2 * q.N; k += 2) {
+        Real along = (q.normals[k].x * dx) + (q.normals[k].y * dy);
+        Real gap = q.apothem - ((q.normals[k].x * ox) + (q.normals[k].y * oy));
+        if (along < 0) {
+            Real edge = gap / along;
+            if (edge > enter) {
+                enter = edge;
+                facing = k;
+            }
+        } else if (along > 0) {
+            Real edge = gap / along;
+            leave = edge < leave ? edge : leave;
+        } else if (gap < 0) {
+            return false;
+        }
+    }
+
+    if (!(enter <= leave) || enter < 0)
+        return false;
+
+    t = enter;
+    normal = q.normals[facing];
+    return true;
+}
+
+
+
+#if defined(__AVX2__)
+// AVX2 versions of the local ray intersections, for 8 float rays at once.
+// Each returns the lanes that hit, with their distances and local normals.
+
+inline __m256 _ray_hit8(const CircleQuery<float>& q, __m256 ox, __m256 oy, __m256 dx, __m256 dy,
+                        __m256& t, __m256& nx, __m256& ny) {
+    __m256 r = _mm256_set1_ps(q.radius);
+    __m256 inside = _query_inside8(q, ox, oy);
+
+    __m256 a = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+    __m256 b = _mm256_add_ps(_mm256_mul_ps(ox, dx), _mm256_mul_ps(oy, dy));
+    __m256 c = _mm256_sub_ps(_mm256_add_ps(_mm256_mul_ps(ox, ox), _mm256_mul_ps(oy, oy)), _mm256_mul_ps(r, r));
+    __m256 disc = _mm256_sub_ps(_mm256_mul_ps(b, b), _mm256_mul_ps(a, c));
+
+    __m256 zero = _mm256_setzero_ps();
+    __m256 hit = _mm256_and_ps(_mm256_cmp_ps(b, zero, _CMP_LT_OQ), _mm256_cmp_ps(disc, zero, _CMP_GE_OQ));
+    hit = q.radius > 0 ? hit : zero;
+
+    __m256 root = _mm256_div_ps(c, _mm256_sub_ps(_mm256_sqrt_ps(_mm256_max_ps(disc, zero)), b));
+    __m256 hx = _mm256_div_ps(_mm256_add_ps(ox, _mm256_mul_ps(root, dx)), r);
+    __m256 hy = _mm256_div_ps(_mm256_add_ps(oy, _mm256_mul_ps(root, dy)), r);
+
+    t = _mm256_andnot_ps(inside, root);
+    nx = _mm256_andnot_ps(inside, hx);
+    ny = _mm256_andnot_ps(inside, hy);
+    return _mm256_or_ps(inside, hit);
+}
+
+inline __m256 _ray_hit8(const RectangleQuery<float>& q, __m256 ox, __m256 oy, __m256 dx, __m256 dy,
+                        __m256& t, __m256& nx, __m256& ny) {
+    __m256 zero = _mm256_setzero_ps();
+    __m256 inf = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+    __m256 inside = _query_inside8(q, ox, oy);
+
+    // Rays parallel to a slab are either always inside it, or never
+    auto slab = [&](__m256 o, __m256 d, float h, __m256& enter, __m256& leave) {
+        __m256 half = _mm256_set1_ps(h);
+        __m256 t1 = _mm256_div_ps(_mm256_sub_ps(_mm256_sub_ps(zero, half), o), d);
+        __m256 t2 = _mm256_div_ps(_mm256_sub_ps(half, o), d);
+        __m256 parallel = _mm256_cmp_ps(d, zero, _CMP_EQ_OQ);
+        enter = _mm256_blendv_ps(_mm256_min_ps(t1, t2), _mm256_sub_ps(zero, inf), parallel);
+        leave = _mm256_blendv_ps(_mm256_max_ps(t1, t2), inf, parallel);
+        return _mm256_andnot_ps(_mm256_and_ps(parallel, _mm256_cmp_ps(_query_abs8(o), half, _CMP_GT_OQ)),
+                                _mm256_castsi256_ps(_mm256_set1_epi32(-1)));
+    };
+
+    __m256 enter_x, leave_x, enter_y, leave_y;
+    __m256 hit = _mm256_and_ps(slab(ox, dx, q.hw, enter_x, leave_x), slab(oy, dy, q.hh, enter_y, leave_y));
+
+    __m256 enter = _mm256_max_ps(enter_x, enter_y);
+    __m256 leave = _mm256_min_ps(leave_x, leave_y);
+    hit = _mm256_and_ps(hit, _mm256_and_ps(_mm256_cmp_ps(enter, leave, _CMP_LE_OQ), _mm256_cmp_ps(enter, zero, _CMP_GE_OQ)));
+
+    // The normal faces against the ray along the axis of the slab entered last
+    __m256 one = _mm256_set1_ps(1.0f), sign = _mm256_set1_ps(-0.0f);
+    __m256 against_x = _mm256_or_ps(one, _mm256_and_ps(_mm256_cmp_ps(dx, zero, _CMP_GT_OQ), sign));
+    __m256 against_y = _mm256_or_ps(one, _mm256_and_ps(_mm256_cmp_ps(dy, zero, _CMP_GT_OQ), sign));
+    __m256 x_axis = _mm256_cmp_ps(enter_x, enter_y, _CMP_GE_OQ);
+
+    t = _mm256_andnot_ps(inside, enter);
+    nx = _mm256_andnot_ps(inside, _mm256_and_ps(x_axis, against_x));
+    ny = _mm256_andnot_ps(inside, _mm256_andnot_ps(x_axis, against_y));
+    return _mm256_or_ps(inside, hit);
+}
+
+inline __m256 _ray_hit8(const NGonQuery<float>& q, __m256 ox, __m256 oy, __m256 dx, __m256 dy,
+                        __m256& t, __m256& nx, __m256& ny) {
+    __m256 zero = _mm256_setzero_ps();
+    if (q.N < 3) {
+        t = nx = ny = zero;
+        return zero;
+    }
+
+    __m256 inside = _query_inside8(q, ox, oy);
+    __m256 apothem = _mm256_set1_ps(q.apothem);
+    __m256 enter = _mm256_set1_ps(-std::numeric_limits<float>::infinity());
+    __m256 leave = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+    __m256 missed = zero;
+    nx = ny = zero;
+
+    for (size_t k = 1; k < 2 * q.N; k += 2) {
+        __m256 ex = _mm256_set1_ps(q.normals[k].x), ey = _mm256_set1_ps(q.normals[k].y);
+        __m256 along = _mm256_add_ps(_mm256_mul_ps(ex, dx), _mm256_mul_ps(ey, dy));
+        __m256 gap = _mm256_sub_ps(apothem, _mm256_add_ps(_mm256_mul_ps(ex, ox), _mm256_mul_ps(ey, oy)));
+        __m256 edge = _mm256_div_ps(gap, along);
+
+        __m256 entering = _mm256_and_ps(_mm256_cmp_ps(along, zero, _CMP_LT_OQ), _mm256_cmp_ps(edge, enter, _CMP_GT_OQ));
+        enter = _mm256_blendv_ps(enter, edge, entering);
+        nx = _mm256_blendv_ps(nx, ex, entering);
+        ny = _mm256_blendv_ps(ny, ey, entering);
+
+        __m256 leaving = _mm256_cmp_ps(along, zero, _CMP_GT_OQ);
+        leave = _mm256_blendv_ps(leave, _mm256_min_ps(edge, leave), leaving);
+
+        __m256 parallel = _mm256_cmp_ps(along, zero, _CMP_EQ_OQ);
+        missed = _mm256_or_ps(missed, _mm256_and_ps(parallel, _mm256_cmp_ps(gap, zero, _CMP_LT_OQ)));
+    }
+
+    __m256 hit = _mm256_and_ps(_mm256_cmp_ps(enter, leave, _CMP_LE_OQ), _mm256_cmp_ps(enter, zero, _CMP_GE_OQ));
+    hit = _mm256_andnot_ps(missed, hit);
+
+    t = _mm256_andnot_ps(inside, enter);
+    nx = _mm256_andnot_ps(inside, nx);
+    ny = _mm256_andnot_ps(inside, ny);
+    return _mm256_or_ps(inside, hit);
+}
+
+// Keeps the hits of the lanes in `hit` that are nearer than the packet's, breaking ties towards the lower shape id.
+// Shape ids are compared as unsigned, by flipping their sign bits.
+inline void _ray_accept8(RayPacket<float>& packet, __m256 hit, __m256 t, __m256 nx, __m256 ny, uint32_t id) {
+    __m256 current = _mm256_load_ps(packet.t);
+    __m256i shapes = _mm256_load_si256(reinterpret_cast<const __m256i*>(packet.shape));
+    __m256i flip = _mm256_set1_epi32(static_cast<int>(0x80000000u));
+    __m256i candidate = _mm256_set1_epi32(static_cast<int>(id));
+
+    __m256 lower = _mm256_castsi256_ps(_mm256_cmpgt_epi32(_mm256_xor_si256(shapes, flip), _mm256_xor_si256(candidate, flip)));
+    __m256 nearer = _mm256_or_ps(_mm256_cmp_ps(t, current, _CMP_LT_OQ),
+                                 _mm256_and_ps(_mm256_cmp_ps(t, current, _CMP_EQ_OQ), lower));
+    __m256 keep = _mm256_and_ps(hit, nearer);
+
+    _mm256_store_ps(packet.t, _mm256_blendv_ps(current, t, keep));
+    _mm256_store_ps(packet.nx, _mm256_blendv_ps(_mm256_load_ps(packet.nx), nx, keep));
+    _mm256_store_ps(packet.ny, _mm256_blendv_ps(_mm256_load_ps(packet.ny), ny, keep));
+    _mm256_store_si256(reinterpret_cast<__m256i*>(packet.shape),
+                       _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(shapes), _mm256_castsi256_ps(candidate), keep)));
+}
+#endif
+
+// Casts every ray of a packet at a shape, given by its frame and local description, keeping the nearer hits
+template <typename Real, typename Query>
+void ray_cast_packet(const QueryFrame<Real>& frame, const Query& query, RayPacket<Real>& packet, uint32_t id) {
+#if defined(__AVX2__)
+    if constexpr (std::is_same_v<Real, float>) {
+        __m256 c = _mm256_set1_ps(frame.c), s = _mm256_set1_ps(frame.s);
+        __m256 dx = _mm256_load_ps(packet.dx), dy = _mm256_load_ps(packet.dy);
+
+        __m256 lox, loy;
+        _query_local8(frame, _mm256_load_ps(packet.ox), _mm256_load_ps(packet.oy), lox, loy);
+        __m256 ldx = _mm256_add_ps(_mm256_mul_ps(dx, c), _mm256_mul_ps(dy, s));
+        __m256 ldy = _mm256_sub_ps(_mm256_mul_ps(dy, c), _mm256_mul_ps(dx, s));
+
+        __m256 t, lnx, lny;
+        __m256 hit = _ray_hit8(query, lox, loy, ldx, ldy, t, lnx, lny);
+        if (_mm256_movemask_ps(hit) == 0)
+            return;
+
+        __m256 nx = _mm256_sub_ps(_mm256_mul_ps(lnx, c), _mm256_mul_ps(lny, s));
+        __m256 ny = _mm256_add_ps(_mm256_mul_ps(lnx, s), _mm256_mul_ps(lny, c));
+        _ray_accept8(packet, hit, t, nx, ny, id);
+        return;
+    }
+#endif
+
+    for (size_t i = 0; i < packet.count; i++) {
+        Vector2<Real> o = frame.local(packet.ox[i], packet.oy[i]);
+        Vector2<Real> d = frame.localDirection(packet.dx[i], packet.dy[i]);
+        Real t;
+        Vector2<Real> normal;
+        if (ray_hit(query, o.x, o.y, d.x, d.y, t, normal))
+            packet.accept(i, t, frame.worldDirection(normal.x, normal.y), id);
+    }
+}
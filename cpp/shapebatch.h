@@ -0,0 +1,694 @@
+/// Author: PlumpDolphin
+/// Date: October 16, 2026
+///
+/// Description:
+///     Provides CircleBatch, RectangleBatch, and NGonBatch classes which store many shapes of a single type
+///     as parallel arrays, rather than as individually allocated Shape2D objects.
+///     Every transform is applied to the whole batch at once without virtual dispatch,
+///     and gives exactly the same results as calling the matching function on each shape.
+///
+/// License:
+///     The code in this file is licensed under the
+///     Revised 3-Clause BSD License.
+///     For details, see https://opensource.org/licenses/BSD-3-Clause
+
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "vectorarray.h" // Includes definition for VectorArray2<T> used to store positions and sizes.
+#include "vectorexpr.h"  // Includes lazy() and assign() used to fuse bulk position updates.
+#include "shapes.h"      // Includes definitions for the shapes stored by each batch.
+#include "executor.h"    // Includes definition for Executor used by the parallel bulk functions.
+
+
+
+// Example usage showing construction and bulk transforms.
+/*
+    // Add shapes one at a time, or convert an existing list
+    CircleBatch<float> circles;
+    circles.push_back(Circle<float>(5, 0, 0));
+    circles.push_back(Circle<float>(2, 10, 4));
+
+    // Transform every circle at once
+    circles.moveAll(1, 1);
+    circles.rotateFromAll(90, Vector2<float>(0, 0));
+    circles.scaleFromAll(2, Vector2<float>(0, 0));
+
+    // Bulk utility functions
+    std::vector<float> areas = circles.areas();
+    std::vector<Bounds2D<float>> boxes = circles.bounds();
+
+    // Render every circle into one contiguous buffer
+    std::vector<Vector2<float>> buffer(circles.vertexCount());
+    circles.vertices(buffer);
+
+    // Or give each circle as many vertices as it needs to stay within half a pixel, at 4 pixels per unit
+    std::vector<size_t> offsets;
+    circles.vertices(buffer, offsets, CircleDetail{ 0.5, 4 });
+
+    // Individual shapes can be read back at any time
+    Circle<float> first = circles.get(0);
+*/
+
+
+
+
+
+// Shared storage and transforms for the position and rotation of every shape in a batch.
+template <typename T>
+class ShapeBatch {
+public:
+    // Data
+    VectorArray2<T> position;
+    std::vector<Angle> rotation; // Stored in degrees, the same as Shape2D.
+
+
+
+    // Size management
+    // Named count() rather than size(), since RectangleBatch stores a `size` column like Rectangle.
+    size_t count() const { return rotation.size(); }
+    bool empty() const   { return rotation.empty(); }
+
+
+
+    // Transformative functions
+    // Each one matches the Shape2D function of the same name, applied to every shape. Floating-point shapes
+    // compose a chain of moves of their position into one transform, so their positions can differ in the last bits.
+
+    void rotateAll(Angle degrees) {
+        for (auto &r: rotation)
+            r += degrees;
+    }
+
+    void rotateFromAll(Angle degrees, T x, T y) { rotateFromAll(degrees, Vector2<T>(x, y)); }
+    void rotateFromAll(Angle degrees, Vector2<T> origin) {
+        // rotate_point returns positions unchanged for a rotation of 0
+        if (degrees == 0)
+            return;
+
+        rotateAll(degrees);
+
+        // Rotate all positions around the origin with a single sine and cosine
+        rotate_points(position, position, origin, degrees);
+    }
+
+    // Moves every shape from it's current position by some offset.
+    void moveAll(T x, T y)          { moveAll(Vector2<T>(x, y)); }
+    void moveAll(Vector2<T> offset) { position += offset; }
+
+    // Moves every shape by its own offset.
+    void moveAll(const VectorArray2<T>& offsets) { position += offsets; }
+
+    // Moves every shape to the same position relative to global origin.
+    void moveToAll(T x, T y)               { moveToAll(Vector2<T>(x, y)); }
+    void moveToAll(Vector2<T> destination) { position.fill(destination); }
+
+
+
+protected:
+    // Appends the shared part of a shape, which the push_back functions have flushed
+    void pushShape(const Shape2D<T>& shape) {
+        position.push_back(shape.position);
+        rotation.push_back(shape.rotation);
+    }
+
+    void reserveShapes(size_t count) {
+        position.reserve(count);
+        rotation.reserve(count);
+    }
+
+    void clearShapes() {
+        position.clear();
+        rotation.clear();
+    }
+
+    // Repositions every shape relative to the scale origin, the same as Shape2D::scaleFrom.
+    // The chain is fused into one pass over the lanes, and each step is stored back to T, the same as the Vector2 operators.
+    void scalePositionsFrom(T scalar, Vector2<T> origin) {
+        assign(position, ((lazy(position) - origin) * scalar) + origin);
+    }
+};
+
+
+
+
+
+template <typename T>
+class CircleBatch : public ShapeBatch<T> {
+public:
+    // Data
+    std::vector<T> radius;
+
+
+
+    // Default constructor
+    CircleBatch() {}
+
+    // List constructor
+    CircleBatch(const std::vector<Circle<T>>& circles) {
+        reserve(circles.size());
+        for (auto &c: circles)
+            push_back(c);
+    }
+
+
+
+    // Size management
+    void reserve(size_t count) {
+        ShapeBatch<T>::reserveShapes(count);
+        radius.reserve(count);
+    }
+
+    void clear() {
+        ShapeBatch<T>::clearShapes();
+        radius.clear();
+    }
+
+    void push_back(const Circle<T>& circle) {
+        if (circle.hasPendingTransform())
+            return push_back(flushed(circle));
+
+        ShapeBatch<T>::pushShape(circle);
+        radius.push_back(circle.radius);
+    }
+
+    Circle<T> get(size_t i) const {
+        return Circle<T>(radius[i], ShapeBatch<T>::position[i], ShapeBatch<T>::rotation[i]);
+    }
+
+
+
+    // Utility functions
+    std::vector<T> areas() const {
+        std::vector<T> out(radius.size());
+        areas(out);
+        return out;
+    }
+
+    void areas(std::span<T> out) const {
+        for (size_t i = 0; i < out.size() && i < radius.size(); i++)
+            out[i] = M_PI * radius[i] * radius[i];
+    }
+
+    std::vector<T> perimeters() const {
+        std::vector<T> out(radius.size());
+        perimeters(out);
+        return out;
+    }
+
+    void perimeters(std::span<T> out) const {
+        for (size_t i = 0; i < out.size() && i < radius.size(); i++)
+            out[i] = 2 * M_PI * radius[i];
+    }
+
+    // Axis-aligned bounds of every shape, computed analytically
+    std::vector<Bounds2D<T>> bounds() const {
+        std::vector<Bounds2D<T>> out(ShapeBatch<T>::count());
+        bounds(out);
+        return out;
+    }
+
+    void bounds(std::span<Bounds2D<T>> out) const {
+        _bounds(out, 0, out.size());
+    }
+
+    // Same as above, split over an executor
+    void bounds(std::span<Bounds2D<T>> out, Executor& executor) const {
+        parallel_for(executor, 0, out.size(), [&](size_t begin, size_t end) { _bounds(out, begin, end); });
+    }
+
+    // Total number of vertices written by vertices() at the given resolution
+    size_t vertexCount(size_t resolution = Circle<T>::default_resolution) const {
+        return radius.size() * resolution;
+    }
+
+    // Renders every circle into one buffer, one after another, and returns how many vertices were written.
+    // Only whole circles are written, so the buffer should hold vertexCount(resolution) elements.
+    size_t vertices(std::span<Vector2<T>> out, size_t resolution = Circle<T>::default_resolution) const {
+        // Every circle shares the same cached unit-circle table
+        auto table = unit_circle_table<T>(resolution);
+
+        size_t count = _whole(out, resolution);
+        _vertices(table.get(), resolution, out, 0, count);
+        return count * resolution;
+    }
+
+    // Same as above, split over an executor
+    size_t vertices(std::span<Vector2<T>> out, Executor& executor,
+                    size_t resolution = Circle<T>::default_resolution) const {
+        auto table = unit_circle_table<T>(resolution);
+
+        size_t count = _whole(out, resolution);
+        parallel_for(executor, 0, count, [&](size_t begin, size_t end) {
+            _vertices(table.get(), resolution, out, begin, end);
+        });
+        return count * resolution;
+    }
+
+    // Renders every circle into a reusable list, which only allocates when it has to grow
+    void vertices(std::vector<Vector2<T>>& out, size_t resolution = Circle<T>::default_resolution) const {
+        INSTRUMENT_BUFFER(out, vertexCount(resolution));
+        out.resize(vertexCount(resolution));
+        vertices(std::span<Vector2<T>>(out), resolution);
+    }
+
+
+
+    // Level of detail
+    // Every circle gets its own resolution from a tolerance shared by the batch, see CircleDetail.
+
+    std::vector<size_t> resolutions(CircleDetail detail) const {
+        std::vector<size_t> out(radius.size());
+        resolutions(out, detail);
+        return out;
+    }
+
+    void resolutions(std::span<size_t> out, CircleDetail detail) const {
+        for (size_t i = 0; i < out.size() && i < radius.size(); i++)
+            out[i] = circle_detail_resolution(radius[i], detail);
+    }
+
+    // Total number of vertices written by vertices() at the given level of detail
+    size_t vertexCount(CircleDetail detail) const {
+        size_t total = 0;
+        for (auto &r: radius)
+            total += circle_detail_resolution(r, detail);
+        return total;
+    }
+
+    // Renders every circle at its own resolution into one list, one after another.
+    // `offsets` receives count() + 1 entries, and circle i is written to out[offsets[i]] up to out[offsets[i + 1]].
+    // Both lists are reused, and only allocate when they have to grow.
+    void vertices(std::vector<Vector2<T>>& out, std::vector<size_t>& offsets, CircleDetail detail) const {
+        _DetailTables tables = _detailOffsets(offsets, detail);
+        INSTRUMENT_BUFFER(out, offsets.back());
+        out.resize(offsets.back());
+        _detailVertices(tables, offsets, out, 0, radius.size());
+    }
+
+    // Same as above, split over an executor
+    void vertices(std::vector<Vector2<T>>& out, std::vector<size_t>& offsets, CircleDetail detail,
+                  Executor& executor) const {
+        _DetailTables tables = _detailOffsets(offsets, detail);
+        INSTRUMENT_BUFFER(out, offsets.back());
+        out.resize(offsets.back());
+        parallel_for(executor, 0, radius.size(), [&](size_t begin, size_t end) {
+            _detailVertices(tables, offsets, out, begin, end);
+        });
+    }
+
+
+
+    // Transformative functions
+    void scaleAll(T scalar) {
+        for (auto &r: radius)
+            r *= scalar;
+    }
+
+    void scaleFromAll(T scalar, T x, T y) { scaleFromAll(scalar, Vector2<T>(x, y)); }
+    void scaleFromAll(T scalar, Vector2<T> origin) {
+        scaleAll(scalar);
+        ShapeBatch<T>::scalePositionsFrom(scalar, origin);
+    }
+
+
+
+private:
+    void _bounds(std::span<Bounds2D<T>> out, size_t begin, size_t end) const {
+        for (size_t i = begin; i < end && i < ShapeBatch<T>::count(); i++)
+            out[i] = circle_bounds(ShapeBatch<T>::position[i], radius[i]);
+    }
+
+    // Number of whole circles that fit in the buffer
+    size_t _whole(std::span<Vector2<T>> out, size_t resolution) const {
+        size_t count = resolution > 0 ? out.size() / resolution : 0;
+        return count < radius.size() ? count : radius.size();
+    }
+
+    void _vertices(const typename UnitCircleCache<T>::Table* table, size_t resolution,
+                   std::span<Vector2<T>> out, size_t begin, size_t end) const {
+        for (size_t i = begin; i < end; i++)
+            place_unit_vertices(table, resolution, resolution, out.data() + (i * resolution),
+                                ShapeBatch<T>::position[i], radius[i], ShapeBatch<T>::rotation[i]);
+    }
+
+    // Direction tables used by one level of detail render, indexed by circle_detail_level().
+    // They are fetched once per distinct resolution, so the cache's lock is only taken a few times per batch.
+    using _DetailTables = std::array<std::shared_ptr<const typename UnitCircleCache<T>::Table>, circle_detail_levels>;
+
+    // Fills the offsets of every circle, and fetches the tables they need
+    _DetailTables _detailOffsets(std::vector<size_t>& offsets, CircleDetail detail) const {
+        _DetailTables tables;
+        offsets.resize(radius.size() + 1);
+        offsets[0] = 0;
+
+        for (size_t i = 0; i < radius.size(); i++) {
+            size_t resolution = circle_detail_resolution(radius[i], detail);
+            offsets[i + 1] = offsets[i] + resolution;
+
+            auto& table = tables[circle_detail_level(resolution)];
+            if (!table)
+                table = unit_circle_table<T>(resolution);
+        }
+        return tables;
+    }
+
+    void _detailVertices(const _DetailTables& tables, const std::vector<size_t>& offsets,
+                         std::span<Vector2<T>> out, size_t begin, size_t end) const {
+        for (size_t i = begin; i < end; i++) {
+            size_t resolution = offsets[i + 1] - offsets[i];
+            const auto* table = tables[circle_detail_level(resolution)].get();
+            place_unit_vertices(table, resolution, resolution, out.data() + offsets[i],
+                                ShapeBatch<T>::position[i], radius[i], ShapeBatch<T>::rotation[i]);
+        }
+    }
+};
+
+
+
+
+
+template <typename T>
+class RectangleBatch : public ShapeBatch<T> {
+public:
+    // Data
+    VectorArray2<T> size;
+
+
+
+    // Default constructor
+    RectangleBatch() {}
+
+    // List constructor
+    RectangleBatch(const std::vector<Rectangle<T>>& rectangles) {
+        reserve(rectangles.size());
+        for (auto &r: rectangles)
+            push_back(r);
+    }
+
+
+
+    // Size management
+    void reserve(size_t count) {
+        ShapeBatch<T>::reserveShapes(count);
+        size.reserve(count);
+    }
+
+    void clear() {
+        ShapeBatch<T>::clearShapes();
+        size.clear();
+    }
+
+    void push_back(const Rectangle<T>& rectangle) {
+        if (rectangle.hasPendingTransform())
+            return push_back(flushed(rectangle));
+
+        ShapeBatch<T>::pushShape(rectangle);
+        size.push_back(rectangle.size);
+    }
+
+    Rectangle<T> get(size_t i) const {
+        return Rectangle<T>(size[i], ShapeBatch<T>::position[i], ShapeBatch<T>::rotation[i]);
+    }
+
+
+
+    // Utility functions
+    std::vector<T> areas() const {
+        std::vector<T> out(size.size());
+        areas(out);
+        return out;
+    }
+
+    void areas(std::span<T> out) const {
+        for (size_t i = 0; i < out.size() && i < size.size(); i++)
+            out[i] = size.x[i] * size.y[i];
+    }
+
+    std::vector<T> perimeters() const {
+        std::vector<T> out(size.size());
+        perimeters(out);
+        return out;
+    }
+
+    void perimeters(std::span<T> out) const {
+        for (size_t i = 0; i < out.size() && i < size.size(); i++)
+            out[i] = (size.x[i] * 2) + (size.y[i] * 2);
+    }
+
+    // Axis-aligned bounds of every shape, computed analytically
+    std::vector<Bounds2D<T>> bounds() const {
+        std::vector<Bounds2D<T>> out(ShapeBatch<T>::count());
+        bounds(out);
+        return out;
+    }
+
+    void bounds(std::span<Bounds2D<T>> out) const {
+        _bounds(out, 0, out.size());
+    }
+
+    // Same as above, split over an executor
+    void bounds(std::span<Bounds2D<T>> out, Executor& executor) const {
+        parallel_for(executor, 0, out.size(), [&](size_t begin, size_t end) { _bounds(out, begin, end); });
+    }
+
+    // Total number of vertices written by vertices()
+    size_t vertexCount() const { return size.size() * 4; }
+
+    // Renders every rectangle into one buffer, one after another, and returns how many vertices were written.
+    // Only whole rectangles are written, so the buffer should hold vertexCount() elements.
+    size_t vertices(std::span<Vector2<T>> out) const {
+        size_t count = _whole(out);
+        _vertices(out, 0, count);
+        return count * 4;
+    }
+
+    // Same as above, split over an executor
+    size_t vertices(std::span<Vector2<T>> out, Executor& executor) const {
+        size_t count = _whole(out);
+        parallel_for(executor, 0, count, [&](size_t begin, size_t end) { _vertices(out, begin, end); });
+        return count * 4;
+    }
+
+    // Renders every rectangle into a reusable list, which only allocates when it has to grow
+    void vertices(std::vector<Vector2<T>>& out) const {
+        INSTRUMENT_BUFFER(out, vertexCount());
+        out.resize(vertexCount());
+        vertices(std::span<Vector2<T>>(out));
+    }
+
+
+
+    // Transformative functions
+    void scaleAll(T scalar) { size *= scalar; }
+
+    void scaleFromAll(T scalar, T x, T y) { scaleFromAll(scalar, Vector2<T>(x, y)); }
+    void scaleFromAll(T scalar, Vector2<T> origin) {
+        scaleAll(scalar);
+        ShapeBatch<T>::scalePositionsFrom(scalar, origin);
+    }
+
+
+
+private:
+    void _bounds(std::span<Bounds2D<T>> out, size_t begin, size_t end) const {
+        for (size_t i = begin; i < end && i < ShapeBatch<T>::count(); i++)
+            out[i] = rectangle_bounds(ShapeBatch<T>::position[i], size[i], ShapeBatch<T>::rotation[i]);
+    }
+
+    // Number of whole rectangles that fit in the buffer
+    size_t _whole(std::span<Vector2<T>> out) const {
+        size_t count = out.size() / 4;
+        return count < size.size() ? count : size.size();
+    }
+
+    void _vertices(std::span<Vector2<T>> out, size_t begin, size_t end) const {
+        for (size_t i = begin; i < end; i++)
+            get(i).vertices(out.data() + (i * 4));
+    }
+};
+
+
+
+
+
+template <typename T>
+class NGonBatch : public ShapeBatch<T> {
+public:
+    // Data
+    std::vector<size_t> N; // Number of vertices of each N-Gon
+    std::vector<T> radius; // Circumradius of each N-Gon
+
+
+
+    // Default constructor
+    NGonBatch() {}
+
+    // List constructor
+    NGonBatch(const std::vector<NGon<T>>& ngons) {
+        reserve(ngons.size());
+        for (auto &n: ngons)
+            push_back(n);
+    }
+
+
+
+    // Size management
+    void reserve(size_t count) {
+        ShapeBatch<T>::reserveShapes(count);
+        N.reserve(count);
+        radius.reserve(count);
+    }
+
+    void clear() {
+        ShapeBatch<T>::clearShapes();
+        N.clear();
+        radius.clear();
+    }
+
+    void push_back(const NGon<T>& ngon) {
+        if (ngon.hasPendingTransform())
+            return push_back(flushed(ngon));
+
+        ShapeBatch<T>::pushShape(ngon);
+        N.push_back(ngon.N);
+        radius.push_back(ngon.radius);
+    }
+
+    NGon<T> get(size_t i) const {
+        return NGon<T>(N[i], radius[i], ShapeBatch<T>::position[i], ShapeBatch<T>::rotation[i]);
+    }
+
+
+
+    // Utility functions
+    // These evaluate the same expressions as NGon, so results are identical.
+    std::vector<T> areas() const {
+        std::vector<T> out(radius.size());
+        areas(out);
+        return out;
+    }
+
+    void areas(std::span<T> out) const {
+        for (size_t i = 0; i < out.size() && i < radius.size(); i++) {
+            T e = 2 * sin(M_PI / N[i]) * radius[i];
+            out[i] = (N[i] * e * e) / (4 * tan(M_PI / N[i]));
+        }
+    }
+
+    std::vector<T> perimeters() const {
+        std::vector<T> out(radius.size());
+        perimeters(out);
+        return out;
+    }
+
+    void perimeters(std::span<T> out) const {
+        for (size_t i = 0; i < out.size() && i < radius.size(); i++) {
+            T e = 2 * sin(M_PI / N[i]) * radius[i];
+            out[i] = e * N[i];
+        }
+    }
+
+    // Axis-aligned bounds of every shape, computed analytically
+    std::vector<Bounds2D<T>> bounds() const {
+        std::vector<Bounds2D<T>> out(ShapeBatch<T>::count());
+        bounds(out);
+        return out;
+    }
+
+    void bounds(std::span<Bounds2D<T>> out) const {
+        _bounds(out, 0, out.size());
+    }
+
+    // Same as above, split over an executor
+    void bounds(std::span<Bounds2D<T>> out, Executor& executor) const {
+        parallel_for(executor, 0, out.size(), [&](size_t begin, size_t end) { _bounds(out, begin, end); });
+    }
+
+    // Total number of vertices written by vertices()
+    size_t vertexCount() const {
+        size_t total = 0;
+        for (auto n: N)
+            total += n;
+        return total;
+    }
+
+    // Renders every N-Gon into one buffer, one after another, and returns how many vertices were written.
+    // Only whole N-Gons are written, so the buffer should hold vertexCount() elements.
+    size_t vertices(std::span<Vector2<T>> out) const {
+        size_t written = 0;
+        size_t count = 0;
+        while (count < N.size() && written + N[count] <= out.size())
+            written += N[count++];
+
+        _vertices(out, 0, count, 0);
+        return written;
+    }
+
+    // Same as above, split over an executor.
+    // The offset of every N-Gon is found up front, so each chunk knows where to start writing.
+    size_t vertices(std::span<Vector2<T>> out, Executor& executor) const {
+        std::vector<size_t> offsets;
+        offsets.reserve(N.size() + 1);
+        offsets.push_back(0);
+        while (offsets.size() <= N.size() && offsets.back() + N[offsets.size() - 1] <= out.size())
+            offsets.push_back(offsets.back() + N[offsets.size() - 1]);
+
+        parallel_for(executor, 0, offsets.size() - 1, [&](size_t begin, size_t end) {
+            _vertices(out, begin, end, offsets[begin]);
+        });
+        return offsets.back();
+    }
+
+    // Renders every N-Gon into a reusable list, which only allocates when it has to grow
+    void vertices(std::vector<Vector2<T>>& out) const {
+        INSTRUMENT_BUFFER(out, vertexCount());
+        out.resize(vertexCount());
+        vertices(std::span<Vector2<T>>(out));
+    }
+
+
+
+    // Transformative functions
+    void scaleAll(T scalar) {
+        for (auto &r: radius)
+            r *= scalar;
+    }
+
+    void scaleFromAll(T scalar, T x, T y) { scaleFromAll(scalar, Vector2<T>(x, y)); }
+    void scaleFromAll(T scalar, Vector2<T> origin) {
+        scaleAll(scalar);
+        ShapeBatch<T>::scalePositionsFrom(scalar, origin);
+    }
+
+
+
+private:
+    void _bounds(std::span<Bounds2D<T>> out, size_t begin, size_t end) const {
+        for (size_t i = begin; i < end && i < ShapeBatch<T>::count(); i++)
+            out[i] = ngon_bounds(ShapeBatch<T>::position[i], N[i], radius[i], ShapeBatch<T>::rotation[i]);
+    }
+
+    // Renders the N-Gons [begin, end), starting at the offset of the first one
+    void _vertices(std::span<Vector2<T>> out, size_t begin, size_t end, size_t written) const {
+        // Tables are looked up once per run of equal N, which is the common case for sorted batches
+        std::shared_ptr<const typename UnitCircleCache<T>::Table> table;
+        size_t table_n = 0;
+
+        for (size_t i = begin; i < end; i++) {
+            if (i == begin || table_n != N[i]) {
+                table = unit_circle_table<T>(N[i]);
+                table_n = N[i];
+            }
+
+            place_unit_vertices(table.get(), N[i], N[i], out.data() + written,
+                                ShapeBatch<T>::position[i], radius[i], ShapeBatch<T>::rotation[i]);
+            written += N[i];
+        }
+    }
+};
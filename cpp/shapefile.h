@@ -0,0 +1,531 @@
+/// Author: PlumpDolphin
+/// Date: October 16, 2026
+///
+/// Description:
+///     Provides a compact binary file format for shape collections, along with a writer and a memory-mapped reader.
+///     Shapes are stored in per-type sections of columns, matching the layout of the shape batches, so loading a
+///     file only maps it into memory and hands out typed views over the columns. Nothing is copied or parsed,
+///     and only the pages that are actually read are loaded from disk.
+///
+/// Format:
+///     All values are little-endian. Every section and column starts on a 64-byte boundary.
+///
+///     Header (32 bytes)
+///         char[8]  magic        "ONESHAPE"
+///         uint32   version      Currently 1
+///         uint32   sections     Number of entries in the section table
+///         uint32   angle_type   Value type code of Angle
+///         uint32   reserved     Always 0
+///         uint64   file_size    Total size of the file in bytes
+///
+///     Section table (32 bytes per section, directly after the header)
+///         uint32   shape        1 = Circle, 2 = Rectangle, 3 = NGon
+///         uint32   value_type   Value type code of T
+///         uint64   count        Number of shapes in the section
+///         uint64   offset       Byte offset of the first column
+///         uint64   bytes        Total size of all columns, including padding
+///
+///     Columns of each section, in order
+///         position.x, position.y (T), rotation (Angle), then
+///         Circle:    radius (T)
+///         Rectangle: size.x, size.y (T)
+///         NGon:      N (uint64), radius (T)
+///
+///     Value type codes are 0x100 for floating-point, 0x200 for signed and 0x300 for unsigned integers,
+///     added to the size of the type in bytes. For example, float is 0x104 and int64_t is 0x208.
+///
+/// License:
+///     The code in this file is licensed under the
+///     Revised 3-Clause BSD License.
+///     For details, see https://opensource.org/licenses/BSD-3-Clause
+
+
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#if defined(_WIN32)
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include "shapes.h"     // Includes definitions for the shapes.
+#include "shapebatch.h" // Includes definitions for the shape batches, which are written column by column.
+
+
+
+// Example usage showing a scene being saved and loaded again.
+/*
+    CircleBatch<float> circles = ...;
+    RectangleBatch<float> rectangles = ...;
+
+    // Batches are referenced by the writer, so they must stay alive until save() returns
+    ShapeFileWriter writer;
+    writer.add(circles);
+    writer.add(rectangles);
+    writer.save("scene.shapes");
+
+    // Map the file and read the columns directly
+    ShapeFile file;
+    if (file.open("scene.shapes")) {
+        for (auto &view: file.circles<float>())
+            for (size_t i = 0; i < view.count; i++)
+                total += view.radius[i];
+
+        // Copy a section into a batch when it needs to be modified
+        RectangleBatch<float> loaded = file.rectangles<float>()[0].toBatch();
+    }
+*/
+
+
+
+// Format constants
+constexpr char SHAPE_FILE_MAGIC[8] = { 'O', 'N', 'E', 'S', 'H', 'A', 'P', 'E' };
+constexpr uint32_t SHAPE_FILE_VERSION = 1;
+constexpr size_t SHAPE_FILE_ALIGNMENT = 64;
+
+enum class ShapeFileType : uint32_t {
+    Circle = 1,
+    Rectangle = 2,
+    NGon = 3,
+};
+
+struct ShapeFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t sections;
+    uint32_t angle_type;
+    uint32_t reserved;
+    uint64_t file_size;
+};
+
+struct ShapeFileSection {
+    uint32_t shape;
+    uint32_t value_type;
+    uint64_t count;
+    uint64_t offset;
+    uint64_t bytes;
+};
+
+static_assert(sizeof(ShapeFileHeader) == 32 && sizeof(ShapeFileSection) == 32,
+              "Shape file structures must match the on-disk layout.");
+
+
+
+// Returns the value type code of T, as stored in the header and section table.
+template <typename T>
+constexpr uint32_t shape_file_type_code() {
+    static_assert(std::is_arithmetic_v<T>, "Shape files can only store arithmetic value types.");
+    uint32_t kind = std::is_floating_point_v<T> ? 0x100 : std::is_signed_v<T> ? 0x200 : 0x300;
+    return kind + sizeof(T);
+}
+
+// Rounds a byte offset up to the next column boundary.
+constexpr uint64_t shape_file_align(uint64_t offset) {
+    return (offset + SHAPE_FILE_ALIGNMENT - 1) / SHAPE_FILE_ALIGNMENT * SHAPE_FILE_ALIGNMENT;
+}
+
+// Returns the byte size of each element of every column of a section, in order.
+inline std::vector<size_t> shape_file_columns(ShapeFileType shape, size_t value_size) {
+    std::vector<size_t> columns = { value_size, value_size, sizeof(Angle) };
+
+    switch (shape) {
+        case ShapeFileType::Circle:    columns.push_back(value_size); break;
+        case ShapeFileType::Rectangle: columns.insert(columns.end(), { value_size, value_size }); break;
+        case ShapeFileType::NGon:      columns.insert(columns.end(), { sizeof(uint64_t), value_size }); break;
+    }
+
+    return columns;
+}
+
+
+
+
+
+// Collects shape batches and writes them to a shape file.
+// Columns are written straight from the batches, which must stay alive until save() returns.
+class ShapeFileWriter {
+public:
+    template <typename T>
+    void add(const CircleBatch<T>& batch) {
+        Section& s = _section(ShapeFileType::Circle, shape_file_type_code<T>(), batch);
+        s.columns.push_back(batch.radius.data());
+    }
+
+    template <typename T>
+    void add(const RectangleBatch<T>& batch) {
+        Section& s = _section(ShapeFileType::Rectangle, shape_file_type_code<T>(), batch);
+        s.columns.push_back(batch.size.x);
+        s.columns.push_back(batch.size.y);
+    }
+
+    template <typename T>
+    void add(const NGonBatch<T>& batch) {
+        Section& s = _section(ShapeFileType::NGon, shape_file_type_code<T>(), batch);
+
+        // N is always stored as 64 bits, so it is only converted where size_t is smaller
+        if constexpr (sizeof(size_t) == sizeof(uint64_t)) {
+            s.columns.push_back(batch.N.data());
+        } else {
+            s.owned.assign(batch.N.begin(), batch.N.end());
+            s.columns.push_back(s.owned.data());
+        }
+        s.columns.push_back(batch.radius.data());
+    }
+
+    // Writes every added section to a file. Returns false if the file could not be written.
+    bool save(const std::string& path) const {
+        // The columns are written from memory as-is
+        if constexpr (std::endian::native != std::endian::little)
+            return false;
+
+        FILE* file = fopen(path.c_str(), "wb");
+        if (file == nullptr)
+            return false;
+
+        // Lay out the sections after the header and section table
+        std::vector<ShapeFileSection> table;
+        uint64_t offset = shape_file_align(sizeof(ShapeFileHeader) + sections.size() * sizeof(ShapeFileSection));
+
+        for (auto &s: sections) {
+            ShapeFileSection entry = s.info;
+            entry.offset = offset;
+            entry.bytes = 0;
+            for (size_t column: shape_file_columns(ShapeFileType(s.info.shape), s.value_size))
+                entry.bytes += shape_file_align(column * s.info.count);
+
+            offset += entry.bytes;
+            table.push_back(entry);
+        }
+
+        ShapeFileHeader header = {};
+        std::memcpy(header.magic, SHAPE_FILE_MAGIC, sizeof(header.magic));
+        header.version = SHAPE_FILE_VERSION;
+        header.sections = static_cast<uint32_t>(sections.size());
+        header.angle_type = shape_file_type_code<Angle>();
+        header.file_size = offset;
+
+        bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+        if (!table.empty())
+            ok = ok && fwrite(table.data(), sizeof(ShapeFileSection), table.size(), file) == table.size();
+        uint64_t written = sizeof(header) + table.size() * sizeof(ShapeFileSection);
+
+        // Write each column, padded up to the next boundary
+        static const char padding[SHAPE_FILE_ALIGNMENT] = {};
+        for (size_t i = 0; i < sections.size() && ok; i++) {
+            auto sizes = shape_file_columns(ShapeFileType(sections[i].info.shape), sections[i].value_size);
+
+            for (size_t c = 0; c < sizes.size() && ok; c++) {
+                size_t pad = shape_file_align(written) - written;
+                ok = pad == 0 || fwrite(padding, 1, pad, file) == pad;
+                written += pad;
+
+                size_t bytes = sizes[c] * sections[i].info.count;
+                ok = ok && (bytes == 0 || fwrite(sections[i].columns[c], 1, bytes, file) == bytes);
+                written += bytes;
+            }
+        }
+
+        size_t pad = shape_file_align(written) - written;
+        ok = ok && (pad == 0 || fwrite(padding, 1, pad, file) == pad);
+
+        return (fclose(file) == 0) && ok;
+    }
+
+
+
+private:
+    struct Section {
+        ShapeFileSection info;
+        size_t value_size;
+        std::vector<const void*> columns;
+        std::vector<uint64_t> owned;
+    };
+
+    std::vector<Section> sections;
+
+    template <typename Batch>
+    Section& _section(ShapeFileType shape, uint32_t value_type, const Batch& batch) {
+        Section s = {};
+        s.info.shape = static_cast<uint32_t>(shape);
+        s.info.value_type = value_type;
+        s.info.count = batch.count();
+        s.value_size = value_type & 0xFF;
+        s.columns = { batch.position.x, batch.position.y, batch.rotation.data() };
+
+        sections.push_back(std::move(s));
+        return sections.back();
+    }
+};
+
+
+
+
+
+// Typed views over the columns of a mapped section.
+// They point directly into the mapped file and stay valid until the ShapeFile is closed.
+template <typename T>
+struct CircleView {
+    size_t count = 0;
+    const T* x = nullptr;
+    const T* y = nullptr;
+    const Angle* rotation = nullptr;
+    const T* radius = nullptr;
+
+    Circle<T> get(size_t i) const { return Circle<T>(radius[i], x[i], y[i], rotation[i]); }
+
+    CircleBatch<T> toBatch() const {
+        CircleBatch<T> batch;
+        batch.reserve(count);
+        for (size_t i = 0; i < count; i++)
+            batch.push_back(get(i));
+        return batch;
+    }
+};
+
+template <typename T>
+struct RectangleView {
+    size_t count = 0;
+    const T* x = nullptr;
+    const T* y = nullptr;
+    const Angle* rotation = nullptr;
+    const T* width = nullptr;
+    const T* height = nullptr;
+
+    Rectangle<T> get(size_t i) const { return Rectangle<T>(width[i], height[i], x[i], y[i], rotation[i]); }
+
+    RectangleBatch<T> toBatch() const {
+        RectangleBatch<T> batch;
+        batch.reserve(count);
+        for (size_t i = 0; i < count; i++)
+            batch.push_back(get(i));
+        return batch;
+    }
+};
+
+template <typename T>
+struct NGonView {
+    size_t count = 0;
+    const T* x = nullptr;
+    const T* y = nullptr;
+    const Angle* rotation = nullptr;
+    const uint64_t* N = nullptr;
+    const T* radius = nullptr;
+
+    NGon<T> get(size_t i) const { return NGon<T>(static_cast<size_t>(N[i]), radius[i], x[i], y[i], rotation[i]); }
+
+    NGonBatch<T> toBatch() const {
+        NGonBatch<T> batch;
+        batch.reserve(count);
+        for (size_t i = 0; i < count; i++)
+            batch.push_back(get(i));
+        return batch;
+    }
+};
+
+
+
+
+
+// Memory-maps a shape file and exposes typed views over its sections.
+class ShapeFile {
+public:
+    ShapeFile() {}
+    ~ShapeFile() { close(); }
+
+    ShapeFile(const ShapeFile&) = delete;
+    ShapeFile& operator=(const ShapeFile&) = delete;
+
+
+
+    // Maps a file and validates its header and section table.
+    // Returns false if the file can't be mapped or is not a valid shape file for this build.
+    bool open(const std::string& path) {
+        close();
+
+        // Views are handed out over the raw little-endian columns
+        if constexpr (std::endian::native != std::endian::little)
+            return false;
+
+        if (!_map(path))
+            return false;
+
+        if (!_validate()) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        if (data != nullptr) {
+#if defined(_WIN32)
+            UnmapViewOfFile(data);
+#else
+            munmap(const_cast<unsigned char*>(data), size);
+#endif
+        }
+        data = nullptr;
+        size = 0;
+    }
+
+    bool isOpen() const { return data != nullptr; }
+
+
+
+    // Section table access
+    size_t sectionCount() const { return isOpen() ? _header()->sections : 0; }
+    const ShapeFileSection& section(size_t i) const { return _table()[i]; }
+
+    // Views of every section of a shape type with value type T
+    template <typename T>
+    std::vector<CircleView<T>> circles() const {
+        std::vector<CircleView<T>> views;
+        for (size_t i = 0; i < sectionCount(); i++) {
+            auto columns = _columns(i, ShapeFileType::Circle, shape_file_type_code<T>());
+            if (!columns.empty())
+                views.push_back({ section(i).count, (const T*)columns[0], (const T*)columns[1],
+                                  (const Angle*)columns[2], (const T*)columns[3] });
+        }
+        return views;
+    }
+
+    template <typename T>
+    std::vector<RectangleView<T>> rectangles() const {
+        std::vector<RectangleView<T>> views;
+        for (size_t i = 0; i < sectionCount(); i++) {
+            auto columns = _columns(i, ShapeFileType::Rectangle, shape_file_type_code<T>());
+            if (!columns.empty())
+                views.push_back({ section(i).count, (const T*)columns[0], (const T*)columns[1],
+                                  (const Angle*)columns[2], (const T*)columns[3], (const T*)columns[4] });
+        }
+        return views;
+    }
+
+    template <typename T>
+    std::vector<NGonView<T>> ngons() const {
+        std::vector<NGonView<T>> views;
+        for (size_t i = 0; i < sectionCount(); i++) {
+            auto columns = _columns(i, ShapeFileType::NGon, shape_file_type_code<T>());
+            if (!columns.empty())
+                views.push_back({ section(i).count, (const T*)columns[0], (const T*)columns[1],
+                                  (const Angle*)columns[2], (const uint64_t*)columns[3], (const T*)columns[4] });
+        }
+        return views;
+    }
+
+
+
+private:
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+
+    const ShapeFileHeader* _header() const { return reinterpret_cast<const ShapeFileHeader*>(data); }
+    const ShapeFileSection* _table() const {
+        return reinterpret_cast<const ShapeFileSection*>(data + sizeof(ShapeFileHeader));
+    }
+
+    // Returns pointers to every column of a section, or nothing if the section doesn't match.
+    std::vector<const void*> _columns(size_t i, ShapeFileType shape, uint32_t value_type) const {
+        const ShapeFileSection& s = section(i);
+        if (s.shape != static_cast<uint32_t>(shape) || s.value_type != value_type)
+            return {};
+
+        std::vector<const void*> columns;
+        uint64_t offset = s.offset;
+        for (size_t column: shape_file_columns(shape, value_type & 0xFF)) {
+            columns.push_back(data + offset);
+            offset += shape_file_align(column * s.count);
+        }
+        return columns;
+    }
+
+    bool _validate() const {
+        if (size < sizeof(ShapeFileHeader))
+            return false;
+
+        const ShapeFileHeader* header = _header();
+        if (std::memcmp(header->magic, SHAPE_FILE_MAGIC, sizeof(header->magic)) != 0
+            || header->version != SHAPE_FILE_VERSION
+            || header->angle_type != shape_file_type_code<Angle>()
+            || header->file_size > size)
+            return false;
+
+        if (header->sections > (size - sizeof(ShapeFileHeader)) / sizeof(ShapeFileSection))
+            return false;
+
+        // Every section must be aligned, fit inside the file and be large enough for its columns
+        for (size_t i = 0; i < header->sections; i++) {
+            const ShapeFileSection& s = _table()[i];
+            if (s.shape < 1 || s.shape > 3 || (s.value_type & 0xFF) == 0 || s.offset % SHAPE_FILE_ALIGNMENT != 0)
+                return false;
+            if (s.offset > size || s.bytes > size - s.offset)
+                return false;
+
+            uint64_t needed = 0;
+            for (size_t column: shape_file_columns(ShapeFileType(s.shape), s.value_type & 0xFF)) {
+                if (s.count > size / column)
+                    return false;
+                needed += shape_file_align(column * s.count);
+            }
+            if (needed > s.bytes)
+                return false;
+        }
+        return true;
+    }
+
+    bool _map(const std::string& path) {
+#if defined(_WIN32)
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+
+        LARGE_INTEGER file_size;
+        HANDLE mapping = nullptr;
+        if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0)
+            mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (mapping == nullptr)
+            return false;
+
+        void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        if (view == nullptr)
+            return false;
+
+        data = static_cast<const unsigned char*>(view);
+        size = static_cast<size_t>(file_size.QuadPart);
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size <= 0) {
+            ::close(fd);
+            return false;
+        }
+
+        void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (view == MAP_FAILED)
+            return false;
+
+        data = static_cast<const unsigned char*>(view);
+        size = static_cast<size_t>(info.st_size);
+#endif
+        return true;
+    }
+};
@@ -0,0 +1,435 @@
+/// Author: PlumpDolphin
+/// Date: October 16, 2026
+///
+/// Description:
+///     Provides streaming JSON serialization for large collections of Vectors and shapes.
+///     The JsonArrayWriter appends every element to one reusable buffer and writes it to a file descriptor
+///     in large chunks, so a scene of millions of shapes is serialized without building a string per shape
+///     or holding the whole document in memory. Output is byte-identical to joining each element's json().
+///
+///     The matching loader parses such an array back into shape batches in a single pass over the input.
+///     For large inputs, a SIMD scan first counts the shapes of each type so every batch is allocated only once.
+///
+/// License:
+///     The code in this file is licensed under the
+///     Revised 3-Clause BSD License.
+///     For details, see https://opensource.org/licenses/BSD-3-Clause
+
+
+#pragma once
+
+#include <bit>
+#include <cerrno>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+    #include <io.h>
+#else
+    #include <unistd.h>
+#endif
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+    #include <immintrin.h>
+#endif
+
+#include "shapes.h"     // Includes definitions for the shapes and their json() serializers.
+#include "shapebatch.h" // Includes definitions for the shape batches.
+
+
+
+// Example usage showing a scene being streamed to a file.
+/*
+    int fd = open("scene.json", O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    // Writes "[" now, then each shape separated by commas
+    JsonArrayWriter writer(fd);
+
+    writer.write(Circle<float>(5, 1, 2));
+    writer.write(Rectangle<float>(2, 4));
+
+    // Whole batches and lists can be written at once
+    writer.writeAll(circleBatch);
+    writer.writeAll(ngonList);
+
+    // Batches can also be serialized over an executor, which writes exactly the same bytes
+    writer.writeAll(rectangleBatch, Executor::shared());
+
+    // Writes the closing "]" and any remaining buffered output
+    if (!writer.close())
+        std::cerr << "Failed to write scene" << std::endl;
+
+    ::close(fd);
+
+    // Load the scene back into one batch per shape type
+    CircleBatch<float> circles;
+    RectangleBatch<float> rectangles;
+    NGonBatch<float> ngons;
+
+    JsonLoadResult result = loadShapesJsonFile("scene.json", circles, rectangles, ngons);
+    if (!result)
+        std::cerr << "Invalid JSON at byte " << result.error_offset << std::endl;
+*/
+
+
+
+
+
+// Writes a JSON array of elements to a file descriptor, flushing whenever a chunk has been filled.
+// Any element with a `json(std::string&)` serializer can be written.
+// The file descriptor is not owned by the writer and stays open after close().
+class JsonArrayWriter {
+public:
+    // Default amount of buffered output before it is written to the file descriptor
+    static constexpr size_t default_chunk_size = 1 << 20;
+
+
+
+    JsonArrayWriter(int fd, size_t chunk_size = default_chunk_size)
+        : fd(fd), chunk_size(chunk_size) {
+        buffer.reserve(chunk_size + 256);
+        buffer += '[';
+    }
+
+    // Closes the array if it is still open
+    ~JsonArrayWriter() { close(); }
+
+    JsonArrayWriter(const JsonArrayWriter&) = delete;
+    JsonArrayWriter& operator=(const JsonArrayWriter&) = delete;
+
+
+
+    // Appends a single element to the array
+    template <typename Element>
+    void write(const Element& element) {
+        if (elements++ > 0)
+            buffer += ',';
+
+        element.json(buffer);
+
+        if (buffer.size() >= chunk_size)
+            flush();
+    }
+
+    // Appends every element of a list to the array
+    template <typename List>
+    void writeAll(const List& list) {
+        for (const auto &element: list)
+            write(element);
+    }
+
+    // Appends every shape of a batch to the array
+    template <typename U>
+    void writeAll(const CircleBatch<U>& batch)    { _write_batch(batch); }
+    template <typename U>
+    void writeAll(const RectangleBatch<U>& batch) { _write_batch(batch); }
+    template <typename U>
+    void writeAll(const NGonBatch<U>& batch)      { _write_batch(batch); }
+
+    // Same as above, serializing the shapes in parallel. The output is the same as writing them one at a time.
+    template <typename U>
+    void writeAll(const CircleBatch<U>& batch, Executor& executor)    { _write_batch(batch, executor); }
+    template <typename U>
+    void writeAll(const RectangleBatch<U>& batch, Executor& executor) { _write_batch(batch, executor); }
+    template <typename U>
+    void writeAll(const NGonBatch<U>& batch, Executor& executor)      { _write_batch(batch, executor); }
+
+
+
+    // Writes all buffered output to the file descriptor. Returns false once any write has failed.
+    bool flush() {
+        const char* data = buffer.data();
+        size_t remaining = buffer.size();
+
+        while (remaining > 0 && !failed) {
+#if defined(_WIN32)
+            auto result = ::_write(fd, data, static_cast<unsigned int>(remaining));
+#else
+            auto result = ::write(fd, data, remaining);
+#endif
+            if (result < 0) {
+                // Retry writes interrupted by a signal
+                if (errno == EINTR)
+                    continue;
+                failed = true;
+                break;
+            }
+
+            data += result;
+            remaining -= result;
+            bytes += result;
+        }
+
+        buffer.clear();
+        return !failed;
+    }
+
+    // Writes the closing bracket and flushes. Returns false if any write has failed.
+    bool close() {
+        if (!closed) {
+            buffer += ']';
+            closed = true;
+            flush();
+        }
+        return !failed;
+    }
+
+
+
+    // Status functions
+    bool good() const { return !failed; }
+
+    size_t count() const        { return elements; } // Number of elements written so far
+    size_t bytesWritten() const { return bytes; }    // Number of bytes sent to the file descriptor
+
+
+
+private:
+    int fd;
+    size_t chunk_size;
+    std::string buffer;
+
+    size_t elements = 0;
+    size_t bytes = 0;
+    bool closed = false;
+    bool failed = false;
+
+    template <typename Batch>
+    void _write_batch(const Batch& batch) {
+        for (size_t i = 0; i < batch.count(); i++)
+            write(batch.get(i));
+    }
+
+    // Number of shapes serialized by each part of a parallel write
+    static constexpr size_t shapes_per_part = 1024;
+
+    // Every part serializes a run of shapes into its own string, each shape preceded by a comma.
+    // Parts are appended in order, a block at a time, so only one block of text is held in memory.
+    template <typename Batch>
+    void _write_batch(const Batch& batch, Executor& executor) {
+        std::vector<std::string> parts(executor.threadCount() * Executor::chunks_per_thread);
+        size_t block = parts.size() * shapes_per_part;
+
+        for (size_t first = 0; first < batch.count(); first += block) {
+            size_t last = batch.count() - first > block ? first + block : batch.count();
+
+            parallel_for(executor, 0, parts.size(), [&](size_t begin, size_t end) {
+                for (size_t p = begin; p < end; p++) {
+                    auto [part_first, part_last] = _part_range(first, last, p);
+                    parts[p].clear();
+                    for (size_t i = part_first; i < part_last; i++) {
+                        parts[p] += ',';
+                        batch.get(i).json(parts[p]);
+                    }
+                }
+            }, 1);
+
+            for (size_t p = 0; p < parts.size(); p++) {
+                auto [part_first, part_last] = _part_range(first, last, p);
+                if (part_first >= part_last)
+                    break;
+
+                // The very first element of the array has no comma
+                buffer.append(parts[p], elements == 0 ? 1 : 0);
+                elements += part_last - part_first;
+
+                if (buffer.size() >= chunk_size)
+                    flush();
+            }
+        }
+    }
+
+    static std::pair<size_t, size_t> _part_range(size_t first, size_t last, size_t part) {
+        size_t begin = first + (part * shapes_per_part);
+        size_t end = begin + shapes_per_part;
+        return { begin < last ? begin : last, end < last ? end : last };
+    }
+};
+
+
+
+
+
+
+// Result of loading a JSON array of shapes
+struct JsonLoadResult {
+    bool ok = false;
+    size_t shapes = 0;       // Number of shapes loaded
+    size_t error_offset = 0; // Byte offset of the first invalid character, when loading failed
+
+    explicit operator bool() const { return ok; }
+};
+
+// Shape counts estimated by the structural scan
+struct JsonShapeCounts {
+    size_t circles = 0;
+    size_t rectangles = 0;
+    size_t ngons = 0;
+};
+
+// Inputs at least this large are scanned before parsing, so every batch is only allocated once
+constexpr size_t JSON_PRESCAN_THRESHOLD = 1 << 16;
+
+
+
+// Counts the shapes of each type in a JSON array written by json().
+// Every shape is one object, '"N"' only appears in N-Gons and the 'z' of '"size"' only appears in rectangles,
+// so counting three characters is enough. This is only used as an allocation hint.
+inline JsonShapeCounts count_json_shapes(std::string_view json) {
+    const char* data = json.data();
+    size_t count = json.size();
+    size_t i = 0;
+
+    size_t objects = 0;
+    size_t n = 0;
+    size_t z = 0;
+
+#if defined(__AVX2__)
+    const __m256i open = _mm256_set1_epi8('{');
+    const __m256i upper_n = _mm256_set1_epi8('N');
+    const __m256i lower_z = _mm256_set1_epi8('z');
+
+    for (; i + 32 <= count; i += 32) {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        objects += std::popcount(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, open))));
+        n += std::popcount(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, upper_n))));
+        z += std::popcount(static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, lower_z))));
+    }
+#elif defined(__SSE2__) || defined(_M_X64)
+    const __m128i open = _mm_set1_epi8('{');
+    const __m128i upper_n = _mm_set1_epi8('N');
+    const __m128i lower_z = _mm_set1_epi8('z');
+
+    for (; i + 16 <= count; i += 16) {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        objects += std::popcount(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, open))));
+        n += std::popcount(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, upper_n))));
+        z += std::popcount(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, lower_z))));
+    }
+#endif
+
+    // Scalar tail, or the whole input without SIMD support
+    for (; i < count; i++) {
+        objects += data[i] == '{';
+        n += data[i] == 'N';
+        z += data[i] == 'z';
+    }
+
+    JsonShapeCounts counts;
+    counts.ngons = n;
+    counts.rectangles = z;
+    counts.circles = objects > n + z ? objects - n - z : 0;
+    return counts;
+}
+
+
+
+// Parses a JSON array of shapes, as written by JsonArrayWriter, appending each shape to the batch of its type.
+// Shapes are told apart by their members: "N" marks an N-Gon, "size" a Rectangle, and anything else is a Circle.
+// Shapes before an error remain in the batches.
+template <typename T>
+JsonLoadResult loadShapesJson(std::string_view json, CircleBatch<T>& circles, RectangleBatch<T>& rectangles,
+                              NGonBatch<T>& ngons, bool prescan = true) {
+    JsonLoadResult result;
+
+    const char* begin = json.data();
+    const char* first = begin;
+    const char* last = begin + json.size();
+
+    if (prescan && json.size() >= JSON_PRESCAN_THRESHOLD) {
+        JsonShapeCounts counts = count_json_shapes(json);
+        circles.reserve(circles.count() + counts.circles);
+        rectangles.reserve(rectangles.count() + counts.rectangles);
+        ngons.reserve(ngons.count() + counts.ngons);
+    }
+
+    // Every member of every shape type is read into one record, which is then added to the right batch
+    struct Record {
+        Vector2<T> position;
+        Angle rotation = 0;
+        T radius = 0;
+        Vector2<T> size;
+        size_t N = 0;
+        bool has_size = false;
+        bool has_N = false;
+    };
+
+    auto fail = [&]() {
+        result.error_offset = first - begin;
+        return result;
+    };
+
+    if (!expect_json(first, last, '['))
+        return fail();
+
+    skip_json_whitespace(first, last);
+    bool empty = first != last && *first == ']';
+    if (empty)
+        first++;
+
+    while (!empty) {
+        Record r;
+        bool valid = parse_json_object(first, last, [&r](std::string_view key, const char*& f, const char* l) {
+            if (key == "position")
+                return r.position.parseJson(f, l);
+            if (key == "rotation")
+                return parse_formatted(f, l, r.rotation);
+            if (key == "radius")
+                return parse_formatted(f, l, r.radius);
+            if (key == "size")
+                return (r.has_size = true) && r.size.parseJson(f, l);
+            if (key == "N")
+                return (r.has_N = true) && parse_formatted(f, l, r.N);
+            return skip_json_value(f, l);
+        });
+        if (!valid)
+            return fail();
+
+        if (r.has_N)
+            ngons.push_back(NGon<T>(r.N, r.radius, r.position, r.rotation));
+        else if (r.has_size)
+            rectangles.push_back(Rectangle<T>(r.size, r.position, r.rotation));
+        else
+            circles.push_back(Circle<T>(r.radius, r.position, r.rotation));
+        result.shapes++;
+
+        skip_json_whitespace(first, last);
+        if (first == last)
+            return fail();
+        if (*first == ']') {
+            first++;
+            break;
+        }
+        if (*first++ != ',')
+            return fail();
+    }
+
+    // Only whitespace may follow the array
+    skip_json_whitespace(first, last);
+    if (first != last)
+        return fail();
+
+    result.ok = true;
+    return result;
+}
+
+// Reads a whole file and parses it with loadShapesJson.
+template <typename T>
+JsonLoadResult loadShapesJsonFile(const std::string& path, CircleBatch<T>& circles,
+                                  RectangleBatch<T>& rectangles, NGonBatch<T>& ngons, bool prescan = true) {
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == nullptr)
+        return JsonLoadResult();
+
+    std::string contents;
+    char chunk[1 << 16];
+    size_t read;
+    while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0)
+        contents.append(chunk, read);
+    fclose(file);
+
+    return loadShapesJson(contents, circles, rectangles, ngons, prescan);
+}
@@ -20,8 +20,29 @@
 #include <sstream>
 #include <vector> // Include vector lists
 #include <cmath>
-
-#include "vectorx.h" // Includes definition for Vector2<T> required for the shapes.
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+
+#include "vectorx.h"     // Includes definition for Vector2<T> required for the shapes.
+#include "vectorarray.h" // Includes definition for VectorArray2<T> used by the bulk functions.
+#include "transform.h"   // Includes definition for Transform2D<T> used by deferred transforms.
+#include "executor.h"    // Includes definition for Executor used by the parallel bulk functions.
+#include "fixedpoint.h"  // Includes the fixed-point rotation used by integer shapes.
+#include "instrument.h"  // Includes the optional counters and timers of the hot paths.
+#include "pointquery.h"  // Includes the analytic point queries behind contains() and signedDistance().
+#include "rayquery.h"    // Includes Ray2D and the exact ray intersections behind raycast().
+#include "rasterspan.h"  // Includes the scanline spans drawn by the Rasterizer.
 
 
 
@@ -59,12 +80,27 @@
     // Print out the rectangle as json
     std::cout << r.json() << std::endl;
 
+    // Append the circle's json to an existing string, which avoids building a new string
+    std::string scene;
+    c.json(scene);
+
+    // Read the circle back from its json
+    Circle<float> copy;
+    Circle<float>::fromJson(scene, copy);
+
+    // Render the circle with just enough vertices to stay within 0.25 units of the true outline
+    std::vector<Vector2<float>> outline = c.vertices(CircleDetail{ 0.25 });
+
     // Create NGon with 5 points and circumradius of 5
     NGon<float> n(5, 5);
 
     // Print out features of n-gon
     std::cout << n.inradius() << std::endl;
     std::cout << n.str() << std::endl;
+
+    // N-Gons with a vertex count known at compile time have their vertex table built by the compiler
+    FixedNGon<float, 6> hexagon(5);
+    std::vector<Vector2<float>> corners = hexagon.vertices();
 */
 
 
@@ -88,31 +124,665 @@ T to_degrees(T radians) {
     return (radians * 180) / M_PI;
 }
 
+template <typename T, typename S> constexpr
+Vector2<T> rotate_point(Vector2<T> position, Vector2<T> origin, S cosine, S sine) {
+    // Get X and Y difference of position and the rotation origin.
+    Vector2<T> diff = position - origin;
+
+    // Perform the rotation on the difference vector
+    // Because it is offset from the rotation origin, this is considered in local space.
+    auto x = (diff.x * cosine) - (diff.y * sine);
+    auto y = (diff.x * sine) + (diff.y * cosine);
+
+    // Offset by rotation origin again to get global position.
+    return Vector2<T>(x, y) + origin;
+}
+
+// Integer points are rotated in fixed-point, which is exact for multiples of 90 degrees and the same on every platform.
 template <typename T> constexpr
 Vector2<T> rotate_point(Vector2<T> position, Vector2<T> origin, Angle degrees) {
     // Check easy return case
     if (degrees == 0)
         return position;
 
-    // Get X and Y difference of position and the rotation origin.
-    Vector2<T> diff = position - origin;
+    if constexpr (std::is_integral_v<T>) {
+        return rotate_point(position, origin, fixed_rotation(degrees));
+    } else {
+        static_assert(std::is_floating_point_v<T>, "Points are rotated in fixed-point or floating-point.");
+        INSTRUMENT_SCOPE("rotate_point");
+        INSTRUMENT_COUNT(TrigEvaluations, 2);
 
-    // Calculate sin and cosine of angle
-    Angle radians = to_radians(degrees);
-    auto cd = cos(radians);
-    auto sd = sin(radians);
+        // Calculate sin and cosine of angle
+        Angle radians = to_radians(degrees);
+        return rotate_point(position, origin, cos(radians), sin(radians));
+    }
+}
 
-    // Perform the rotation on the difference vector
-    // Because it is offset from the rotation origin, this is considered in local space.
-    auto x = (diff.x * cd) - (diff.y * sd);
-    auto y = (diff.x * sd) + (diff.y * cd);
 
-    // Offset by rotation origin again to get global position.
-    return Vector2<T>(x, y) + origin;
+
+// Bulk rotation functions
+// These apply the same rotation to every point, so sine and cosine are only evaluated once per call.
+// The input and output may be the same buffer to rotate the points in place.
+
+// Rotates every point around the origin, using a precomputed cosine and sine of the angle.
+template <typename T, typename S>
+void rotate_points(std::span<const Vector2<std::type_identity_t<T>>> in,
+                   std::span<Vector2<std::type_identity_t<T>>> out,
+                   Vector2<T> origin, S cosine, S sine) {
+    const Vector2<T>* src = in.data();
+    Vector2<T>* dst = out.data();
+    size_t count = in.size() < out.size() ? in.size() : out.size();
+
+    for (size_t i = 0; i < count; i++)
+        dst[i] = rotate_point(src[i], origin, cosine, sine);
+}
+
+// Rotates every point around the origin by some angle in degrees.
+template <typename T>
+void rotate_points(std::span<const Vector2<std::type_identity_t<T>>> in,
+                   std::span<Vector2<std::type_identity_t<T>>> out,
+                   Vector2<T> origin, Angle degrees) {
+    // Check easy case, which only needs a copy
+    if (degrees == 0) {
+        size_t count = in.size() < out.size() ? in.size() : out.size();
+        if (in.data() != out.data())
+            for (size_t i = 0; i < count; i++)
+                out[i] = in[i];
+        return;
+    }
+
+    if constexpr (std::is_integral_v<T>) {
+        rotate_points_fixed<T>(in, out, origin, fixed_rotation(degrees));
+    } else {
+        static_assert(std::is_floating_point_v<T>, "Points are rotated in fixed-point or floating-point.");
+        INSTRUMENT_COUNT(TrigEvaluations, 2);
+        Angle radians = to_radians(degrees);
+        rotate_points<T>(in, out, origin, cos(radians), sin(radians));
+    }
+}
+
+// Rotates the elements [begin, end) of a pair of lanes
+template <typename T, typename S>
+void _rotate_lanes(const T* sx, const T* sy, T* dx, T* dy, size_t begin, size_t end,
+                   Vector2<T> origin, S cosine, S sine) {
+    for (size_t i = begin; i < end; i++) {
+        // Same arithmetic as rotate_point, so results match it exactly
+        T ox = sx[i] - origin.x;
+        T oy = sy[i] - origin.y;
+
+        auto x = (ox * cosine) - (oy * sine);
+        auto y = (ox * sine) + (oy * cosine);
+
+        dx[i] = static_cast<T>(x) + origin.x;
+        dy[i] = static_cast<T>(y) + origin.y;
+    }
+}
+
+// Structure-of-arrays variant, which keeps every lane contiguous for the vectorizer.
+template <typename T, typename S>
+void rotate_points(const VectorArray2<T>& in, VectorArray2<T>& out,
+                   Vector2<T> origin, S cosine, S sine) {
+    if (&in != &out)
+        out.resize(in.size());
+
+    _rotate_lanes(in.x, in.y, out.x, out.y, 0, in.size(), origin, cosine, sine);
+}
+
+template <typename T>
+void rotate_points(const VectorArray2<T>& in, VectorArray2<T>& out, Vector2<T> origin, Angle degrees) {
+    if constexpr (std::is_integral_v<T>) {
+        rotate_points_fixed(in, out, origin, fixed_rotation(degrees));
+    } else {
+        INSTRUMENT_COUNT(TrigEvaluations, 2);
+        Angle radians = to_radians(degrees);
+        rotate_points(in, out, origin, cos(radians), sin(radians));
+    }
+}
+
+
+// Parallel variants, which split the points over an executor. Results are the same as the variants above.
+template <typename T>
+void rotate_points(std::span<const Vector2<std::type_identity_t<T>>> in,
+                   std::span<Vector2<std::type_identity_t<T>>> out,
+                   Vector2<T> origin, Angle degrees, Executor& executor) {
+    size_t count = in.size() < out.size() ? in.size() : out.size();
+    parallel_for(executor, 0, count, [&](size_t begin, size_t end) {
+        rotate_points<T>(in.subspan(begin, end - begin), out.subspan(begin, end - begin), origin, degrees);
+    });
+}
+
+template <typename T>
+void rotate_points(const VectorArray2<T>& in, VectorArray2<T>& out, Vector2<T> origin, Angle degrees,
+                   Executor& executor) {
+    if (&in != &out)
+        out.resize(in.size());
+
+    if constexpr (std::is_integral_v<T>) {
+        FixedRotation rotation = fixed_rotation(degrees);
+        parallel_for(executor, 0, in.size(), [&](size_t begin, size_t end) {
+            _rotate_lanes_fixed(in.x, in.y, out.x, out.y, begin, end, origin, rotation);
+        });
+    } else {
+        INSTRUMENT_COUNT(TrigEvaluations, 2);
+        Angle radians = to_radians(degrees);
+        auto cosine = cos(radians);
+        auto sine = sin(radians);
+
+        parallel_for(executor, 0, in.size(), [&](size_t begin, size_t end) {
+            _rotate_lanes(in.x, in.y, out.x, out.y, begin, end, origin, cosine, sine);
+        });
+    }
+}
+
+
+
+
+// Process-wide cache of unit-circle direction tables.
+// Each table holds `resolution` evenly spaced unit vectors, starting at (0, 1) and continuing clockwise,
+// which is the vertex order used by Circle::vertices and NGon::vertices. Tables are shared between
+// every shape of the same value type T, so trig is only evaluated the first time a resolution is used.
+template <typename T>
+class UnitCircleCache {
+public:
+    // Directions are stored in floating-point, even for integer shapes.
+    using Real = std::conditional_t<std::is_floating_point_v<T>, T, Angle>;
+    using Table = std::vector<Vector2<Real>>;
+
+    struct Stats {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t evictions = 0;
+        size_t tables = 0; // Number of tables currently cached
+    };
+
+
+
+    // Returns the direction table for a resolution, building and caching it if needed.
+    // The returned table stays valid for as long as it is held, even if it is evicted in the meantime.
+    static std::shared_ptr<const Table> table(size_t resolution) {
+        UnitCircleCache& cache = instance();
+
+        // Fast path, shared with every other reader
+        {
+            std::shared_lock<std::shared_mutex> lock(cache.mutex);
+            auto it = cache.tables.find(resolution);
+            if (it != cache.tables.end()) {
+                it->second.last_use.store(++cache.tick, std::memory_order_relaxed);
+                cache.hits.fetch_add(1, std::memory_order_relaxed);
+                return it->second.table;
+            }
+        }
+
+        // Build the table outside of the lock, since this is the only part that evaluates trig
+        cache.misses.fetch_add(1, std::memory_order_relaxed);
+        INSTRUMENT_COUNT(TrigEvaluations, 2 * resolution);
+        auto built = std::make_shared<Table>(resolution);
+        for (size_t i = 0; i < resolution; i++) {
+            double radians = (2 * M_PI * i) / resolution;
+            (*built)[i] = Vector2<Real>(static_cast<Real>(sin(radians)), static_cast<Real>(cos(radians)));
+        }
+
+        std::unique_lock<std::shared_mutex> lock(cache.mutex);
+
+        // Another thread may have inserted the same table while this one was building it
+        auto [it, inserted] = cache.tables.try_emplace(resolution);
+        if (inserted)
+            it->second.table = std::move(built);
+        it->second.last_use.store(++cache.tick, std::memory_order_relaxed);
+
+        auto result = it->second.table;
+        cache.evict();
+        return result;
+    }
+
+    // Limits the number of cached tables. The least recently used tables are evicted first.
+    // A capacity of 0 means the cache is unbounded, which is the default.
+    static void setCapacity(size_t capacity) {
+        UnitCircleCache& cache = instance();
+        std::unique_lock<std::shared_mutex> lock(cache.mutex);
+        cache.capacity = capacity;
+        cache.evict();
+    }
+
+    static Stats stats() {
+        UnitCircleCache& cache = instance();
+        std::shared_lock<std::shared_mutex> lock(cache.mutex);
+
+        Stats s;
+        s.hits = cache.hits.load(std::memory_order_relaxed);
+        s.misses = cache.misses.load(std::memory_order_relaxed);
+        s.evictions = cache.evictions;
+        s.tables = cache.tables.size();
+        return s;
+    }
+
+    static void resetStats() {
+        UnitCircleCache& cache = instance();
+        std::unique_lock<std::shared_mutex> lock(cache.mutex);
+        cache.hits = 0;
+        cache.misses = 0;
+        cache.evictions = 0;
+    }
+
+    // Drops every cached table. Tables still held by callers remain valid.
+    static void clear() {
+        UnitCircleCache& cache = instance();
+        std::unique_lock<std::shared_mutex> lock(cache.mutex);
+        cache.tables.clear();
+    }
+
+
+
+private:
+    struct Entry {
+        std::shared_ptr<const Table> table;
+        std::atomic<uint64_t> last_use{0};
+    };
+
+    std::shared_mutex mutex;
+    std::unordered_map<size_t, Entry> tables;
+    std::atomic<uint64_t> tick{0};
+    std::atomic<size_t> hits{0};
+    std::atomic<size_t> misses{0};
+    size_t evictions = 0;
+    size_t capacity = 0;
+
+    static UnitCircleCache& instance() {
+        static UnitCircleCache cache;
+        return cache;
+    }
+
+    // Removes least recently used tables until the capacity is met. Requires the exclusive lock.
+    void evict() {
+        while (capacity > 0 && tables.size() > capacity) {
+            auto oldest = tables.begin();
+            for (auto it = tables.begin(); it != tables.end(); it++)
+                if (it->second.last_use.load(std::memory_order_relaxed) < oldest->second.last_use.load(std::memory_order_relaxed))
+                    oldest = it;
+
+            tables.erase(oldest);
+            evictions++;
+        }
+    }
+};
+
+// Compile-time unit-circle tables
+// These match the direction tables of UnitCircleCache, but are evaluated by the compiler,
+// so shapes with a fixed vertex count have their table baked into the binary.
+
+// Returns direction i of N, (sin(2πi/N), cos(2πi/N)), in a constant expression.
+template <typename Real>
+constexpr Vector2<Real> unit_vertex(size_t i, size_t N) {
+    // Split the angle into whole quarter turns and a remainder within an eighth of a turn,
+    // using exact integer arithmetic, so the series below converges in a few terms
+    long long n = static_cast<long long>(N);
+    long long k = 4 * static_cast<long long>(i % N);
+    long long quarter = ((2 * k) + n) / (2 * n);
+    double r = (M_PI / 2) * static_cast<double>(k - (quarter * n)) / static_cast<double>(n);
+
+    // Taylor series of sine and cosine, accurate to double precision for |r| <= π/4
+    double r2 = r * r;
+    double sine = r, cosine = 1;
+    double sine_term = r, cosine_term = 1;
+    for (int t = 1; t <= 10; t++) {
+        sine_term *= -r2 / ((2 * t) * ((2 * t) + 1));
+        cosine_term *= -r2 / (((2 * t) - 1) * (2 * t));
+        sine += sine_term;
+        cosine += cosine_term;
+    }
+
+    // Rotate the remainder back by the quarter turns
+    switch (quarter % 4) {
+    case 1:  return Vector2<Real>(static_cast<Real>(cosine), static_cast<Real>(-sine));
+    case 2:  return Vector2<Real>(static_cast<Real>(-sine), static_cast<Real>(-cosine));
+    case 3:  return Vector2<Real>(static_cast<Real>(-cosine), static_cast<Real>(sine));
+    default: return Vector2<Real>(static_cast<Real>(sine), static_cast<Real>(cosine));
+    }
+}
+
+// Builds the table of all N directions in a constant expression.
+template <typename Real, size_t N>
+constexpr std::array<Vector2<Real>, N> unit_vertex_table() {
+    std::array<Vector2<Real>, N> table;
+    for (size_t i = 0; i < N; i++)
+        table[i] = unit_vertex<Real>(i, N);
+    return table;
 }
 
 
 
+// Places the first `count` of `resolution` evenly spaced vertices of an integer shape in fixed-point,
+// so they are the same on every platform. No direction table is read.
+template <typename T, typename OutputIt>
+OutputIt place_fixed_vertices(size_t resolution, size_t count, OutputIt out, Vector2<T> position, T radius, Angle degrees) {
+    static_assert(std::is_integral_v<T>, "Only integer shapes place their vertices in fixed-point.");
+    if (count > resolution)
+        count = resolution;
+
+    int64_t rotation = fixed_degrees(degrees);
+    for (size_t i = 0; i < count; i++, out++)
+        *out = fixed_unit_vertex(i, resolution, rotation, radius) + position;
+    return out;
+}
+
+// Scales, rotates and translates the first `count` entries of a unit-circle table into shape vertices.
+// This is the shared vertex generator for Circle, NGon and FixedNGon.
+// Integer shapes look every direction up in fixed-point instead, so their vertices are the same on every platform.
+template <typename T, typename Real, typename OutputIt>
+OutputIt place_unit_vertices(std::span<const Vector2<Real>> table, size_t count, OutputIt out,
+                             Vector2<T> position, T radius, Angle degrees) {
+    if constexpr (std::is_integral_v<T>) {
+        return place_fixed_vertices(table.size(), count, out, position, radius, degrees);
+    } else {
+        if (count > table.size())
+            count = table.size();
+
+        // Fold the radius into the rotation, so each vertex only needs a 2x2 multiply and an offset
+        INSTRUMENT_COUNT(TrigEvaluations, 2);
+        Real radians = to_radians<Real>(degrees);
+        Real rc = cos(radians) * radius;
+        Real rs = sin(radians) * radius;
+
+        const Vector2<Real>* dir = table.data();
+
+        for (size_t i = 0; i < count; i++, out++)
+            *out = Vector2<T>(static_cast<T>(position.x + ((dir[i].x * rc) - (dir[i].y * rs))),
+                              static_cast<T>(position.y + ((dir[i].x * rs) + (dir[i].y * rc))));
+
+        return out;
+    }
+}
+
+template <typename T, typename Real, typename OutputIt>
+OutputIt place_unit_vertices(const std::vector<Vector2<Real>>& table, size_t count, OutputIt out,
+                             Vector2<T> position, T radius, Angle degrees) {
+    return place_unit_vertices<T, Real>(std::span<const Vector2<Real>>(table), count, out, position, radius, degrees);
+}
+
+// Direction table of a resolution, for the shapes that read one.
+// Integer shapes place their vertices in fixed-point, so they get no table and never take the cache's lock.
+template <typename T>
+std::shared_ptr<const typename UnitCircleCache<T>::Table> unit_circle_table(size_t resolution) {
+    if constexpr (std::is_integral_v<T>)
+        return nullptr;
+    else
+        return UnitCircleCache<T>::table(resolution);
+}
+
+// Places the first `count` of `resolution` vertices, from a table given by unit_circle_table()
+template <typename T, typename OutputIt>
+OutputIt place_unit_vertices(const typename UnitCircleCache<T>::Table* table, size_t resolution, size_t count,
+                             OutputIt out, Vector2<T> position, T radius, Angle degrees) {
+    if constexpr (std::is_integral_v<T>)
+        return place_fixed_vertices(resolution, count, out, position, radius, degrees);
+    else
+        return place_unit_vertices(*table, count, out, position, radius, degrees);
+}
+
+
+
+// JSON parsing functions
+// Like the ones in vectorx.h, these advance `first` and return false if the input is invalid.
+
+// Reads a JSON string, returning its contents without the quotes. Escape sequences are left as-is.
+inline bool parse_json_string(const char*& first, const char* last, std::string_view& out) {
+    if (!expect_json(first, last, '"'))
+        return false;
+
+    const char* start = first;
+    while (first != last && *first != '"')
+        first += (*first == '\\' && last - first > 1) ? 2 : 1;
+
+    if (first == last)
+        return false;
+
+    out = std::string_view(start, first - start);
+    first++;
+    return true;
+}
+
+// Skips over any JSON value, including nested arrays and objects.
+inline bool skip_json_value(const char*& first, const char* last) {
+    skip_json_whitespace(first, last);
+    if (first == last)
+        return false;
+
+    if (*first == '"') {
+        std::string_view ignored;
+        return parse_json_string(first, last, ignored);
+    }
+
+    size_t depth = 0;
+    while (first != last) {
+        char c = *first;
+        if (c == '"') {
+            std::string_view ignored;
+            if (!parse_json_string(first, last, ignored))
+                return false;
+            continue;
+        }
+
+        if (c == '[' || c == '{') {
+            depth++;
+        } else if (c == ']' || c == '}') {
+            if (depth == 0)
+                return true; // End of the enclosing container
+            if (--depth == 0) {
+                first++;
+                return true;
+            }
+        } else if (depth == 0 && (c == ',' || c == ' ' || c == '\n' || c == '\r' || c == '\t')) {
+            return true; // End of a number or literal
+        }
+        first++;
+    }
+    return depth == 0;
+}
+
+// Reads a JSON object, calling `field(key, first, last)` to read the value of every member.
+// `field` returns false if the value is invalid.
+template <typename F>
+bool parse_json_object(const char*& first, const char* last, F field) {
+    if (!expect_json(first, last, '{'))
+        return false;
+
+    // Check for an empty object
+    skip_json_whitespace(first, last);
+    if (first != last && *first == '}') {
+        first++;
+        return true;
+    }
+
+    while (true) {
+        std::string_view key;
+        if (!parse_json_string(first, last, key) || !expect_json(first, last, ':'))
+            return false;
+        if (!field(key, first, last))
+            return false;
+
+        skip_json_whitespace(first, last);
+        if (first == last)
+            return false;
+        if (*first == '}') {
+            first++;
+            return true;
+        }
+        if (*first++ != ',')
+            return false;
+    }
+}
+
+
+
+// Axis-aligned bounding box, stored as its minimum and maximum corners.
+template <typename T>
+struct Bounds2D {
+    // Data
+    Vector2<T> min;
+    Vector2<T> max;
+
+
+
+    // Default constructor
+    Bounds2D() {}
+
+    // Corner constructor
+    Bounds2D(Vector2<T> min, Vector2<T> max)
+        : min(min), max(max) {}
+
+    // Builds bounds from floating-point extents.
+    // Integer bounds are rounded outward, so they always contain the exact extents.
+    template <typename Real>
+    static Bounds2D fromExtents(Real min_x, Real min_y, Real max_x, Real max_y) {
+        if constexpr (std::is_integral_v<T>)
+            return Bounds2D(Vector2<T>(static_cast<T>(floor(min_x)), static_cast<T>(floor(min_y))),
+                            Vector2<T>(static_cast<T>(ceil(max_x)), static_cast<T>(ceil(max_y))));
+        else
+            return Bounds2D(Vector2<T>(static_cast<T>(min_x), static_cast<T>(min_y)),
+                            Vector2<T>(static_cast<T>(max_x), static_cast<T>(max_y)));
+    }
+
+
+
+    // Utility functions
+    T width() const  { return max.x - min.x; }
+    T height() const { return max.y - min.y; }
+    Vector2<T> center() const { return Vector2<T>((min.x + max.x) / 2, (min.y + max.y) / 2); }
+
+    bool contains(Vector2<T> point) const {
+        return point.x >= min.x && point.x <= max.x && point.y >= min.y && point.y <= max.y;
+    }
+
+    bool overlaps(const Bounds2D& other) const {
+        return min.x <= other.max.x && max.x >= other.min.x && min.y <= other.max.y && max.y >= other.min.y;
+    }
+
+    // Returns the smallest bounds containing both
+    Bounds2D merge(const Bounds2D& other) const {
+        return Bounds2D(Vector2<T>(min.x < other.min.x ? min.x : other.min.x, min.y < other.min.y ? min.y : other.min.y),
+                        Vector2<T>(max.x > other.max.x ? max.x : other.max.x, max.y > other.max.y ? max.y : other.max.y));
+    }
+};
+
+
+
+// Analytic bounds of each shape type
+// These are shared by the shape classes and the shape batches.
+
+// A circle's bounds don't depend on its rotation.
+template <typename T>
+Bounds2D<T> circle_bounds(Vector2<T> position, T radius) {
+    T r = radius < 0 ? -radius : radius;
+    return Bounds2D<T>(Vector2<T>(position.x - r, position.y - r), Vector2<T>(position.x + r, position.y + r));
+}
+
+// A rotated rectangle extends |w cos| + |h sin| horizontally and |w sin| + |h cos| vertically from its center.
+template <typename T>
+Bounds2D<T> rectangle_bounds(Vector2<T> position, Vector2<T> size, Angle degrees) {
+    using Real = typename UnitCircleCache<T>::Real;
+
+    INSTRUMENT_COUNT(TrigEvaluations, 2);
+    Real radians = to_radians<Real>(degrees);
+    Real c = std::abs(static_cast<Real>(cos(radians)));
+    Real s = std::abs(static_cast<Real>(sin(radians)));
+    Real hw = std::abs(static_cast<Real>(size.x)) / 2;
+    Real hh = std::abs(static_cast<Real>(size.y)) / 2;
+
+    Real ex = (hw * c) + (hh * s);
+    Real ey = (hw * s) + (hh * c);
+    return Bounds2D<T>::fromExtents(position.x - ex, position.y - ey, position.x + ex, position.y + ey);
+}
+
+// Finds the exact extrema of the vertices placed from a unit-circle table.
+template <typename T, typename Real>
+Bounds2D<T> unit_table_bounds(std::span<const Vector2<Real>> table, Vector2<T> position, T radius, Angle degrees) {
+    if (table.empty())
+        return Bounds2D<T>(position, position);
+
+    INSTRUMENT_COUNT(TrigEvaluations, 2);
+    Real radians = to_radians<Real>(degrees);
+    Real rc = cos(radians) * radius;
+    Real rs = sin(radians) * radius;
+
+    Real min_x = 0, min_y = 0, max_x = 0, max_y = 0;
+    for (size_t i = 0; i < table.size(); i++) {
+        const Vector2<Real>& d = table[i];
+        Real x = (d.x * rc) - (d.y * rs);
+        Real y = (d.x * rs) + (d.y * rc);
+
+        if (i == 0 || x < min_x) min_x = x;
+        if (i == 0 || x > max_x) max_x = x;
+        if (i == 0 || y < min_y) min_y = y;
+        if (i == 0 || y > max_y) max_y = y;
+    }
+
+    return Bounds2D<T>::fromExtents(position.x + min_x, position.y + min_y, position.x + max_x, position.y + max_y);
+}
+
+// An N-Gon's bounds are the exact extrema of its vertices, found from the cached unit-circle table.
+template <typename T>
+Bounds2D<T> ngon_bounds(Vector2<T> position, size_t N, T radius, Angle degrees) {
+    if (N == 0)
+        return Bounds2D<T>(position, position);
+
+    auto table = UnitCircleCache<T>::table(N);
+    return unit_table_bounds<T>(std::span<const Vector2<typename UnitCircleCache<T>::Real>>(*table),
+                                position, radius, degrees);
+}
+
+
+
+// Level of detail for rendering circles.
+// Rather than a fixed vertex count, the count is chosen so that no point of the true circle is further than
+// `tolerance` from the edges drawn in its place. `scale` converts the circle's units into the units of the
+// tolerance, for example pixels per world unit, so one tolerance can follow a camera zoom.
+struct CircleDetail {
+    double tolerance = 0.25;
+    double scale = 1;
+};
+
+// Resolutions chosen by a level of detail stay within these limits
+constexpr size_t circle_detail_min_resolution = 8;
+constexpr size_t circle_detail_max_resolution = 4096;
+
+// Vertex count for a circle of the given radius, within the level of detail's tolerance.
+// The sagitta of an edge spanning 2 pi / n radians is r (1 - cos(pi / n)), which is at most r (pi / n)^2 / 2,
+// so n = pi / sqrt(2 tolerance / r) always meets the tolerance, without any trig, and is within 1% of the
+// smallest count once it exceeds the minimum. Counts are then rounded up to 4 significant bits, which adds
+// at most 1/8 more vertices, so a whole scene of circles only ever uses a few dozen distinct resolutions,
+// and their direction tables stay cached.
+template <typename T>
+size_t circle_detail_resolution(T radius, CircleDetail detail) {
+    double r = std::abs(static_cast<double>(radius) * detail.scale);
+    if (!(detail.tolerance > 0))
+        return circle_detail_max_resolution;
+    if (r <= detail.tolerance)
+        return circle_detail_min_resolution;
+
+    double ideal = M_PI / std::sqrt(2 * detail.tolerance / r);
+    if (!(ideal < static_cast<double>(circle_detail_max_resolution)))
+        return circle_detail_max_resolution;
+
+    size_t n = std::max(static_cast<size_t>(std::ceil(ideal)), circle_detail_min_resolution);
+    int shift = std::bit_width(n) - 4;
+    if (shift > 0) {
+        size_t step = size_t(1) << shift;
+        n = (n + step - 1) & ~(step - 1);
+    }
+    return std::min(n, circle_detail_max_resolution);
+}
+
+// Every resolution circle_detail_resolution() can choose has a level, counted from 0 at the minimum resolution.
+// Levels are dense, so they can index a table of directions tables instead of searching for them.
+constexpr size_t circle_detail_level(size_t resolution) {
+    int shift = std::bit_width(resolution) - 4;
+    return shift > 0 ? (8 * static_cast<size_t>(shift)) + (resolution >> shift) - 8 : resolution - 8;
+}
+
+constexpr size_t circle_detail_levels = circle_detail_level(circle_detail_max_resolution) + 1;
+static_assert(circle_detail_level(circle_detail_min_resolution) == 0);
+
+
 
 template <typename T>
 class Shape2D {
@@ -134,42 +804,229 @@ public:
         : rotation(0), position(position) {}
 
     // Position and rotation constructor
-    Shape2D(T x, T y, T r) 
-        : rotation(0), position(x, y) {}
+    Shape2D(T x, T y, Angle r) 
+        : rotation(r), position(x, y) {}
     Shape2D(Vector2<T> position, Angle rotation) 
         : rotation(rotation), position(position) {}
 
+    // Mixed collections of shapes are owned and deleted through Shape2D pointers
+    virtual ~Shape2D() = default;
+
 
 
     // Utility functions
+    // Area and perimeter flush the pending transform, since a scale changes them.
     virtual T area() = 0;
     virtual T perimeter() = 0;
     
-    virtual std::vector<Vector2<T>> vertices() = 0;
+    // Number of vertices the shape renders to, which allows sizing buffers up front.
+    virtual size_t vertexCount() = 0;
+
+    // Writes the vertices into a caller-provided buffer and returns how many were written.
+    // At most out.size() vertices are written, so the buffer should hold vertexCount() elements.
+    virtual size_t vertices(std::span<Vector2<T>> out) = 0;
+
+    // Writes the vertices into a reusable list, which only allocates when it has to grow.
+    void vertices(std::vector<Vector2<T>>& out) {
+        INSTRUMENT_BUFFER(out, vertexCount());
+        out.resize(vertexCount());
+        vertices(std::span<Vector2<T>>(out));
+    }
+
+    // Returns the vertices in a new list.
+    virtual std::vector<Vector2<T>> vertices() {
+        std::vector<Vector2<T>> vertex_list;
+        vertices(vertex_list);
+        return vertex_list;
+    }
+
+    // True if the outline written by vertices() is convex, so it can be filled with a triangle fan.
+    // Every built-in shape is, while polygons may not be.
+    virtual bool isConvex() { return true; }
+
+
+
+    // Point queries
+    // Tests whether a point is inside the shape, or on its outline.
+    virtual bool contains(Vector2<T> point) = 0;
+
+    // Distance from a point to the shape's outline, negative inside the shape.
+    virtual T signedDistance(Vector2<T> point) = 0;
+
+    // Tests every point of the lanes, setting bit i % 64 of mask[i / 64] when point i is inside.
+    // The mask should hold query_mask_words(points.size()) words, and only points it has room for are tested.
+    void contains(const VectorArray2<T>& points, std::span<uint64_t> mask) {
+        size_t count = _queryCount(points, mask);
+        _prepareQueries();
+        _containsPoints(points.x, points.y, 0, count, mask.data());
+    }
+
+    // Same as above, split over an executor in chunks of whole mask words
+    void contains(const VectorArray2<T>& points, std::span<uint64_t> mask, Executor& executor) {
+        size_t count = _queryCount(points, mask);
+        _prepareQueries();
+        parallel_for(executor, 0, query_mask_words(count), [&](size_t begin, size_t end) {
+            _containsPoints(points.x, points.y, begin * 64, std::min(end * 64, count), mask.data());
+        });
+    }
+
+    // Writes the signed distance of every point of the lanes that fits in `out`
+    void signedDistance(const VectorArray2<T>& points, std::span<T> out) {
+        size_t count = std::min(points.size(), out.size());
+        _prepareQueries();
+        _signedDistances(points.x, points.y, 0, count, out.data());
+    }
+
+    // Same as above, split over an executor
+    void signedDistance(const VectorArray2<T>& points, std::span<T> out, Executor& executor) {
+        size_t count = std::min(points.size(), out.size());
+        _prepareQueries();
+        parallel_for(executor, 0, count, [&](size_t begin, size_t end) {
+            _signedDistances(points.x, points.y, begin, end, out.data());
+        });
+    }
+
+
+    // Computes the axis-aligned bounds of the shape analytically, bypassing the cache.
+    virtual Bounds2D<T> computeBounds() = 0;
+
+    // Returns the axis-aligned bounds of the shape, computed analytically.
+    // The result is cached until the shape is transformed through one of the functions below.
+    Bounds2D<T> bounds() {
+        flush();
+        if (bounds_dirty) {
+            cached_bounds = computeBounds();
+            bounds_dirty = false;
+        }
+        return cached_bounds;
+    }
+
+    // Marks the cached bounds as stale.
+    // This must be called after writing to members such as position or radius directly.
+    void invalidate() { bounds_dirty = true; }
+
+
+    // Deferred transforms
+    // Transforms are composed into a single pending transform, without touching the shape.
+    // The moves of the position by rotateFrom(), move(), moveTo() and scaleFrom() of floating-point shapes are
+    // composed into it as well, so a chain of them costs one matrix multiply when it is applied.
+    // The pending transform is applied once, by flush(), bounds(), vertices(), area(), getPosition(), getRotation(),
+    // or the serializers. Read members directly only after a flush.
+    // Readers of a const shape, such as the serializers, batches and colliders, read a flushed copy instead.
+    using Real = typename UnitCircleCache<T>::Real;
+
+    // Shapes only store a position, rotation and uniform size, so only similarity transforms can be applied.
+    // A reflection, shear or non-uniform scale is rejected with false, and leaves the shape unchanged.
+    bool transform(const Transform2D<Real>& t) {
+        INSTRUMENT_COUNT(TransformCalls, 1);
+        if (!t.isSimilarity())
+            return false;
+
+        pending = t * pending;
+        pending_shape = t * pending_shape;
+        position_pending = shape_pending = true;
+        invalidate();
+        return true;
+    }
+
+    // Applies the pending transform to the position, rotation and size of the shape.
+    // The scale is applied in floating point, so integer shapes round their new size and position.
+    void flush() {
+        if (!hasPendingTransform())
+            return;
+
+        position = _appliedPosition();
+        rotation = _appliedRotation();
+        Real factor = shape_pending ? pending_shape.scaleFactor() : 1;
+        pending = pending_shape = Transform2D<Real>();
+        position_pending = shape_pending = false;
+
+        if (factor != 1)
+            _scaleBy(factor);
+        invalidate();
+    }
+
+    bool hasPendingTransform() const { return position_pending || shape_pending; }
+
+    // Transform of the position, including the moves deferred by the transformative functions
+    const Transform2D<Real>& pendingTransform() const { return pending; }
+
+    Vector2<T> getPosition() {
+        flush();
+        return position;
+    }
+
+    Angle getRotation() {
+        flush();
+        return rotation;
+    }
+
+
+    // Ray casting
+    // Returns where a ray first hits the shape, with a shape id of 0, or a hit() of false if it misses.
+    // Rays starting inside the shape hit it at t = 0. Whole scenes are cast in packets by the RayCaster of raycast.h.
+    RayHit<Real> raycast(const Ray2D<T>& ray) {
+        RayPacket<Real> packet;
+        packet.load(std::span<const Ray2D<T>>(&ray, 1));
+        _prepareQueries();
+        _raycastPacket(packet, 0);
+        return packet.hit(0);
+    }
 
 
     // Transformative functions
     // Any function with two implementations will call the other by default.
 
     // This way, only one function must be implemented by the inheriting class.
-    virtual void rotate(Angle degrees) { rotation += degrees; }
+    // Each call is counted once by instrumentation, rotateFrom through the rotate() it calls.
+    // Rotations and sizes only change by an addition or product, so they are applied right away. Floating-point
+    // shapes defer the move of their position into the pending transform. Integer shapes apply it right away,
+    // since their positions are rotated in exact fixed-point and scaled by whole factors.
+    virtual void rotate(Angle degrees) {
+        INSTRUMENT_COUNT(TransformCalls, 1);
+        rotation += degrees;
+        invalidate();
+    }
 
     virtual void rotateFrom(Angle degrees, T x, T y) { rotateFrom(degrees, Vector2<T>(x, y)); }
     virtual void rotateFrom(Angle degrees, Vector2<T> origin) {
         // Call rotate to correct object rotation angle
         rotate(degrees);
-        
+
         // Rotate position around origin point
-        position = rotate_point(position, origin, degrees);
+        if constexpr (std::is_integral_v<T>) {
+            flush();
+            position = rotate_point(position, origin, degrees);
+        } else if (degrees != 0) {
+            _deferPosition(Transform2D<Real>::rotation(static_cast<Real>(degrees), origin));
+        }
     }
 
     // Moves the shape from it's current position by some offset.
     virtual void move(T x, T y)          { move(Vector2<T>(x, y)); }
-    virtual void move(Vector2<T> offset) { position += offset; }
+    virtual void move(Vector2<T> offset) {
+        INSTRUMENT_COUNT(TransformCalls, 1);
+        if constexpr (std::is_integral_v<T>) {
+            flush();
+            position += offset;
+            invalidate();
+        } else {
+            _deferPosition(Transform2D<Real>::translation(offset));
+        }
+    }
 
     // Moves the shape to a specific position relative to global origin.
     virtual void moveTo(T x, T y)                { moveTo(Vector2<T>(x, y)); }
-    virtual void moveTo(Vector2<T> destination)  { position = destination; }
+    // The position is replaced, so the pending moves of the old one are dropped.
+    virtual void moveTo(Vector2<T> destination)  {
+        INSTRUMENT_COUNT(TransformCalls, 1);
+        if constexpr (std::is_integral_v<T>)
+            flush();
+        position = destination;
+        pending = Transform2D<Real>();
+        position_pending = false;
+        invalidate();
+    }
 
     // Scales the shape to some standard factor.
     virtual void scale(T scalar) {}
@@ -177,36 +1034,200 @@ public:
     // Scale the shape 
     virtual void scaleFrom(T scalar, T x, T y) { scaleFrom(scalar, Vector2<T>(x, y)); }
     virtual void scaleFrom(T scalar, Vector2<T> origin) { 
+        INSTRUMENT_COUNT(TransformCalls, 1);
+        if constexpr (std::is_integral_v<T>)
+            flush();
+
         // Scale shape's dimensions
         scale(scalar);
         // Find the distance between position and orgin,
         // multiply the distance by scalar, and reposition to origin
-        position = ((position - origin) * scalar) + origin;
+        if constexpr (std::is_integral_v<T>)
+            position = ((position - origin) * scalar) + origin;
+        else
+            _deferPosition(Transform2D<Real>::scaling(scalar, origin));
+        invalidate();
     }
 
 
 
     // Partial serializers
+    // The overloads taking a string append to it, which avoids allocating a new string per call.
+    // They write the position and rotation with the pending transform applied.
     std::string str() {
-        std::stringstream ss;
-        ss << "position: " << position.str() << ", rotation: " << rotation << "°";
-        return ss.str();
+        std::string out;
+        str(out);
+        return out;
+    }
+
+    void str(std::string& out) const {
+        out += "position: ";
+        _appliedPosition().str(out);
+        out += ", rotation: ";
+        append_formatted(out, _appliedRotation());
+        out += "°";
     }
 
     std::string json() {
-        std::stringstream ss;
-        ss << "\"position\":" << position.json() << ",\"rotation\":" << rotation;
-        return ss.str();
+        std::string out;
+        json(out);
+        return out;
+    }
+
+    void json(std::string& out) const {
+        out += "\"position\":";
+        _appliedPosition().json(out);
+        out += ",\"rotation\":";
+        append_formatted(out, _appliedRotation());
+    }
+
+    // Partial parser
+    // Reads the value of one member written by json(). Members of other shapes are skipped.
+    bool parseJsonField(std::string_view key, const char*& first, const char* last) {
+        invalidate();
+        if (key == "position")
+            return position.parseJson(first, last);
+        if (key == "rotation")
+            return parse_formatted(first, last, rotation);
+        return skip_json_value(first, last);
+    }
+
+
+
+protected:
+    // Range kernels behind the batch point queries, which may run on several threads at once.
+    // Shapes replace these with the vectorized kernels of pointquery.h. By default every point is queried on its own.
+    virtual void _containsPoints(const T* x, const T* y, size_t begin, size_t end, uint64_t* mask) {
+        for (size_t word = begin; word < end; word += 64) {
+            uint64_t bits = 0;
+            for (size_t j = 0; j < 64 && word + j < end; j++)
+                bits |= static_cast<uint64_t>(contains(Vector2<T>(x[word + j], y[word + j]))) << j;
+            mask[word / 64] = bits;
+        }
+    }
+
+    virtual void _signedDistances(const T* x, const T* y, size_t begin, size_t end, T* out) {
+        for (size_t i = begin; i < end; i++)
+            out[i] = signedDistance(Vector2<T>(x[i], y[i]));
+    }
+
+    // Called once before a batch query, so that the range kernels only read the shape.
+    // Shapes with cached state must bring it up to date here.
+    virtual void _prepareQueries() { flush(); }
+
+    // Casts every ray of a packet at the shape, keeping the hits nearer than the packet's, as shape `id`.
+    // This may run on several threads at once, after _prepareQueries().
+    virtual void _raycastPacket(RayPacket<Real>& packet, uint32_t id) = 0;
+
+    // Called once before the shape is drawn into the tiles of a grid.
+    // Shapes that draw from world-space state, such as the edge table of a polygon, build it here.
+    virtual void _prepareRaster(const RasterGrid<Real>&) { _prepareQueries(); }
+
+    // Draws the shape into a tile of a grid, which may happen on several threads at once, after _prepareRaster().
+    virtual void _rasterize(RasterTile<Real>& tile) = 0;
+
+    // Scales the size of the shape by the scale of a flushed transform, in floating point
+    virtual void _scaleBy(Real) {}
+
+    // Converts a floating-point size or coordinate to the shape's type, rounding for integer shapes
+    static T _fromReal(Real value) {
+        if constexpr (std::is_integral_v<T>)
+            return static_cast<T>(std::lround(value));
+        else
+            return static_cast<T>(value);
+    }
+
+    // Frame of a batch or single point query: the shape's position, with its rotation undone.
+    // A negative `flip` turns the frame around, for shapes with a negative size.
+    QueryFrame<Real> _queryFrame(Real flip = 1) const {
+        INSTRUMENT_COUNT(TrigEvaluations, 2);
+        Real radians = to_radians<Real>(rotation);
+        QueryFrame<Real> frame;
+        frame.px = static_cast<Real>(position.x);
+        frame.py = static_cast<Real>(position.y);
+        frame.c = static_cast<Real>(cos(radians)) * flip;
+        frame.s = static_cast<Real>(sin(radians)) * flip;
+        return frame;
+    }
+
+
+
+private:
+    // Casts packets against, and draws, whole collections through the protected kernels
+    template <typename> friend class RayCaster;
+    template <typename> friend class Rasterizer;
+
+    Bounds2D<T> cached_bounds;
+    bool bounds_dirty = true;
+
+    // Number of points a batch query has room for
+    static size_t _queryCount(const VectorArray2<T>& points, std::span<uint64_t> mask) {
+        return std::min(points.size(), mask.size() * 64);
+    }
+
+    // Position and rotation with the pending transform applied, without flushing it
+    Vector2<T> _appliedPosition() const {
+        if (!position_pending)
+            return position;
+        Vector2<Real> p = pending.apply(Vector2<Real>(static_cast<Real>(position.x), static_cast<Real>(position.y)));
+        return Vector2<T>(_fromReal(p.x), _fromReal(p.y));
     }
+
+    Angle _appliedRotation() const {
+        return shape_pending ? rotation + static_cast<Angle>(pending_shape.rotationAngle()) : rotation;
+    }
+
+    // Composes a move of the position into the pending transform
+    void _deferPosition(const Transform2D<Real>& t) {
+        pending = t * pending;
+        position_pending = true;
+        invalidate();
+    }
+
+    // Pending transform of the position, and the part of it given to transform(), which also rotates and
+    // scales the shape when it is flushed
+    Transform2D<Real> pending, pending_shape;
+    bool position_pending = false, shape_pending = false;
 };
 
 
 
+// Returns a copy of a shape with its pending transform applied.
+// Readers of a const shape use it, since they can't flush the shape itself.
+template <typename Shape>
+Shape flushed(Shape shape) {
+    shape.flush();
+    return shape;
+}
+
+
+
+// Writes the bounds of every shape into `out`, which should hold one element per shape.
+// Cached bounds are reused, so only shapes transformed since their last bounds() are recomputed.
+template <typename T>
+void bounds_all(std::span<Shape2D<T>* const> shapes, std::span<Bounds2D<T>> out) {
+    for (size_t i = 0; i < shapes.size() && i < out.size(); i++)
+        out[i] = shapes[i]->bounds();
+}
+
+// Same as above, split over an executor. Every shape is only touched by one thread.
+template <typename T>
+void bounds_all(std::span<Shape2D<T>* const> shapes, std::span<Bounds2D<T>> out, Executor& executor) {
+    size_t count = shapes.size() < out.size() ? shapes.size() : out.size();
+    parallel_for(executor, 0, count, [&](size_t begin, size_t end) {
+        bounds_all<T>(shapes.subspan(begin, end - begin), out.subspan(begin, end - begin));
+    });
+}
+
+
+
 
 
 template <typename T>
 class Circle : public Shape2D<T> {
 public:
+    using Real = typename Shape2D<T>::Real;
+
     // Data
     T radius;
 
@@ -235,57 +1256,198 @@ public:
 
 
     // Utility functions
-    constexpr T area() override { return M_PI * radius * radius; }
-    constexpr T perimeter() override { return 2 * M_PI * radius; }
+    T area() override {
+        Shape2D<T>::flush();
+        return M_PI * radius * radius;
+    }
+
+    T perimeter() override {
+        Shape2D<T>::flush();
+        return 2 * M_PI * radius;
+    }
+
+    // Number of vertices rendered when no resolution is specified
+    static constexpr size_t default_resolution = 64;
+
+    // Make the base overloads visible next to the resolution overloads
+    using Shape2D<T>::vertices;
+
+    constexpr size_t vertexCount() override { return default_resolution; }
 
     // Call to render the circle to a default, fixed number of verticies
-    constexpr std::vector<Vector2<T>> vertices() override { return vertices(64); }
+    size_t vertices(std::span<Vector2<T>> out) override { return vertices(out, default_resolution); }
 
     // Renders the circle to a list of vertices of a specified count
-    constexpr std::vector<Vector2<T>> vertices(size_t resolution) {
-        // Get central angle for given resolution
-        Angle angle_central = -360 / static_cast<Angle>(resolution);
+    std::vector<Vector2<T>> vertices(size_t resolution) {
+        std::vector<Vector2<T>> vertex_list;
+        vertices(vertex_list, resolution);
+        return vertex_list;
+    }
 
-        // Defines the container for resulting verticies
-        std::vector<Vector2<T>> vertex_list(resolution);
+    // Renders the circle into a reusable list, which only allocates when it has to grow
+    void vertices(std::vector<Vector2<T>>& out, size_t resolution) {
+        INSTRUMENT_BUFFER(out, resolution);
+        out.resize(resolution);
+        vertices(std::span<Vector2<T>>(out), resolution);
+    }
 
-        // Iterate through each point and add to vertex list.
-        for (size_t i = 0; i < resolution; i++) {
-            // Calculate degrees of rotation for given vertex
-            Angle v_rotation = angle_central * i;
+    // Renders the circle into a caller-provided buffer and returns how many vertices were written
+    size_t vertices(std::span<Vector2<T>> out, size_t resolution) {
+        size_t count = out.size() < resolution ? out.size() : resolution;
+        vertices(out.begin(), resolution, count);
+        return count;
+    }
 
-            // Rotate point around circle's center
-            vertex_list[i] = rotate_point(Vector2<T>(0, radius), Shape2D<T>::position, v_rotation);
-        }
+    // Renders the circle through an output iterator and returns the iterator past the last vertex
+    template <std::output_iterator<Vector2<T>> OutputIt>
+    OutputIt vertices(OutputIt out, size_t resolution = default_resolution) {
+        return vertices(out, resolution, resolution);
+    }
+
+    // Vertex count chosen by a level of detail, for the circle's current radius
+    size_t resolution(CircleDetail detail) {
+        Shape2D<T>::flush();
+        return circle_detail_resolution(radius, detail);
+    }
+
+    // Renders the circle with as many vertices as its level of detail needs.
+    // The direction tables are cached per resolution, the same as for an explicit resolution.
+    std::vector<Vector2<T>> vertices(CircleDetail detail) { return vertices(resolution(detail)); }
+    void vertices(std::vector<Vector2<T>>& out, CircleDetail detail) { vertices(out, resolution(detail)); }
+    size_t vertices(std::span<Vector2<T>> out, CircleDetail detail) { return vertices(out, resolution(detail)); }
+
+    // Renders only the first `count` vertices of the given resolution
+    template <std::output_iterator<Vector2<T>> OutputIt>
+    OutputIt vertices(OutputIt out, size_t resolution, size_t count) {
+        INSTRUMENT_SCOPE("Circle::vertices");
+        Shape2D<T>::flush();
+
+        // Scale the cached unit-circle table to the circle, then rotate and offset it
+        auto table = unit_circle_table<T>(resolution);
+        return place_unit_vertices(table.get(), resolution, count, out, Shape2D<T>::position, radius, Shape2D<T>::rotation);
+    }
 
-        // Rotate vertices by shapes's rotation value
-        if (rotation != 0)
-            for (auto &v: vertex_list) 
-                v = rotate_point(v, Shape2D<T>::position, Shape2D<T>::rotation);
 
-        // Return rotated vertices list
-        return vertex_list;
+    // Computes the bounds from the radius, without generating vertices
+    Bounds2D<T> computeBounds() override { return circle_bounds(Shape2D<T>::position, radius); }
+
+
+    // Point queries
+    // Make the base batch overloads visible next to the single point overrides
+    using Shape2D<T>::contains;
+    using Shape2D<T>::signedDistance;
+
+    bool contains(Vector2<T> point) override {
+        Shape2D<T>::flush();
+        Vector2<Real> p = _frame().local(static_cast<Real>(point.x), static_cast<Real>(point.y));
+        return _query().inside(p.x, p.y);
+    }
+
+    T signedDistance(Vector2<T> point) override {
+        Shape2D<T>::flush();
+        Vector2<Real> p = _frame().local(static_cast<Real>(point.x), static_cast<Real>(point.y));
+        return _query_result<T>(_query().distance(p.x, p.y));
     }
 
 
     // Transformative functions
     // Scales the circle from it's own origin point
-    void scale(T scalar) override { radius *= scalar; }
+    void scale(T scalar) override {
+        radius *= scalar;
+        Shape2D<T>::invalidate();
+    }
 
 
 
     // Serializers
     std::string str() {
-        std::stringstream ss;
-        ss << "Circle { radius: " << radius << ", " << Shape2D<T>::str() << " }";
-        return ss.str();
+        Shape2D<T>::flush();
+        std::string out;
+        str(out);
+        return out;
+    }
+
+    void str(std::string& out) const {
+        if (Shape2D<T>::hasPendingTransform())
+            return flushed(*this).str(out);
+
+        INSTRUMENT_SCOPE("Circle::str");
+        INSTRUMENT_SERIALIZATION(out);
+
+        out += "Circle { radius: ";
+        append_formatted(out, radius);
+        out += ", ";
+        Shape2D<T>::str(out);
+        out += " }";
     }
 
     std::string json() {
-        std::stringstream ss;
-        ss << "{\"radius\":" << radius << "," << Shape2D<T>::json() << "}";
-        return ss.str();
+        Shape2D<T>::flush();
+        std::string out;
+        json(out);
+        return out;
+    }
+
+    void json(std::string& out) const {
+        if (Shape2D<T>::hasPendingTransform())
+            return flushed(*this).json(out);
+
+        INSTRUMENT_SCOPE("Circle::json");
+        INSTRUMENT_SERIALIZATION(out);
+
+        out += "{\"radius\":";
+        append_formatted(out, radius);
+        out += ',';
+        Shape2D<T>::json(out);
+        out += '}';
+    }
+
+
+
+    // Parsers
+    // Reads an object written by json(). Members may appear in any order.
+    bool parseJson(const char*& first, const char* last) {
+        return parse_json_object(first, last, [this](std::string_view key, const char*& f, const char* l) {
+            if (key == "radius")
+                return parse_formatted(f, l, radius);
+            return Shape2D<T>::parseJsonField(key, f, l);
+        });
+    }
+
+    // Parses a whole JSON document, returning false if it is invalid
+    static bool fromJson(std::string_view json, Circle& out) { return parse_json_document(json, out); }
+
+
+
+protected:
+    void _containsPoints(const T* x, const T* y, size_t begin, size_t end, uint64_t* mask) override {
+        query_contains(x, y, begin, end, _frame(), _query(), mask);
+    }
+
+    void _signedDistances(const T* x, const T* y, size_t begin, size_t end, T* out) override {
+        query_distances(x, y, begin, end, _frame(), _query(), out);
+    }
+
+    void _raycastPacket(RayPacket<Real>& packet, uint32_t id) override {
+        ray_cast_packet(_frame(), _query(), packet, id);
+    }
+
+    void _rasterize(RasterTile<Real>& tile) override { raster_shape(tile, _frame(), _query()); }
+
+    void _scaleBy(Real factor) override { radius = Shape2D<T>::_fromReal(static_cast<Real>(radius) * factor); }
+
+
+
+private:
+    // Circles look the same at any rotation, so their frame only moves points
+    QueryFrame<Real> _frame() const {
+        QueryFrame<Real> frame;
+        frame.px = static_cast<Real>(Shape2D<T>::position.x);
+        frame.py = static_cast<Real>(Shape2D<T>::position.y);
+        return frame;
     }
+
+    CircleQuery<Real> _query() const { return { std::abs(static_cast<Real>(radius)) }; }
 };
 
 
@@ -295,6 +1457,8 @@ public:
 template <typename T>
 class Rectangle : public Shape2D<T> {
 public:
+    using Real = typename Shape2D<T>::Real;
+
     // Data
     Vector2<T> size;
 
@@ -331,10 +1495,36 @@ public:
 
 
     // Utility functions
-    constexpr T area() override { return size.x * size.y; }
-    constexpr T perimeter() override { return (size.x * 2) + (size.y * 2); }
+    T area() override {
+        Shape2D<T>::flush();
+        return size.x * size.y;
+    }
+
+    T perimeter() override {
+        Shape2D<T>::flush();
+        return (size.x * 2) + (size.y * 2);
+    }
+
+    // Make the base overloads visible next to the output iterator overload
+    using Shape2D<T>::vertices;
+
+    constexpr size_t vertexCount() override { return 4; }
+
+    size_t vertices(std::span<Vector2<T>> out) override {
+        Vector2<T> corners[4];
+        vertices(corners);
+
+        size_t count = out.size() < 4 ? out.size() : 4;
+        std::copy_n(corners, count, out.begin());
+        return count;
+    }
+
+    // Renders the rectangle through an output iterator and returns the iterator past the last vertex
+    template <std::output_iterator<Vector2<T>> OutputIt>
+    OutputIt vertices(OutputIt out) {
+        INSTRUMENT_SCOPE("Rectangle::vertices");
+        Shape2D<T>::flush();
 
-    constexpr std::vector<Vector2<T>> vertices() override {
         // Calculate half of size for offsets
         Vector2<T> hs = size / 2;
 
@@ -343,44 +1533,158 @@ public:
         auto rotation = Shape2D<T>::rotation;
 
         // Define vertices
-        std::vector<Vector2<T>> vertex_list = {
+        Vector2<T> vertex_list[4] = {
             position - hs,                      // Top left
             Vector2<T>(hs.x, -hs.y) + position, // Top right
             hs + position,                      // Bottom right
             Vector2<T>(-hs.x, hs.y) + position, // Bottom left
         };
 
-        // Rotate all vertices by shape's rotation value
-        if (rotation != 0)
-            for (auto &v: vertex_list) 
-                v = rotate_point(v, position, rotation);
+        // Rotate all vertices by shape's rotation value at once
+        rotate_points<T>(vertex_list, vertex_list, position, rotation);
 
-        // Return rotated vertices list
-        return vertex_list;
+        // Copy rotated vertices to the output
+        return std::copy(vertex_list, vertex_list + 4, out);
+    }
+
+
+    // Computes the bounds from the rotated half extents, without generating vertices
+    Bounds2D<T> computeBounds() override {
+        return rectangle_bounds(Shape2D<T>::position, size, Shape2D<T>::rotation);
+    }
+
+
+    // Point queries
+    // Make the base batch overloads visible next to the single point overrides
+    using Shape2D<T>::contains;
+    using Shape2D<T>::signedDistance;
+
+    bool contains(Vector2<T> point) override {
+        _prepareQueries();
+        Vector2<Real> p = _frame().local(static_cast<Real>(point.x), static_cast<Real>(point.y));
+        return _query().inside(p.x, p.y);
+    }
+
+    T signedDistance(Vector2<T> point) override {
+        _prepareQueries();
+        Vector2<Real> p = _frame().local(static_cast<Real>(point.x), static_cast<Real>(point.y));
+        return _query_result<T>(_query().distance(p.x, p.y));
     }
 
 
     // Transformative functions
-    void scale(T scalar) override { size *= scalar; }
+    void scale(T scalar) override {
+        size *= scalar;
+        Shape2D<T>::invalidate();
+    }
     void scale(T x, T y) { 
         size.x *= x; 
         size.y *= y; 
+        Shape2D<T>::invalidate();
+    }
+    void scale(Vector2<T> scale) {
+        size *= scale;
+        Shape2D<T>::invalidate();
     }
-    void scale(Vector2<T> scale) { size *= scale; }
 
 
 
     // Serializers
     std::string str() {
-        std::stringstream ss;
-        ss << "Rectangle { size: " << size.str() << ", " << Shape2D<T>::str() << " }";
-        return ss.str();
+        Shape2D<T>::flush();
+        std::string out;
+        str(out);
+        return out;
+    }
+
+    void str(std::string& out) const {
+        if (Shape2D<T>::hasPendingTransform())
+            return flushed(*this).str(out);
+
+        INSTRUMENT_SCOPE("Rectangle::str");
+        INSTRUMENT_SERIALIZATION(out);
+
+        out += "Rectangle { size: ";
+        size.str(out);
+        out += ", ";
+        Shape2D<T>::str(out);
+        out += " }";
     }
 
     std::string json() {
-        std::stringstream ss;
-        ss << "{\"size\":" << size.json() << "," << Shape2D<T>::json() << "}";
-        return ss.str();
+        Shape2D<T>::flush();
+        std::string out;
+        json(out);
+        return out;
+    }
+
+    void json(std::string& out) const {
+        if (Shape2D<T>::hasPendingTransform())
+            return flushed(*this).json(out);
+
+        INSTRUMENT_SCOPE("Rectangle::json");
+        INSTRUMENT_SERIALIZATION(out);
+
+        out += "{\"size\":";
+        size.json(out);
+        out += ',';
+        Shape2D<T>::json(out);
+        out += '}';
+    }
+
+
+
+    // Parsers
+    // Reads an object written by json(). Members may appear in any order.
+    bool parseJson(const char*& first, const char* last) {
+        return parse_json_object(first, last, [this](std::string_view key, const char*& f, const char* l) {
+            if (key == "size")
+                return size.parseJson(f, l);
+            return Shape2D<T>::parseJsonField(key, f, l);
+        });
+    }
+
+    // Parses a whole JSON document, returning false if it is invalid
+    static bool fromJson(std::string_view json, Rectangle& out) { return parse_json_document(json, out); }
+
+
+
+protected:
+    void _containsPoints(const T* x, const T* y, size_t begin, size_t end, uint64_t* mask) override {
+        query_contains(x, y, begin, end, _frame(), _query(), mask);
+    }
+
+    void _signedDistances(const T* x, const T* y, size_t begin, size_t end, T* out) override {
+        query_distances(x, y, begin, end, _frame(), _query(), out);
+    }
+
+    void _raycastPacket(RayPacket<Real>& packet, uint32_t id) override {
+        ray_cast_packet(_frame(), _query(), packet, id);
+    }
+
+    void _rasterize(RasterTile<Real>& tile) override { raster_shape(tile, _frame(), _query()); }
+
+    void _scaleBy(Real factor) override {
+        size.x = Shape2D<T>::_fromReal(static_cast<Real>(size.x) * factor);
+        size.y = Shape2D<T>::_fromReal(static_cast<Real>(size.y) * factor);
+    }
+
+    // The frame's trig is evaluated once here, rather than for every range, packet or tile the kernels run on
+    void _prepareQueries() override {
+        Shape2D<T>::flush();
+        query_frame = Shape2D<T>::_queryFrame();
+    }
+
+
+
+private:
+    // Frame of the kernels, kept since _prepareQueries()
+    QueryFrame<Real> query_frame;
+
+    const QueryFrame<Real>& _frame() const { return query_frame; }
+
+    RectangleQuery<Real> _query() const {
+        return { std::abs(static_cast<Real>(size.x)) / 2, std::abs(static_cast<Real>(size.y)) / 2 };
     }
 };
 
@@ -389,10 +1693,12 @@ public:
 
 
 // This class represents regular N-Gons only.
-// For asymmetrical N-gons, use the Polygon class. (Coming soon)
+// For asymmetrical N-gons, use the Polygon class from polygon.h.
 template <typename T>
 class NGon : public Shape2D<T> {
 public:
+    using Real = typename Shape2D<T>::Real;
+
     // Data
     size_t N; // Number of vertices
     T radius; // This represents the N-Gon's circumradius.
@@ -426,61 +1732,387 @@ public:
 
 
     // Utility functions
-    constexpr Angle centralAngle() { return 360 / N; }
+    constexpr Angle centralAngle() { return 360 / static_cast<Angle>(N); }
     constexpr Angle innerAngle()   { return 180 - centralAngle(); }
     
-    constexpr T edge() { return 2 * sin(M_PI / N) * radius; }
-    constexpr T circumradius() { return radius; }
-    constexpr T inradius() { return radius * cos(M_PI / N); }
+    // The sizes flush the pending transform, which scales them
+    T edge()         { Shape2D<T>::flush(); return 2 * sin(M_PI / N) * radius; }
+    T circumradius() { Shape2D<T>::flush(); return radius; }
+    T inradius()     { Shape2D<T>::flush(); return radius * cos(M_PI / N); }
 
-    constexpr T perimeter() override { return edge() * N; }
-    constexpr T area() override { 
+    T perimeter() override { return edge() * N; }
+    T area() override { 
         T e = edge();
         return (N * e * e) / (4 * tan(M_PI / N)); 
     }
 
-    constexpr std::vector<Vector2<T>> vertices() {
-        // Store value of central angle
-        auto angle_central = -centralAngle();
+    // Make the base overloads visible next to the output iterator overload
+    using Shape2D<T>::vertices;
 
-        // Defines the container for resulting verticies
-        std::vector<Vector2<T>> vertex_list(N);
+    constexpr size_t vertexCount() override { return N; }
 
-        // Iterate through each point and add to vertex list.
-        for (size_t i = 0; i < N; i++) {
-            // Calculate degrees of rotation for given vertex
-            Angle v_rotation = angle_central * i;
+    size_t vertices(std::span<Vector2<T>> out) override {
+        size_t count = out.size() < N ? out.size() : N;
+        vertices(out.begin(), count);
+        return count;
+    }
 
-            // Rotate point around circle's center
-            vertex_list[i] = rotate_point(Vector2<T>(0, radius), Shape2D<T>::position, v_rotation);
-        }
+    // Renders the N-Gon through an output iterator and returns the iterator past the last vertex
+    template <std::output_iterator<Vector2<T>> OutputIt>
+    OutputIt vertices(OutputIt out) { return vertices(out, N); }
 
-        // Rotate vertices by shapes's rotation value
-        if (rotation != 0)
-            for (auto &v: vertex_list) 
-                v = rotate_point(v, Shape2D<T>::position, Shape2D<T>::rotation);
+    // Renders only the first `count` vertices
+    template <std::output_iterator<Vector2<T>> OutputIt>
+    OutputIt vertices(OutputIt out, size_t count) {
+        INSTRUMENT_SCOPE("NGon::vertices");
+        Shape2D<T>::flush();
 
-        // Return rotated vertices list
-        return vertex_list;
+        // Scale the cached unit-circle table to the N-Gon, then rotate and offset it
+        auto table = unit_circle_table<T>(N);
+        return place_unit_vertices(table.get(), N, count, out, Shape2D<T>::position, radius, Shape2D<T>::rotation);
     }
 
 
 
+    // Computes the bounds from the extrema of the cached unit-circle table
+    Bounds2D<T> computeBounds() override {
+        return ngon_bounds(Shape2D<T>::position, N, radius, Shape2D<T>::rotation);
+    }
+
+
+    // Point queries
+    // Make the base batch overloads visible next to the single point overrides
+    using Shape2D<T>::contains;
+    using Shape2D<T>::signedDistance;
+
+    bool contains(Vector2<T> point) override {
+        _prepareQueries();
+        Vector2<Real> p = _frame().local(static_cast<Real>(point.x), static_cast<Real>(point.y));
+        return _query().inside(p.x, p.y);
+    }
+
+    T signedDistance(Vector2<T> point) override {
+        _prepareQueries();
+        Vector2<Real> p = _frame().local(static_cast<Real>(point.x), static_cast<Real>(point.y));
+        return _query_result<T>(_query().distance(p.x, p.y));
+    }
+
+
     // Transformative functions
-    void scale(T scalar) override { radius *= scalar; }
+    void scale(T scalar) override {
+        radius *= scalar;
+        Shape2D<T>::invalidate();
+    }
 
 
 
     // Serializers
     std::string str() {
-        std::stringstream ss;
-        ss << "NGon { N: " << N << ", radius: " << radius << ", " << Shape2D<T>::str() << " }";
-        return ss.str();
+        Shape2D<T>::flush();
+        std::string out;
+        str(out);
+        return out;
+    }
+
+    void str(std::string& out) const {
+        if (Shape2D<T>::hasPendingTransform())
+            return flushed(*this).str(out);
+
+        INSTRUMENT_SCOPE("NGon::str");
+        INSTRUMENT_SERIALIZATION(out);
+
+        out += "NGon { N: ";
+        append_formatted(out, N);
+        out += ", radius: ";
+        append_formatted(out, radius);
+        out += ", ";
+        Shape2D<T>::str(out);
+        out += " }";
     }
 
     std::string json() {
-        std::stringstream ss;
-        ss << "{\"N\":" << N << ",\"radius\":" << radius << "," << Shape2D<T>::json() << "}";
-        return ss.str();
+        Shape2D<T>::flush();
+        std::string out;
+        json(out);
+        return out;
+    }
+
+    void json(std::string& out) const {
+        if (Shape2D<T>::hasPendingTransform())
+            return flushed(*this).json(out);
+
+        INSTRUMENT_SCOPE("NGon::json");
+        INSTRUMENT_SERIALIZATION(out);
+
+        out += "{\"N\":";
+        append_formatted(out, N);
+        out += ",\"radius\":";
+        append_formatted(out, radius);
+        out += ',';
+        Shape2D<T>::json(out);
+        out += '}';
+    }
+
+
+
+    // Parsers
+    // Reads an object written by json(). Members may appear in any order.
+    bool parseJson(const char*& first, const char* last) {
+        return parse_json_object(first, last, [this](std::string_view key, const char*& f, const char* l) {
+            if (key == "N")
+                return parse_formatted(f, l, N);
+            if (key == "radius")
+                return parse_formatted(f, l, radius);
+            return Shape2D<T>::parseJsonField(key, f, l);
+        });
+    }
+
+    // Parses a whole JSON document, returning false if it is invalid
+    static bool fromJson(std::string_view json, NGon& out) { return parse_json_document(json, out); }
+
+
+
+protected:
+    void _containsPoints(const T* x, const T* y, size_t begin, size_t end, uint64_t* mask) override {
+        query_contains(x, y, begin, end, _frame(), _query(), mask);
+    }
+
+    void _signedDistances(const T* x, const T* y, size_t begin, size_t end, T* out) override {
+        query_distances(x, y, begin, end, _frame(), _query(), out);
+    }
+
+    void _raycastPacket(RayPacket<Real>& packet, uint32_t id) override {
+        ray_cast_packet(_frame(), _query(), packet, id);
+    }
+
+    void _rasterize(RasterTile<Real>& tile) override { raster_shape(tile, _frame(), _query()); }
+
+    void _scaleBy(Real factor) override { radius = Shape2D<T>::_fromReal(static_cast<Real>(radius) * factor); }
+
+    // The normal table is fetched from the cache once, and kept until the vertex count changes, and the frame's
+    // trig is evaluated once, so the kernels that may run on several threads at once only read them.
+    // A negative radius places every vertex on the opposite side, which turns the frame around.
+    void _prepareQueries() override {
+        Shape2D<T>::flush();
+        if (!normals || normals->size() != 2 * N)
+            normals = UnitCircleCache<T>::table(2 * N);
+        query_frame = Shape2D<T>::_queryFrame(radius < 0 ? -1 : 1);
     }
-};
\ No newline at end of file
+
+
+
+private:
+    // Edge normals are the odd entries of the 2N direction table, held by the shape since _prepareQueries()
+    std::shared_ptr<const typename UnitCircleCache<T>::Table> normals;
+
+    // Frame of the kernels, kept since _prepareQueries()
+    QueryFrame<Real> query_frame;
+
+    const QueryFrame<Real>& _frame() const { return query_frame; }
+
+    NGonQuery<Real> _query() const { return NGonQuery<Real>(N, std::abs(static_cast<Real>(radius)), normals->data()); }
+};
+
+
+
+
+// An N-Gon whose vertex count is fixed at compile time.
+// Its unit-circle table is generated by the compiler and stored in the binary,
+// so rendering never touches UnitCircleCache or evaluates trig for the table.
+// It serializes exactly like an NGon with the same N.
+template <typename T, size_t N>
+class FixedNGon : public Shape2D<T> {
+    static_assert(N >= 3, "A FixedNGon needs at least 3 vertices");
+
+public:
+    using Real = typename UnitCircleCache<T>::Real;
+
+    // Direction of every vertex, starting at (0, 1) and continuing clockwise, the same as NGon
+    static constexpr std::array<Vector2<Real>, N> unit_vertices = unit_vertex_table<Real, N>();
+
+    // Data
+    T radius; // This represents the N-Gon's circumradius.
+
+
+
+    // Default constructor
+    FixedNGon()
+        : radius(0) {}
+
+    // Size constructor
+    FixedNGon(T radius)
+        : radius(radius) {}
+
+    // Size and position constructor
+    FixedNGon(T radius, T positionX, T positionY)
+        : Shape2D<T>(positionX, positionY), radius(radius) {}
+    FixedNGon(T radius, Vector2<T> position)
+        : Shape2D<T>(position), radius(radius) {}
+
+    // Size, position, and rotation constructor
+    FixedNGon(T radius, T positionX, T positionY, Angle rotation)
+        : Shape2D<T>(positionX, positionY, rotation), radius(radius) {}
+    FixedNGon(T radius, Vector2<T> position, Angle rotation)
+        : Shape2D<T>(position, rotation), radius(radius) {}
+
+
+
+    // Utility functions
+    // The trig terms are read from compile-time tables: (sin, cos) of π/N is the first entry of the 2N table.
+    static constexpr Angle centralAngle() { return 360 / static_cast<Angle>(N); }
+    static constexpr Angle innerAngle()   { return 180 - centralAngle(); }
+
+    // The sizes flush the pending transform, which scales them
+    T edge()         { Shape2D<T>::flush(); return 2 * unit_vertex<Real>(1, 2 * N).x * radius; }
+    T circumradius() { Shape2D<T>::flush(); return radius; }
+    T inradius()     { Shape2D<T>::flush(); return radius * unit_vertex<Real>(1, 2 * N).y; }
+
+    T perimeter() override { return edge() * N; }
+    T area() override {
+        T r = circumradius();
+        return (N * r * r * unit_vertices[1].x) / 2;
+    }
+
+    // Make the base overloads visible next to the output iterator overload
+    using Shape2D<T>::vertices;
+
+    constexpr size_t vertexCount() override { return N; }
+
+    size_t vertices(std::span<Vector2<T>> out) override {
+        size_t count = out.size() < N ? out.size() : N;
+        vertices(out.begin(), count);
+        return count;
+    }
+
+    // Renders the N-Gon through an output iterator and returns the iterator past the last vertex
+    template <std::output_iterator<Vector2<T>> OutputIt>
+    OutputIt vertices(OutputIt out) { return vertices(out, N); }
+
+    // Renders only the first `count` vertices
+    template <std::output_iterator<Vector2<T>> OutputIt>
+    OutputIt vertices(OutputIt out, size_t count) {
+        INSTRUMENT_SCOPE("FixedNGon::vertices");
+        Shape2D<T>::flush();
+        return place_unit_vertices<T, Real>(std::span<const Vector2<Real>>(unit_vertices), count, out,
+                                            Shape2D<T>::position, radius, Shape2D<T>::rotation);
+    }
+
+
+
+    // Computes the bounds from the extrema of the compile-time table
+    Bounds2D<T> computeBounds() override {
+        return unit_table_bounds<T, Real>(std::span<const Vector2<Real>>(unit_vertices),
+                                          Shape2D<T>::position, radius, Shape2D<T>::rotation);
+    }
+
+
+    // Point queries
+    // Make the base batch overloads visible next to the single point overrides
+    using Shape2D<T>::contains;
+    using Shape2D<T>::signedDistance;
+
+    bool contains(Vector2<T> point) override {
+        _prepareQueries();
+        Vector2<Real> p = _frame().local(static_cast<Real>(point.x), static_cast<Real>(point.y));
+        return _query().inside(p.x, p.y);
+    }
+
+    T signedDistance(Vector2<T> point) override {
+        _prepareQueries();
+        Vector2<Real> p = _frame().local(static_cast<Real>(point.x), static_cast<Real>(point.y));
+        return _query_result<T>(_query().distance(p.x, p.y));
+    }
+
+
+    // Transformative functions
+    void scale(T scalar) override {
+        radius *= scalar;
+        Shape2D<T>::invalidate();
+    }
+
+
+    // Converts to a runtime N-Gon with the same data
+    NGon<T> toNGon() const {
+        if (Shape2D<T>::hasPendingTransform())
+            return flushed(*this).toNGon();
+        return NGon<T>(N, radius, Shape2D<T>::position, Shape2D<T>::rotation);
+    }
+
+
+
+    // Serializers
+    std::string str() {
+        Shape2D<T>::flush();
+        std::string out;
+        str(out);
+        return out;
+    }
+
+    void str(std::string& out) const { toNGon().str(out); }
+
+    std::string json() {
+        Shape2D<T>::flush();
+        std::string out;
+        json(out);
+        return out;
+    }
+
+    void json(std::string& out) const { toNGon().json(out); }
+
+
+
+    // Parsers
+    // Reads an object written by json(). Fails if the object has a different N.
+    bool parseJson(const char*& first, const char* last) {
+        size_t count = N;
+        bool valid = parse_json_object(first, last, [this, &count](std::string_view key, const char*& f, const char* l) {
+            if (key == "N")
+                return parse_formatted(f, l, count);
+            if (key == "radius")
+                return parse_formatted(f, l, radius);
+            return Shape2D<T>::parseJsonField(key, f, l);
+        });
+        return valid && count == N;
+    }
+
+    // Parses a whole JSON document, returning false if it is invalid
+    static bool fromJson(std::string_view json, FixedNGon& out) { return parse_json_document(json, out); }
+
+
+
+protected:
+    void _containsPoints(const T* x, const T* y, size_t begin, size_t end, uint64_t* mask) override {
+        query_contains(x, y, begin, end, _frame(), _query(), mask);
+    }
+
+    void _signedDistances(const T* x, const T* y, size_t begin, size_t end, T* out) override {
+        query_distances(x, y, begin, end, _frame(), _query(), out);
+    }
+
+    void _raycastPacket(RayPacket<Real>& packet, uint32_t id) override {
+        ray_cast_packet(_frame(), _query(), packet, id);
+    }
+
+    void _rasterize(RasterTile<Real>& tile) override { raster_shape(tile, _frame(), _query()); }
+
+    void _scaleBy(Real factor) override { radius = Shape2D<T>::_fromReal(static_cast<Real>(radius) * factor); }
+
+    // Same as NGon, the frame is computed once for all the kernels
+    void _prepareQueries() override {
+        Shape2D<T>::flush();
+        query_frame = Shape2D<T>::_queryFrame(radius < 0 ? -1 : 1);
+    }
+
+
+
+private:
+    // Frame of the kernels, kept since _prepareQueries()
+    QueryFrame<Real> query_frame;
+
+    const QueryFrame<Real>& _frame() const { return query_frame; }
+
+    // Edge normals are the odd entries of the compile-time 2N direction table
+    static constexpr std::array<Vector2<Real>, 2 * N> edge_normals = unit_vertex_table<Real, 2 * N>();
+
+    NGonQuery<Real> _query() const { return NGonQuery<Real>(N, std::abs(static_cast<Real>(radius)), edge_normals.data()); }
+};
@@ -0,0 +1,571 @@
+/// Author: PlumpDolphin
+/// Date: October 16, 2026
+///
+/// Description:
+///     Provides spatial indices for answering region and point queries over large shape collections.
+///     BVH is a bounding volume hierarchy built with the surface area heuristic, suited to static or
+///     slowly changing scenes. UniformGrid is a hashed grid of fixed-size cells, suited to scenes
+///     of similarly sized shapes that move every frame.
+///
+///     Both index the axis-aligned bounds of each shape, so they can be built from Shape2D pointers or
+///     from the bounds of a shape batch. Shapes are identified by their index in the collection, and
+///     both indices can be refit in place after shapes are transformed, without a full rebuild.
+///
+/// License:
+///     The code in this file is licensed under the
+///     Revised 3-Clause BSD License.
+///     For details, see https://opensource.org/licenses/BSD-3-Clause
+
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "shapes.h" // Includes definitions for Shape2D<T> and Bounds2D<T>.
+
+
+
+// Example usage showing construction, queries and refitting.
+/*
+    std::vector<Shape2D<float>*> shapes = ...;
+
+    // Build both indices over the same shapes
+    BVH<float> bvh;
+    bvh.build(shapes);
+
+    UniformGrid<float> grid(16); // 16 units per cell
+    grid.build(shapes);
+
+    // Queries write the indices of matching shapes into a reusable list
+    std::vector<uint32_t> hits;
+    bvh.query(Bounds2D<float>({0, 0}, {100, 100}), hits);
+    grid.query(Vector2<float>(5, 5), hits);
+
+    // After shapes move, refit instead of rebuilding
+    shapes[3]->move(1, 0);
+    bvh.refit(shapes);
+    grid.refit(shapes);
+
+    // Indices of shape batches are built from their bounds
+    bvh.build(circleBatch.bounds());
+*/
+
+
+
+
+
+// Bounding volume hierarchy over the bounds of a shape collection.
+// Nodes are stored depth-first, so the left child of a node always directly follows it.
+template <typename T>
+class BVH {
+public:
+    struct Node {
+        Bounds2D<T> box;
+        uint32_t start = 0; // First item of a leaf, or index of the right child of an inner node
+        uint32_t count = 0; // Number of items in a leaf, or 0 for inner nodes
+    };
+
+    // Maximum number of shapes stored in a single leaf
+    static constexpr uint32_t max_leaf_size = 4;
+
+    // Number of bins used to evaluate split candidates
+    static constexpr size_t bin_count = 16;
+
+
+
+    // Builds the hierarchy from the current bounds of every shape
+    void build(std::span<Shape2D<T>* const> shapes) {
+        _gather(shapes);
+        _build();
+    }
+
+    // Builds the hierarchy from a list of bounds, such as the result of a batch's bounds()
+    void build(std::span<const Bounds2D<T>> bounds) {
+        boxes.assign(bounds.begin(), bounds.end());
+        _build();
+    }
+
+
+
+    // Refits every node to the current bounds of the shapes, keeping the tree structure.
+    // Bounds are cached by each shape, so only transformed shapes are recomputed.
+    void refit(std::span<Shape2D<T>* const> shapes) {
+        _gather(shapes);
+        _refit_all();
+    }
+
+    void refit(std::span<const Bounds2D<T>> bounds) {
+        boxes.assign(bounds.begin(), bounds.end());
+        _refit_all();
+    }
+
+    // Refits only the path from one shape's leaf up to the root
+    void update(uint32_t id, const Bounds2D<T>& box) {
+        boxes[id] = box;
+
+        uint32_t node = leaf_of[id];
+        while (true) {
+            Bounds2D<T> before = nodes[node].box;
+            _refit_node(node);
+
+            // Ancestors only change if this node did
+            if (node == 0 || (nodes[node].box.min == before.min && nodes[node].box.max == before.max))
+                break;
+            node = parents[node];
+        }
+    }
+
+
+
+    // Writes the indices of every shape whose bounds overlap the region
+    void query(const Bounds2D<T>& region, std::vector<uint32_t>& out) const {
+        out.clear();
+        _traverse([&](const Bounds2D<T>& box) { return box.overlaps(region); }, out);
+    }
+
+    // Writes the indices of every shape whose bounds contain the point
+    void query(Vector2<T> point, std::vector<uint32_t>& out) const {
+        out.clear();
+        _traverse([&](const Bounds2D<T>& box) { return box.contains(point); }, out);
+    }
+
+
+
+    // Utility functions
+    size_t size() const { return boxes.size(); }
+    bool empty() const  { return boxes.empty(); }
+
+    const std::vector<Node>& getNodes() const { return nodes; }
+    const std::vector<uint32_t>& getItems() const { return items; }
+
+
+
+private:
+    std::vector<Node> nodes;
+    std::vector<uint32_t> items;    // Shape indices, grouped by leaf
+    std::vector<uint32_t> parents;  // Parent of every node
+    std::vector<uint32_t> leaf_of;  // Leaf node of every shape
+    std::vector<Bounds2D<T>> boxes; // Bounds of every shape
+
+    // The traversal stack is fixed-size, and deep subtrees are split at the median to stay within it
+    static constexpr uint32_t max_sah_depth = 48;
+    static constexpr size_t stack_size = 128;
+
+    struct Bin {
+        Bounds2D<T> box;
+        uint32_t count = 0;
+    };
+
+    static double _half_perimeter(const Bounds2D<T>& box) {
+        return static_cast<double>(box.width()) + static_cast<double>(box.height());
+    }
+
+    static double _centroid(const Bounds2D<T>& box, int axis) {
+        return axis == 0 ? (static_cast<double>(box.min.x) + box.max.x) / 2
+                         : (static_cast<double>(box.min.y) + box.max.y) / 2;
+    }
+
+    void _gather(std::span<Shape2D<T>* const> shapes) {
+        boxes.resize(shapes.size());
+        bounds_all<T>(shapes, boxes);
+    }
+
+    void _build() {
+        nodes.clear();
+        items.resize(boxes.size());
+        for (uint32_t i = 0; i < items.size(); i++)
+            items[i] = i;
+
+        parents.clear();
+        leaf_of.assign(boxes.size(), 0);
+
+        if (!boxes.empty())
+            _build_node(0, static_cast<uint32_t>(items.size()), 0, 0);
+    }
+
+    // Builds the subtree over items[begin, end) and returns the index of its root node
+    uint32_t _build_node(uint32_t begin, uint32_t end, uint32_t depth, uint32_t parent) {
+        uint32_t index = static_cast<uint32_t>(nodes.size());
+        nodes.push_back(Node());
+        parents.push_back(parent);
+
+        Bounds2D<T> box = boxes[items[begin]];
+        double min_c[2] = { _centroid(box, 0), _centroid(box, 1) };
+        double max_c[2] = { min_c[0], min_c[1] };
+
+        for (uint32_t i = begin + 1; i < end; i++) {
+            const Bounds2D<T>& b = boxes[items[i]];
+            box = box.merge(b);
+            for (int axis = 0; axis < 2; axis++) {
+                double c = _centroid(b, axis);
+                min_c[axis] = c < min_c[axis] ? c : min_c[axis];
+                max_c[axis] = c > max_c[axis] ? c : max_c[axis];
+            }
+        }
+        nodes[index].box = box;
+
+        uint32_t count = end - begin;
+        if (count <= max_leaf_size)
+            return _make_leaf(index, begin, count);
+
+        // Split along the axis with the widest spread of centroids
+        int axis = (max_c[1] - min_c[1]) > (max_c[0] - min_c[0]) ? 1 : 0;
+        double extent = max_c[axis] - min_c[axis];
+        uint32_t middle = begin;
+
+        if (extent > 0 && depth < max_sah_depth) {
+            // Bin the centroids and evaluate every bin boundary with the surface area heuristic
+            Bin bins[bin_count];
+            double scale = bin_count / extent;
+            auto bin_of = [&](uint32_t item) {
+                size_t b = static_cast<size_t>((_centroid(boxes[item], axis) - min_c[axis]) * scale);
+                return b < bin_count ? b : bin_count - 1;
+            };
+
+            for (uint32_t i = begin; i < end; i++) {
+                Bin& bin = bins[bin_of(items[i])];
+                bin.box = bin.count++ ? bin.box.merge(boxes[items[i]]) : boxes[items[i]];
+            }
+
+            // Sweep from the right to find the cost of every right-hand side
+            double right_cost[bin_count] = {};
+            Bounds2D<T> sweep;
+            uint32_t right_count = 0;
+            for (size_t b = bin_count - 1; b > 0; b--) {
+                if (bins[b].count > 0) {
+                    sweep = right_count ? sweep.merge(bins[b].box) : bins[b].box;
+                    right_count += bins[b].count;
+                }
+                right_cost[b] = right_count ? _half_perimeter(sweep) * right_count : 0;
+            }
+
+            // Sweep from the left, combining both sides
+            double best_cost = _half_perimeter(box) * count; // Cost of not splitting
+            size_t best_split = 0;
+            uint32_t left_count = 0;
+            for (size_t b = 0; b + 1 < bin_count; b++) {
+                if (bins[b].count > 0) {
+                    sweep = left_count ? sweep.merge(bins[b].box) : bins[b].box;
+                    left_count += bins[b].count;
+                }
+                if (left_count == 0 || left_count == count)
+                    continue;
+
+                double cost = (_half_perimeter(sweep) * left_count) + right_cost[b + 1];
+                if (cost < best_cost) {
+                    best_cost = cost;
+                    best_split = b + 1;
+                }
+            }
+
+            if (best_split > 0) {
+                uint32_t* first = items.data() + begin;
+                uint32_t* last = items.data() + end;
+                middle = static_cast<uint32_t>(std::partition(first, last, [&](uint32_t item) {
+                    return bin_of(item) < best_split;
+                }) - items.data());
+            }
+        }
+
+        // Fall back to splitting at the median centroid when the heuristic can't separate the items,
+        // so the children still divide the space between them
+        if (middle == begin || middle == end) {
+            middle = begin + (count / 2);
+            std::nth_element(items.data() + begin, items.data() + middle, items.data() + end, [&](uint32_t a, uint32_t b) {
+                return _centroid(boxes[a], axis) < _centroid(boxes[b], axis);
+            });
+        }
+
+        _build_node(begin, middle, depth + 1, index);
+        uint32_t right = _build_node(middle, end, depth + 1, index);
+
+        nodes[index].start = right;
+        nodes[index].count = 0;
+        return index;
+    }
+
+    uint32_t _make_leaf(uint32_t index, uint32_t begin, uint32_t count) {
+        nodes[index].start = begin;
+        nodes[index].count = count;
+        for (uint32_t i = begin; i < begin + count; i++)
+            leaf_of[items[i]] = index;
+        return index;
+    }
+
+    // Recomputes the bounds of one node from its items or children
+    void _refit_node(uint32_t index) {
+        Node& node = nodes[index];
+        if (node.count > 0) {
+            node.box = boxes[items[node.start]];
+            for (uint32_t i = node.start + 1; i < node.start + node.count; i++)
+                node.box = node.box.merge(boxes[items[i]]);
+        } else {
+            node.box = nodes[index + 1].box.merge(nodes[node.start].box);
+        }
+    }
+
+    void _refit_all() {
+        // Children always follow their parent, so a reverse sweep visits them first
+        for (size_t i = nodes.size(); i > 0; i--)
+            _refit_node(static_cast<uint32_t>(i - 1));
+    }
+
+    template <typename Test>
+    void _traverse(Test test, std::vector<uint32_t>& out) const {
+        if (nodes.empty())
+            return;
+
+        uint32_t stack[stack_size];
+        size_t top = 0;
+        stack[top++] = 0;
+
+        while (top > 0) {
+            const Node& node = nodes[stack[--top]];
+            if (!test(node.box))
+                continue;
+
+            if (node.count > 0) {
+                for (uint32_t i = node.start; i < node.start + node.count; i++)
+                    if (test(boxes[items[i]]))
+                        out.push_back(items[i]);
+            } else {
+                uint32_t index = static_cast<uint32_t>(&node - nodes.data());
+                stack[top++] = node.start;
+                stack[top++] = index + 1;
+            }
+        }
+    }
+};
+
+
+
+
+
+// Hashed uniform grid over the bounds of a shape collection.
+// Every shape is stored in each cell its bounds overlap. Only occupied cells are kept in the hash map:
+// cells that become empty are removed, and their lists are recycled for newly occupied cells,
+// so refitting moving shapes doesn't allocate in steady state, and memory follows the peak occupancy.
+// Queries use internal scratch space, so a grid should only be queried by one thread at a time.
+template <typename T>
+class UniformGrid {
+public:
+    // Constructs a grid with square cells of the given size.
+    // Cells around the size of a typical shape work best.
+    explicit UniformGrid(T cell_size)
+        : cell_size(cell_size) {}
+
+
+
+    void build(std::span<Shape2D<T>* const> shapes) {
+        _clear();
+        boxes.resize(shapes.size());
+        bounds_all<T>(shapes, boxes);
+        _insert_all();
+    }
+
+    void build(std::span<const Bounds2D<T>> bounds) {
+        _clear();
+        boxes.assign(bounds.begin(), bounds.end());
+        _insert_all();
+    }
+
+
+
+    // Moves shapes whose bounds changed to their new cells.
+    // The collection must be the same size as the one the grid was built from.
+    void refit(std::span<Shape2D<T>* const> shapes) {
+        for (uint32_t i = 0; i < shapes.size() && i < boxes.size(); i++)
+            update(i, shapes[i]->bounds());
+    }
+
+    void refit(std::span<const Bounds2D<T>> bounds) {
+        for (uint32_t i = 0; i < bounds.size() && i < boxes.size(); i++)
+            update(i, bounds[i]);
+    }
+
+    // Updates the bounds of a single shape, moving it between cells only if its cell range changed
+    void update(uint32_t id, const Bounds2D<T>& box) {
+        boxes[id] = box;
+
+        CellRange range = _range(box);
+        if (range == ranges[id])
+            return;
+
+        _remove(id, ranges[id]);
+        ranges[id] = range;
+        _insert(id, range);
+    }
+
+
+
+    // Writes the indices of every shape whose bounds overlap the region
+    void query(const Bounds2D<T>& region, std::vector<uint32_t>& out) {
+        out.clear();
+        _next_stamp();
+
+        CellRange range = _range(region);
+        uint64_t cell_span = static_cast<uint64_t>(range.x1 - range.x0 + 1) * static_cast<uint64_t>(range.y1 - range.y0 + 1);
+
+        auto visit = [&](const std::vector<uint32_t>& cell) {
+            for (uint32_t id: cell) {
+                if (stamps[id] != stamp) {
+                    stamps[id] = stamp;
+                    if (boxes[id].overlaps(region))
+                        out.push_back(id);
+                }
+            }
+        };
+
+        // Large regions are cheaper to answer by visiting only the occupied cells
+        if (cell_span > cells.size()) {
+            for (auto &[key, cell]: cells) {
+                int32_t cx = static_cast<int32_t>(key >> 32);
+                int32_t cy = static_cast<int32_t>(key & 0xFFFFFFFF);
+                if (cx >= range.x0 && cx <= range.x1 && cy >= range.y0 && cy <= range.y1)
+                    visit(cell);
+            }
+            return;
+        }
+
+        for (int32_t cx = range.x0; cx <= range.x1; cx++) {
+            for (int32_t cy = range.y0; cy <= range.y1; cy++) {
+                auto it = cells.find(_key(cx, cy));
+                if (it != cells.end())
+                    visit(it->second);
+            }
+        }
+    }
+
+    // Writes the indices of every shape whose bounds contain the point
+    void query(Vector2<T> point, std::vector<uint32_t>& out) {
+        out.clear();
+
+        auto it = cells.find(_key(_cell(point.x), _cell(point.y)));
+        if (it == cells.end())
+            return;
+
+        // A point lies in exactly one cell, so there are no duplicates to filter
+        for (uint32_t id: it->second)
+            if (boxes[id].contains(point))
+                out.push_back(id);
+    }
+
+
+
+    // Utility functions
+    size_t size() const      { return boxes.size(); }
+    size_t cellCount() const { return cells.size(); }
+    T cellSize() const       { return cell_size; }
+
+
+
+private:
+    struct CellRange {
+        int32_t x0 = 0, y0 = 0, x1 = -1, y1 = -1;
+        bool operator==(const CellRange&) const = default;
+    };
+
+    using CellMap = std::unordered_map<uint64_t, std::vector<uint32_t>>;
+
+    T cell_size;
+    CellMap cells;
+    std::vector<typename CellMap::node_type> spare; // Emptied cells, kept with their list's capacity
+    std::vector<Bounds2D<T>> boxes;
+    std::vector<CellRange> ranges;
+    std::vector<uint32_t> stamps; // Query number each shape was last visited in, to skip duplicates
+    uint32_t stamp = 0;
+
+    int32_t _cell(T value) const {
+        return static_cast<int32_t>(std::floor(static_cast<double>(value) / static_cast<double>(cell_size)));
+    }
+
+    static uint64_t _key(int32_t cx, int32_t cy) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32) | static_cast<uint32_t>(cy);
+    }
+
+    CellRange _range(const Bounds2D<T>& box) const {
+        CellRange range;
+        range.x0 = _cell(box.min.x);
+        range.y0 = _cell(box.min.y);
+        range.x1 = _cell(box.max.x);
+        range.y1 = _cell(box.max.y);
+        return range;
+    }
+
+    void _clear() {
+        // Empty the cell lists rather than dropping them, so their capacity is reused
+        while (!cells.empty()) {
+            spare.push_back(cells.extract(cells.begin()));
+            spare.back().mapped().clear();
+        }
+    }
+
+    // Returns the list of a cell, occupying it with a recycled list if it was empty
+    std::vector<uint32_t>& _occupy(uint64_t key) {
+        auto it = cells.find(key);
+        if (it != cells.end())
+            return it->second;
+
+        if (spare.empty())
+            return cells[key];
+
+        typename CellMap::node_type node = std::move(spare.back());
+        spare.pop_back();
+        node.key() = key;
+        return cells.insert(std::move(node)).position->second;
+    }
+
+    void _insert_all() {
+        ranges.resize(boxes.size());
+        stamps.assign(boxes.size(), 0);
+        stamp = 0;
+
+        for (uint32_t i = 0; i < boxes.size(); i++) {
+            ranges[i] = _range(boxes[i]);
+            _insert(i, ranges[i]);
+        }
+    }
+
+    void _insert(uint32_t id, const CellRange& range) {
+        for (int32_t cx = range.x0; cx <= range.x1; cx++)
+            for (int32_t cy = range.y0; cy <= range.y1; cy++)
+                _occupy(_key(cx, cy)).push_back(id);
+    }
+
+    void _remove(uint32_t id, const CellRange& range) {
+        for (int32_t cx = range.x0; cx <= range.x1; cx++) {
+            for (int32_t cy = range.y0; cy <= range.y1; cy++) {
+                auto it = cells.find(_key(cx, cy));
+                if (it == cells.end())
+                    continue;
+
+                // Order within a cell doesn't matter, so swap with the last entry and pop
+                auto &cell = it->second;
+                for (size_t i = 0; i < cell.size(); i++) {
+                    if (cell[i] == id) {
+                        cell[i] = cell.back();
+                        cell.pop_back();
+                        break;
+                    }
+                }
+
+                if (cell.empty())
+                    spare.push_back(cells.extract(it));
+            }
+        }
+    }
+
+    void _next_stamp() {
+        // Reset the stamps on the rare occasion the counter wraps around
+        if (++stamp == 0) {
+            std::fill(stamps.begin(), stamps.end(), 0);
+            stamp = 1;
+        }
+    }
+};
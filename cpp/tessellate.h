@@ -0,0 +1,292 @@
+/// Author: PlumpDolphin
+/// Date: October 16, 2026
+///
+/// Description:
+///     Provides the Tessellator, which turns shapes into filled triangle meshes: a vertex buffer, stored either
+///     interleaved or as a structure of arrays, and a 16 or 32-bit index buffer.
+///     Convex shapes, which are all of the built-in shapes, are filled with a triangle fan, and polygons that
+///     aren't convex are filled by ear clipping. Either way a shape of n vertices gives exactly n - 2 triangles,
+///     so a whole collection's buffers are sized once from its vertex counts, and then written in one pass.
+///
+/// License:
+///     The code in this file is licensed under the
+///     Revised 3-Clause BSD License.
+///     For details, see https://opensource.org/licenses/BSD-3-Clause
+
+
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+#include "vectorarray.h" // Includes definition for VectorArray2<T> used by the structure of arrays output.
+#include "polygon.h"     // Includes definitions for Shape2D, Polygon and the wide products used by the turn tests.
+
+
+
+// Example usage showing a scene exported to a renderer.
+/*
+    std::vector<std::unique_ptr<Shape2D<float>>> scene;
+    scene.push_back(std::make_unique<Circle<float>>(5, 0, 0));
+    scene.push_back(std::make_unique<Polygon<float>>(Polygon<float>::fromVertices(outline)));
+
+    // Buffers and scratch space are kept between frames, so exporting a scene doesn't allocate once they are large enough
+    Tessellator<float, uint16_t> tessellator;
+    std::vector<Vector2<float>> vertices;
+    std::vector<uint16_t> indices;
+    if (!tessellator.tessellate(scene, vertices, indices))
+        std::cout << "Too many vertices for 16-bit indices" << std::endl;
+
+    // Vertices can also be written as separate x and y lanes
+    VectorArray2<float> lanes;
+    tessellator.tessellate(scene, lanes, indices);
+*/
+
+
+
+// Number of vertices and indices written for some shapes
+struct TessellationCounts {
+    size_t vertices = 0;
+    size_t indices = 0;
+
+    TessellationCounts& operator+=(const TessellationCounts& other) {
+        vertices += other.vertices;
+        indices += other.indices;
+        return *this;
+    }
+};
+
+// A shape's outline is used as-is for its vertices, with a triangle for every vertex past the second
+template <typename T>
+TessellationCounts tessellation_counts(Shape2D<T>& shape) {
+    size_t n = shape.vertexCount();
+    return { n, n >= 3 ? 3 * (n - 2) : 0 };
+}
+
+
+
+// Triangulation of a single outline
+// Indices are written relative to `base`, the index of the outline's first vertex in the vertex buffer.
+// Triangles keep the winding of the outline.
+
+// Fans out from the first vertex, which fills any convex outline
+template <typename Index>
+void tessellate_fan(size_t n, size_t base, std::span<Index> out) {
+    for (size_t i = 2, k = 0; i < n && k + 3 <= out.size(); i++, k += 3) {
+        out[k] = static_cast<Index>(base);
+        out[k + 1] = static_cast<Index>(base + i - 1);
+        out[k + 2] = static_cast<Index>(base + i);
+    }
+}
+
+// Same turn test as the polygon kernels, on interleaved vertices
+template <typename T>
+int _tessellate_turn(const Vector2<T>* v, size_t a, size_t b, size_t c) {
+    using Wide = polygon_wide_t<T>;
+    Wide left = (Wide(v[b].x) - v[a].x) * (Wide(v[c].y) - v[a].y);
+    Wide right = (Wide(v[b].y) - v[a].y) * (Wide(v[c].x) - v[a].x);
+    return (left > right) - (left < right);
+}
+
+// Fills a simple outline of any shape by clipping ears: triangles of three consecutive vertices that turn
+// the same way as the outline, and hold no other vertex. `next` and `prev` are scratch space, resized as needed.
+// Only reflex vertices within the ear's bounds can be inside it, so only those are tested.
+// This is O(n^2) in the worst case.
+// Outlines that aren't simple may run out of ears, and the rest is then filled with a fan,
+// so exactly n - 2 triangles are always written.
+template <typename T, typename Index>
+void tessellate_ear_clip(std::span<const Vector2<T>> vertices, size_t base, std::span<Index> out,
+                         std::vector<size_t>& next, std::vector<size_t>& prev) {
+    size_t n = vertices.size();
+    if (n < 3 || out.size() < 3 * (n - 2))
+        return;
+
+    // Orientation of the outline, from twice its signed area
+    using Wide = polygon_wide_t<T>;
+    const Vector2<T>* v = vertices.data();
+    Wide area2 = 0;
+    for (size_t i = 1; i + 1 < n; i++) {
+        Wide ax = Wide(v[i].x) - v[0].x, ay = Wide(v[i].y) - v[0].y;
+        Wide bx = Wide(v[i + 1].x) - v[0].x, by = Wide(v[i + 1].y) - v[0].y;
+        area2 += (ax * by) - (bx * ay);
+    }
+    const int orientation = (area2 > 0) - (area2 < 0);
+
+    size_t k = 0;
+    auto emit = [&](size_t a, size_t b, size_t c) {
+        out[k++] = static_cast<Index>(base + a);
+        out[k++] = static_cast<Index>(base + b);
+        out[k++] = static_cast<Index>(base + c);
+    };
+
+    // Outlines without area have no ears to find
+    if (orientation == 0) {
+        tessellate_fan(n, base, out);
+        return;
+    }
+
+    next.resize(n);
+    prev.resize(n);
+    for (size_t i = 0; i < n; i++) {
+        next[i] = i + 1 < n ? i + 1 : 0;
+        prev[i] = i > 0 ? i - 1 : n - 1;
+    }
+
+    auto is_ear = [&](size_t a, size_t b, size_t c) {
+        if (_tessellate_turn(v, a, b, c) != orientation)
+            return false;
+
+        // Vertices outside the ear's bounds are rejected with comparisons alone
+        T min_x = std::min({ v[a].x, v[b].x, v[c].x }), max_x = std::max({ v[a].x, v[b].x, v[c].x });
+        T min_y = std::min({ v[a].y, v[b].y, v[c].y }), max_y = std::max({ v[a].y, v[b].y, v[c].y });
+        for (size_t p = next[c]; p != a; p = next[p]) {
+            if (v[p].x < min_x || v[p].x > max_x || v[p].y < min_y || v[p].y > max_y)
+                continue;
+            if (_tessellate_turn(v, prev[p], p, next[p]) == orientation)
+                continue;
+            if (_tessellate_turn(v, a, b, p) != -orientation && _tessellate_turn(v, b, c, p) != -orientation &&
+                _tessellate_turn(v, c, a, p) != -orientation)
+                return false;
+        }
+        return true;
+    };
+
+    size_t remaining = n, current = 0, stalled = 0;
+    while (remaining > 3) {
+        size_t a = prev[current], c = next[current];
+        if (is_ear(a, current, c)) {
+            emit(a, current, c);
+            next[a] = c;
+            prev[c] = a;
+            remaining--;
+            current = c;
+            stalled = 0;
+        } else if (++stalled >= remaining) {
+            // No ears left, so the outline crosses itself. Fan out over what is left.
+            for (size_t b = next[current]; next[b] != current; b = next[b])
+                emit(current, b, next[b]);
+            return;
+        } else {
+            current = c;
+        }
+    }
+    emit(prev[current], current, next[current]);
+}
+
+
+
+// Writes shapes into reusable vertex and index buffers.
+// The scratch space used by ear clipping is kept between calls, along with the buffers passed in,
+// so once they have grown to fit a scene, tessellating it again doesn't allocate.
+template <typename T, typename Index = uint32_t>
+class Tessellator {
+public:
+    static_assert(std::is_unsigned_v<Index>, "Tessellator indices must be an unsigned integer type");
+
+
+
+    // Writes a single shape's vertices and triangles.
+    // Both buffers must hold tessellation_counts(shape), and indices are offset by `base`.
+    TessellationCounts tessellate(Shape2D<T>& shape, std::span<Vector2<T>> vertices, std::span<Index> indices,
+                                  size_t base = 0) {
+        TessellationCounts counts = tessellation_counts(shape);
+        if (vertices.size() < counts.vertices || indices.size() < counts.indices)
+            return {};
+
+        std::span<Vector2<T>> outline = vertices.first(counts.vertices);
+        shape.vertices(outline);
+        _triangulate(shape, outline, indices.first(counts.indices), base);
+        return counts;
+    }
+
+
+
+    // Writes a whole collection of shapes, or of pointers to shapes, into one mesh.
+    // Returns false, leaving the buffers untouched, if the mesh has more vertices than an Index can address.
+    template <std::ranges::range Shapes>
+    bool tessellate(Shapes&& shapes, std::vector<Vector2<T>>& vertices, std::vector<Index>& indices) {
+        INSTRUMENT_SCOPE("Tessellator::tessellate");
+        TessellationCounts total;
+        if (!_count(shapes, total))
+            return false;
+
+        INSTRUMENT_BUFFER(vertices, total.vertices);
+        INSTRUMENT_BUFFER(indices, total.indices);
+        vertices.resize(total.vertices);
+        indices.resize(total.indices);
+
+        TessellationCounts at;
+        for (auto &element: shapes)
+            at += tessellate(_shape(element), std::span<Vector2<T>>(vertices).subspan(at.vertices),
+                             std::span<Index>(indices).subspan(at.indices), at.vertices);
+        return true;
+    }
+
+    // Same as above, with the vertices written as separate x and y lanes.
+    // Each shape is rendered to a scratch outline first, then scattered to the lanes.
+    template <std::ranges::range Shapes>
+    bool tessellate(Shapes&& shapes, VectorArray2<T>& vertices, std::vector<Index>& indices) {
+        INSTRUMENT_SCOPE("Tessellator::tessellate");
+        TessellationCounts total;
+        if (!_count(shapes, total))
+            return false;
+
+        INSTRUMENT_BUFFER(indices, total.indices);
+        vertices.resize(total.vertices);
+        indices.resize(total.indices);
+
+        TessellationCounts at;
+        for (auto &element: shapes) {
+            Shape2D<T>& shape = _shape(element);
+            size_t n = shape.vertexCount();
+            if (outline.size() < n)
+                outline.resize(n);
+
+            TessellationCounts counts = tessellate(shape, std::span<Vector2<T>>(outline).first(n),
+                                                   std::span<Index>(indices).subspan(at.indices), at.vertices);
+            for (size_t i = 0; i < counts.vertices; i++) {
+                vertices.x[at.vertices + i] = outline[i].x;
+                vertices.y[at.vertices + i] = outline[i].y;
+            }
+            at += counts;
+        }
+        return true;
+    }
+
+
+
+private:
+    std::vector<size_t> next, prev;
+    std::vector<Vector2<T>> outline;
+
+    void _triangulate(Shape2D<T>& shape, std::span<const Vector2<T>> outline, std::span<Index> indices, size_t base) {
+        if (shape.isConvex())
+            tessellate_fan(outline.size(), base, indices);
+        else
+            tessellate_ear_clip(outline, base, indices, next, prev);
+    }
+
+    // Elements of a collection may be shapes, or pointers to them
+    template <typename Element>
+    static Shape2D<T>& _shape(Element& element) {
+        if constexpr (std::derived_from<std::remove_cvref_t<Element>, Shape2D<T>>)
+            return element;
+        else
+            return *element;
+    }
+
+    // Sums the counts of every shape, and checks that the last vertex can be indexed
+    template <typename Shapes>
+    static bool _count(Shapes& shapes, TessellationCounts& total) {
+        for (auto &element: shapes)
+            total += tessellation_counts(_shape(element));
+        return total.vertices == 0 || total.vertices - 1 <= std::numeric_limits<Index>::max();
+    }
+};
@@ -0,0 +1,118 @@
+/// Author: PlumpDolphin
+/// Date: October 16, 2026
+///
+/// Description:
+///     Provides a small, dependency-free test runner used by the test programs in this folder.
+///     Every test is a function making checks. Failed checks are printed with their expression and location,
+///     and the program exits with a non-zero code if any test failed, so it can be run by scripts and CI.
+///
+/// License:
+///     The code in this file is licensed under the
+///     Revised 3-Clause BSD License.
+///     For details, see https://opensource.org/licenses/BSD-3-Clause
+
+
+#pragma once
+
+#include <cstdio>
+#include <string>
+#include <string_view>
+
+
+
+// Example usage showing a test program.
+/*
+    #include "test.h"
+
+    int main(int argc, char** argv) {
+        TestRunner runner(argc, argv);
+
+        runner.run("Vector2 addition", [] {
+            TEST_CHECK(Vector2<int>(1, 2) + Vector2<int>(3, 4) == Vector2<int>(4, 6));
+        });
+
+        return runner.finish();
+    }
+
+    // Command line options:
+    //     --filter=<text> Only runs tests whose name contains the text
+*/
+
+
+
+// Number of failed checks so far, over every test
+inline size_t test_failures = 0;
+
+// Only the first few failures of a test are printed, since a broken loop can fail thousands of checks
+constexpr size_t test_printed_failures = 10;
+inline size_t test_failures_in_test = 0;
+
+// Records a check, printing it if it failed. Returns whether it passed, so callers can skip dependent checks.
+inline bool test_check(bool passed, const char* expression, const char* file, int line) {
+    if (!passed) {
+        test_failures++;
+        if (test_failures_in_test++ < test_printed_failures)
+            std::printf("    %s:%d: check failed: %s\n", file, line, expression);
+    }
+    return passed;
+}
+
+#define TEST_CHECK(condition) test_check(static_cast<bool>(condition), #condition, __FILE__, __LINE__)
+
+
+
+class TestRunner {
+public:
+    // Settings
+    std::string filter;
+
+
+
+    TestRunner() {}
+
+    // Reads the settings from the command line
+    TestRunner(int argc, char** argv) {
+        for (int i = 1; i < argc; i++) {
+            std::string_view arg = argv[i];
+            if (arg.starts_with("--filter="))
+                filter = arg.substr(9);
+            else
+                std::fprintf(stderr, "Unknown option: %s\n", argv[i]);
+        }
+    }
+
+
+
+    // Runs `f()`, which makes its checks with TEST_CHECK
+    template <typename F>
+    void run(std::string_view name, F&& f) {
+        if (!filter.empty() && name.find(filter) == std::string_view::npos)
+            return;
+
+        std::printf("%.*s\n", static_cast<int>(name.size()), name.data());
+        std::fflush(stdout);
+
+        test_failures_in_test = 0;
+        f();
+
+        if (test_failures_in_test > 0) {
+            std::printf("    FAILED with %zu failed checks\n", test_failures_in_test);
+            failed++;
+        } else {
+            passed++;
+        }
+        std::fflush(stdout);
+    }
+
+    // Prints a summary, and returns the exit code for main()
+    int finish() const {
+        std::printf("%zu passed, %zu failed\n", passed, failed);
+        return failed > 0 ? 1 : 0;
+    }
+
+
+
+private:
+    size_t passed = 0;
+    size_t failed = 0;
+};
@@ -0,0 +1,153 @@
+/// Author: PlumpDolphin
+/// Date: October 16, 2026
+///
+/// Description:
+///     Tests for the instrumentation of instrument.h, built with the counters and scoped timers enabled.
+///     Instrumentation is chosen before the headers are included, so these tests are their own program, while
+///     test_shapes.cpp checks that a build without it compiles every hook to nothing.
+///
+///     Build and run from this folder, for example:
+///         g++ -std=c++20 -O2 -march=native -pthread -I.. test_instrument.cpp -o test_instrument
+///         ./test_instrument
+///
+/// License:
+///     The code in this file is licensed under the
+///     Revised 3-Clause BSD License.
+///     For details, see https://opensource.org/licenses/BSD-3-Clause
+
+
+#define SHAPES_INSTRUMENTATION_TIMERS
+
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "test.h"      // Includes the TestRunner and TEST_CHECK.
+#include "executor.h"  // Includes the Executor, whose threads count into their own counters.
+#include "shapes.h"    // Includes the shapes, whose hot paths are instrumented.
+#include "transform.h" // Includes Transform2D, which counts the trig of its rotations.
+
+
+
+// Calls received by the timer hooks
+std::atomic<size_t> test_scope_begins = 0, test_scope_ends = 0;
+std::atomic<uint64_t> test_scope_nanoseconds = 0;
+std::atomic<size_t> test_scope_other = 0; // Scopes with a name other than Circle::vertices
+
+void test_begin_hook(const char* name) {
+    if (std::strcmp(name, "Circle::vertices") == 0)
+        test_scope_begins++;
+    else
+        test_scope_other++;
+}
+
+void test_end_hook(const char* name, uint64_t nanoseconds) {
+    if (std::strcmp(name, "Circle::vertices") == 0) {
+        test_scope_ends++;
+        test_scope_nanoseconds += nanoseconds;
+    }
+}
+
+
+
+// Counters count every instrumented call, on every thread, and scoped timers report to the hooks
+void test_instrumentation(TestRunner& runner) {
+    runner.run("Counters count trig, vertex buffers, serializations and transforms", [] {
+        Circle<float> circle(5, 1, 2);
+        circle.vertices(48); // Caches the direction table, which is the only trig of the first call
+
+        instrument_reset();
+        std::vector<Vector2<float>> vertices = circle.vertices(48);
+        InstrumentCounters counters = instrument_snapshot();
+        TEST_CHECK(counters.vertexBuffers() == 1 && counters.vertexBytes() == 48 * sizeof(Vector2<float>));
+        TEST_CHECK(counters.trigEvaluations() == 2);
+
+        // Filling a list that already has room allocates nothing
+        circle.vertices(vertices, 48);
+        TEST_CHECK((instrument_snapshot() - counters).vertexBuffers() == 0);
+
+        instrument_reset();
+        std::string json = circle.json();
+        std::string text = circle.str();
+        counters = instrument_snapshot();
+        TEST_CHECK(counters.serializations() == 2 && counters.serializedBytes() == json.size() + text.size());
+
+        // rotateFrom is counted once, through the rotate() it calls
+        instrument_reset();
+        circle.move(1, 1);
+        circle.rotateFrom(30, Vector2<float>(0, 0));
+        circle.scaleFrom(2, Vector2<float>(0, 0));
+        TEST_CHECK(circle.transform(Transform2D<float>::scaling(2)));
+        counters = instrument_snapshot();
+        TEST_CHECK(counters.transformCalls() == 4);
+        TEST_CHECK(counters.trigEvaluations() == 2); // The rotation matrix of rotateFrom
+
+        instrument_reset();
+        rotate_point(Vector2<float>(1, 0), Vector2<float>(0, 0), 45.0f);
+        TEST_CHECK(instrument_snapshot().trigEvaluations() == 2 && instrument_snapshot().vertexBuffers() == 0);
+    });
+
+    runner.run("Counters are summed over every thread", [] {
+        Executor executor(4);
+        instrument_reset();
+        InstrumentCounters own = instrument_thread_snapshot();
+
+        parallel_for(executor, 0, 1000, [](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++)
+                rotate_point(Vector2<float>(1, 0), Vector2<float>(0, 0), static_cast<float>(i + 1));
+        }, 10);
+
+        // Threads that have exited keep their counts
+        std::thread worker([] {
+            for (int i = 0; i < 50; i++)
+                INSTRUMENT_COUNT(TransformCalls, 1);
+        });
+        worker.join();
+
+        InstrumentCounters counters = instrument_snapshot();
+        TEST_CHECK(counters.trigEvaluations() == 2000 && counters.transformCalls() == 50);
+
+        // The calling thread's own counters only hold what it ran itself
+        InstrumentCounters ran = instrument_thread_snapshot() - own;
+        TEST_CHECK(ran.trigEvaluations() <= 2000 && ran.transformCalls() == 0);
+
+        instrument_reset();
+        TEST_CHECK(instrument_snapshot().trigEvaluations() == 0);
+        TEST_CHECK(instrument_snapshot().str().starts_with("InstrumentCounters { trig: 0,"));
+    });
+
+    runner.run("Scoped timers report every call to the hooks", [] {
+        Circle<float> circle(5);
+        std::vector<Vector2<float>> vertices;
+        instrument_set_hooks(test_begin_hook, test_end_hook);
+        for (int i = 0; i < 100; i++)
+            circle.vertices(vertices, 4096);
+        instrument_set_hooks(nullptr, nullptr);
+
+        TEST_CHECK(test_scope_begins == 100 && test_scope_ends == 100);
+        TEST_CHECK(test_scope_nanoseconds > 0);
+
+        // Without hooks nothing is reported
+        circle.vertices(vertices, 4096);
+        rotate_point(Vector2<float>(1, 0), Vector2<float>(0, 0), 45.0f);
+        TEST_CHECK(test_scope_begins == 100 && test_scope_ends == 100 && test_scope_other == 0);
+
+        // Only a begin hook is fine too
+        instrument_set_hooks(test_begin_hook, nullptr);
+        rotate_point(Vector2<float>(1, 0), Vector2<float>(0, 0), 45.0f);
+        instrument_set_hooks(nullptr, nullptr);
+        TEST_CHECK(test_scope_other == 1 && test_scope_ends == 100);
+    });
+}
+
+
+
+int main(int argc, char** argv) {
+    TestRunner runner(argc, argv);
+
+    test_instrumentation(runner);
+
+    return runner.finish();
+}
@@ -0,0 +1,2155 @@
+/// Author: PlumpDolphin
+/// Date: October 16, 2026
+///
+/// Description:
+///     Tests for the shape headers, checking the guarantees their documentation makes: formats that round-trip,
+///     results that match a simple reference implementation, and parallel functions that give the same result
+///     as their serial versions for any number of threads.
+///
+///     Build and run from this folder, for example:
+///         g++ -std=c++20 -O2 -march=native -pthread -I.. test_shapes.cpp -o test_shapes
+///         ./test_shapes
+///
+/// License:
+///     The code in this file is licensed under the
+///     Revised 3-Clause BSD License.
+///     For details, see https://opensource.org/licenses/BSD-3-Clause
+
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fcntl.h>
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "test.h"       // Includes the TestRunner and TEST_CHECK.
+#include "collision.h"  // Includes the exact collision tests and the collision pipeline.
+#include "instrument.h" // Includes the instrumentation, which this program is built without.
+#include "polygon.h"    // Includes the Polygon class and its geometry kernels.
+#include "raster.h"     // Includes the Rasterizer.
+#include "raycast.h"    // Includes the RayCaster.
+#include "shapebatch.h" // Includes the shape batches.
+#include "shapefile.h"  // Includes the shape file writer and reader.
+#include "shapejson.h"  // Includes the JSON writer and loader.
+#include "shapes.h"     // Includes the shapes being tested.
+#include "spatial.h"    // Includes the BVH and UniformGrid indices.
+#include "tessellate.h" // Includes the Tessellator.
+
+
+
+// Path of a scratch file in the temporary directory
+std::string test_path(const std::string& name) {
+    return (std::filesystem::temp_directory_path() / name).string();
+}
+
+
+
+// Writes a JSON array of the shapes of three batches to a file, returning false if it couldn't be written.
+// The shapes are serialized in parallel when an executor is given.
+template <typename T>
+bool test_write_json(const std::string& path, const CircleBatch<T>& circles, const RectangleBatch<T>& rectangles,
+                     const NGonBatch<T>& ngons, Executor* executor = nullptr) {
+    int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+        return false;
+
+    // A small chunk size makes the writer flush many times
+    JsonArrayWriter writer(fd, 4096);
+    if (executor != nullptr) {
+        writer.writeAll(circles, *executor);
+        writer.writeAll(rectangles, *executor);
+        writer.writeAll(ngons, *executor);
+    } else {
+        writer.writeAll(circles);
+        writer.writeAll(rectangles);
+        writer.writeAll(ngons);
+    }
+    bool written = writer.close();
+    ::close(fd);
+    return written;
+}
+
+// Reads a whole file into a string
+std::string test_read(const std::string& path) {
+    std::string contents;
+    FILE* file = fopen(path.c_str(), "rb");
+    if (file == nullptr)
+        return contents;
+
+    char chunk[4096];
+    size_t read;
+    while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0)
+        contents.append(chunk, read);
+    fclose(file);
+    return contents;
+}
+
+
+
+// Shape files read back every column exactly, and files that aren't valid are rejected
+void test_shape_file(TestRunner& runner) {
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> value(-1000, 1000);
+
+    CircleBatch<float> circles;
+    RectangleBatch<double> rectangles;
+    NGonBatch<int32_t> ngons;
+    for (size_t i = 0; i < 1000; i++) {
+        circles.push_back(Circle<float>(float(value(rng)), float(value(rng)), float(value(rng)), value(rng)));
+        rectangles.push_back(Rectangle<double>(value(rng), value(rng), value(rng), value(rng), value(rng)));
+        ngons.push_back(NGon<int32_t>(3 + (i % 10), int32_t(value(rng)), int32_t(value(rng)), int32_t(value(rng)), value(rng)));
+    }
+    std::string path = test_path("test_shapes.shapes");
+
+    runner.run("ShapeFile round trip", [&] {
+        ShapeFileWriter writer;
+        writer.add(circles);
+        writer.add(rectangles);
+        writer.add(ngons);
+        writer.add(CircleBatch<float>()); // Empty sections are kept
+        if (!TEST_CHECK(writer.save(path)))
+            return;
+
+        ShapeFile file;
+        if (!TEST_CHECK(file.open(path)))
+            return;
+        TEST_CHECK(file.sectionCount() == 4);
+
+        auto circle_views = file.circles<float>();
+        auto rectangle_views = file.rectangles<double>();
+        auto ngon_views = file.ngons<int32_t>();
+        if (!TEST_CHECK(circle_views.size() == 2 && rectangle_views.size() == 1 && ngon_views.size() == 1))
+            return;
+
+        // Sections of another value type aren't handed out
+        TEST_CHECK(file.circles<double>().empty());
+        TEST_CHECK(file.rectangles<float>().empty());
+
+        TEST_CHECK(circle_views[0].count == circles.count() && circle_views[1].count == 0);
+        for (size_t i = 0; i < circles.count(); i++) {
+            Circle<float> expected = circles.get(i), loaded = circle_views[0].get(i);
+            TEST_CHECK(loaded.radius == expected.radius && loaded.position == expected.position &&
+                       loaded.rotation == expected.rotation);
+        }
+
+        TEST_CHECK(rectangle_views[0].count == rectangles.count());
+        for (size_t i = 0; i < rectangles.count(); i++) {
+            Rectangle<double> expected = rectangles.get(i), loaded = rectangle_views[0].get(i);
+            TEST_CHECK(loaded.size == expected.size && loaded.position == expected.position &&
+                       loaded.rotation == expected.rotation);
+        }
+
+        // Copying a view into a batch gives back the batch that was written
+        NGonBatch<int32_t> copy = ngon_views[0].toBatch();
+        TEST_CHECK(copy.count() == ngons.count());
+        for (size_t i = 0; i < ngons.count() && i < copy.count(); i++)
+            TEST_CHECK(copy.N[i] == ngons.N[i] && copy.radius[i] == ngons.radius[i] &&
+                       copy.position.x[i] == ngons.position.x[i] && copy.position.y[i] == ngons.position.y[i] &&
+                       copy.rotation[i] == ngons.rotation[i]);
+    });
+
+    runner.run("ShapeFile write, read and write again gives the same bytes", [&] {
+        ShapeFileWriter writer;
+        writer.add(circles);
+        writer.add(rectangles);
+        writer.add(ngons);
+        writer.add(CircleBatch<float>());
+        if (!TEST_CHECK(writer.save(path)))
+            return;
+
+        ShapeFile file;
+        if (!TEST_CHECK(file.open(path)))
+            return;
+        auto circle_views = file.circles<float>();
+        auto rectangle_views = file.rectangles<double>();
+        auto ngon_views = file.ngons<int32_t>();
+        if (!TEST_CHECK(circle_views.size() == 2 && rectangle_views.size() == 1 && ngon_views.size() == 1))
+            return;
+
+        CircleBatch<float> loaded_circles = circle_views[0].toBatch(), loaded_empty = circle_views[1].toBatch();
+        RectangleBatch<double> loaded_rectangles = rectangle_views[0].toBatch();
+        NGonBatch<int32_t> loaded_ngons = ngon_views[0].toBatch();
+        file.close();
+
+        ShapeFileWriter again;
+        again.add(loaded_circles);
+        again.add(loaded_rectangles);
+        again.add(loaded_ngons);
+        again.add(loaded_empty);
+        std::string again_path = test_path("test_shapes_again.shapes");
+        TEST_CHECK(again.save(again_path));
+        std::string bytes = test_read(path);
+        TEST_CHECK(!bytes.empty() && test_read(again_path) == bytes);
+        std::remove(again_path.c_str());
+    });
+
+    runner.run("ShapeFile rejects invalid files", [&] {
+        std::vector<unsigned char> bytes;
+        {
+            FILE* file = fopen(path.c_str(), "rb");
+            if (!TEST_CHECK(file != nullptr))
+                return;
+            int c;
+            while ((c = fgetc(file)) != EOF)
+                bytes.push_back(static_cast<unsigned char>(c));
+            fclose(file);
+        }
+
+        auto opens = [&](const std::vector<unsigned char>& contents) {
+            std::string broken = test_path("test_shapes_broken.shapes");
+            FILE* file = fopen(broken.c_str(), "wb");
+            if (!TEST_CHECK(file != nullptr))
+                return false;
+            if (!contents.empty())
+                TEST_CHECK(fwrite(contents.data(), 1, contents.size(), file) == contents.size());
+            fclose(file);
+
+            ShapeFile reader;
+            bool opened = reader.open(broken);
+            reader.close();
+            std::remove(broken.c_str());
+            return opened;
+        };
+
+        TEST_CHECK(opens(bytes));
+
+        std::vector<unsigned char> truncated(bytes.begin(), bytes.end() - 64);
+        TEST_CHECK(!opens(truncated));
+
+        std::vector<unsigned char> magic = bytes;
+        magic[0] = 'X';
+        TEST_CHECK(!opens(magic));
+
+        std::vector<unsigned char> version = bytes;
+        version[8] = 2;
+        TEST_CHECK(!opens(version));
+
+        // A section whose columns reach past the end of the file
+        std::vector<unsigned char> section = bytes;
+        section[sizeof(ShapeFileHeader) + 8] = 0xFF;
+        section[sizeof(ShapeFileHeader) + 9] = 0xFF;
+        TEST_CHECK(!opens(section));
+
+        TEST_CHECK(!opens({}));
+
+        ShapeFile missing;
+        TEST_CHECK(!missing.open(test_path("test_shapes_missing.shapes")));
+    });
+
+    std::remove(path.c_str());
+}
+
+
+
+
+
+// JSON written by the serializers parses back into the same shapes, and malformed documents are rejected
+void test_json(TestRunner& runner) {
+    runner.run("fromJson of single values", [] {
+        Vector2<float> v2;
+        TEST_CHECK(Vector2<float>::fromJson(" [1.5, -2] ", v2) && v2 == Vector2<float>(1.5f, -2));
+
+        Vector4<int> v4;
+        TEST_CHECK(Vector4<int>::fromJson("[1,2,3,4]", v4) && v4 == Vector4<int>(1, 2, 3, 4));
+
+        // Invalid documents leave the output unchanged
+        TEST_CHECK(!Vector4<int>::fromJson("[1,2,3]", v4) && v4 == Vector4<int>(1, 2, 3, 4));
+        TEST_CHECK(!Vector2<float>::fromJson("[1,2] x", v2));
+        TEST_CHECK(!Vector2<float>::fromJson("[1,a]", v2));
+        TEST_CHECK(!Vector2<float>::fromJson("", v2));
+
+        // Members may come in any order, and unknown members are skipped
+        Circle<float> circle;
+        TEST_CHECK(Circle<float>::fromJson(R"({"rotation":30, "extra":{"a":[1,"]"]}, "position":[1,2], "radius":5})", circle));
+        TEST_CHECK(circle.radius == 5 && circle.position == Vector2<float>(1, 2) && circle.rotation == 30);
+
+        Rectangle<double> rectangle;
+        TEST_CHECK(Rectangle<double>::fromJson(R"({"size":[1,2],"position":[3,4],"rotation":5})", rectangle));
+        TEST_CHECK(rectangle.size == Vector2<double>(1, 2) && rectangle.position == Vector2<double>(3, 4));
+
+        NGon<int> ngon;
+        TEST_CHECK(NGon<int>::fromJson(R"({"N":6,"radius":5,"position":[1,2],"rotation":30})", ngon));
+        TEST_CHECK(ngon.N == 6 && ngon.radius == 5 && ngon.position == Vector2<int>(1, 2));
+        TEST_CHECK(!NGon<int>::fromJson(R"({"N":6,"radius":5,)", ngon));
+
+        // The serializers' own output parses back
+        std::string json;
+        Rectangle<float>(1.25f, 2, -3, 4.5f, 45).json(json);
+        Rectangle<float> parsed;
+        TEST_CHECK(Rectangle<float>::fromJson(json, parsed) && parsed.size == Vector2<float>(1.25f, 2) &&
+                   parsed.position == Vector2<float>(-3, 4.5f) && parsed.rotation == 45);
+    });
+
+    runner.run("loadShapesJson round trip", [] {
+        // Eighths are printed exactly with 6 significant digits, so the shapes must parse back unchanged
+        std::mt19937 rng(2);
+        std::uniform_int_distribution<int> value(-8000, 8000);
+        auto eighths = [&]() { return static_cast<float>(value(rng)) / 8; };
+
+        CircleBatch<float> circles;
+        RectangleBatch<float> rectangles;
+        NGonBatch<float> ngons;
+        for (size_t i = 0; i < 20000; i++) {
+            circles.push_back(Circle<float>(eighths(), eighths(), eighths(), eighths()));
+            rectangles.push_back(Rectangle<float>(eighths(), eighths(), eighths(), eighths(), eighths()));
+            ngons.push_back(NGon<float>(3 + (i % 20), eighths(), eighths(), eighths(), eighths()));
+        }
+
+        std::string path = test_path("test_shapes.json");
+        if (!TEST_CHECK(test_write_json(path, circles, rectangles, ngons)))
+            return;
+        std::string json = test_read(path);
+        TEST_CHECK(json.size() >= JSON_PRESCAN_THRESHOLD);
+
+        // With and without the structural pre-scan
+        for (bool prescan: { true, false }) {
+            CircleBatch<float> loaded_circles;
+            RectangleBatch<float> loaded_rectangles;
+            NGonBatch<float> loaded_ngons;
+            JsonLoadResult result = loadShapesJsonFile(path, loaded_circles, loaded_rectangles, loaded_ngons, prescan);
+            if (!TEST_CHECK(result && result.shapes == 60000))
+                continue;
+
+            TEST_CHECK(loaded_circles.count() == circles.count());
+            TEST_CHECK(loaded_rectangles.count() == rectangles.count());
+            TEST_CHECK(loaded_ngons.count() == ngons.count());
+            for (size_t i = 0; i < circles.count() && i < loaded_circles.count(); i++)
+                TEST_CHECK(loaded_circles.radius[i] == circles.radius[i] &&
+                           loaded_circles.position.x[i] == circles.position.x[i] &&
+                           loaded_circles.position.y[i] == circles.position.y[i] &&
+                           loaded_circles.rotation[i] == circles.rotation[i]);
+            for (size_t i = 0; i < ngons.count() && i < loaded_ngons.count(); i++)
+                TEST_CHECK(loaded_ngons.N[i] == ngons.N[i] && loaded_ngons.radius[i] == ngons.radius[i]);
+
+            // Writing the loaded shapes again gives the same bytes
+            std::string again = test_path("test_shapes_again.json");
+            TEST_CHECK(test_write_json(again, loaded_circles, loaded_rectangles, loaded_ngons));
+            TEST_CHECK(test_read(again) == json);
+            std::remove(again.c_str());
+        }
+        std::remove(path.c_str());
+    });
+
+    runner.run("Numbers are formatted the same as a default stream", [] {
+        auto same = [](auto value) {
+            std::string out;
+            append_formatted(out, value);
+            std::ostringstream stream;
+            stream << value;
+            return out == stream.str();
+        };
+
+        std::mt19937 rng(6);
+        std::uniform_real_distribution<double> mantissa(-10, 10);
+        std::uniform_int_distribution<int> exponent(-40, 40);
+        bool formatted = true;
+        for (int i = 0; i < 20000; i++) {
+            double value = std::ldexp(mantissa(rng), exponent(rng));
+            formatted = formatted && same(value) && same(static_cast<float>(value)) &&
+                        same(static_cast<int32_t>(value * 1000)) && same(static_cast<int64_t>(value * 1e9));
+        }
+        TEST_CHECK(formatted);
+        TEST_CHECK(same(0.0) && same(-0.0f) && same(1e300) && same(std::numeric_limits<double>::infinity()) &&
+                   same(-std::numeric_limits<float>::infinity()) && same(std::numeric_limits<double>::denorm_min()) &&
+                   same(std::numeric_limits<double>::quiet_NaN()) && same(-std::numeric_limits<float>::quiet_NaN()));
+        TEST_CHECK(same(INT64_MIN) && same(UINT64_MAX) && same('x') && same(true));
+    });
+
+    runner.run("JSON write, read and write again gives the same bytes", [] {
+        // Full-precision values, which the first write rounds to 6 significant digits
+        auto round_trip = [](auto zero) {
+            using T = decltype(zero);
+            std::mt19937 rng(7);
+            std::uniform_real_distribution<double> value(-5000, 5000);
+            auto next = [&] { return static_cast<T>(value(rng)); };
+
+            CircleBatch<T> circles;
+            RectangleBatch<T> rectangles;
+            NGonBatch<T> ngons;
+            for (size_t i = 0; i < 5000; i++) {
+                circles.push_back(Circle<T>(next(), next(), next(), value(rng)));
+                rectangles.push_back(Rectangle<T>(next(), next(), next(), next(), value(rng)));
+                ngons.push_back(NGon<T>(3 + (i % 20), next(), next(), next(), value(rng)));
+            }
+
+            std::string path = test_path("test_shapes_bytes.json"), again = test_path("test_shapes_bytes_again.json");
+            CircleBatch<T> loaded_circles;
+            RectangleBatch<T> loaded_rectangles;
+            NGonBatch<T> loaded_ngons;
+            bool same = test_write_json(path, circles, rectangles, ngons) &&
+                        loadShapesJsonFile(path, loaded_circles, loaded_rectangles, loaded_ngons).shapes == 15000 &&
+                        test_write_json(again, loaded_circles, loaded_rectangles, loaded_ngons);
+            same = same && test_read(again) == test_read(path);
+            std::remove(path.c_str());
+            std::remove(again.c_str());
+            return same;
+        };
+
+        TEST_CHECK(round_trip(0.0f));
+        TEST_CHECK(round_trip(0.0));
+        TEST_CHECK(round_trip(int32_t(0)));
+    });
+
+    runner.run("loadShapesJson errors", [] {
+        CircleBatch<float> circles;
+        RectangleBatch<float> rectangles;
+        NGonBatch<float> ngons;
+
+        JsonLoadResult empty = loadShapesJson<float>(" [ ] ", circles, rectangles, ngons);
+        TEST_CHECK(empty && empty.shapes == 0);
+
+        // The error offset points at the first invalid character, and shapes before it are kept
+        std::string_view json = R"([{"radius":1,"position":[0,0],"rotation":0}, {"radius":x}])";
+        JsonLoadResult result = loadShapesJson(json, circles, rectangles, ngons);
+        TEST_CHECK(!result && result.shapes == 1 && circles.count() == 1);
+        TEST_CHECK(result.error_offset == json.find('x'));
+
+        TEST_CHECK(!loadShapesJson<float>(R"([{"radius":1}] trailing)", circles, rectangles, ngons));
+        TEST_CHECK(!loadShapesJson<float>(R"([{"radius":1},])", circles, rectangles, ngons));
+        TEST_CHECK(!loadShapesJson<float>(R"([{"radius":1})", circles, rectangles, ngons));
+        TEST_CHECK(!loadShapesJson<float>("", circles, rectangles, ngons));
+        TEST_CHECK(!loadShapesJsonFile<float>(test_path("test_shapes_missing.json"), circles, rectangles, ngons));
+    });
+}
+
+
+
+
+
+// Both spatial indices find exactly the shapes a linear scan of the bounds finds, before and after shapes move
+void test_spatial(TestRunner& runner) {
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> coordinate(-200, 200), size(0.5f, 12), angle(0, 360), step(-30, 30);
+
+    std::vector<std::unique_ptr<Shape2D<float>>> owned;
+    for (size_t i = 0; i < 3000; i++) {
+        Vector2<float> position(coordinate(rng), coordinate(rng));
+        if (i % 3 == 0)
+            owned.push_back(std::make_unique<Circle<float>>(size(rng), position));
+        else if (i % 3 == 1)
+            owned.push_back(std::make_unique<Rectangle<float>>(size(rng), size(rng), position, angle(rng)));
+        else
+            owned.push_back(std::make_unique<NGon<float>>(5, size(rng), position, angle(rng)));
+    }
+
+    // Shapes stacked on the same spot, which the surface area heuristic can't separate
+    for (size_t i = 0; i < 100; i++)
+        owned.push_back(std::make_unique<Circle<float>>(2.0f, 50.0f, 50.0f));
+
+    std::vector<Shape2D<float>*> scene;
+    for (auto &shape: owned)
+        scene.push_back(shape.get());
+
+    auto check_queries = [&](BVH<float>& bvh, UniformGrid<float>& grid) {
+        std::vector<uint32_t> hits, expected;
+        auto same = [&](std::vector<uint32_t>& found) {
+            std::sort(found.begin(), found.end());
+            return found == expected;
+        };
+
+        for (size_t q = 0; q < 500; q++) {
+            Vector2<float> corner(coordinate(rng), coordinate(rng));
+            Bounds2D<float> region(corner, corner + Vector2<float>(size(rng) * 4, size(rng) * 4));
+            Vector2<float> point(coordinate(rng), coordinate(rng));
+            if (q % 50 == 0)
+                point = Vector2<float>(50, 50);
+
+            expected.clear();
+            for (uint32_t i = 0; i < scene.size(); i++)
+                if (scene[i]->bounds().overlaps(region))
+                    expected.push_back(i);
+            bvh.query(region, hits);
+            TEST_CHECK(same(hits));
+            grid.query(region, hits);
+            TEST_CHECK(same(hits));
+
+            expected.clear();
+            for (uint32_t i = 0; i < scene.size(); i++)
+                if (scene[i]->bounds().contains(point))
+                    expected.push_back(i);
+            bvh.query(point, hits);
+            TEST_CHECK(same(hits));
+            grid.query(point, hits);
+            TEST_CHECK(same(hits));
+        }
+    };
+
+    // Number of cells the bounds of the shapes overlap, which is all an up to date grid should keep
+    auto occupied_cells = [&](float cell_size) {
+        std::set<std::pair<int64_t, int64_t>> cells;
+        for (auto *shape: scene) {
+            Bounds2D<float> box = shape->bounds();
+            for (int64_t x = int64_t(std::floor(box.min.x / cell_size)); x <= int64_t(std::floor(box.max.x / cell_size)); x++)
+                for (int64_t y = int64_t(std::floor(box.min.y / cell_size)); y <= int64_t(std::floor(box.max.y / cell_size)); y++)
+                    cells.insert({ x, y });
+        }
+        return cells.size();
+    };
+
+    runner.run("BVH and UniformGrid queries match a linear scan", [&] {
+        BVH<float> bvh;
+        UniformGrid<float> grid(10);
+        bvh.build(scene);
+        grid.build(scene);
+        check_queries(bvh, grid);
+        TEST_CHECK(grid.cellCount() == occupied_cells(10));
+
+        // Leaves never hold more items than allowed, even for the stacked shapes
+        for (const auto &node: bvh.getNodes())
+            TEST_CHECK(node.count <= BVH<float>::max_leaf_size);
+    });
+
+    runner.run("BVH and UniformGrid refit after shapes move", [&] {
+        BVH<float> bvh;
+        UniformGrid<float> grid(10);
+        bvh.build(scene);
+        grid.build(scene);
+
+        // Shapes wander across many cells, and the grid must only keep the ones they currently overlap
+        for (size_t frame = 0; frame < 20; frame++) {
+            for (auto *shape: scene)
+                shape->move(step(rng), step(rng));
+            bvh.refit(scene);
+            grid.refit(scene);
+            TEST_CHECK(grid.cellCount() == occupied_cells(10));
+        }
+        check_queries(bvh, grid);
+
+        // Single shapes can be updated on their own
+        scene[7]->moveTo(1000, 1000);
+        bvh.update(7, scene[7]->bounds());
+        grid.update(7, scene[7]->bounds());
+        check_queries(bvh, grid);
+    });
+}
+
+
+
+// Reference shape for the collision tests: a circle, or a convex outline built from vertices()
+struct TestConvex {
+    bool circle = false;
+    Vector2<double> center;
+    double radius = 0;
+    std::vector<Vector2<double>> points;
+
+    void move(Vector2<double> offset) {
+        center += offset;
+        for (auto &p: points)
+            p += offset;
+    }
+};
+
+template <typename Shape>
+TestConvex test_convex(Shape shape) {
+    TestConvex convex;
+    convex.center = Vector2<double>(shape.position.x, shape.position.y);
+    for (const auto &v: shape.vertices())
+        convex.points.push_back(Vector2<double>(v.x, v.y));
+    return convex;
+}
+
+TestConvex test_convex(const Circle<double>& circle) {
+    TestConvex convex;
+    convex.circle = true;
+    convex.center = circle.position;
+    convex.radius = std::abs(circle.radius);
+    return convex;
+}
+
+double test_length(Vector2<double> v) { return std::hypot(v.x, v.y); }
+
+// Interval of a convex outline along an axis
+void test_project(const TestConvex& shape, Vector2<double> axis, double& low, double& high) {
+    low = high = (shape.points[0].x * axis.x) + (shape.points[0].y * axis.y);
+    for (const auto &p: shape.points) {
+        double d = (p.x * axis.x) + (p.y * axis.y);
+        low = std::min(low, d);
+        high = std::max(high, d);
+    }
+}
+
+// Whether two reference shapes overlap, by brute force: distances for circles, every edge axis for outlines
+bool test_overlaps(const TestConvex& a, const TestConvex& b) {
+    if (a.circle && b.circle)
+        return test_length(b.center - a.center) < a.radius + b.radius;
+
+    if (a.circle || b.circle) {
+        const TestConvex& circle = a.circle ? a : b;
+        const TestConvex& outline = a.circle ? b : a;
+
+        // Inside the outline, or closer than the radius to one of its edges
+        bool inside = true;
+        double nearest = std::numeric_limits<double>::infinity();
+        size_t n = outline.points.size();
+        double winding = 0;
+        for (size_t i = 0; i < n; i++) {
+            Vector2<double> p = outline.points[i], q = outline.points[(i + 1) % n];
+            winding += (p.x * q.y) - (q.x * p.y);
+        }
+        for (size_t i = 0; i < n; i++) {
+            Vector2<double> p = outline.points[i], q = outline.points[(i + 1) % n];
+            Vector2<double> edge = q - p, offset = circle.center - p;
+            double side = (edge.x * offset.y) - (edge.y * offset.x);
+            if (side * winding < 0)
+                inside = false;
+            double t = std::clamp(((offset.x * edge.x) + (offset.y * edge.y)) / ((edge.x * edge.x) + (edge.y * edge.y)), 0.0, 1.0);
+            nearest = std::min(nearest, test_length(circle.center - (p + (edge * t))));
+        }
+        return inside || nearest < circle.radius;
+    }
+
+    for (const TestConvex* shape: { &a, &b }) {
+        size_t n = shape->points.size();
+        for (size_t i = 0; i < n; i++) {
+            Vector2<double> edge = shape->points[(i + 1) % n] - shape->points[i];
+            Vector2<double> axis(-edge.y, edge.x);
+            double a_low, a_high, b_low, b_high;
+            test_project(a, axis, a_low, a_high);
+            test_project(b, axis, b_low, b_high);
+            if (!(a_high > b_low && b_high > a_low))
+                return false;
+        }
+    }
+    return true;
+}
+
+// Exact tests agree with brute force on whether shapes overlap, and their contact is the shortest way apart:
+// moving b along the normal by slightly more than the depth separates the shapes, and slightly less doesn't
+template <typename A, typename B>
+void test_contacts(std::mt19937& rng, A make_a, B make_b) {
+    std::uniform_real_distribution<double> offset(-12, 12);
+    constexpr double tolerance = 1e-6;
+
+    for (size_t i = 0; i < 4000; i++) {
+        auto a = make_a(Vector2<double>(0, 0));
+        auto b = make_b(Vector2<double>(offset(rng), offset(rng)));
+        TestConvex ra = test_convex(a), rb = test_convex(b);
+
+        Contact2D<double> contact;
+        bool hit = collide(a, b, contact);
+        if (hit != test_overlaps(ra, rb)) {
+            // Disagreements are only allowed for shapes that barely touch
+            TestConvex nudged = rb;
+            nudged.move(Vector2<double>(1e-7, 1e-7));
+            TestConvex back = rb;
+            back.move(Vector2<double>(-1e-7, -1e-7));
+            TEST_CHECK(test_overlaps(ra, nudged) != test_overlaps(ra, back));
+            continue;
+        }
+        if (!hit)
+            continue;
+
+        TEST_CHECK(std::abs(test_length(contact.normal) - 1) < 1e-9 && contact.depth > 0);
+
+        TestConvex apart = rb, close = rb;
+        apart.move(contact.normal * (contact.depth + tolerance));
+        close.move(contact.normal * (contact.depth - tolerance));
+        TEST_CHECK(!test_overlaps(ra, apart));
+        TEST_CHECK(contact.depth <= tolerance || test_overlaps(ra, close));
+    }
+}
+
+void test_collision(TestRunner& runner) {
+    std::mt19937 rng(4);
+    std::uniform_real_distribution<double> size(0.5, 8), angle(0, 360);
+    std::uniform_int_distribution<size_t> sides(3, 64);
+
+    auto circle = [&](Vector2<double> p) { return Circle<double>(size(rng), p); };
+    auto rectangle = [&](Vector2<double> p) { return Rectangle<double>(size(rng), size(rng), p, angle(rng)); };
+    auto ngon = [&](Vector2<double> p) { return NGon<double>(sides(rng), size(rng), p, angle(rng)); };
+
+    runner.run("collide matches brute force for every pair of types", [&] {
+        test_contacts(rng, circle, circle);
+        test_contacts(rng, circle, rectangle);
+        test_contacts(rng, rectangle, circle);
+        test_contacts(rng, circle, ngon);
+        test_contacts(rng, ngon, circle);
+        test_contacts(rng, rectangle, rectangle);
+        test_contacts(rng, rectangle, ngon);
+        test_contacts(rng, ngon, rectangle);
+        test_contacts(rng, ngon, ngon);
+    });
+
+    runner.run("CollisionPipeline matches every pair, for any number of threads", [&] {
+        // Enough shapes for the pipeline to split every phase into many tasks
+        std::uniform_real_distribution<float> coordinate(0, 1500), small(0.5f, 4);
+        CircleBatch<float> circles;
+        RectangleBatch<float> rectangles;
+        NGonBatch<float> ngons;
+        for (size_t i = 0; i < 20000; i++) {
+            circles.push_back(Circle<float>(small(rng), coordinate(rng), coordinate(rng)));
+            rectangles.push_back(Rectangle<float>(small(rng), small(rng), coordinate(rng), coordinate(rng), float(angle(rng))));
+            ngons.push_back(NGon<float>(3 + (i % 8), small(rng), coordinate(rng), coordinate(rng), float(angle(rng))));
+        }
+
+        std::vector<std::vector<Contact2D<float>>> results;
+        for (size_t threads: { 1, 2, 3, 8 }) {
+            CollisionPipeline<float> pipeline(threads);
+            pipeline.add(circles);
+            pipeline.add(rectangles);
+            pipeline.add(ngons);
+            results.push_back(pipeline.detect());
+
+            // Detecting again reuses the same team of threads and gives the same contacts
+            TEST_CHECK(pipeline.detect().size() == results.back().size());
+        }
+
+        auto same = [](const Contact2D<float>& x, const Contact2D<float>& y) {
+            return x.a == y.a && x.b == y.b && x.normal == y.normal && x.depth == y.depth;
+        };
+        for (size_t r = 1; r < results.size(); r++) {
+            if (!TEST_CHECK(results[r].size() == results[0].size()))
+                continue;
+            for (size_t i = 0; i < results[0].size(); i++)
+                TEST_CHECK(same(results[r][i], results[0][i]));
+        }
+
+        // Every pair the exact tests find, and no other, once each
+        std::vector<Collider2D<float>> colliders;
+        for (size_t i = 0; i < circles.count(); i++)
+            colliders.push_back(make_collider(circles.get(i), uint32_t(colliders.size())));
+        for (size_t i = 0; i < rectangles.count(); i++)
+            colliders.push_back(make_collider(rectangles.get(i), uint32_t(colliders.size())));
+        for (size_t i = 0; i < ngons.count(); i++)
+            colliders.push_back(make_collider(ngons.get(i), uint32_t(colliders.size())));
+
+        // Candidates come from a BVH over the same bounds, rather than the pipeline's own sweep
+        std::vector<Bounds2D<float>> boxes;
+        for (const auto &c: colliders)
+            boxes.push_back(c.bounds);
+        BVH<float> bvh;
+        bvh.build(std::span<const Bounds2D<float>>(boxes));
+
+        std::vector<std::pair<uint32_t, uint32_t>> expected, found;
+        std::vector<uint32_t> nearby;
+        for (uint32_t a = 0; a < colliders.size(); a++) {
+            bvh.query(boxes[a], nearby);
+            std::sort(nearby.begin(), nearby.end());
+            for (uint32_t b: nearby) {
+                Contact2D<float> contact;
+                if (b > a && collide(colliders[a], colliders[b], contact))
+                    expected.push_back({ a, b });
+            }
+        }
+        for (const auto &contact: results[0])
+            found.push_back({ contact.a, contact.b });
+        std::sort(found.begin(), found.end());
+        TEST_CHECK(expected.size() > 1000);
+        TEST_CHECK(found == expected);
+    });
+}
+
+
+
+// Every element of two arrays is exactly the same
+template <typename T>
+bool test_same(const VectorArray2<T>& a, const VectorArray2<T>& b) {
+    if (a.size() != b.size())
+        return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (!(a.get(i) == b.get(i)))
+            return false;
+    }
+    return true;
+}
+
+template <typename T>
+bool test_same(std::span<const Bounds2D<T>> a, std::span<const Bounds2D<T>> b) {
+    if (a.size() != b.size())
+        return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (!(a[i].min == b[i].min && a[i].max == b[i].max))
+            return false;
+    }
+    return true;
+}
+
+
+
+// The executor runs every chunk once, and the parallel bulk functions give exactly the serial results
+void test_parallel(TestRunner& runner) {
+    // Thread counts with and without a fixed chunk size, including counts that don't divide the work evenly
+    auto executors = [] {
+        std::vector<std::unique_ptr<Executor>> list;
+        for (size_t threads: { 1, 2, 3, 8 })
+            list.push_back(std::make_unique<Executor>(threads));
+        list.push_back(std::make_unique<Executor>(3, 7));
+        return list;
+    };
+
+    runner.run("Executor runs every index once, including nested loops", [&] {
+        for (auto &executor: executors()) {
+            for (size_t count: { 0, 1, 5, 1000, 100003 }) {
+                std::vector<std::atomic<int>> hits(count);
+                parallel_for(*executor, 0, count, [&](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; i++)
+                        hits[i]++;
+                });
+                TEST_CHECK(std::all_of(hits.begin(), hits.end(), [](const std::atomic<int>& h) { return h == 1; }));
+            }
+
+            // Chunks that start their own loops on the same executor finish without waiting on each other
+            std::vector<std::atomic<int>> nested(64 * 64);
+            parallel_for(*executor, 0, 64, [&](size_t begin, size_t end) {
+                for (size_t row = begin; row < end; row++) {
+                    parallel_for(*executor, 0, 64, [&](size_t b, size_t e) {
+                        for (size_t i = b; i < e; i++)
+                            nested[(row * 64) + i]++;
+                    });
+                }
+            }, 1);
+            TEST_CHECK(std::all_of(nested.begin(), nested.end(), [](const std::atomic<int>& h) { return h == 1; }));
+
+            // The first exception reaches the caller, after the other chunks have run
+            std::atomic<size_t> ran = 0;
+            bool caught = false;
+            try {
+                parallel_for(*executor, 0, 100, [&](size_t begin, size_t end) {
+                    ran += end - begin;
+                    if (begin == 0)
+                        throw std::runtime_error("chunk failed");
+                }, 10);
+            } catch (const std::runtime_error&) {
+                caught = true;
+            }
+            TEST_CHECK(caught && ran == 100);
+        }
+    });
+
+    runner.run("Parallel bulk functions match their serial versions", [&] {
+        std::mt19937 rng(16);
+        std::uniform_real_distribution<float> coordinate(-1000, 1000), size(0.5f, 20), angle(-180, 180);
+        CircleBatch<float> circles;
+        RectangleBatch<float> rectangles;
+        NGonBatch<float> ngons;
+        std::vector<Vector2<float>> points;
+        for (size_t i = 0; i < 20000; i++) {
+            circles.push_back(Circle<float>(size(rng), coordinate(rng), coordinate(rng), angle(rng)));
+            rectangles.push_back(Rectangle<float>(size(rng), size(rng), coordinate(rng), coordinate(rng), angle(rng)));
+            ngons.push_back(NGon<float>(3 + (i % 13), size(rng), coordinate(rng), coordinate(rng), angle(rng)));
+            points.push_back(Vector2<float>(coordinate(rng), coordinate(rng)));
+        }
+
+        // Shapes with a pending transform each, which bounds_all flushes
+        std::vector<Transform2D<float>> transforms;
+        for (size_t i = 0; i < 5000; i++)
+            transforms.push_back(Transform2D<float>::rotation(angle(rng)).then(Transform2D<float>::scaling(1.5f)));
+
+        auto transformed = [&](std::vector<std::unique_ptr<Shape2D<float>>>& owned) {
+            std::vector<Shape2D<float>*> shapes;
+            for (size_t i = 0; i < transforms.size(); i++) {
+                owned.push_back(std::make_unique<NGon<float>>(ngons.get(i)));
+                owned.back()->transform(transforms[i]);
+                shapes.push_back(owned.back().get());
+            }
+            return shapes;
+        };
+        std::vector<std::unique_ptr<Shape2D<float>>> owned;
+        std::vector<Shape2D<float>*> shapes = transformed(owned);
+
+        Transform2D<float> transform = Transform2D<float>::rotation(33, Vector2<float>(5, -7))
+                                           .then(Transform2D<float>::scaling(1.25f));
+        VectorArray2<float> lanes(points);
+
+        // Serial results
+        std::vector<Bounds2D<float>> circle_bounds = circles.bounds();
+        std::vector<Bounds2D<float>> ngon_bounds = ngons.bounds();
+        std::vector<Bounds2D<float>> shape_bounds(shapes.size());
+        bounds_all<float>(shapes, shape_bounds);
+        std::vector<Vector2<float>> circle_vertices, ngon_vertices;
+        circles.vertices(circle_vertices);
+        ngons.vertices(ngon_vertices);
+        std::vector<Vector2<float>> rotated(points.size()), applied(points.size());
+        rotate_points<float>(points, rotated, Vector2<float>(3, 4), 27.5f);
+        transform.apply(points, applied);
+        VectorArray2<float> applied_lanes;
+        transform.apply(lanes, applied_lanes);
+        VectorArray2<float> expression = evaluate(((lazy(lanes) - Vector2<float>(1, 2)) * 3.0f) + lanes);
+
+        std::string json_path = test_path("test_parallel.json");
+        TEST_CHECK(test_write_json(json_path, circles, rectangles, ngons));
+        std::string json = test_read(json_path);
+
+        for (auto &executor: executors()) {
+            std::vector<Bounds2D<float>> bounds(circles.count());
+            circles.bounds(bounds, *executor);
+            TEST_CHECK(test_same<float>(bounds, circle_bounds));
+            bounds.resize(ngons.count());
+            ngons.bounds(bounds, *executor);
+            TEST_CHECK(test_same<float>(bounds, ngon_bounds));
+
+            std::vector<std::unique_ptr<Shape2D<float>>> copies;
+            std::vector<Shape2D<float>*> copy_shapes = transformed(copies);
+            bounds.resize(copy_shapes.size());
+            bounds_all<float>(copy_shapes, bounds, *executor);
+            TEST_CHECK(test_same<float>(bounds, shape_bounds));
+
+            std::vector<Vector2<float>> vertices(circle_vertices.size());
+            circles.vertices(vertices, *executor);
+            TEST_CHECK(vertices == circle_vertices);
+            vertices.resize(ngon_vertices.size());
+            ngons.vertices(vertices, *executor);
+            TEST_CHECK(vertices == ngon_vertices);
+
+            std::vector<Vector2<float>> out(points.size());
+            rotate_points<float>(points, out, Vector2<float>(3, 4), 27.5f, *executor);
+            TEST_CHECK(out == rotated);
+            transform.apply(points, out, *executor);
+            TEST_CHECK(out == applied);
+
+            VectorArray2<float> out_lanes;
+            transform.apply(lanes, out_lanes, *executor);
+            TEST_CHECK(test_same(out_lanes, applied_lanes));
+            assign(out_lanes, ((lazy(lanes) - Vector2<float>(1, 2)) * 3.0f) + lanes, *executor);
+            TEST_CHECK(test_same(out_lanes, expression));
+
+            // Parallel writes are byte for byte the same as writing one shape at a time
+            TEST_CHECK(test_write_json(json_path, circles, rectangles, ngons, executor.get()));
+            TEST_CHECK(test_read(json_path) == json);
+        }
+        std::filesystem::remove(json_path);
+    });
+}
+
+
+
+// Runs every batch function and the same Shape2D call on every shape, which must give identical results
+template <typename T, typename Batch, typename Shape>
+void test_batch_matches(std::vector<Shape>& shapes, Executor& executor) {
+    Batch batch(shapes);
+    bool same = batch.count() == shapes.size();
+
+    // Floating-point shapes compose the moves of their position into one transform, while batches move
+    // every position in turn, so positions can differ in the last bits. Everything else is identical.
+    auto check_shapes = [&] {
+        for (size_t i = 0; same && i < shapes.size(); i++) {
+            Shape own = flushed(shapes[i]), copy = batch.get(i);
+            if constexpr (std::is_floating_point_v<T>) {
+                Vector2<T> difference = own.position - copy.position;
+                T tolerance = std::max<T>(1, std::max(std::abs(own.position.x), std::abs(own.position.y))) * T(1e-5);
+                same = std::abs(difference.x) <= tolerance && std::abs(difference.y) <= tolerance;
+                copy.position = own.position;
+            }
+            same = same && copy.str() == own.str();
+        }
+    };
+
+    std::vector<T> areas = batch.areas(), perimeters = batch.perimeters();
+    std::vector<Bounds2D<T>> bounds = batch.bounds(), parallel_bounds(batch.count());
+    batch.bounds(parallel_bounds, executor);
+    for (size_t i = 0; same && i < shapes.size(); i++) {
+        Bounds2D<T> box = shapes[i].bounds();
+        same = areas[i] == shapes[i].area() && perimeters[i] == shapes[i].perimeter() &&
+               bounds[i].min == box.min && bounds[i].max == box.max &&
+               parallel_bounds[i].min == box.min && parallel_bounds[i].max == box.max;
+    }
+    TEST_CHECK(same);
+
+    // Vertices of every shape, one after another
+    std::vector<Vector2<T>> expected, vertices;
+    for (auto &shape: shapes) {
+        std::vector<Vector2<T>> own = shape.vertices();
+        expected.insert(expected.end(), own.begin(), own.end());
+    }
+    batch.vertices(vertices);
+    TEST_CHECK(vertices == expected);
+    std::fill(vertices.begin(), vertices.end(), Vector2<T>());
+    batch.vertices(std::span<Vector2<T>>(vertices), executor);
+    TEST_CHECK(vertices == expected);
+
+    // Transforms, in the same order on both sides
+    batch.rotateAll(12.5f);
+    batch.rotateFromAll(-40, Vector2<T>(3, -2));
+    batch.moveAll(Vector2<T>(7, 1));
+    batch.scaleAll(2);
+    batch.scaleFromAll(3, Vector2<T>(-5, 4));
+    for (auto &shape: shapes) {
+        shape.rotate(12.5f);
+        shape.rotateFrom(-40, Vector2<T>(3, -2));
+        shape.move(Vector2<T>(7, 1));
+        shape.scale(2);
+        shape.scaleFrom(3, Vector2<T>(-5, 4));
+    }
+    check_shapes();
+    TEST_CHECK(same);
+
+    batch.moveToAll(Vector2<T>(9, 9));
+    for (auto &shape: shapes)
+        shape.moveTo(Vector2<T>(9, 9));
+    check_shapes();
+    TEST_CHECK(same);
+}
+
+template <typename T>
+void test_batch_types(Executor& executor) {
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> coordinate(-1000, 1000), size(1, 50), angle(-180, 180);
+    auto value = [&](std::uniform_real_distribution<float>& d) { return static_cast<T>(d(rng)); };
+
+    std::vector<Circle<T>> circles;
+    std::vector<Rectangle<T>> rectangles;
+    std::vector<NGon<T>> ngons;
+    for (size_t i = 0; i < 1001; i++) {
+        circles.push_back(Circle<T>(value(size), value(coordinate), value(coordinate), angle(rng)));
+        rectangles.push_back(Rectangle<T>(value(size), value(size), value(coordinate), value(coordinate), angle(rng)));
+        ngons.push_back(NGon<T>(3 + (i % 9), value(size), value(coordinate), value(coordinate), angle(rng)));
+    }
+
+    // Level of detail picks each circle's own resolution
+    CircleBatch<T> batch(circles);
+    CircleDetail detail { 0.1, 2 };
+    std::vector<Vector2<T>> expected, vertices;
+    std::vector<size_t> offsets;
+    for (auto &circle: circles) {
+        std::vector<Vector2<T>> own = circle.vertices(detail);
+        expected.insert(expected.end(), own.begin(), own.end());
+    }
+    batch.vertices(vertices, offsets, detail);
+    TEST_CHECK(vertices == expected && offsets.back() == expected.size());
+    batch.vertices(vertices, offsets, detail, executor);
+    TEST_CHECK(vertices == expected);
+
+    test_batch_matches<T, CircleBatch<T>>(circles, executor);
+    test_batch_matches<T, RectangleBatch<T>>(rectangles, executor);
+    test_batch_matches<T, NGonBatch<T>>(ngons, executor);
+}
+
+void test_batch(TestRunner& runner) {
+    runner.run("Batch functions match the same calls on every shape", [] {
+        Executor executor(3);
+        test_batch_types<float>(executor);
+        test_batch_types<double>(executor);
+        test_batch_types<int32_t>(executor);
+    });
+}
+
+
+
+// Integer rotation gives the same bits on every path, and exact results for quarter turns
+void test_fixed_point(TestRunner& runner) {
+    runner.run("Fixed-point sine and cosine", [] {
+        TEST_CHECK(fixed_rotation(0).cosine == fixed_one && fixed_rotation(0).sine == 0);
+        TEST_CHECK(fixed_rotation(90).cosine == 0 && fixed_rotation(90).sine == fixed_one);
+        TEST_CHECK(fixed_rotation(-90).cosine == 0 && fixed_rotation(-90).sine == -fixed_one);
+        TEST_CHECK(fixed_rotation(180).cosine == -fixed_one && fixed_rotation(720 + 270).sine == -fixed_one);
+        TEST_CHECK(std::abs(fixed_rotation(30).sine - (fixed_one / 2)) <= 1);
+
+        // Every step of a turn stays within a step or two of the true values
+        for (int64_t angle = -fixed_degrees_per_turn; angle <= fixed_degrees_per_turn; angle += 997) {
+            FixedRotation r = fixed_sin_cos(angle);
+            double radians = static_cast<double>(angle) / fixed_one * (M_PI / 180);
+            TEST_CHECK(std::abs(r.cosine - (std::cos(radians) * fixed_one)) < 1.5);
+            TEST_CHECK(std::abs(r.sine - (std::sin(radians) * fixed_one)) < 1.5);
+        }
+
+        Vector2<int> p = rotate_point(Vector2<int>(100, 0), Vector2<int>(0, 0), 90.0f);
+        TEST_CHECK(p == Vector2<int>(0, 100));
+        p = rotate_point(Vector2<int>(7, -3), Vector2<int>(2, 2), 180.0f);
+        TEST_CHECK(p == Vector2<int>(-3, 7));
+    });
+
+    runner.run("Bulk integer rotation matches rotate_point on every path", [] {
+        std::mt19937 rng(19);
+        std::uniform_int_distribution<int32_t> any(INT32_MIN, INT32_MAX), near(-100000, 100000);
+        std::uniform_real_distribution<float> angle(-720, 720);
+
+        for (size_t count: { 0, 1, 3, 4, 7, 1003 }) {
+            for (int round = 0; round < 8; round++) {
+                // Half the rounds span the whole range, where results wrap the same way on every path
+                auto coordinate = [&] { return round % 2 ? any(rng) : near(rng); };
+                std::vector<Vector2<int32_t>> points(count);
+                for (auto &point: points)
+                    point = Vector2<int32_t>(coordinate(), coordinate());
+                Vector2<int32_t> origin(coordinate(), coordinate());
+                FixedRotation rotation = fixed_rotation(round < 2 ? 90 * round : angle(rng));
+
+                std::vector<Vector2<int32_t>> expected(count);
+                for (size_t i = 0; i < count; i++)
+                    expected[i] = rotate_point(points[i], origin, rotation);
+
+                std::vector<Vector2<int32_t>> out(count);
+                rotate_points_fixed<int32_t>(points, out, origin, rotation);
+                TEST_CHECK(out == expected);
+
+                VectorArray2<int32_t> lanes(points), lanes_out;
+                rotate_points_fixed(lanes, lanes_out, origin, rotation);
+                bool same = lanes_out.size() == count;
+                for (size_t i = 0; same && i < count; i++)
+                    same = lanes_out.get(i) == expected[i];
+                TEST_CHECK(same);
+
+                // In place, and for a 64-bit type, which only has the scalar path
+                rotate_points_fixed<int32_t>(points, points, origin, rotation);
+                TEST_CHECK(points == expected);
+
+                std::vector<Vector2<int64_t>> wide(count), wide_out(count);
+                for (size_t i = 0; i < count; i++)
+                    wide[i] = Vector2<int64_t>(lanes.x[i], lanes.y[i]);
+                Vector2<int64_t> wide_origin(origin.x, origin.y);
+                rotate_points_fixed<int64_t>(wide, wide_out, wide_origin, rotation);
+                same = true;
+                for (size_t i = 0; i < count; i++)
+                    same = same && wide_out[i] == rotate_point(wide[i], wide_origin, rotation);
+                TEST_CHECK(same);
+            }
+        }
+    });
+
+    runner.run("Integer shapes place vertices without direction tables", [] {
+        UnitCircleCache<int>::resetStats();
+        Circle<int> circle(100, 5, -5, 30);
+        NGon<int> hexagon(6, 50, Vector2<int>(1, 2), 90);
+        std::vector<Vector2<int>> vertices = circle.vertices(12);
+        TEST_CHECK(vertices.size() == 12 && vertices[0] == rotate_point(Vector2<int>(5, 95), Vector2<int>(5, -5), 30.0f));
+        TEST_CHECK(hexagon.vertices()[0] == Vector2<int>(-49, 2));
+
+        CircleBatch<int> batch;
+        batch.push_back(circle);
+        batch.push_back(Circle<int>(3, 0, 0));
+        std::vector<Vector2<int>> out;
+        std::vector<size_t> offsets;
+        batch.vertices(out, 12);
+        TEST_CHECK(out.size() == 24 && std::equal(vertices.begin(), vertices.end(), out.begin()));
+        batch.vertices(out, offsets, CircleDetail{ 0.5 });
+
+        UnitCircleCache<int>::Stats stats = UnitCircleCache<int>::stats();
+        TEST_CHECK(stats.hits == 0 && stats.misses == 0);
+    });
+}
+
+
+
+// Levels of detail stay within their limits and tolerance, and the direction tables they use are cached
+// with least recently used eviction
+void test_detail(TestRunner& runner) {
+    runner.run("Level of detail resolutions are clamped and meet the tolerance", [] {
+        CircleDetail detail;
+        TEST_CHECK(circle_detail_resolution(0.0, detail) == circle_detail_min_resolution);
+        TEST_CHECK(circle_detail_resolution(0.25, detail) == circle_detail_min_resolution);
+        TEST_CHECK(circle_detail_resolution(1e9, detail) == circle_detail_max_resolution);
+        TEST_CHECK(circle_detail_resolution(INFINITY, detail) == circle_detail_max_resolution);
+        TEST_CHECK(circle_detail_resolution(NAN, detail) == circle_detail_max_resolution);
+        TEST_CHECK(circle_detail_resolution(100.0, CircleDetail{ 0 }) == circle_detail_max_resolution);
+        TEST_CHECK(circle_detail_resolution(100.0, CircleDetail{ -1 }) == circle_detail_max_resolution);
+        TEST_CHECK(circle_detail_resolution(100.0, CircleDetail{ NAN }) == circle_detail_max_resolution);
+
+        // Negative radii and scales measure the same circle, and the scale multiplies the radius
+        TEST_CHECK(circle_detail_resolution(-50.0, detail) == circle_detail_resolution(50.0, detail));
+        TEST_CHECK(circle_detail_resolution(50.0, CircleDetail{ 0.25, -2 }) == circle_detail_resolution(100.0, detail));
+        TEST_CHECK(circle_detail_resolution(50.0f, CircleDetail{ 0.25, 4 }) == circle_detail_resolution(200, detail));
+
+        std::set<size_t> levels;
+        size_t previous = 0;
+        bool bounded = true, monotonic = true, within = true, rounded = true, dense = true;
+        for (double r = 0.01; r < 1e7; r *= 1.01) {
+            size_t n = circle_detail_resolution(r, detail);
+            bounded = bounded && n >= circle_detail_min_resolution && n <= circle_detail_max_resolution;
+            monotonic = monotonic && n >= previous;
+            previous = n;
+
+            // The sagitta of every edge is within the tolerance, unless the maximum was reached
+            double sagitta = r * (1 - std::cos(M_PI / static_cast<double>(n)));
+            within = within && (sagitta <= detail.tolerance || n == circle_detail_max_resolution);
+
+            // Counts keep at most 4 significant bits, and each one has its own level
+            int shift = std::max(static_cast<int>(std::bit_width(n)) - 4, 0);
+            rounded = rounded && ((n >> shift) << shift) == n;
+            size_t level = circle_detail_level(n);
+            dense = dense && level < circle_detail_levels;
+            levels.insert(level);
+        }
+        TEST_CHECK(bounded && monotonic && within && rounded && dense);
+        TEST_CHECK(levels.size() == circle_detail_levels);
+
+        // A circle's resolution follows its radius, including pending scales
+        Circle<float> circle(10);
+        TEST_CHECK(circle.resolution(detail) == circle_detail_resolution(10.0f, detail));
+        TEST_CHECK(circle.transform(Transform2D<float>::scaling(20)));
+        TEST_CHECK(circle.resolution(detail) == circle_detail_resolution(200.0f, detail));
+        TEST_CHECK(circle.vertices(detail).size() == circle.resolution(detail));
+    });
+
+    runner.run("Direction tables are evicted least recently used first", [] {
+        using Cache = UnitCircleCache<double>;
+        Cache::clear();
+        Cache::resetStats();
+        Cache::setCapacity(3);
+
+        auto held = Cache::table(11);
+        Cache::table(10);
+        Cache::table(12);
+        Cache::table(11); // 10 is now the least recently used
+        Cache::table(13);
+        Cache::Stats stats = Cache::stats();
+        TEST_CHECK(stats.hits == 1 && stats.misses == 4 && stats.evictions == 1 && stats.tables == 3);
+
+        Cache::table(11);
+        Cache::table(12);
+        Cache::table(10); // Evicts 13
+        Cache::table(13); // Evicts 11
+        stats = Cache::stats();
+        TEST_CHECK(stats.hits == 3 && stats.misses == 6 && stats.evictions == 3 && stats.tables == 3);
+
+        // Evicted tables stay valid while they are held, and are built again on their next use
+        TEST_CHECK(held->size() == 11 && (*held)[0] == Vector2<double>(0, 1));
+        auto rebuilt = Cache::table(11);
+        TEST_CHECK(rebuilt != held && *rebuilt == *held && Cache::stats().misses == 7);
+
+        // Lowering the capacity evicts right away and keeps the most recently used
+        Cache::setCapacity(1);
+        stats = Cache::stats();
+        TEST_CHECK(stats.tables == 1 && stats.evictions == 6);
+        Cache::table(11);
+        TEST_CHECK(Cache::stats().hits == 4);
+
+        // Resetting the counters keeps the tables
+        Cache::resetStats();
+        stats = Cache::stats();
+        TEST_CHECK(stats.hits == 0 && stats.misses == 0 && stats.evictions == 0 && stats.tables == 1);
+
+        // An unbounded cache never evicts
+        Cache::setCapacity(0);
+        for (size_t resolution = 3; resolution < 40; resolution++)
+            Cache::table(resolution);
+        stats = Cache::stats();
+        TEST_CHECK(stats.evictions == 0 && stats.tables == 37 && stats.hits == 1 && stats.misses == 36);
+        Cache::clear();
+    });
+
+    runner.run("Direction cache counts every lookup from every thread", [] {
+        using Cache = UnitCircleCache<double>;
+        Cache::clear();
+        Cache::resetStats();
+
+        Executor executor(4);
+        parallel_for(executor, 0, 1000, [](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++)
+                Cache::table(16 + (i % 4));
+        }, 10);
+
+        // Threads racing to build a table may each count a miss, but only one table is kept
+        Cache::Stats stats = Cache::stats();
+        TEST_CHECK(stats.hits + stats.misses == 1000 && stats.misses >= 4 && stats.tables == 4);
+        Cache::clear();
+        Cache::resetStats();
+    });
+}
+
+
+
+// Polygon hulls and bounds hold every vertex, including for outlines that cross themselves
+void test_polygon(TestRunner& runner) {
+    runner.run("Polygon hulls and bounds hold every vertex", [] {
+        std::mt19937 rng(20);
+        std::uniform_real_distribution<float> coordinate(-100, 100), angle(0, 360), scale(0.5f, 3);
+        size_t incomplete = 0;
+
+        for (int round = 0; round < 500; round++) {
+            // Random points joined in order, which cross themselves almost every time
+            std::vector<Vector2<float>> outline(3 + (round % 40));
+            for (auto &point: outline)
+                point = Vector2<float>(coordinate(rng), coordinate(rng));
+            Polygon<float> polygon(outline, Vector2<float>(coordinate(rng), coordinate(rng)), angle(rng));
+            polygon.scale(scale(rng));
+
+            const float* x = polygon.points.x;
+            const float* y = polygon.points.y;
+            size_t n = polygon.points.size();
+            std::vector<size_t> linear, general;
+            polygon_convex_hull(x, y, n, linear);
+            polygon_point_hull(x, y, n, general);
+            incomplete += !polygon_hull_contains_all(x, y, n, linear);
+            TEST_CHECK(polygon_hull_contains_all(x, y, n, general));
+
+            std::vector<size_t> hull = general;
+            std::sort(hull.begin(), hull.end());
+            Polygon<float> convex = polygon.convexHull();
+            TEST_CHECK(convex.points.size() == hull.size());
+            TEST_CHECK(convex.isConvex());
+            TEST_CHECK(polygon.isConvex() == (n == 3) || hull.size() == n);
+
+            // The bounds hold every vertex, and every side touches one
+            Bounds2D<float> bounds = polygon.bounds();
+            Vector2<float> min = polygon.vertices()[0], max = min;
+            for (Vector2<float> v: polygon.vertices()) {
+                min = Vector2<float>(std::min(min.x, v.x), std::min(min.y, v.y));
+                max = Vector2<float>(std::max(max.x, v.x), std::max(max.y, v.y));
+            }
+            TEST_CHECK(bounds.min.x <= min.x && bounds.min.y <= min.y && bounds.max.x >= max.x && bounds.max.y >= max.y);
+            TEST_CHECK(min.x - bounds.min.x < 0.01f && min.y - bounds.min.y < 0.01f &&
+                       bounds.max.x - max.x < 0.01f && bounds.max.y - max.y < 0.01f);
+        }
+
+        // The linear hull left out vertices often enough for the general hull to be checked
+        TEST_CHECK(incomplete > 50);
+    });
+
+    runner.run("Polygon::isConvex follows the outline", [] {
+        std::vector<Vector2<float>> square = { { 0, 0 }, { 1, 0 }, { 1, 1 }, { 0, 1 } };
+        TEST_CHECK(Polygon<float>(square).isConvex());
+        std::reverse(square.begin(), square.end());
+        TEST_CHECK(Polygon<float>(square).isConvex());
+
+        // Every vertex of a pentagram is on its hull, in a different order
+        std::vector<Vector2<float>> pentagram;
+        for (int i = 0; i < 5; i++) {
+            float a = static_cast<float>(M_PI) * 0.8f * static_cast<float>(i);
+            pentagram.push_back(Vector2<float>(std::cos(a), std::sin(a)));
+        }
+        Polygon<float> star(pentagram);
+        TEST_CHECK(star.convexHull().points.size() == 5 && !star.isConvex());
+
+        // An outline along one line that doubles back
+        std::vector<Vector2<float>> line = { { 0, 0 }, { 5, 0 }, { -3, 0 } };
+        Polygon<float> segment(line);
+        TEST_CHECK(segment.convexHull().points.size() == 2 && segment.bounds().min.x <= -3 && segment.bounds().max.x >= 5);
+
+        std::vector<Vector2<float>> dart = { { 0, 0 }, { 2, 1 }, { 0, 2 }, { 1, 1 } };
+        TEST_CHECK(!Polygon<float>(dart).isConvex() && Polygon<float>(dart).convexHull().points.size() == 3);
+    });
+}
+
+
+
+// Twice the signed area of a triangle of a mesh
+template <typename T>
+double test_triangle_area2(const std::vector<Vector2<T>>& vertices, size_t a, size_t b, size_t c) {
+    double ax = static_cast<double>(vertices[b].x) - vertices[a].x, ay = static_cast<double>(vertices[b].y) - vertices[a].y;
+    double bx = static_cast<double>(vertices[c].x) - vertices[a].x, by = static_cast<double>(vertices[c].y) - vertices[a].y;
+    return (ax * by) - (bx * ay);
+}
+
+// Checks that a polygon's slice of a mesh is n - 2 triangles within its own vertices, all turning the same way
+// as the outline, whose areas sum to the outline's area
+template <typename T, typename Index>
+bool test_ear_clip(Polygon<T>& polygon, const std::vector<Vector2<T>>& vertices, const std::vector<Index>& indices,
+                   TessellationCounts at) {
+    size_t n = polygon.vertexCount();
+    double outline2 = 0;
+    for (size_t i = 0; i < n; i++)
+        outline2 += test_triangle_area2(vertices, at.vertices, at.vertices + i, at.vertices + ((i + 1) % n));
+
+    bool in_range = true, same_turn = true;
+    double total2 = 0;
+    for (size_t k = at.indices; k < at.indices + (3 * (n - 2)); k += 3) {
+        for (size_t j = 0; j < 3; j++)
+            in_range = in_range && indices[k + j] >= at.vertices && indices[k + j] < at.vertices + n;
+        if (!in_range)
+            return false;
+
+        double area2 = test_triangle_area2(vertices, indices[k], indices[k + 1], indices[k + 2]);
+        same_turn = same_turn && (area2 * outline2) >= 0;
+        total2 += area2;
+    }
+    return same_turn && std::abs(total2 - outline2) <= 1e-4 * std::abs(outline2) &&
+           std::abs((std::abs(outline2) / 2) - polygon.area()) <= 1e-4 * polygon.area();
+}
+
+// Outline of a star, with points and notches at random radii, which is simple but not convex
+std::vector<Vector2<float>> test_star(std::mt19937& rng, size_t points, Vector2<float> center) {
+    std::uniform_real_distribution<float> outer(8, 12), inner(2, 5);
+    std::vector<Vector2<float>> outline;
+    for (size_t i = 0; i < 2 * points; i++) {
+        double radians = (M_PI * static_cast<double>(i)) / static_cast<double>(points);
+        float r = (i % 2 == 0) ? outer(rng) : inner(rng);
+        outline.emplace_back(center.x + (r * static_cast<float>(std::cos(radians))),
+                             center.y + (r * static_cast<float>(std::sin(radians))));
+    }
+    return outline;
+}
+
+
+
+// Meshes fan out convex shapes, ear clip the rest, and never hold indices their index type can't address
+void test_tessellation(TestRunner& runner) {
+    runner.run("Convex shapes are filled with a fan", [] {
+        Rectangle<float> rectangle(4, 2, 10, 5, 30);
+        NGon<float> hexagon(6, 3, -4, 2, 15);
+        Circle<float> circle(2, 1, 1);
+        Polygon<float> square = Polygon<float>::fromVertices({ { 0, 0 }, { 2, 0 }, { 2, 2 }, { 0, 2 } });
+        std::vector<Shape2D<float>*> scene { &rectangle, &hexagon, &circle, &square };
+
+        Tessellator<float, uint16_t> tessellator;
+        std::vector<Vector2<float>> vertices;
+        std::vector<uint16_t> indices;
+        TEST_CHECK(tessellator.tessellate(scene, vertices, indices));
+
+        TessellationCounts at;
+        for (Shape2D<float>* shape: scene) {
+            size_t n = shape->vertexCount();
+            std::vector<Vector2<float>> outline = shape->vertices();
+            TEST_CHECK(std::equal(outline.begin(), outline.end(), vertices.begin() + at.vertices));
+
+            // Every triangle shares the first vertex, and the triangles cover the outline's area
+            bool fan = true;
+            double area2 = 0;
+            for (size_t i = 2, k = at.indices; i < n; i++, k += 3) {
+                fan = fan && indices[k] == at.vertices && indices[k + 1] == at.vertices + i - 1 &&
+                      indices[k + 2] == at.vertices + i;
+                area2 += std::abs(test_triangle_area2(vertices, indices[k], indices[k + 1], indices[k + 2]));
+            }
+            TEST_CHECK(fan);
+            if (shape != &circle)
+                TEST_CHECK(std::abs((area2 / 2) - shape->area()) <= 1e-4 * shape->area());
+            at += { n, 3 * (n - 2) };
+        }
+        TEST_CHECK(vertices.size() == at.vertices && indices.size() == at.indices);
+
+        // Lanes hold the same vertices, with the same indices
+        VectorArray2<float> lanes;
+        std::vector<uint16_t> lane_indices;
+        TEST_CHECK(tessellator.tessellate(scene, lanes, lane_indices));
+        bool same = lanes.size() == vertices.size() && lane_indices == indices;
+        for (size_t i = 0; same && i < vertices.size(); i++)
+            same = lanes.x[i] == vertices[i].x && lanes.y[i] == vertices[i].y;
+        TEST_CHECK(same);
+    });
+
+    runner.run("Concave polygons are ear clipped", [] {
+        std::mt19937 rng(23);
+        std::vector<Polygon<float>> polygons;
+        polygons.push_back(Polygon<float>::fromVertices({ { 0, 0 }, { 6, 0 }, { 6, 2 }, { 2, 2 }, { 2, 6 }, { 0, 6 } }));
+        polygons.push_back(Polygon<float>::fromVertices({ { 0, 0 }, { 9, 0 }, { 9, 5 }, { 8, 5 }, { 8, 1 }, { 7, 1 },
+                                                          { 7, 5 }, { 6, 5 }, { 6, 1 }, { 1, 1 }, { 1, 5 }, { 0, 5 } }));
+        for (size_t points: { 3, 5, 17, 64 }) {
+            std::vector<Vector2<float>> outline = test_star(rng, points, Vector2<float>(20, -10));
+            polygons.push_back(Polygon<float>::fromVertices(outline));
+
+            // Clockwise outlines are clipped with the opposite turn
+            std::reverse(outline.begin(), outline.end());
+            polygons.push_back(Polygon<float>::fromVertices(outline));
+        }
+
+        // The rectangle first offsets every polygon's indices
+        Rectangle<float> rectangle(4, 2, 10, 5);
+        std::vector<Shape2D<float>*> scene { &rectangle };
+        for (auto &polygon: polygons) {
+            TEST_CHECK(!polygon.isConvex());
+            scene.push_back(&polygon);
+        }
+
+        Tessellator<float, uint32_t> tessellator;
+        std::vector<Vector2<float>> vertices;
+        std::vector<uint32_t> indices;
+        TEST_CHECK(tessellator.tessellate(scene, vertices, indices));
+
+        TessellationCounts at = tessellation_counts<float>(rectangle);
+        for (auto &polygon: polygons) {
+            TEST_CHECK(test_ear_clip(polygon, vertices, indices, at));
+            at += tessellation_counts(polygon);
+        }
+        TEST_CHECK(vertices.size() == at.vertices && indices.size() == at.indices);
+
+        // Integer outlines have exact turns, and the same triangle count
+        Polygon<int> notch = Polygon<int>::fromVertices({ { 0, 0 }, { 10, 0 }, { 10, 10 }, { 5, 3 }, { 0, 10 } });
+        Tessellator<int, uint16_t> integer_tessellator;
+        std::vector<Vector2<int>> integer_vertices;
+        std::vector<uint16_t> integer_indices;
+        TEST_CHECK(integer_tessellator.tessellate(std::vector<Shape2D<int>*>{ &notch }, integer_vertices, integer_indices));
+        TEST_CHECK(integer_indices.size() == 9 && test_ear_clip(notch, integer_vertices, integer_indices, TessellationCounts{}));
+    });
+
+    runner.run("Meshes too large for the index type are rejected", [] {
+        std::vector<Vector2<float>> outline(255);
+        for (size_t i = 0; i < outline.size(); i++) {
+            double radians = (2 * M_PI * static_cast<double>(i)) / static_cast<double>(outline.size());
+            outline[i] = Vector2<float>(static_cast<float>(std::cos(radians)), static_cast<float>(std::sin(radians)));
+        }
+        Polygon<float> polygon = Polygon<float>::fromVertices(outline);
+        Polygon<float> triangle = Polygon<float>::fromVertices({ { 0, 0 }, { 1, 0 }, { 0, 1 } });
+
+        // 256 vertices end on index 255, the last an 8-bit index can address
+        Tessellator<float, uint8_t> tessellator;
+        std::vector<Vector2<float>> vertices;
+        std::vector<uint8_t> indices;
+        std::vector<Polygon<float>> fits { polygon };
+        fits.push_back(Polygon<float>::fromVertices({ { 0, 0 } }));
+        TEST_CHECK(tessellator.tessellate(fits, vertices, indices));
+        TEST_CHECK(vertices.size() == 256 && indices.size() == 3 * 253 && indices.back() == 254);
+
+        // One more vertex fails, leaving the buffers untouched
+        std::vector<Polygon<float>> too_many { polygon, triangle };
+        vertices.assign(5, Vector2<float>(7, 7));
+        indices.assign(4, 9);
+        TEST_CHECK(!tessellator.tessellate(too_many, vertices, indices));
+        TEST_CHECK(vertices.size() == 5 && vertices[4] == Vector2<float>(7, 7));
+        TEST_CHECK(indices == std::vector<uint8_t>(4, 9));
+
+        VectorArray2<float> lanes;
+        TEST_CHECK(!tessellator.tessellate(too_many, lanes, indices) && lanes.size() == 0);
+
+        // Wider indices take the same scene
+        Tessellator<float, uint16_t> wide;
+        std::vector<uint16_t> wide_indices;
+        TEST_CHECK(wide.tessellate(too_many, vertices, wide_indices) && vertices.size() == 258 && wide_indices.back() == 257);
+
+        // Single shapes given buffers that are too small write nothing
+        std::vector<Vector2<float>> small(2);
+        std::vector<uint16_t> small_indices(3);
+        TessellationCounts counts = wide.tessellate(triangle, small, small_indices);
+        TEST_CHECK(counts.vertices == 0 && counts.indices == 0);
+    });
+}
+
+
+
+// Runs the scalar kernels on the same float points as the vectorized ones: double lanes with a float frame
+// and query take the scalar loop, and every float converts to double exactly.
+// The scalar loop may be compiled with fused multiply-adds, so the two agree to rounding, and points within
+// rounding of the outline may land on either side of it.
+template <typename Query>
+bool test_query_paths(const VectorArray2<float>& points, const QueryFrame<float>& frame, const Query& query) {
+    size_t count = points.size();
+    std::vector<double> x(points.x, points.x + count), y(points.y, points.y + count);
+    std::vector<uint64_t> vector_mask(query_mask_words(count), ~uint64_t(0)), scalar_mask(query_mask_words(count));
+    std::vector<float> vector_out(count + 3, 12345.0f);
+    std::vector<double> scalar_out(count);
+
+    query_contains(points.x, points.y, 0, count, frame, query, vector_mask.data());
+    query_contains(x.data(), y.data(), 0, count, frame, query, scalar_mask.data());
+    query_distances(points.x, points.y, 0, count, frame, query, vector_out.data());
+    query_distances(x.data(), y.data(), 0, count, frame, query, scalar_out.data());
+
+    bool same = true;
+    for (size_t i = 0; i < count; i++) {
+        same = same && std::abs(vector_out[i] - scalar_out[i]) <= 1e-5 * (1 + std::abs(scalar_out[i]));
+        if (std::abs(scalar_out[i]) > 1e-4)
+            same = same && ((vector_mask[i / 64] ^ scalar_mask[i / 64]) >> (i % 64) & 1) == 0;
+    }
+    if (count % 64 != 0)
+        same = same && (vector_mask.back() >> (count % 64)) == 0;
+
+    // Masked loads and stores stay within the points
+    return same && vector_out[count] == 12345.0f && vector_out[count + 2] == 12345.0f;
+}
+
+// Checks a shape's batch queries, serial and split over an executor, against its single point queries
+template <typename T>
+bool test_batch_queries(Shape2D<T>& shape, const VectorArray2<T>& points, Executor& executor) {
+    size_t count = points.size();
+    std::vector<uint64_t> mask(query_mask_words(count), ~uint64_t(0)), split_mask(query_mask_words(count));
+    std::vector<T> out(count), split_out(count);
+    shape.contains(points, mask);
+    shape.contains(points, split_mask, executor);
+    shape.signedDistance(points, out);
+    shape.signedDistance(points, split_out, executor);
+
+    // Single point queries run the scalar code, which agrees to rounding, as for test_query_paths()
+    bool same = mask == split_mask && out == split_out;
+    for (size_t i = 0; i < count; i++) {
+        Vector2<T> point(points.x[i], points.y[i]);
+        T distance = shape.signedDistance(point);
+        same = same && std::abs(out[i] - distance) <= T(1e-4) * (1 + std::abs(distance));
+        if (std::abs(distance) > T(1e-4))
+            same = same && ((mask[i / 64] >> (i % 64)) & 1) == shape.contains(point);
+    }
+
+    // Bits past the last point are cleared
+    if (count % 64 != 0)
+        same = same && (mask.back() >> (count % 64)) == 0;
+    return same;
+}
+
+
+
+// Point queries match the analytic distances of every shape, and the batch kernels match the single point queries
+void test_point_queries(TestRunner& runner) {
+    auto near = [](float a, float b) { return std::abs(a - b) <= 1e-4f * (1 + std::abs(b)); };
+
+    runner.run("Circles and rectangles match their analytic distances", [&] {
+        Circle<float> circle(5, 1, 2);
+        TEST_CHECK(near(circle.signedDistance(Vector2<float>(10, 2)), 4) && near(circle.signedDistance(Vector2<float>(1, 2)), -5));
+        TEST_CHECK(near(circle.signedDistance(Vector2<float>(4, 6)), 0) && circle.contains(Vector2<float>(4, 6)));
+        TEST_CHECK(!circle.contains(Vector2<float>(4.01f, 6)));
+
+        // A negative radius is the same circle, and scales are applied before the query
+        Circle<float> negative(-5, 1, 2);
+        TEST_CHECK(near(negative.signedDistance(Vector2<float>(10, 2)), 4) && negative.contains(Vector2<float>(5, 2)));
+        circle.scaleFrom(2, Vector2<float>(1, 2));
+        TEST_CHECK(near(circle.signedDistance(Vector2<float>(14, 2)), 3) && circle.contains(Vector2<float>(10, 2)));
+
+        // Along the rotated axes of the rectangle, and past its corner
+        for (float rotation: { 0.0f, 30.0f, 90.0f, -135.0f }) {
+            Rectangle<float> rectangle(4, 2, 10, 5, rotation);
+            double radians = rotation * (M_PI / 180);
+            Vector2<float> u(static_cast<float>(std::cos(radians)), static_cast<float>(std::sin(radians)));
+            Vector2<float> v(-u.y, u.x), center(10, 5);
+            TEST_CHECK(near(rectangle.signedDistance(center), -1));
+            TEST_CHECK(near(rectangle.signedDistance(center + (u * 5.0f)), 3) && !rectangle.contains(center + (u * 2.1f)));
+            TEST_CHECK(near(rectangle.signedDistance(center + (v * 0.75f)), -0.25f) && rectangle.contains(center + (u * 1.9f)));
+            TEST_CHECK(near(rectangle.signedDistance(center + (u * 5.0f) - (v * 5.0f)), 5));
+
+            // A pending scale doubles every size
+            TEST_CHECK(rectangle.transform(Transform2D<float>::scaling(2, center)));
+            TEST_CHECK(near(rectangle.signedDistance(center + (u * 5.0f)), 1) && rectangle.contains(center + (v * 1.9f)));
+        }
+
+        // Negative sizes give the same rectangle
+        Rectangle<float> flipped(-4, -2, 10, 5);
+        TEST_CHECK(near(flipped.signedDistance(Vector2<float>(13, 5)), 1) && flipped.contains(Vector2<float>(11.5f, 5.5f)));
+    });
+
+    runner.run("N-Gons match their analytic distances", [&] {
+        for (float radius: { 10.0f, -10.0f }) {
+            for (float rotation: { 0.0f, 15.0f, 90.0f, 200.0f }) {
+                NGon<float> hexagon(6, radius, Vector2<float>(3, -4), rotation);
+                Vector2<float> center(3, -4);
+                TEST_CHECK(near(hexagon.signedDistance(center), -10 * std::cos(static_cast<float>(M_PI) / 6)));
+
+                // Radially past every vertex, the vertex is nearest, and the middle of every edge is on the outline
+                std::vector<Vector2<float>> vertices = hexagon.vertices();
+                bool exact = true;
+                for (size_t i = 0; i < vertices.size(); i++) {
+                    Vector2<float> out = (vertices[i] - center) / 10.0f;
+                    Vector2<float> middle = (vertices[i] + vertices[(i + 1) % 6]) / 2.0f;
+                    exact = exact && near(hexagon.signedDistance(center + (out * 12.0f)), 2);
+                    exact = exact && hexagon.contains(center + (out * 9.9f)) && !hexagon.contains(center + (out * 10.1f));
+                    exact = exact && std::abs(hexagon.signedDistance(middle)) <= 1e-4f;
+                }
+                TEST_CHECK(exact);
+
+                // Scales are applied before the query, and the normal table follows the vertex count
+                TEST_CHECK(hexagon.transform(Transform2D<float>::scaling(1.5f, center)));
+                TEST_CHECK(near(hexagon.signedDistance(center), -15 * std::cos(static_cast<float>(M_PI) / 6)));
+                hexagon.N = 4;
+                TEST_CHECK(near(hexagon.signedDistance(center), -15 * std::cos(static_cast<float>(M_PI) / 4)));
+            }
+        }
+
+        // Fewer than 3 vertices hold no points, and measure the distance to the center
+        NGon<float> line(2, 5, 1, 1);
+        TEST_CHECK(!line.contains(Vector2<float>(1, 1)) && near(line.signedDistance(Vector2<float>(4, 5)), 5));
+    });
+
+    runner.run("Vectorized and scalar query kernels agree on every point", [&] {
+        std::mt19937 rng(29);
+        std::uniform_real_distribution<float> coordinate(-20, 20);
+        Executor executor(3);
+
+        Circle<float> circle(7, 1, 2);
+        Circle<float> negative_circle(-4, -3, 5);
+        Rectangle<float> rectangle(12, 5, -2, 1, 30);
+        NGon<float> hexagon(6, 9, Vector2<float>(2, -1), 15);
+        NGon<float> negative_ngon(7, -8, Vector2<float>(-1, 3), 100);
+        NGon<float> empty(2, 8, Vector2<float>(0, 0), 0);
+        std::vector<Shape2D<float>*> shapes { &circle, &negative_circle, &rectangle, &hexagon, &negative_ngon, &empty };
+
+        for (size_t count: { 1, 7, 8, 9, 63, 64, 65, 130, 1001 }) {
+            VectorArray2<float> points;
+            VectorArray2<double> wide;
+            for (size_t i = 0; i < count; i++) {
+                Vector2<float> p(coordinate(rng), coordinate(rng));
+                points.push_back(p);
+                wide.push_back(Vector2<double>(p.x, p.y));
+            }
+
+            for (Shape2D<float>* shape: shapes)
+                TEST_CHECK(test_batch_queries(*shape, points, executor));
+
+            auto table = UnitCircleCache<float>::table(12);
+            QueryFrame<float> frame { 1, -2, std::cos(0.5f), std::sin(0.5f) };
+            TEST_CHECK(test_query_paths(points, frame, CircleQuery<float>{ 7 }));
+            TEST_CHECK(test_query_paths(points, frame, RectangleQuery<float>{ 6, 2.5f }));
+            TEST_CHECK(test_query_paths(points, frame, NGonQuery<float>(6, 9, table->data())));
+
+            // Double shapes take the scalar batch kernels
+            Circle<double> double_circle(7, 1, 2);
+            NGon<double> double_hexagon(6, 9, Vector2<double>(2, -1), 15);
+            TEST_CHECK(test_batch_queries<double>(double_circle, wide, executor));
+            TEST_CHECK(test_batch_queries<double>(double_hexagon, wide, executor));
+        }
+    });
+}
+
+
+
+// Checks a hit against the expected distance and normal, as the only shape hit
+template <typename Real>
+bool test_hit(const RayHit<Real>& hit, double t, Vector2<double> normal) {
+    return hit.shape == 0 && std::abs(hit.t - t) <= 1e-4 * (1 + t) &&
+           std::abs(hit.normal.x - normal.x) <= 1e-4 && std::abs(hit.normal.y - normal.y) <= 1e-4;
+}
+
+// Casts one ray at a shape both on its own and through a RayCaster, whose packets take the vectorized
+// kernels for float shapes, and checks both hits
+template <typename T>
+bool test_ray(Shape2D<T>& shape, Ray2D<T> ray, double t, Vector2<double> normal) {
+    using Real = typename Shape2D<T>::Real;
+    std::vector<Shape2D<T>*> scene { &shape };
+    std::vector<Ray2D<T>> rays(11, ray);
+    std::vector<RayHit<Real>> hits(rays.size());
+    RayCaster<T> caster;
+    caster.cast(scene, rays, hits);
+
+    bool same = true;
+    for (const RayHit<Real>& hit: hits)
+        same = same && hit.t == hits[0].t && hit.normal == hits[0].normal && hit.shape == hits[0].shape;
+    return same && test_hit(shape.raycast(ray), t, normal) && test_hit(hits[0], t, normal);
+}
+
+template <typename T>
+bool test_ray_miss(Shape2D<T>& shape, Ray2D<T> ray) {
+    using Real = typename Shape2D<T>::Real;
+    std::vector<Shape2D<T>*> scene { &shape };
+    std::vector<RayHit<Real>> hits(1);
+    RayCaster<T>().cast(scene, std::span<const Ray2D<T>>(&ray, 1), hits);
+    RayHit<Real> hit = shape.raycast(ray);
+    return !hit.hit() && std::isinf(hit.t) && !hits[0].hit() && std::isinf(hits[0].t);
+}
+
+// Hits of every shape type at known distances and normals
+template <typename T>
+void test_ray_shapes() {
+    using V = Vector2<T>;
+    const double root3 = std::sqrt(3.0);
+
+    // Distances are measured in lengths of the direction, and rays starting inside hit at 0
+    for (T radius: { T(2), T(-2) }) {
+        Circle<T> circle(radius, 10, 0);
+        TEST_CHECK(test_ray(circle, Ray2D<T>(V(0, 0), V(1, 0)), 8, Vector2<double>(-1, 0)));
+        TEST_CHECK(test_ray(circle, Ray2D<T>(V(0, 0), V(2, 0)), 4, Vector2<double>(-1, 0)));
+        TEST_CHECK(test_ray(circle, Ray2D<T>(V(0, 1), V(1, 0)), 10 - root3, Vector2<double>(-root3 / 2, 0.5)));
+        TEST_CHECK(test_ray(circle, Ray2D<T>(V(10, T(0.5)), V(0, 1)), 0, Vector2<double>(0, 0)));
+        TEST_CHECK(test_ray_miss(circle, Ray2D<T>(V(0, 0), V(-1, 0))));
+        TEST_CHECK(test_ray_miss(circle, Ray2D<T>(V(0, 3), V(1, 0))));
+    }
+
+    // Normals are rotated back out of the rectangle's frame
+    for (float rotation: { 0.0f, 30.0f, 90.0f, -120.0f }) {
+        Rectangle<T> rectangle(4, 2, 10, 5, rotation);
+        double radians = rotation * (M_PI / 180);
+        Vector2<double> u(std::cos(radians), std::sin(radians)), v(-u.y, u.x);
+        V center(10, 5);
+        auto from = [&](Vector2<double> direction, double distance) {
+            return Ray2D<T>(V(static_cast<T>(center.x + (direction.x * distance)), static_cast<T>(center.y + (direction.y * distance))),
+                            V(static_cast<T>(-direction.x), static_cast<T>(-direction.y)));
+        };
+        TEST_CHECK(test_ray(rectangle, from(u, 10), 8, u));
+        TEST_CHECK(test_ray(rectangle, from(v * -1.0, 6), 5, v * -1.0));
+        TEST_CHECK(test_ray(rectangle, Ray2D<T>(center, V(1, 1)), 0, Vector2<double>(0, 0)));
+        TEST_CHECK(test_ray_miss(rectangle, from(u, -10)));
+    }
+
+    // Rays aimed at the middle of every edge of an N-Gon hit it along the edge's normal
+    for (T radius: { T(10), T(-10) }) {
+        for (float rotation: { 0.0f, 15.0f, 200.0f }) {
+            NGon<T> hexagon(6, radius, V(3, -4), rotation);
+            FixedNGon<T, 6> fixed(radius, V(3, -4), rotation);
+            std::vector<V> vertices = hexagon.vertices();
+            Vector2<double> center(3, -4);
+            for (size_t i = 0; i < 6; i++) {
+                Vector2<double> a(vertices[i].x, vertices[i].y), b(vertices[(i + 1) % 6].x, vertices[(i + 1) % 6].y);
+                Vector2<double> out = ((a + b) / 2.0) - center;
+                out /= std::sqrt((out.x * out.x) + (out.y * out.y));
+                Ray2D<T> ray(V(static_cast<T>(center.x + (out.x * 20)), static_cast<T>(center.y + (out.y * 20))),
+                             V(static_cast<T>(-out.x), static_cast<T>(-out.y)));
+                TEST_CHECK(test_ray(hexagon, ray, 20 - (5 * root3), out));
+                TEST_CHECK(test_ray(fixed, ray, 20 - (5 * root3), out));
+            }
+            TEST_CHECK(test_ray_miss(hexagon, Ray2D<T>(V(3, 8), V(1, 0))));
+        }
+    }
+
+    // Polygons hit their nearest crossed edge, including inside a notch
+    Polygon<T> notch = Polygon<T>::fromVertices({ V(0, 0), V(6, 0), V(6, 6), V(4, 6), V(4, 2), V(2, 2), V(2, 6), V(0, 6) });
+    TEST_CHECK(test_ray(notch, Ray2D<T>(V(-3, 1), V(1, 0)), 3, Vector2<double>(-1, 0)));
+    TEST_CHECK(test_ray(notch, Ray2D<T>(V(3, 10), V(0, -1)), 8, Vector2<double>(0, 1)));
+    TEST_CHECK(test_ray(notch, Ray2D<T>(V(1, 1), V(0, 1)), 0, Vector2<double>(0, 0)));
+    TEST_CHECK(test_ray_miss(notch, Ray2D<T>(V(3, 10), V(0, 1))));
+}
+
+// Random rays at a random scene, giving the number of rays a packet doesn't divide
+template <typename T>
+bool test_ray_modes(size_t shape_count, size_t ray_count) {
+    using Real = typename Shape2D<T>::Real;
+    std::mt19937 rng(31);
+    std::uniform_real_distribution<T> coordinate(-100, 100), size(1, 8), angle(0, 360), direction(-1, 1);
+
+    std::vector<std::unique_ptr<Shape2D<T>>> owned;
+    for (size_t i = 0; i < shape_count; i++) {
+        Vector2<T> position(coordinate(rng), coordinate(rng));
+        switch (i % 4) {
+        case 0:  owned.push_back(std::make_unique<Circle<T>>(size(rng), position)); break;
+        case 1:  owned.push_back(std::make_unique<Rectangle<T>>(size(rng), size(rng), position, angle(rng))); break;
+        case 2:  owned.push_back(std::make_unique<NGon<T>>(5, size(rng), position, angle(rng))); break;
+        default: {
+            std::vector<Vector2<T>> outline;
+            for (Vector2<float> p: test_star(rng, 5, Vector2<float>(position.x, position.y)))
+                outline.emplace_back(p.x, p.y);
+            owned.push_back(std::make_unique<Polygon<T>>(Polygon<T>::fromVertices(outline)));
+            break;
+        }
+        }
+    }
+
+    // Copies of a few shapes tie with them, and the lower id must win in every mode
+    for (size_t i = 0; i < shape_count && i < 32; i += 4)
+        owned.push_back(std::make_unique<Circle<T>>(*static_cast<Circle<T>*>(owned[i].get())));
+
+    std::vector<Shape2D<T>*> scene;
+    for (auto &shape: owned)
+        scene.push_back(shape.get());
+
+    std::vector<Ray2D<T>> rays;
+    for (size_t i = 0; i < ray_count; i++)
+        rays.emplace_back(Vector2<T>(coordinate(rng), coordinate(rng)), Vector2<T>(direction(rng), direction(rng)));
+
+    BVH<T> bvh;
+    bvh.build(scene);
+    Executor executor(3);
+    RayCaster<T> caster;
+    std::vector<RayHit<Real>> flat(ray_count), indexed(ray_count), flat_split(ray_count), indexed_split(ray_count);
+    caster.cast(scene, rays, flat);
+    caster.cast(scene, bvh, rays, indexed);
+    caster.cast(scene, rays, flat_split, executor);
+    caster.cast(scene, bvh, rays, indexed_split, executor);
+
+    size_t hits = 0;
+    bool same = true;
+    for (size_t i = 0; i < ray_count; i++) {
+        for (auto *other: { &indexed, &flat_split, &indexed_split }) {
+            const RayHit<Real>& hit = (*other)[i];
+            same = same && hit.t == flat[i].t && hit.normal == flat[i].normal && hit.shape == flat[i].shape;
+        }
+        same = same && (flat[i].shape < shape_count || !flat[i].hit());
+        hits += flat[i].hit();
+    }
+    return same && hits >= ray_count / 8;
+}
+
+
+
+// Rays hit every shape at its exact distance, and every way of casting a scene gives the same hits
+void test_raycasting(TestRunner& runner) {
+    runner.run("Rays hit every shape at its analytic distance and normal", [] {
+        test_ray_shapes<float>();
+        test_ray_shapes<double>();
+    });
+
+    runner.run("Flat and BVH casts give identical hits", [] {
+        TEST_CHECK(test_ray_modes<float>(301, 1001));
+        TEST_CHECK(test_ray_modes<double>(301, 1001));
+        TEST_CHECK(test_ray_modes<float>(3, 5));
+    });
+
+    runner.run("Lanes without a ray keep a distance of -1", [] {
+        // The missing lanes hold rays from the origin, inside the circle, which would hit it at 0
+        Circle<float> circle(5);
+        Ray2D<float> ray(Vector2<float>(-10, 0), Vector2<float>(1, 0));
+        std::vector<Ray2D<float>> rays(3, ray);
+
+        RayPacket<float> packet;
+        packet.load(std::span<const Ray2D<float>>(rays));
+        ray_cast_packet(QueryFrame<float>(), CircleQuery<float>{ 5 }, packet, 0);
+        RayPacket<double> wide;
+        wide.load(std::span<const Ray2D<float>>(rays));
+        ray_cast_packet(QueryFrame<double>(), CircleQuery<double>{ 5 }, wide, 0);
+
+        bool kept = packet.count == 3 && wide.count == 3;
+        for (size_t i = 0; i < ray_packet_size; i++) {
+            bool loaded = i < 3;
+            kept = kept && packet.hit(i).t == (loaded ? 5.0f : -1.0f) && packet.hit(i).hit() == loaded;
+            kept = kept && wide.hit(i).t == (loaded ? 5.0 : -1.0) && wide.hit(i).hit() == loaded;
+        }
+        TEST_CHECK(kept);
+
+        // Only the hits of loaded rays are stored, and the RayCaster writes no further than its rays and hits
+        std::vector<RayHit<float>> stored(ray_packet_size);
+        packet.store(stored);
+        TEST_CHECK(stored[2].t == 5 && stored[3].t == std::numeric_limits<float>::infinity() && !stored[7].hit());
+
+        std::vector<Shape2D<float>*> scene { &circle };
+        std::vector<RayHit<float>> hits(5);
+        RayCaster<float> caster;
+        caster.cast(scene, rays, hits);
+        TEST_CHECK(hits[2].t == 5 && hits[2].shape == 0 && !hits[3].hit() && std::isinf(hits[4].t));
+        hits.assign(5, RayHit<float>());
+        caster.cast(scene, rays, std::span<RayHit<float>>(hits).first(1));
+        TEST_CHECK(hits[0].t == 5 && !hits[1].hit() && !hits[3].hit());
+
+        // Empty scenes and empty ray lists hit nothing
+        std::vector<RayHit<float>> none(3);
+        caster.cast(std::vector<Shape2D<float>*>{}, rays, none);
+        TEST_CHECK(!none[0].hit() && std::isinf(none[2].t));
+        caster.cast(scene, std::vector<Ray2D<float>>{}, none);
+        TEST_CHECK(!none[0].hit());
+    });
+
+    runner.run("Ties between shapes go to the lower id", [] {
+        // Both outlines are exactly 8 along the ray
+        Circle<float> circle(2, 10, 0);
+        Rectangle<float> rectangle(2, 6, 9, 0);
+        Ray2D<float> ray(Vector2<float>(0, 0), Vector2<float>(1, 0));
+        TEST_CHECK(circle.raycast(ray).t == 8 && rectangle.raycast(ray).t == 8);
+
+        for (bool circle_first: { true, false }) {
+            std::vector<Shape2D<float>*> scene;
+            if (circle_first)
+                scene = { &circle, &rectangle };
+            else
+                scene = { &rectangle, &circle };
+            BVH<float> bvh;
+            bvh.build(scene);
+
+            std::vector<Ray2D<float>> rays(9, ray);
+            std::vector<RayHit<float>> flat(rays.size()), indexed(rays.size());
+            RayCaster<float> caster;
+            caster.cast(scene, rays, flat);
+            caster.cast(scene, bvh, rays, indexed);
+            TEST_CHECK(flat[0].shape == 0 && indexed[0].shape == 0 && flat[8].shape == 0 && indexed[8].shape == 0);
+            TEST_CHECK(flat[0].t == 8 && flat[0].normal == Vector2<float>(-1, 0));
+        }
+
+        // Within a packet, whichever order the shapes are cast in
+        for (uint32_t first: { 1u, 3u }) {
+            uint32_t second = first == 1 ? 3 : 1;
+            RayPacket<float> packet;
+            packet.load(std::span<const Ray2D<float>>(&ray, 1));
+            ray_cast_packet(QueryFrame<float>{ 10, 0, 1, 0 }, CircleQuery<float>{ 2 }, packet, first);
+            ray_cast_packet(QueryFrame<float>{ 10, 0, 1, 0 }, CircleQuery<float>{ 2 }, packet, second);
+            RayPacket<double> wide;
+            wide.load(std::span<const Ray2D<float>>(&ray, 1));
+            ray_cast_packet(QueryFrame<double>{ 10, 0, 1, 0 }, CircleQuery<double>{ 2 }, wide, first);
+            ray_cast_packet(QueryFrame<double>{ 10, 0, 1, 0 }, CircleQuery<double>{ 2 }, wide, second);
+            TEST_CHECK(packet.hit(0).shape == 1 && wide.hit(0).shape == 1);
+        }
+    });
+}
+
+
+
+// Rasterized cells agree with the point queries of the shapes drawn into them
+void test_raster(TestRunner& runner) {
+    runner.run("Grids without cells draw nothing", [] {
+        Circle<float> circle(5, 2, 2);
+        std::vector<Shape2D<float>*> scene = { &circle };
+        Rasterizer<float> rasterizer;
+        Executor executor(2);
+
+        for (auto [width, height]: { std::pair<size_t, size_t>(0, 100), { 100, 0 }, { 0, 0 } }) {
+            RasterGrid<float> grid { Vector2<float>(0, 0), 0.5f, width, height };
+            std::vector<uint8_t> cells;
+            std::vector<uint64_t> bits;
+            TEST_CHECK(rasterizer.rasterize(scene, grid, cells));
+            TEST_CHECK(rasterizer.rasterize(scene, grid, cells, executor, RasterMode::Coverage));
+            TEST_CHECK(rasterizer.rasterize(scene, grid, bits));
+            TEST_CHECK(rasterizer.rasterize(scene, grid, bits, executor));
+        }
+    });
+
+    runner.run("Large polygons rasterize like their point queries", [] {
+        // A wavy ring of 100k vertices, hanging off the bottom of the grid
+        constexpr size_t n = 100000;
+        std::mt19937 rng(25);
+        std::uniform_real_distribution<float> noise(-2, 2);
+        std::vector<Vector2<float>> outline(n);
+        for (size_t i = 0; i < n; i++) {
+            float angle = static_cast<float>(i) * 6.2831853f / n;
+            float radius = 200 + (60 * std::sin(angle * 37)) + noise(rng);
+            outline[i] = Vector2<float>(radius * std::cos(angle), radius * std::sin(angle));
+        }
+        Polygon<float> polygon(outline, Vector2<float>(300, 120), 15);
+        polygon.scale(1.5f);
+
+        std::vector<Shape2D<float>*> scene = { &polygon };
+        RasterGrid<float> grid { Vector2<float>(0, 0), 1, 700, 500 };
+        std::vector<uint64_t> bits(grid.wordCount());
+        std::vector<uint8_t> coverage(grid.cellCount());
+        Rasterizer<float> rasterizer;
+        Executor executor(2);
+        TEST_CHECK(rasterizer.rasterize(scene, grid, bits, executor));
+        TEST_CHECK(rasterizer.rasterize(scene, grid, coverage, RasterMode::Coverage));
+
+        // Cells whose centers are near the outline may go either way
+        std::uniform_int_distribution<size_t> column(0, grid.width - 1), row(0, grid.height - 1);
+        for (int sample = 0; sample < 2000; sample++) {
+            size_t x = column(rng), y = row(rng);
+            float distance = polygon.signedDistance(Vector2<float>(x + 0.5f, y + 0.5f));
+            if (std::abs(distance) < 0.01f)
+                continue;
+            bool occupied = (bits[(y * grid.wordsPerRow()) + (x / 64)] >> (x % 64)) & 1;
+            TEST_CHECK(occupied == (distance < 0));
+            if (std::abs(distance) > 1)
+                TEST_CHECK(coverage[(y * grid.width) + x] == (distance < 0 ? 255 : 0));
+        }
+    });
+}
+
+
+
+// Deferred transforms are seen by every reader, whether or not it flushes the shape first
+void test_transform(TestRunner& runner) {
+    using Transform = Transform2D<float>;
+
+    runner.run("Readers see pending transforms", [] {
+        auto scaled = [] {
+            Circle<float> circle(5, 1, 2);
+            TEST_CHECK(circle.transform(Transform::scaling(2)));
+            return circle;
+        };
+
+        Circle<float> circle = scaled();
+        TEST_CHECK(std::abs(circle.area() - 314.159f) < 0.01f);
+        TEST_CHECK(circle.radius == 10 && circle.position == Vector2<float>(2, 4));
+        TEST_CHECK(std::abs(scaled().perimeter() - 62.8319f) < 0.001f);
+        TEST_CHECK(scaled().json() == circle.json() && scaled().str() == circle.str());
+
+        // Const readers can't flush, so they read a flushed copy and leave the transform pending
+        const Circle<float> pending = scaled();
+        std::string json;
+        pending.json(json);
+        TEST_CHECK(json == circle.json() && pending.hasPendingTransform());
+
+        CircleBatch<float> batch;
+        batch.push_back(pending);
+        TEST_CHECK(batch.radius[0] == 10 && batch.position[0] == Vector2<float>(2, 4));
+
+        Collider2D<float> collider = make_collider(pending);
+        TEST_CHECK(collider.radius == 10 && collider.center == Vector2<float>(2, 4));
+
+        // The pending scale makes the circles overlap
+        CollisionPipeline<float> pipeline(1);
+        pipeline.add(pending);
+        pipeline.add(Circle<float>(1, 12, 4));
+        TEST_CHECK(pipeline.detect().size() == 1);
+
+        FixedNGon<float, 6> hexagon(3);
+        TEST_CHECK(hexagon.transform(Transform::rotation(30).then(Transform::scaling(2))));
+        TEST_CHECK(hexagon.toNGon().radius == 6 && std::abs(hexagon.toNGon().rotation - 30) < 1e-4f);
+        TEST_CHECK(std::abs(hexagon.inradius() - 6 * std::cos(float(M_PI) / 6)) < 1e-4f);
+    });
+
+    runner.run("Chains of transformative calls are deferred", [] {
+        Rectangle<float> rectangle(2, 1, 5, 5);
+        rectangle.rotateFrom(90, Vector2<float>(0, 0));
+        rectangle.move(1, 2);
+        rectangle.scaleFrom(2, Vector2<float>(0, 0));
+        rectangle.rotateFrom(370, Vector2<float>(-8, 14));
+
+        // Only the position waits for the flush, the rotation and size change right away
+        TEST_CHECK(rectangle.hasPendingTransform() && rectangle.position == Vector2<float>(5, 5));
+        TEST_CHECK(rectangle.rotation == 460 && rectangle.size == Vector2<float>(4, 2));
+        Vector2<float> position = rectangle.getPosition();
+        TEST_CHECK(!rectangle.hasPendingTransform() && rectangle.rotation == 460);
+        TEST_CHECK(std::abs(position.x + 8) < 1e-4f && std::abs(position.y - 14) < 1e-4f);
+
+        // The same chain applied by hand, one call at a time. rotate_point evaluates the trig of a float Angle.
+        Circle<double> circle(1, 3, -2), expected = circle;
+        for (int i = 0; i < 50; i++) {
+            circle.rotateFrom(7.5, Vector2<double>(1, 1));
+            circle.move(0.25, -0.5);
+            circle.scaleFrom(1.01, Vector2<double>(-2, 0));
+            expected.position = rotate_point(expected.position, Vector2<double>(1, 1), 7.5) + Vector2<double>(0.25, -0.5);
+            expected.position = ((expected.position - Vector2<double>(-2, 0)) * 1.01) + Vector2<double>(-2, 0);
+        }
+        TEST_CHECK(circle.hasPendingTransform() && circle.rotation == 375);
+        TEST_CHECK(std::abs(circle.radius - std::pow(1.01, 50)) < 1e-12);
+        Vector2<double> difference = circle.getPosition() - expected.position;
+        TEST_CHECK(std::abs(difference.x) < 1e-5 && std::abs(difference.y) < 1e-5);
+
+        // moveTo replaces the position, while a pending transform() still rotates and scales the shape
+        TEST_CHECK(circle.transform(Transform2D<double>::rotation(30).then(Transform2D<double>::scaling(2))));
+        circle.move(5, 5);
+        circle.moveTo(1, 2);
+        TEST_CHECK(circle.hasPendingTransform() && circle.getPosition() == Vector2<double>(1, 2));
+        TEST_CHECK(std::abs(circle.rotation - 405) < 1e-9 && std::abs(circle.radius - 2 * std::pow(1.01, 50)) < 1e-9);
+
+        // Integer shapes move right away, exactly
+        Rectangle<int> square(2, 2, 7, 3);
+        square.rotateFrom(90, Vector2<int>(1, 1));
+        square.move(1, 1);
+        square.scaleFrom(3, Vector2<int>(0, 0));
+        TEST_CHECK(!square.hasPendingTransform() && square.position == Vector2<int>(0, 24) && square.size == Vector2<int>(6, 6));
+    });
+
+    runner.run("Integer shapes round scaled sizes", [] {
+        Rectangle<int> rectangle(3, 3, 2, 2);
+        TEST_CHECK(rectangle.transform(Transform::scaling(1.5f)));
+        TEST_CHECK(rectangle.area() == 25);
+        TEST_CHECK(rectangle.size == Vector2<int>(5, 5) && rectangle.position == Vector2<int>(3, 3));
+
+        NGon<int> ngon(5, 10);
+        TEST_CHECK(ngon.transform(Transform::scaling(0.66f)));
+        TEST_CHECK(ngon.circumradius() == 7);
+    });
+
+    runner.run("Only similarity transforms are accepted", [] {
+        Rectangle<float> rectangle(2, 1);
+        TEST_CHECK(!rectangle.transform(Transform::scaling(Vector2<float>(-1, 1))));
+        TEST_CHECK(!rectangle.transform(Transform::rotation(30).then(Transform::scaling(Vector2<float>(1, -1)))));
+        TEST_CHECK(!rectangle.transform(Transform::scaling(Vector2<float>(2, 1))));
+        TEST_CHECK(!rectangle.transform(Transform(1, 0, 0.5f, 1, 0, 0)));
+        TEST_CHECK(!rectangle.transform(Transform::scaling(0)));
+        TEST_CHECK(!rectangle.hasPendingTransform() && rectangle.size == Vector2<float>(2, 1));
+
+        // Many composed rotations and scales are still similarities
+        Transform composed;
+        for (int i = 0; i < 1000; i++)
+            composed = composed.then(Transform::rotation(0.37f)).then(Transform::scaling(1.001f));
+        TEST_CHECK(rectangle.transform(composed));
+        // The rotation of the composed matrix is read back in (-180, 180]
+        TEST_CHECK(std::abs(rectangle.getRotation() - 10) < 0.01f);
+    });
+}
+
+
+
+// Instrumentation left disabled compiles every hook to nothing, see test_instrument.cpp for it enabled
+#define TEST_STRING(...) #__VA_ARGS__
+#define TEST_EXPANDED(...) TEST_STRING(__VA_ARGS__)
+
+void test_instrumentation(TestRunner& runner) {
+    runner.run("Disabled instrumentation compiles to nothing", [] {
+        static_assert(std::string_view(TEST_EXPANDED(INSTRUMENT_SCOPE("Circle::vertices"))) == "((void)0)");
+        static_assert(std::string_view(TEST_EXPANDED(INSTRUMENT_COUNT(TrigEvaluations, 2))) == "((void)0)");
+        static_assert(std::string_view(TEST_EXPANDED(INSTRUMENT_BUFFER(list, 64))) == "((void)0)");
+        static_assert(std::string_view(TEST_EXPANDED(INSTRUMENT_SERIALIZATION(out))) == "((void)0)");
+
+        Circle<float> circle(5, 1, 2);
+        circle.vertices(64);
+        circle.json();
+        circle.rotateFrom(30, Vector2<float>(0, 0));
+        circle.flush();
+        rotate_point(Vector2<float>(1, 0), Vector2<float>(0, 0), 45.0f);
+        InstrumentCounters counters = instrument_snapshot();
+        TEST_CHECK(counters.trigEvaluations() == 0 && counters.vertexBuffers() == 0 && counters.vertexBytes() == 0);
+        TEST_CHECK(counters.serializations() == 0 && counters.transformCalls() == 0);
+    });
+}
+
+#undef TEST_EXPANDED
+#undef TEST_STRING
+
+
+
+int main(int argc, char** argv) {
+    TestRunner runner(argc, argv);
+
+    test_shape_file(runner);
+    test_json(runner);
+    test_spatial(runner);
+    test_collision(runner);
+    test_parallel(runner);
+    test_batch(runner);
+    test_fixed_point(runner);
+    test_detail(runner);
+    test_polygon(runner);
+    test_tessellation(runner);
+    test_point_queries(runner);
+    test_raycasting(runner);
+    test_raster(runner);
+    test_transform(runner);
+    test_instrumentation(runner);
+
+    return runner.finish();
+}
@@ -0,0 +1,258 @@
+/// Author: PlumpDolphin
+/// Date: October 16, 2026
+///
+/// Description:
+///     Provides the Transform2D class, a 2D affine transform stored as a 2x3 matrix.
+///     Transforms can be composed, inverted, and applied to single points or whole arrays of points,
+///     so a chain of moves, rotations and scales costs a single matrix multiply per point once it is composed.
+///     Shapes use it to defer their transforms until their position, vertices or bounds are needed.
+///
+/// License:
+///     The code in this file is licensed under the
+///     Revised 3-Clause BSD License.
+///     For details, see https://opensource.org/licenses/BSD-3-Clause
+
+
+#pragma once
+
+#define _USE_MATH_DEFINES // This allows access of the Pi definition, M_PI, from <cmath>
+
+#include <cmath>
+#include <limits>
+#include <span>
+#include <string>
+#include <type_traits>
+
+#include "vectorx.h"     // Includes definition for Vector2<T>.
+#include "vectorarray.h" // Includes definition for VectorArray2<T> used by the bulk functions.
+#include "executor.h"    // Includes definition for Executor used by the parallel bulk functions.
+#include "instrument.h"  // Includes the optional counters of the hot paths.
+
+
+
+// Example usage showing composition and application.
+/*
+    // Rotate 90 degrees around (1, 1), then double in size, then move up by 5
+    Transform2D<float> t = Transform2D<float>::rotation(90, Vector2<float>(1, 1))
+                               .then(Transform2D<float>::scaling(2))
+                               .then(Transform2D<float>::translation(Vector2<float>(0, 5)));
+
+    // Apply to a single point
+    Vector2<float> p = t.apply(Vector2<float>(3, 1));
+
+    // Undo it again
+    Vector2<float> q = t.inverse().apply(p);
+
+    // Apply to many points at once, in place
+    std::vector<Vector2<float>> points = ...;
+    t.apply(points, points);
+
+    // Or to points stored as lanes
+    VectorArray2<float> lanes(points);
+    t.apply(lanes, lanes);
+*/
+
+
+
+
+
+// A 2D affine transform, mapping a point (x, y) to
+//     (a * x + c * y + tx,
+//      b * x + d * y + ty)
+// T should be a floating-point type.
+template <typename T>
+class Transform2D {
+    static_assert(std::is_floating_point_v<T>, "Transform2D requires a floating-point type");
+
+public:
+    // Data
+    // The columns (a, b) and (c, d) are the images of the x and y axes, and (tx, ty) is the image of the origin.
+    T a, b, c, d;
+    T tx, ty;
+
+
+
+    // Default constructor, which is the identity transform
+    constexpr Transform2D()
+        : a(1), b(0), c(0), d(1), tx(0), ty(0) {}
+
+    // Matrix constructor
+    constexpr Transform2D(T a, T b, T c, T d, T tx, T ty)
+        : a(a), b(b), c(c), d(d), tx(tx), ty(ty) {}
+
+
+
+    // Factory functions
+    static constexpr Transform2D identity() { return Transform2D(); }
+
+    static constexpr Transform2D translation(Vector2<T> offset) {
+        return Transform2D(1, 0, 0, 1, offset.x, offset.y);
+    }
+
+    // Counter-clockwise rotation around the origin, matching rotate_point
+    static Transform2D rotation(T degrees) {
+        INSTRUMENT_COUNT(TrigEvaluations, 2);
+        T radians = degrees * static_cast<T>(M_PI / 180);
+        T cosine = std::cos(radians);
+        T sine = std::sin(radians);
+        return Transform2D(cosine, sine, -sine, cosine, 0, 0);
+    }
+
+    static Transform2D rotation(T degrees, Vector2<T> origin) {
+        return _about(rotation(degrees), origin);
+    }
+
+    static constexpr Transform2D scaling(T scalar) { return Transform2D(scalar, 0, 0, scalar, 0, 0); }
+    static constexpr Transform2D scaling(Vector2<T> scalar) { return Transform2D(scalar.x, 0, 0, scalar.y, 0, 0); }
+
+    static constexpr Transform2D scaling(T scalar, Vector2<T> origin) {
+        return _about(scaling(scalar), origin);
+    }
+
+
+
+    // Composition
+    // (first * second) applies second, then first, the same as matrix multiplication.
+    constexpr Transform2D operator* (const Transform2D& o) const {
+        return Transform2D((a * o.a) + (c * o.b),
+                           (b * o.a) + (d * o.b),
+                           (a * o.c) + (c * o.d),
+                           (b * o.c) + (d * o.d),
+                           (a * o.tx) + (c * o.ty) + tx,
+                           (b * o.tx) + (d * o.ty) + ty);
+    }
+
+    constexpr Transform2D& operator*= (const Transform2D& o) { return *this = *this * o; }
+
+    // Applies this transform, then the next one. Reads left to right when chaining.
+    constexpr Transform2D then(const Transform2D& next) const { return next * *this; }
+
+
+
+    // Utility functions
+    constexpr T determinant() const { return (a * d) - (b * c); }
+    constexpr bool invertible() const { return determinant() != 0; }
+    constexpr bool isIdentity() const { return a == 1 && b == 0 && c == 0 && d == 1 && tx == 0 && ty == 0; }
+
+    // Returns the transform that undoes this one. A transform that isn't invertible returns the identity.
+    constexpr Transform2D inverse() const {
+        T det = determinant();
+        if (det == 0)
+            return Transform2D();
+
+        T ia = d / det;
+        T ib = -b / det;
+        T ic = -c / det;
+        T id = a / det;
+        return Transform2D(ia, ib, ic, id, -((ia * tx) + (ic * ty)), -((ib * tx) + (id * ty)));
+    }
+
+    // Rotation of the x axis in degrees
+    T rotationAngle() const { return std::atan2(b, a) * static_cast<T>(180 / M_PI); }
+
+    // Uniform scale factor, which is exact for transforms built from rotations, uniform scales and translations
+    T scaleFactor() const { return std::sqrt(std::abs(determinant())); }
+
+    // True if the transform only rotates, scales uniformly and translates, which keeps angles and handedness.
+    // Reflections, shears and non-uniform scales are not similarities. The matrix is compared with a relative
+    // tolerance of the square root of epsilon, so transforms composed from many rotations and scales still count.
+    bool isSimilarity() const {
+        T tolerance = std::sqrt(std::numeric_limits<T>::epsilon()) * (std::abs(a) + std::abs(b) + std::abs(c) + std::abs(d));
+        return determinant() > 0 && std::abs(a - d) <= tolerance && std::abs(b + c) <= tolerance;
+    }
+
+
+
+    // Applies the transform to a point
+    constexpr Vector2<T> apply(Vector2<T> p) const {
+        return Vector2<T>((a * p.x) + (c * p.y) + tx, (b * p.x) + (d * p.y) + ty);
+    }
+
+    // Applies the transform to a direction, ignoring the translation
+    constexpr Vector2<T> applyVector(Vector2<T> v) const {
+        return Vector2<T>((a * v.x) + (c * v.y), (b * v.x) + (d * v.y));
+    }
+
+
+    // Bulk application
+    // The input and output may be the same buffer to transform the points in place.
+
+    void apply(std::span<const Vector2<T>> in, std::span<Vector2<T>> out) const {
+        const Vector2<T>* src = in.data();
+        Vector2<T>* dst = out.data();
+        size_t count = in.size() < out.size() ? in.size() : out.size();
+
+        for (size_t i = 0; i < count; i++) {
+            T x = src[i].x;
+            T y = src[i].y;
+            dst[i].x = (a * x) + (c * y) + tx;
+            dst[i].y = (b * x) + (d * y) + ty;
+        }
+    }
+
+    // Structure-of-arrays variant, which keeps every lane contiguous for the vectorizer.
+    void apply(const VectorArray2<T>& in, VectorArray2<T>& out) const {
+        if (&in != &out)
+            out.resize(in.size());
+
+        _apply_lanes(in.x, in.y, out.x, out.y, 0, in.size());
+    }
+
+    // Parallel variants, which split the points over an executor. Results are the same as the variants above.
+    void apply(std::span<const Vector2<T>> in, std::span<Vector2<T>> out, Executor& executor) const {
+        size_t count = in.size() < out.size() ? in.size() : out.size();
+        parallel_for(executor, 0, count, [&](size_t begin, size_t end) {
+            apply(in.subspan(begin, end - begin), out.subspan(begin, end - begin));
+        });
+    }
+
+    void apply(const VectorArray2<T>& in, VectorArray2<T>& out, Executor& executor) const {
+        if (&in != &out)
+            out.resize(in.size());
+
+        parallel_for(executor, 0, in.size(), [&](size_t begin, size_t end) {
+            _apply_lanes(in.x, in.y, out.x, out.y, begin, end);
+        });
+    }
+
+
+
+    // Serializers
+    std::string str() const {
+        std::string out;
+        str(out);
+        return out;
+    }
+
+    void str(std::string& out) const {
+        out += "Transform2D { ";
+        const T values[6] = { a, b, c, d, tx, ty };
+        const char* names[6] = { "a", "b", "c", "d", "tx", "ty" };
+        for (int i = 0; i < 6; i++) {
+            if (i > 0)
+                out += ", ";
+            out += names[i];
+            out += ": ";
+            append_formatted(out, values[i]);
+        }
+        out += " }";
+    }
+
+
+
+private:
+    // Applies the transform to the elements [begin, end) of a pair of lanes
+    void _apply_lanes(const T* sx, const T* sy, T* dx, T* dy, size_t begin, size_t end) const {
+        for (size_t i = begin; i < end; i++) {
+            T x = sx[i];
+            T y = sy[i];
+            dx[i] = (a * x) + (c * y) + tx;
+            dy[i] = (b * x) + (d * y) + ty;
+        }
+    }
+
+    // Conjugates a transform so it acts around a point rather than the origin
+    static constexpr Transform2D _about(const Transform2D& t, Vector2<T> origin) {
+        return translation(origin) * t * translation(Vector2<T>(-origin.x, -origin.y));
+    }
+};
@@ -0,0 +1,409 @@
+/// Author: PlumpDolphin
+/// Date: October 16, 2026
+///
+/// Description:
+///     Provides VectorArray2, VectorArray3, and VectorArray4 classes for bulk operations on large sets of vectors.
+///     Vectors are stored as a structure of arrays: every dimension lives in its own aligned lane (x[], y[], ...),
+///     so each operator is a single tight loop per lane that the compiler turns into packed SSE2, AVX2 or
+///     AVX-512 instructions, depending on the target flags. Without those flags the same loops run as scalar code.
+///
+/// License:
+///     The code in this file is licensed under the
+///     Revised 3-Clause BSD License.
+///     For details, see https://opensource.org/licenses/BSD-3-Clause
+
+
+#pragma once
+
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include "vectorx.h" // Includes definitions for Vector2<T>, Vector3<T> and Vector4<T>.
+
+
+
+// Example usage showing conversion and bulk arithmetic syntax.
+/*
+    // Existing lists of vectors can be converted to lanes and back again.
+    std::vector<Vector2<float>> points = { {1, 2}, {3, 4}, {5, 6} };
+    VectorArray2<float> a(points);
+
+    // Performing scalar arithmetic on every vector
+    a *= 2; // Multiplies every x and y by 2
+
+    // Performing arithmetic with a single vector on every vector
+    a += Vector2<float>(1, -1); // Offsets every point by (1, -1)
+
+    // Performing element-wise arithmetic across arrays of equal size
+    VectorArray2<float> b(3, Vector2<float>(2, 2));
+    auto c = a / b;
+
+    // Lanes can be read and written directly
+    c.x[0] = 0;
+
+    // Converting back to a list of vectors
+    std::vector<Vector2<float>> result = c.toVector();
+*/
+
+
+
+// Loop hint used by every kernel.
+// Lanes are separate allocations, so the loops never carry a dependency between iterations.
+#if defined(__clang__)
+    #define _ARRAY_VECTORIZE _Pragma("clang loop vectorize(enable) interleave(enable)")
+#elif defined(__GNUC__)
+    #define _ARRAY_VECTORIZE _Pragma("GCC ivdep")
+#elif defined(_MSC_VER)
+    #define _ARRAY_VECTORIZE __pragma(loop(ivdep))
+#else
+    #define _ARRAY_VECTORIZE
+#endif
+
+
+
+// Alignment of every lane in bytes.
+// 64 bytes covers a full AVX-512 register as well as a cache line.
+constexpr size_t VECTOR_ARRAY_ALIGNMENT = 64;
+
+template <typename T>
+inline T* _array_assume_aligned(T* lane) {
+#if defined(__cpp_lib_assume_aligned)
+    return std::assume_aligned<VECTOR_ARRAY_ALIGNMENT>(lane);
+#else
+    return lane;
+#endif
+}
+
+
+
+// Bulk kernels
+// Applies `f` to every element of one lane, taking the right hand side from another lane or a single value.
+template <typename T, typename F>
+inline void _array_kernel(T* dst, const T* lhs, const T* rhs, size_t count, F f) {
+    dst = _array_assume_aligned(dst);
+    lhs = _array_assume_aligned(lhs);
+    rhs = _array_assume_aligned(rhs);
+
+    _ARRAY_VECTORIZE
+    for (size_t i = 0; i < count; i++)
+        dst[i] = f(lhs[i], rhs[i]);
+}
+
+template <typename T, typename F>
+inline void _array_kernel(T* dst, const T* lhs, T rhs, size_t count, F f) {
+    dst = _array_assume_aligned(dst);
+    lhs = _array_assume_aligned(lhs);
+
+    _ARRAY_VECTORIZE
+    for (size_t i = 0; i < count; i++)
+        dst[i] = f(lhs[i], rhs);
+}
+
+
+
+// Defines which operators should be implemented by the VectorArray classes.
+// This matches the OPERATORS list of vectorx.h, including the assignment-variants.
+#define ARRAY_OPERATORS(func, ...) \
+    func(+, __VA_ARGS__)           \
+    func(-, __VA_ARGS__)           \
+    func(*, __VA_ARGS__)           \
+    func(/, __VA_ARGS__)           \
+    func(%, __VA_ARGS__)           \
+    func(&, __VA_ARGS__)           \
+    func(|, __VA_ARGS__)           \
+    func(^, __VA_ARGS__)           \
+    func(<<, __VA_ARGS__)          \
+    func(>>, __VA_ARGS__)
+
+
+
+// Define each VectorArray size's lane names, matching the named members of Vector2, Vector3 and Vector4.
+
+// PARAMS:
+// 0: Name of dimension  (x, y, z, etc)
+// 1: Is last element    (0 = False, 1 = True)
+// 2: Optional arguments (Set to __VA_ARGS__)
+#define _ARRAY_DIMS_2(func, ...) \
+    func(x, 0, __VA_ARGS__)      \
+    func(y, 1, __VA_ARGS__)
+
+#define _ARRAY_DIMS_3(func, ...) \
+    func(x, 0, __VA_ARGS__)      \
+    func(y, 0, __VA_ARGS__)      \
+    func(z, 1, __VA_ARGS__)
+
+#define _ARRAY_DIMS_4(func, ...) \
+    func(x, 0, __VA_ARGS__)      \
+    func(y, 0, __VA_ARGS__)      \
+    func(z, 0, __VA_ARGS__)      \
+    func(w, 1, __VA_ARGS__)
+
+
+
+// Formatting functions
+// The ones ending in 0 or 1 treat the last dimension differently.
+#define _ARRAY_LANE_DEF(dim, is_end, ...) T* dim = nullptr;
+#define _ARRAY_LANE_BIND(dim, is_end, ...) dim = _data + (lane++ * _capacity);
+
+#define _ARRAY_GET0(dim) dim[i],
+#define _ARRAY_GET1(dim) dim[i]
+#define _ARRAY_GET(dim, is_end, ...) _ARRAY_GET##is_end(dim)
+
+#define _ARRAY_SET(dim, is_end, ...) dim[i] = value.dim;
+#define _ARRAY_FILL(dim, is_end, ...) _array_kernel(dim, dim, value.dim, _count, [](T, T v) { return v; });
+#define _ARRAY_GATHER(dim, is_end, ...) dim[i] = list[i].dim;
+#define _ARRAY_SCATTER(dim, is_end, ...) out[i].dim = dim[i];
+
+
+
+// Operator helper functions
+// `other` is either one vector or another array, and _array_kernel takes its value or its lane to match.
+// Applies the operator to every element of every lane, storing the result in `this` array
+#define _ARRAY_SCALAR_THIS(dim, is_end, op) _array_kernel(dim, dim, scalar,    _count, [](T a, T b) -> T { return a op b; });
+#define _ARRAY_VECTOR_THIS(dim, is_end, op) _array_kernel(dim, dim, other.dim, _count, [](T a, T b) -> T { return a op b; });
+
+// Applies the operator to every element of every lane, storing the result in a temporary array
+#define _ARRAY_SCALAR_NEW(dim, is_end, op) _array_kernel(v.dim, dim, scalar,    _count, [](T a, T b) -> T { return a op b; });
+#define _ARRAY_VECTOR_NEW(dim, is_end, op) _array_kernel(v.dim, dim, other.dim, _count, [](T a, T b) -> T { return a op b; });
+
+
+
+/*** Defines template for creating bulk operator implementations for scalars, single vectors and other arrays. ***/
+#define _ARRAY_OP(op, dim)                                                           \
+    /* Create new array, applies scalar to every lane, and returns */                \
+    VectorArray##dim operator op(const T& scalar) const {                            \
+        VectorArray##dim v(_count);                                                  \
+        _ARRAY_DIMS_##dim( _ARRAY_SCALAR_NEW, op )                                  \
+        return v;                                                                    \
+    }                                                                                \
+                                                                                     \
+    /* Applies scalar to every lane of this array and returns it */                  \
+    VectorArray##dim& operator op##=(const T& scalar) {                              \
+        _ARRAY_DIMS_##dim( _ARRAY_SCALAR_THIS, op )                                 \
+        return *this;                                                                \
+    }                                                                                \
+                                                                                     \
+    /* Create new array, applies one vector to every element, and returns */         \
+    VectorArray##dim operator op(const Vector##dim<T>& other) const {                \
+        VectorArray##dim v(_count);                                                  \
+        _ARRAY_DIMS_##dim( _ARRAY_VECTOR_NEW, op )                                  \
+        return v;                                                                    \
+    }                                                                                \
+                                                                                     \
+    /* Applies one vector to every element of this array and returns it */           \
+    VectorArray##dim& operator op##=(const Vector##dim<T>& other) {                  \
+        _ARRAY_DIMS_##dim( _ARRAY_VECTOR_THIS, op )                                 \
+        return *this;                                                                \
+    }                                                                                \
+                                                                                     \
+    /* Create new array, applies other array element-wise, and returns */            \
+    VectorArray##dim operator op(const VectorArray##dim& other) const {              \
+        assert(other._count == _count);                                              \
+        VectorArray##dim v(_count);                                                  \
+        _ARRAY_DIMS_##dim( _ARRAY_VECTOR_NEW, op )                                  \
+        return v;                                                                    \
+    }                                                                                \
+                                                                                     \
+    /* Applies other array element-wise to this array and returns it */              \
+    VectorArray##dim& operator op##=(const VectorArray##dim& other) {                \
+        assert(other._count == _count);                                              \
+        _ARRAY_DIMS_##dim( _ARRAY_VECTOR_THIS, op )                                 \
+        return *this;                                                                \
+    }
+
+
+
+/*** Defines template for each VectorArray class implementation ***/
+#define _ARRAY_DEF(dim)                                                              \
+    template<typename T>                                                             \
+    class VectorArray##dim {                                                         \
+        static_assert(std::is_trivially_copyable_v<T>,                               \
+                      "VectorArray lanes must hold trivially copyable values.");     \
+    public:                                                                          \
+        static constexpr size_t dimensions = dim;                                    \
+                                                                                     \
+        /* Declares a pointer to the lane of every dimension */                      \
+        _ARRAY_DIMS_##dim( _ARRAY_LANE_DEF )                                        \
+                                                                                     \
+        /* Builds the VectorArray constructor functions */                           \
+        VectorArray##dim () {}                                                       \
+        explicit VectorArray##dim (size_t count) { resize(count); }                  \
+        VectorArray##dim (size_t count, const Vector##dim<T>& value) {               \
+            resize(count);                                                           \
+            fill(value);                                                             \
+        }                                                                            \
+        VectorArray##dim (const std::vector<Vector##dim<T>>& list) {                 \
+            resize(list.size());                                                     \
+            for (size_t i = 0; i < _count; i++) {                                    \
+                _ARRAY_DIMS_##dim( _ARRAY_GATHER )                                  \
+            }                                                                        \
+        }                                                                            \
+                                                                                     \
+        /* Copy and move semantics */                                                \
+        VectorArray##dim (const VectorArray##dim& other) { *this = other; }          \
+        VectorArray##dim (VectorArray##dim&& other) noexcept {                       \
+            *this = std::move(other);                                                \
+        }                                                                            \
+        VectorArray##dim& operator=(const VectorArray##dim& other) {                 \
+            if (this != &other) {                                                    \
+                resize(other._count);                                                \
+                for (size_t d = 0; d < dim; d++)                                     \
+                    _copy_lane(_lane(d), other._lane(d), _count);                    \
+            }                                                                        \
+            return *this;                                                            \
+        }                                                                            \
+        VectorArray##dim& operator=(VectorArray##dim&& other) noexcept {             \
+            if (this != &other) {                                                    \
+                _release();                                                          \
+                _data = other._data;                                                 \
+                _count = other._count;                                               \
+                _capacity = other._capacity;                                         \
+                _bind();                                                             \
+                other._data = nullptr;                                               \
+                other._count = other._capacity = 0;                                  \
+                other._bind();                                                       \
+            }                                                                        \
+            return *this;                                                            \
+        }                                                                            \
+        ~VectorArray##dim () { _release(); }                                         \
+                                                                                     \
+        /* Size management */                                                        \
+        size_t size() const     { return _count; }                                   \
+        size_t capacity() const { return _capacity; }                                \
+        bool empty() const      { return _count == 0; }                              \
+                                                                                     \
+        void clear() { _count = 0; }                                                 \
+        void resize(size_t count) {                                                  \
+            reserve(count);                                                          \
+            for (size_t d = 0; d < dim && count > _count; d++)                       \
+                std::memset(_lane(d) + _count, 0, (count - _count) * sizeof(T));     \
+            _count = count;                                                          \
+        }                                                                            \
+        void reserve(size_t count) {                                                 \
+            if (count <= _capacity)                                                  \
+                return;                                                              \
+                                                                                     \
+            /* Round each lane up so that every lane starts on an aligned address */ \
+            constexpr size_t step = VECTOR_ARRAY_ALIGNMENT / sizeof(T) > 0           \
+                                  ? VECTOR_ARRAY_ALIGNMENT / sizeof(T) : 1;          \
+            size_t capacity = ((count + step - 1) / step) * step;                    \
+            T* data = static_cast<T*>(::operator new(                                \
+                capacity * dim * sizeof(T),                                          \
+                std::align_val_t(VECTOR_ARRAY_ALIGNMENT)));                          \
+                                                                                     \
+            for (size_t d = 0; d < dim; d++)                                         \
+                _copy_lane(data + (d * capacity), _lane(d), _count);                 \
+                                                                                     \
+            _release();                                                              \
+            _data = data;                                                            \
+            _capacity = capacity;                                                    \
+            _bind();                                                                 \
+        }                                                                            \
+                                                                                     \
+        /* Element access */                                                         \
+        Vector##dim<T> get(size_t i) const {                                         \
+            return Vector##dim<T>( _ARRAY_DIMS_##dim( _ARRAY_GET ) );               \
+        }                                                                            \
+        Vector##dim<T> operator[](size_t i) const { return get(i); }                 \
+                                                                                     \
+        void set(size_t i, const Vector##dim<T>& value) {                            \
+            _ARRAY_DIMS_##dim( _ARRAY_SET )                                         \
+        }                                                                            \
+                                                                                     \
+        void push_back(const Vector##dim<T>& value) {                                \
+            if (_count == _capacity)                                                 \
+                reserve(_capacity ? _capacity * 2 : 1);                              \
+            set(_count++, value);                                                    \
+        }                                                                            \
+                                                                                     \
+        /* Sets every element to the same vector */                                  \
+        void fill(const Vector##dim<T>& value) {                                     \
+            _ARRAY_DIMS_##dim( _ARRAY_FILL )                                        \
+        }                                                                            \
+                                                                                     \
+        /* Conversion back to a list of vectors */                                   \
+        std::vector<Vector##dim<T>> toVector() const {                               \
+            std::vector<Vector##dim<T>> out;                                         \
+            toVector(out);                                                           \
+            return out;                                                              \
+        }                                                                            \
+                                                                                     \
+        /* Writes into an existing list, reusing its storage */                      \
+        void toVector(std::vector<Vector##dim<T>>& out) const {                      \
+            out.resize(_count);                                                      \
+            for (size_t i = 0; i < _count; i++) {                                    \
+                _ARRAY_DIMS_##dim( _ARRAY_SCATTER )                                 \
+            }                                                                        \
+        }                                                                            \
+                                                                                     \
+        /* Implements all of the supported operators */                              \
+        ARRAY_OPERATORS( _ARRAY_OP, dim )                                            \
+                                                                                     \
+    private:                                                                         \
+        T* _data = nullptr;                                                          \
+        size_t _count = 0;                                                           \
+        size_t _capacity = 0;                                                        \
+                                                                                     \
+        T* _lane(size_t d) const { return _data + (d * _capacity); }                 \
+                                                                                     \
+        static void _copy_lane(T* dst, const T* src, size_t count) {                 \
+            if (count > 0)                                                           \
+                std::memcpy(dst, src, count * sizeof(T));                            \
+        }                                                                            \
+                                                                                     \
+        void _bind() {                                                               \
+            size_t lane = 0;                                                         \
+            _ARRAY_DIMS_##dim( _ARRAY_LANE_BIND )                                   \
+        }                                                                            \
+                                                                                     \
+        void _release() {                                                            \
+            if (_data != nullptr)                                                    \
+                ::operator delete(_data, std::align_val_t(VECTOR_ARRAY_ALIGNMENT));  \
+            _data = nullptr;                                                         \
+        }                                                                            \
+    };
+
+
+
+// Build VectorArray class definitions
+_ARRAY_DEF(2)
+_ARRAY_DEF(3)
+_ARRAY_DEF(4)
+
+
+
+
+
+
+// Clean up all definitions to prevent collisions with other headers.
+#undef ARRAY_OPERATORS
+
+#undef _ARRAY_VECTORIZE
+
+#undef _ARRAY_DIMS_2
+#undef _ARRAY_DIMS_3
+#undef _ARRAY_DIMS_4
+
+#undef _ARRAY_LANE_DEF
+#undef _ARRAY_LANE_BIND
+
+#undef _ARRAY_GET
+#undef _ARRAY_GET0
+#undef _ARRAY_GET1
+
+#undef _ARRAY_SET
+#undef _ARRAY_FILL
+#undef _ARRAY_GATHER
+#undef _ARRAY_SCATTER
+
+#undef _ARRAY_SCALAR_THIS
+#undef _ARRAY_VECTOR_THIS
+#undef _ARRAY_SCALAR_NEW
+#undef _ARRAY_VECTOR_NEW
+
+#undef _ARRAY_OP
+#undef _ARRAY_DEF
@@ -0,0 +1,306 @@
+/// Author: PlumpDolphin
+/// Date: October 16, 2026
+///
+/// Description:
+///     Provides opt-in expression templates for Vector2/3/4 and VectorArray2/3/4.
+///     Wrapping an operand in lazy() makes the operators build a small expression tree instead of computing a result.
+///     The whole chain is then evaluated in a single pass, so `((a - origin) * s) + origin` over a VectorArray reads
+///     and writes every lane once, instead of once per operator with a full temporary array in between.
+///
+/// License:
+///     The code in this file is licensed under the
+///     Revised 3-Clause BSD License.
+///     For details, see https://opensource.org/licenses/BSD-3-Clause
+
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "vectorx.h"     // Includes definition for Vector<T, N>.
+#include "vectorarray.h" // Includes definitions for VectorArray2<T>, VectorArray3<T> and VectorArray4<T>.
+#include "executor.h"    // Includes definition for Executor used by the parallel assign().
+
+
+
+// Example usage showing fused array and vector arithmetic.
+/*
+    VectorArray2<float> points = ...;
+    Vector2<float> origin(10, 20);
+
+    // Nothing is computed yet, this only records the operations.
+    auto scaled = ((lazy(points) - origin) * 2.0f) + origin;
+
+    // Evaluates the whole chain in one pass per lane, into a new array...
+    VectorArray2<float> out = evaluate(scaled);
+
+    // ...or into an existing one, which may be one of the operands.
+    assign(points, scaled);
+
+    // Large arrays can be split over an executor
+    assign(points, scaled, Executor::shared());
+
+    // Expressions over single vectors evaluate to a vector
+    Vector2<float> p = evaluate((lazy(origin) * 3.0f) - Vector2<float>(1, 1));
+
+    // Arrays referenced by an expression must outlive it, and must not be resized before it is evaluated.
+*/
+
+
+
+// Loop hint used by the evaluation kernels, the same as the one used by vectorarray.h.
+// Every lane of the result only reads the same index of its operands, so iterations never depend on each other.
+#if defined(__clang__)
+    #define _EXPR_VECTORIZE _Pragma("clang loop vectorize(enable) interleave(enable)")
+#elif defined(__GNUC__)
+    #define _EXPR_VECTORIZE _Pragma("GCC ivdep")
+#elif defined(_MSC_VER)
+    #define _EXPR_VECTORIZE __pragma(loop(ivdep))
+#else
+    #define _EXPR_VECTORIZE
+#endif
+
+
+
+// Maps a dimension count onto its VectorArray class
+template <typename T, size_t N> struct _vector_array_of;
+template <typename T> struct _vector_array_of<T, 2> { using type = VectorArray2<T>; };
+template <typename T> struct _vector_array_of<T, 3> { using type = VectorArray3<T>; };
+template <typename T> struct _vector_array_of<T, 4> { using type = VectorArray4<T>; };
+
+template <typename T, size_t N>
+using vector_array_t = typename _vector_array_of<T, N>::type;
+
+// Returns the lane of dimension D
+template <size_t D, typename Array>
+inline auto _array_lane(Array& array) {
+    if constexpr (D == 0) return array.x;
+    else if constexpr (D == 1) return array.y;
+    else if constexpr (D == 2) return array.z;
+    else return array.w;
+}
+
+
+
+// Expression nodes
+// Every node provides `at<D>(i)`, the value of dimension D of element i, and `size()`, its element count.
+// Nodes that don't come from an array have a single element, and ignore `i`.
+
+// Reads from the lanes of a VectorArray
+template <typename T, size_t N>
+struct ExprArray {
+    using value_type = T;
+    static constexpr size_t dimensions = N;
+    static constexpr bool is_array = true;
+
+    const T* lanes[N];
+    size_t count;
+
+    template <size_t D> T at(size_t i) const { return lanes[D][i]; }
+    size_t size() const { return count; }
+};
+
+// Broadcasts one vector over every element
+template <typename T, size_t N>
+struct ExprVector {
+    using value_type = T;
+    static constexpr size_t dimensions = N;
+    static constexpr bool is_array = false;
+
+    Vector<T, N> value;
+
+    template <size_t D> constexpr T at(size_t) const { return value.template get<D>(); }
+    constexpr size_t size() const { return 1; }
+};
+
+// Broadcasts one value over every dimension of every element
+template <typename T, size_t N>
+struct ExprScalar {
+    using value_type = T;
+    static constexpr size_t dimensions = N;
+    static constexpr bool is_array = false;
+
+    T value;
+
+    template <size_t D> constexpr T at(size_t) const { return value; }
+    constexpr size_t size() const { return 1; }
+};
+
+// Applies an operator to two nodes of the same type and dimensions
+template <typename Op, typename L, typename R>
+struct ExprBinary {
+    static_assert(std::is_same_v<typename L::value_type, typename R::value_type> && L::dimensions == R::dimensions,
+                  "Both sides of a vector expression must have the same type and dimensions");
+
+    using value_type = typename L::value_type;
+    static constexpr size_t dimensions = L::dimensions;
+    static constexpr bool is_array = L::is_array || R::is_array;
+
+    L lhs;
+    R rhs;
+
+    constexpr ExprBinary(const L& lhs, const R& rhs) : lhs(lhs), rhs(rhs) {
+        if constexpr (L::is_array && R::is_array)
+            assert(lhs.size() == rhs.size());
+    }
+
+    template <size_t D> constexpr value_type at(size_t i) const {
+        return Op::apply(lhs.template at<D>(i), rhs.template at<D>(i));
+    }
+
+    constexpr size_t size() const {
+        if constexpr (L::is_array) return lhs.size();
+        else return rhs.size();
+    }
+};
+
+
+
+// Detects expression nodes
+template <typename E> struct _is_vector_expr : std::false_type {};
+template <typename T, size_t N> struct _is_vector_expr<ExprArray<T, N>> : std::true_type {};
+template <typename T, size_t N> struct _is_vector_expr<ExprVector<T, N>> : std::true_type {};
+template <typename T, size_t N> struct _is_vector_expr<ExprScalar<T, N>> : std::true_type {};
+template <typename Op, typename L, typename R> struct _is_vector_expr<ExprBinary<Op, L, R>> : std::true_type {};
+
+template <typename E>
+concept VectorExpression = _is_vector_expr<E>::value;
+
+
+
+// Entry points, which turn operands into expressions
+template <typename T> ExprArray<T, 2> lazy(const VectorArray2<T>& a) { return { { a.x, a.y }, a.size() }; }
+template <typename T> ExprArray<T, 3> lazy(const VectorArray3<T>& a) { return { { a.x, a.y, a.z }, a.size() }; }
+template <typename T> ExprArray<T, 4> lazy(const VectorArray4<T>& a) { return { { a.x, a.y, a.z, a.w }, a.size() }; }
+
+template <typename T, size_t N>
+constexpr ExprVector<T, N> lazy(const Vector<T, N>& v) { return { v }; }
+
+
+
+// Defines which operators can be used in expressions, with a name for the functor implementing each.
+// This matches the OPERATORS list of vectorx.h.
+#define EXPR_OPERATORS(func) \
+    func(+, Add)             \
+    func(-, Sub)             \
+    func(*, Mul)             \
+    func(/, Div)             \
+    func(%, Mod)             \
+    func(&, And)             \
+    func(|, Or)              \
+    func(^, Xor)             \
+    func(<<, Shl)            \
+    func(>>, Shr)
+
+
+
+/*** Defines template for each operator's functor and its overloads. ***/
+// Expressions combine with other expressions, single values, single vectors and whole arrays, on either side.
+// Each step is stored back to T, the same as the Vector and VectorArray operators.
+#define _EXPR_OP(op, name)                                                                                  \
+    struct _Expr##name {                                                                                    \
+        template <typename T> static constexpr T apply(T a, T b) { return a op b; }                         \
+    };                                                                                                      \
+                                                                                                            \
+    template <VectorExpression L, VectorExpression R>                                                       \
+    constexpr auto operator op(const L& lhs, const R& rhs) {                                                \
+        return ExprBinary<_Expr##name, L, R>(lhs, rhs);                                                     \
+    }                                                                                                       \
+                                                                                                            \
+    template <VectorExpression L>                                                                           \
+    constexpr auto operator op(const L& lhs, const typename L::value_type& rhs) {                           \
+        return lhs op ExprScalar<typename L::value_type, L::dimensions>{ rhs };                             \
+    }                                                                                                       \
+    template <VectorExpression R>                                                                           \
+    constexpr auto operator op(const typename R::value_type& lhs, const R& rhs) {                           \
+        return ExprScalar<typename R::value_type, R::dimensions>{ lhs } op rhs;                             \
+    }                                                                                                       \
+                                                                                                            \
+    template <VectorExpression L>                                                                           \
+    constexpr auto operator op(const L& lhs, const Vector<typename L::value_type, L::dimensions>& rhs) {    \
+        return lhs op lazy(rhs);                                                                            \
+    }                                                                                                       \
+    template <VectorExpression R>                                                                           \
+    constexpr auto operator op(const Vector<typename R::value_type, R::dimensions>& lhs, const R& rhs) {    \
+        return lazy(lhs) op rhs;                                                                            \
+    }                                                                                                       \
+                                                                                                            \
+    template <VectorExpression L>                                                                           \
+    auto operator op(const L& lhs, const vector_array_t<typename L::value_type, L::dimensions>& rhs) {      \
+        return lhs op lazy(rhs);                                                                            \
+    }                                                                                                       \
+    template <VectorExpression R>                                                                           \
+    auto operator op(const vector_array_t<typename R::value_type, R::dimensions>& lhs, const R& rhs) {      \
+        return lazy(lhs) op rhs;                                                                            \
+    }
+
+EXPR_OPERATORS( _EXPR_OP )
+
+
+
+// Evaluation
+// Evaluates the elements [begin, end) of one lane
+template <size_t D, typename T, VectorExpression E>
+inline void _assign_lane(T* dst, const E& expr, size_t begin, size_t end) {
+    dst = _array_assume_aligned(dst);
+
+    _EXPR_VECTORIZE
+    for (size_t i = begin; i < end; i++)
+        dst[i] = expr.template at<D>(i);
+}
+
+template <VectorExpression E, size_t... D>
+inline void _assign_lanes(vector_array_t<typename E::value_type, E::dimensions>& out, const E& expr,
+                          size_t begin, size_t end, std::index_sequence<D...>) {
+    (_assign_lane<D>(_array_lane<D>(out), expr, begin, end), ...);
+}
+
+template <VectorExpression E, size_t... D>
+constexpr Vector<typename E::value_type, E::dimensions> _evaluate_vector(const E& expr, std::index_sequence<D...>) {
+    return Vector<typename E::value_type, E::dimensions>(expr.template at<D>(0)...);
+}
+
+// Evaluates an expression into an existing array, resizing it to fit.
+// The array may also be an operand of the expression, as every element only depends on the same element of its operands.
+template <VectorExpression E>
+void assign(vector_array_t<typename E::value_type, E::dimensions>& out, const E& expr) {
+    if (out.size() != expr.size())
+        out.resize(expr.size());
+    _assign_lanes(out, expr, 0, out.size(), std::make_index_sequence<E::dimensions>());
+}
+
+// Same as above, split over an executor. Every lane of every chunk is still evaluated in a single pass.
+template <VectorExpression E>
+void assign(vector_array_t<typename E::value_type, E::dimensions>& out, const E& expr, Executor& executor) {
+    if (out.size() != expr.size())
+        out.resize(expr.size());
+
+    parallel_for(executor, 0, out.size(), [&](size_t begin, size_t end) {
+        _assign_lanes(out, expr, begin, end, std::make_index_sequence<E::dimensions>());
+    });
+}
+
+// Evaluates an expression into a new VectorArray, or into a Vector if it doesn't reference any arrays.
+template <VectorExpression E>
+constexpr auto evaluate(const E& expr) {
+    if constexpr (E::is_array) {
+        vector_array_t<typename E::value_type, E::dimensions> out;
+        assign(out, expr);
+        return out;
+    } else {
+        return _evaluate_vector(expr, std::make_index_sequence<E::dimensions>());
+    }
+}
+
+
+
+
+
+
+// Clean up all definitions to prevent collisions with other headers.
+#undef EXPR_OPERATORS
+#undef _EXPR_OP
+#undef _EXPR_VECTORIZE
@@ -2,9 +2,9 @@
 /// Date: February 29, 2024
 /// 
 /// Description: 
-///     Provides Vector2, Vector3, and Vector4 classes designed for operations on cartesian coordinate systems.
-///     The provided macros make it simple to extend this functionality to other fixed Vector sizes with custom
-///     dimension labels.
+///     Provides the Vector<T, N> class, and its Vector2, Vector3, and Vector4 aliases, designed for operations on
+///     cartesian coordinate systems. Vectors of up to 4 dimensions are accessed by name (x, y, z, w), and wider
+///     vectors, such as 8 or 16-wide feature vectors, by index. All of them share the same arithmetic.
 /// 
 /// License:
 ///     The code in this file is licensed under the
@@ -16,6 +16,12 @@
 
 #include <iostream>
 #include <sstream>
+#include <charconv>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 
 
 
@@ -40,12 +46,116 @@
 
     // Formatting evaluated expressions to debug string or to JSON
     std::cout << (a * b).json() << std::endl;
+
+    // Appending to an existing string avoids allocating a new one for every vector
+    std::string out;
+    a.json(out);
+    out += ',';
+    b.json(out);
+
+    // Parsing vectors back from JSON
+    Vector4<int> c;
+    if (Vector4<int>::fromJson("[1,2,3,4]", c))
+        std::cout << c.str() << std::endl;
+
+    // Wider vectors work the same way, and are indexed instead of named
+    auto d = Vector<float, 8>::filled(1.5f);
+    d *= Vector<float, 8>(1, 2, 3, 4, 5, 6, 7, 8);
+    float first = d[0];
 */
 
 
 
-// Generator Constants
-#define DEFAULT_MEMBER_VALUE 0
+// Appends a value to a string, formatted exactly the same as inserting it into a default std::ostream.
+// Numbers are formatted with std::to_chars, which is much faster than going through a stream.
+template <typename T>
+void append_formatted(std::string& out, const T& value) {
+    if constexpr (std::is_same_v<T, char> || std::is_same_v<T, signed char> || std::is_same_v<T, unsigned char>) {
+        // Streams insert character types as characters, not numbers
+        out.push_back(static_cast<char>(value));
+    } else if constexpr (std::is_same_v<T, bool>) {
+        out.push_back(value ? '1' : '0');
+    } else if constexpr (std::is_floating_point_v<T>) {
+        // Streams default to the same output as printf's "%.6g"
+        char buffer[64];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::general, 6);
+        out.append(buffer, result.ptr);
+    } else if constexpr (std::is_integral_v<T>) {
+        char buffer[32];
+        auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+        out.append(buffer, result.ptr);
+    } else {
+        // Other types fall back to their stream insertion operator
+        std::ostringstream ss;
+        ss << value;
+        out += ss.str();
+    }
+}
+
+
+
+// JSON parsing functions
+// These advance `first` past whatever they read, and return false if the input doesn't match.
+
+// Skips any JSON whitespace.
+inline void skip_json_whitespace(const char*& first, const char* last) {
+    while (first != last && (*first == ' ' || *first == '\n' || *first == '\r' || *first == '\t'))
+        first++;
+}
+
+// Skips whitespace, then reads one expected character.
+inline bool expect_json(const char*& first, const char* last, char c) {
+    skip_json_whitespace(first, last);
+    if (first == last || *first != c)
+        return false;
+    first++;
+    return true;
+}
+
+// Reads a value written by append_formatted, using std::from_chars for numbers.
+template <typename T>
+bool parse_formatted(const char*& first, const char* last, T& value) {
+    static_assert(std::is_arithmetic_v<T>, "Only arithmetic values can be parsed.");
+    skip_json_whitespace(first, last);
+
+    if constexpr (std::is_same_v<T, char> || std::is_same_v<T, signed char> || std::is_same_v<T, unsigned char>) {
+        // Character types are written as characters
+        if (first == last)
+            return false;
+        value = static_cast<T>(*first++);
+        return true;
+    } else if constexpr (std::is_same_v<T, bool>) {
+        if (first == last || (*first != '0' && *first != '1'))
+            return false;
+        value = *first++ == '1';
+        return true;
+    } else {
+        auto result = std::from_chars(first, last, value);
+        if (result.ec != std::errc())
+            return false;
+        first = result.ptr;
+        return true;
+    }
+}
+
+// Parses a whole document into `out`, which must provide `parseJson(first, last)`.
+// Only trailing whitespace may follow the parsed value. `out` is left unchanged on failure.
+template <typename Parsed>
+bool parse_json_document(std::string_view json, Parsed& out) {
+    const char* first = json.data();
+    const char* last = first + json.size();
+
+    Parsed parsed;
+    if (!parsed.parseJson(first, last))
+        return false;
+
+    skip_json_whitespace(first, last);
+    if (first != last)
+        return false;
+
+    out = parsed;
+    return true;
+}
 
 
 
@@ -66,178 +176,245 @@
 
 
 
-// Formatting functions
-// This section is a bunch of utility functions.
-// The ones ending in 0 or 1 are used as compile-time comparisons to treat the end of the
-// dimensions list differently than prior elements. This is used for comma-delimination mostly.
-#define _VARIABLE_DEF(str, is_end, ...) T str;
+// Alignment of a vector in bytes.
+// Vectors whose size is a power of two, up to a cache line, are aligned to their size so that one vector
+// fills exactly one packed register (Vector4<float> for SSE, Vector<float, 8> for AVX, Vector<float, 16> for AVX-512).
+// Other sizes, such as Vector3, keep the alignment of T so they are never padded.
+template <typename T, size_t N>
+constexpr size_t vector_alignment() {
+    constexpr size_t bytes = N * sizeof(T);
+    if constexpr (bytes <= 64 && (bytes & (bytes - 1)) == 0)
+        return bytes > alignof(T) ? bytes : alignof(T);
+    else
+        return alignof(T);
+}
 
-#define _PARAMETER_DEF0(str) T str,
-#define _PARAMETER_DEF1(str) T str
-#define _PARAMETER_DEF(str, is_end, ...) _PARAMETER_DEF##is_end(str)
 
-#define _MEMBER_INITIALIZER_DEF0(str, value) str (value),
-#define _MEMBER_INITIALIZER_DEF1(str, value) str (value)
-#define _MEMBER_INITIALIZER_DEF(str, is_end, ...) _MEMBER_INITIALIZER_DEF##is_end(str, str)
-#define _MEMBER_INITIALIZER_DEFAULT(str, is_end, ...) _MEMBER_INITIALIZER_DEF##is_end(str, DEFAULT_MEMBER_VALUE)
 
-#define _INSERTION_STR0(str) str << ", " <<
-#define _INSERTION_STR1(str) str << ")"
-#define _INSERTION_STR(str, is_end, ...) _INSERTION_STR##is_end(str)
+// Storage
+// Vectors of up to 4 dimensions keep their named members, so `v.x` keeps working everywhere.
+// Named members are laid out exactly like an array of N values, and get<I>() maps an index onto them at compile time.
+// Larger vectors are stored as a plain array.
+template <typename T, size_t N>
+struct VectorStorage {
+    alignas(vector_alignment<T, N>()) T data[N];
 
-#define _INSERTION_JSON0(str) str << "," <<
-#define _INSERTION_JSON1(str) str << "]"
-#define _INSERTION_JSON(str, is_end, ...) _INSERTION_JSON##is_end(str)
+    template <size_t I> constexpr T& get() noexcept { return data[I]; }
+    template <size_t I> constexpr const T& get() const noexcept { return data[I]; }
 
+    constexpr T& operator[](size_t i) noexcept { return data[i]; }
+    constexpr const T& operator[](size_t i) const noexcept { return data[i]; }
+};
 
+template <typename T>
+struct alignas(vector_alignment<T, 2>()) VectorStorage<T, 2> {
+    T x, y;
 
-// Operator helper functions
-// Performs scaling on `this` vector
-#define _SCALE_SCALAR_THIS(dim, is_end, op) dim op##= scalar;
-#define _SCALE_OTHER_THIS(dim, is_end, op)  dim op##= other.dim;
+    template <size_t I> constexpr T& get() noexcept {
+        if constexpr (I == 0) return x; else return y;
+    }
+    template <size_t I> constexpr const T& get() const noexcept {
+        if constexpr (I == 0) return x; else return y;
+    }
+
+    constexpr T& operator[](size_t i) noexcept { return i == 0 ? x : y; }
+    constexpr const T& operator[](size_t i) const noexcept { return i == 0 ? x : y; }
+};
 
-// Performs scaling on temporary Vector
-#define _SCALE_SCALAR_NEW(dim, is_end, op) v.dim = dim op scalar;
-#define _SCALE_OTHER_NEW(dim, is_end, op)  v.dim = dim op other.dim;
+template <typename T>
+struct alignas(vector_alignment<T, 3>()) VectorStorage<T, 3> {
+    T x, y, z;
 
+    template <size_t I> constexpr T& get() noexcept {
+        if constexpr (I == 0) return x; else if constexpr (I == 1) return y; else return z;
+    }
+    template <size_t I> constexpr const T& get() const noexcept {
+        if constexpr (I == 0) return x; else if constexpr (I == 1) return y; else return z;
+    }
 
+    constexpr T& operator[](size_t i) noexcept { return i == 0 ? x : i == 1 ? y : z; }
+    constexpr const T& operator[](size_t i) const noexcept { return i == 0 ? x : i == 1 ? y : z; }
+};
 
-// Comparison helper functions
-#define _EQ0(dim) (dim == other.dim) &
-#define _EQ1(dim) (dim == other.dim)
-#define _EQ(dim, is_end, ...) _EQ##is_end(dim)
+template <typename T>
+struct alignas(vector_alignment<T, 4>()) VectorStorage<T, 4> {
+    T x, y, z, w;
+
+    template <size_t I> constexpr T& get() noexcept {
+        if constexpr (I == 0) return x; else if constexpr (I == 1) return y; else if constexpr (I == 2) return z; else return w;
+    }
+    template <size_t I> constexpr const T& get() const noexcept {
+        if constexpr (I == 0) return x; else if constexpr (I == 1) return y; else if constexpr (I == 2) return z; else return w;
+    }
 
-#define _NEQ0(dim) (dim != other.dim) |
-#define _NEQ1(dim) (dim != other.dim)
-#define _NEQ(dim, is_end, ...) _NEQ##is_end(dim)
+    constexpr T& operator[](size_t i) noexcept { return i == 0 ? x : i == 1 ? y : i == 2 ? z : w; }
+    constexpr const T& operator[](size_t i) const noexcept { return i == 0 ? x : i == 1 ? y : i == 2 ? z : w; }
+};
 
 
 
 /*** Defines template for creating operator implementations for scalar values and other Vector types. ***/
-#define _VECTOR_OP(op, dim)                                     \
-    /* Create new vector, scales all dimensions, and returns */ \
-    Vector##dim operator op(const T& scalar) {                  \
-        Vector##dim v;                                          \
-        _VECTOR_DIMS_##dim( _SCALE_SCALAR_NEW, op )             \
-        return v;                                               \
-    }                                                           \
-                                                                \
-    /* Scales all dimensions of first vecotr and returns it */  \
-    Vector##dim& operator op##=(const T& scalar) {              \
-        _VECTOR_DIMS_##dim( _SCALE_SCALAR_THIS, op )            \
-        return *this;                                           \
-    }                                                           \
-                                                                \
-    /* Create new vector, scales all dimensions, and returns */ \
-    Vector##dim operator op(const Vector##dim& other) {         \
-        Vector##dim v;                                          \
-        _VECTOR_DIMS_##dim( _SCALE_OTHER_NEW, op )              \
-        return v;                                               \
-    }                                                           \
-                                                                \
-    /* Scales all dimensions of first vecotr and returns it */  \
-    Vector##dim& operator op##=(const Vector##dim& other) {     \
-        _VECTOR_DIMS_##dim( _SCALE_OTHER_THIS, op )             \
-        return *this;                                           \
+// Every operator is unrolled over the dimensions with a fold expression, which leaves straight-line code
+// that the optimizer packs into SIMD instructions for float and integer lanes.
+#define _VECTOR_OP(op, ...)                                                                      \
+    /* Create new vector, scales all dimensions, and returns */                                  \
+    constexpr Vector operator op(const T& scalar) const noexcept {                               \
+        return _map([&scalar](const T& a) { return a op scalar; }, _indices());                 \
+    }                                                                                            \
+                                                                                                 \
+    /* Scales all dimensions of first vector and returns it */                                   \
+    constexpr Vector& operator op##=(const T& scalar) noexcept {                                 \
+        _each([&scalar](T& a) { a op##= scalar; }, _indices());                                  \
+        return *this;                                                                            \
+    }                                                                                            \
+                                                                                                 \
+    /* Create new vector, scales all dimensions, and returns */                                  \
+    constexpr Vector operator op(const Vector& other) const noexcept {                           \
+        return _zip(other, [](const T& a, const T& b) { return a op b; }, _indices());           \
+    }                                                                                            \
+                                                                                                 \
+    /* Scales all dimensions of first vector and returns it */                                   \
+    constexpr Vector& operator op##=(const Vector& other) noexcept {                             \
+        _each(other, [](T& a, const T& b) { a op##= b; }, _indices());                           \
+        return *this;                                                                            \
     }
 
 
 
-/*** Defines template for creating comparator implementations between vectors. ***/
-#define _VECTOR_COMP(dim)                        \
-    bool operator== (const Vector##dim& other) { \
-        return _VECTOR_DIMS_##dim( _EQ );        \
-    }                                            \
-                                                 \
-    bool operator!= (const Vector##dim& other) { \
-        return _VECTOR_DIMS_##dim( _NEQ );       \
+// A vector of N values of type T.
+// Vector2, Vector3 and Vector4 are aliases of this, and any other width can be used directly, e.g. Vector<float, 8>.
+template <typename T, size_t N>
+class Vector : public VectorStorage<T, N> {
+    static_assert(N > 0, "Vectors need at least one dimension");
+
+public:
+    static constexpr size_t dimensions = N;
+    using value_type = T;
+
+    // Dimension values default to 0
+    constexpr Vector() noexcept : VectorStorage<T, N>{} {}
+
+    // One value per dimension
+    template <typename... Values>
+        requires (sizeof...(Values) == N && (std::is_convertible_v<Values, T> && ...))
+    constexpr explicit(N == 1) Vector(Values... values) noexcept
+        : VectorStorage<T, N>{ static_cast<T>(values)... } {}
+
+    // Every dimension set to the same value
+    static constexpr Vector filled(const T& value) noexcept {
+        return _filled(value, _indices());
     }
 
+    constexpr size_t size() const noexcept { return N; }
 
 
 
-/*** Defines template for each Vector class implementation ***/
-#define _VECTOR_DEF(dim)                                           \
-    template<typename T>                                           \
-    class Vector##dim {                                            \
-    public:                                                        \
-        /* Declares all of the dimension variables */              \
-        _VECTOR_DIMS_##dim( _VARIABLE_DEF )                        \
-                                                                   \
-        /* Builds the Vector constructor functions */              \
-        Vector##dim ()                                             \
-            : _VECTOR_DIMS_##dim( _MEMBER_INITIALIZER_DEFAULT ) {} \
-        Vector##dim ( _VECTOR_DIMS_##dim( _PARAMETER_DEF ) )       \
-            : _VECTOR_DIMS_##dim( _MEMBER_INITIALIZER_DEF ) {}     \
-                                                                   \
-        /* Implements all of the supported operators */            \
-        OPERATORS( _VECTOR_OP, dim )                               \
-                                                                   \
-        /* Implements all of the supported comparators */          \
-        _VECTOR_COMP( dim )                                        \
-                                                                   \
-        /* Imlements string conversion for all dimensions */       \
-        std::string str() {                                        \
-            std::stringstream ss;                                  \
-            ss << "(" << _VECTOR_DIMS_##dim(_INSERTION_STR);       \
-            return ss.str();                                       \
-        }                                                          \
-                                                                   \
-        /* Imlements JSON conversion for all dimensions */         \
-        std::string json() {                                       \
-            std::stringstream ss;                                  \
-            ss << "[" << _VECTOR_DIMS_##dim(_INSERTION_JSON);      \
-            return ss.str();                                       \
-        }                                                          \
-    };
-
-
-
-
-
-
-// Define each Vector size's dimension names
-
-// PARAMS:
-// 0: Name of dimension  (x, y, z, etc)
-// 1: Is last element    (0 = False, 1 = True)
-// 2: Optional arguments (Set to __VA_ARGS__)
-#define _VECTOR_DIMS_2(func, ...) \
-    func(x, 0, __VA_ARGS__)       \
-    func(y, 1, __VA_ARGS__)
-
-#define _VECTOR_DIMS_3(func, ...) \
-    func(x, 0, __VA_ARGS__)       \
-    func(y, 0, __VA_ARGS__)       \
-    func(z, 1, __VA_ARGS__)
-
-#define _VECTOR_DIMS_4(func, ...) \
-    func(x, 0, __VA_ARGS__)       \
-    func(y, 0, __VA_ARGS__)       \
-    func(z, 0, __VA_ARGS__)       \
-    func(w, 1, __VA_ARGS__)
-
-// Example: Adding your own vector is as simple as specifying the letters for each dimension.
-//          Then, call the _VECTOR_DEF() macro with the same dimension number below.
-/*
-#define _VECTOR_DIMS_5(func, ...) \
-    func(x, 0, __VA_ARGS__)       \
-    func(y, 0, __VA_ARGS__)       \
-    func(z, 0, __VA_ARGS__)       \
-    func(w, 0, __VA_ARGS__)       \
-    func(a, 1, __VA_ARGS__)
-*/
+    // Implements all of the supported operators
+    OPERATORS( _VECTOR_OP )
+
+    // Implements all of the supported comparators
+    constexpr bool operator== (const Vector& other) const noexcept { return _equal(other, _indices()); }
+    constexpr bool operator!= (const Vector& other) const noexcept { return !_equal(other, _indices()); }
 
 
 
-// Build Vector class definitions
-_VECTOR_DEF(2)
-_VECTOR_DEF(3)
-_VECTOR_DEF(4)
+    // Serializers
+    // Implements string conversion for all dimensions
+    std::string str() const {
+        std::string out;
+        str(out);
+        return out;
+    }
+
+    // Appends the string conversion to an existing string
+    void str(std::string& out) const {
+        out += '(';
+        for (size_t i = 0; i < N; i++) {
+            append_formatted(out, (*this)[i]);
+            if (i + 1 < N)
+                out += ", ";
+        }
+        out += ')';
+    }
+
+    // Implements JSON conversion for all dimensions
+    std::string json() const {
+        std::string out;
+        json(out);
+        return out;
+    }
+
+    // Appends the JSON conversion to an existing string
+    void json(std::string& out) const {
+        out += '[';
+        for (size_t i = 0; i < N; i++) {
+            append_formatted(out, (*this)[i]);
+            out += i + 1 < N ? ',' : ']';
+        }
+    }
 
-// Example: This would be the implementation for the above 5th-dimensional class.
+    // Reads a JSON array of all dimensions from a cursor
+    bool parseJson(const char*& first, const char* last) {
+        if (!expect_json(first, last, '['))
+            return false;
+        for (size_t i = 0; i < N; i++) {
+            if (!parse_formatted(first, last, (*this)[i]) || !expect_json(first, last, i + 1 < N ? ',' : ']'))
+                return false;
+        }
+        return true;
+    }
+
+    // Implements JSON parsing, returning false if invalid
+    static bool fromJson(std::string_view json, Vector& out) {
+        return parse_json_document(json, out);
+    }
+
+
+
+private:
+    static constexpr std::make_index_sequence<N> _indices() noexcept { return {}; }
+
+    template <size_t... I>
+    static constexpr Vector _filled(const T& value, std::index_sequence<I...>) noexcept {
+        return Vector(((void)I, value)...);
+    }
+
+    template <typename F, size_t... I>
+    constexpr Vector _map(F f, std::index_sequence<I...>) const noexcept {
+        return Vector(f(this->template get<I>())...);
+    }
+
+    template <typename F, size_t... I>
+    constexpr Vector _zip(const Vector& other, F f, std::index_sequence<I...>) const noexcept {
+        return Vector(f(this->template get<I>(), other.template get<I>())...);
+    }
+
+    template <typename F, size_t... I>
+    constexpr void _each(F f, std::index_sequence<I...>) noexcept {
+        (f(this->template get<I>()), ...);
+    }
+
+    template <typename F, size_t... I>
+    constexpr void _each(const Vector& other, F f, std::index_sequence<I...>) noexcept {
+        (f(this->template get<I>(), other.template get<I>()), ...);
+    }
+
+    template <size_t... I>
+    constexpr bool _equal(const Vector& other, std::index_sequence<I...>) const noexcept {
+        return ((this->template get<I>() == other.template get<I>()) && ...);
+    }
+};
+
+
+
+// Named vector sizes
+template <typename T> using Vector2 = Vector<T, 2>;
+template <typename T> using Vector3 = Vector<T, 3>;
+template <typename T> using Vector4 = Vector<T, 4>;
+
+// Example: Wider vectors need no extra definitions, just use the width directly.
 /*
-_VECTOR_DEF(5)
+using Features = Vector<float, 16>;
 */
 
 
@@ -245,41 +422,35 @@ _VECTOR_DEF(5)
 
 
 
-// Clean up all definitions to prevent collisions or bugs with other broken headers.
-// Not necessarily required, but good practice. I don't want that blood on my hands.
-#undef DEFAULT_MEMBER_VALUE
-#undef OPERATORS
+// Vectors are plain aggregates of their dimensions, so they can be copied with memcpy,
+// written to binary files, mapped from memory, and used in constant expressions.
+template <typename T, size_t N>
+constexpr bool vector_layout_check() {
+    static_assert(std::is_trivially_copyable_v<Vector<T, N>>, "Vectors must be trivially copyable");
+    static_assert(std::is_standard_layout_v<Vector<T, N>>, "Vectors must have standard layout");
+    static_assert(sizeof(Vector<T, N>) == N * sizeof(T), "Vectors must not be padded");
+    static_assert(alignof(Vector<T, N>) == vector_alignment<T, N>(), "Vectors must be aligned to their register width");
+    return true;
+}
+
+template <size_t N>
+constexpr bool vector_layout_checks() {
+    return vector_layout_check<float, N>() && vector_layout_check<double, N>() && vector_layout_check<int, N>();
+}
 
-#undef _VARIABLE_DEF
+static_assert(vector_layout_checks<2>() && vector_layout_checks<3>() && vector_layout_checks<4>() &&
+              vector_layout_checks<8>() && vector_layout_checks<16>());
 
-#undef _PARAMETER_DEF
-#undef _PARAMETER_DEF0
-#undef _PARAMETER_DEF1
+static_assert((Vector2<int>(1, 2) + Vector2<int>(3, 4)) * 2 == Vector2<int>(8, 12), "Vectors must be usable in constant expressions");
+static_assert(Vector<int, 8>::filled(3) - Vector<int, 8>(0, 1, 2, 3, 4, 5, 6, 7) == Vector<int, 8>(3, 2, 1, 0, -1, -2, -3, -4),
+              "Wide vectors must be usable in constant expressions");
 
-#undef _MEMBER_INITIALIZER_DEF
-#undef _MEMBER_INITIALIZER_DEF0
-#undef _MEMBER_INITIALIZER_DEF1
-#undef _MEMBER_INITIALIZER_DEFAULT
 
-#undef _INSERTION_STR
-#undef _INSERTION_STR0
-#undef _INSERTION_STR1
-#undef _INSERTION_JSON
-#undef _INSERTION_JSON0
-#undef _INSERTION_JSON1
 
-#undef _SCALE_OTHER_NEW
-#undef _SCALE_OTHER_THIS
-#undef _SCALE_SCALAR_NEW
-#undef _SCALE_SCALAR_THIS
 
-#undef _EQ
-#undef _EQ0
-#undef _EQ1
 
-#undef _NEQ
-#undef _NEQ0
-#undef _NEQ1
 
+// Clean up all definitions to prevent collisions or bugs with other broken headers.
+// Not necessarily required, but good practice. I don't want that blood on my hands.
+#undef OPERATORS
 #undef _VECTOR_OP
-#undef _VECTOR_DEF
\ No newline at end of file